@@ -12,6 +12,7 @@ public:
 	virtual void OnDetach() override;
 
 	void OnUpdate(rhombus::DeltaTime dt) override;
+	void OnFixedUpdate(rhombus::DeltaTime dt) override;
 	virtual void OnImGuiRender() override;
 	void OnEvent(rhombus::Event& e) override;
 
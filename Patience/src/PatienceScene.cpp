@@ -180,10 +180,8 @@ void PatienceScene::DeserializeEntity(void* yamlEntity, Entity entity)
 	}
 }
 
-void PatienceScene::OnMouseMoved(int x, int y)
+void PatienceScene::OnCursorMoved(int x, int y)
 {
-	Scene::OnMouseMoved(x, y);
-
 	cardPlacementSystem->OnMouseMoved(x, y);
 }
 
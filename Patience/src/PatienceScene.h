@@ -22,10 +22,12 @@ public:
 	virtual void SerializeEntity(void* yamlEmitter, Entity entity) override;
 	virtual void DeserializeEntity(void* yamlEntity, Entity entity) override;
 
-	virtual void OnMouseMoved(int x, int y) override;
 	virtual void OnMouseButtonPressed(int button) override;
 	virtual void OnMouseButtonReleased(int button) override;
 
+protected:
+	virtual void OnCursorMoved(int x, int y) override;
+
 private:
 	Ref<CardSlotSystem> cardSlotSystem;
 	Ref<CardPlacementSystem> cardPlacementSystem;
@@ -263,7 +263,7 @@ bool CardPlacementSystem::DamageMonster(Entity siteEntity)
 
 				SpriteRendererComponent& sprite = cardEntity.GetComponent<SpriteRendererComponent>();
 				auto path = Project::GetAssetFileSystemPath("textures\\CardsNew\\Backs\\CardBack0.png");
-				sprite.m_texture = Texture2D::Create(path.string());
+				sprite.m_texture = AssetManager::GetTexture(path);
 			}
 		}
 	}
@@ -273,49 +273,44 @@ bool CardPlacementSystem::DamageMonster(Entity siteEntity)
 
 EntityID CardPlacementSystem::CheckForCardSlot(Entity cardEntity)
 {
-	EntityID currentSlot = INVALID_ENTITY;
-	const CardComponent& card = cardEntity.GetComponent<CardComponent>();
 	const BoxArea2DComponent& cardBoxArea = cardEntity.GetComponent<BoxArea2DComponent>();
-	TransformComponent& cardTransform = cardEntity.GetComponent<TransformComponent>();
-	EntityID nearestCardSlot = -1;
-	float nearestSeparation = -1.0f;
-	std::vector<EntityID> view = m_scene->GetRegistry().GetEntityList<CardSlotComponent>();
-	for (EntityID e : view)
+	const Vec3 cardPos = cardEntity.GetComponent<TransformComponent>().GetWorldPosition() + Vec3(cardBoxArea.m_offset, 0.0f);
+	const Vec2 cardCenter = Vec2(cardPos.x, cardPos.y);
+
+	// Only the areas touching the card, the other cards in the stacks included
+	if (m_areaHits.empty())
 	{
-		Entity entity = { e, m_scene };
-		const BoxArea2DComponent& slotArea = entity.GetComponent<BoxArea2DComponent>();
-		const TransformComponent& slotTransform = entity.GetComponent<TransformComponent>();
+		m_areaHits.resize(64);
+	}
 
-		Vec3 cardPos = cardTransform.GetWorldPosition() + Vec3(cardBoxArea.m_offset, 0.0f);
-		Vec3 slotPos = slotTransform.GetWorldPosition() + Vec3(slotArea.m_offset, 0.0f);
+	uint32_t hitCount;
+	while ((hitCount = m_scene->Query().OverlapBox(cardCenter - cardBoxArea.m_size, cardCenter + cardBoxArea.m_size, m_areaHits.data(), (uint32_t)m_areaHits.size(), QUERY_BOX_AREA)) == (uint32_t)m_areaHits.size())
+	{
+		m_areaHits.resize(m_areaHits.size() * 2);
+	}
 
-		Vec2 separation = Vec2(abs(cardPos.x - slotPos.x), abs(cardPos.y - slotPos.y));
-		if (separation.GetMagnitude() < nearestSeparation || nearestSeparation < 0.0f)
+	EntityID nearestCardSlot = INVALID_ENTITY;
+	float nearestSeparation = -1.0f;
+	for (uint32_t i = 0; i < hitCount; i++)
+	{
+		Entity entity = { m_areaHits[i].m_entity, m_scene };
+		if (!entity.HasComponent<CardSlotComponent>())
 		{
-			nearestCardSlot = entity;
-			nearestSeparation = separation.GetMagnitude();
+			continue;
 		}
-	}
 
-	bool placedInSlot = false;
-	if (nearestCardSlot >= 0)
-	{
-		Entity entity = { nearestCardSlot, m_scene };
 		const BoxArea2DComponent& slotArea = entity.GetComponent<BoxArea2DComponent>();
-		TransformComponent& slotTransform = entity.GetComponent<TransformComponent>();
-
-		Vec3 cardPos = cardTransform.GetWorldPosition() + Vec3(cardBoxArea.m_offset, 0.0f);
-		Vec3 slotPos = slotTransform.GetWorldPosition() + Vec3(slotArea.m_offset, 0.0f);
+		const Vec3 slotPos = entity.GetComponent<TransformComponent>().GetWorldPosition() + Vec3(slotArea.m_offset, 0.0f);
 
-		Vec2 separation = Vec2(abs(cardPos.x - slotPos.x), abs(cardPos.y - slotPos.y));
-
-		if (separation.x < (slotArea.m_size.x + cardBoxArea.m_size.x) && separation.y < (slotArea.m_size.y + cardBoxArea.m_size.y))
+		const float separation = (cardCenter - Vec2(slotPos.x, slotPos.y)).GetMagnitude();
+		if (separation < nearestSeparation || nearestSeparation < 0.0f)
 		{
-			currentSlot = entity;
+			nearestCardSlot = entity;
+			nearestSeparation = separation;
 		}
 	}
 
-	return currentSlot;
+	return nearestCardSlot;
 }
 
 void CardPlacementSystem::ReleaseMonster(Entity slotEntity)
@@ -362,7 +357,7 @@ void SetCardBackSprite(Entity card)
 {
 	SpriteRendererComponent& sprite = card.GetComponent<SpriteRendererComponent>();
 	auto path = Project::GetAssetFileSystemPath("textures\\CardsNew\\Backs\\CardBack1.png");
-	sprite.m_texture = Texture2D::Create(path.string());
+	sprite.m_texture = AssetManager::GetTexture(path);
 }
 
 void CardPlacementSystem::MoveCardToSlot(Entity card, Entity slot, bool flipCard)
@@ -371,17 +366,17 @@ void CardPlacementSystem::MoveCardToSlot(Entity card, Entity slot, bool flipCard
 	const TransformComponent& slotTransform = slot.GetComponentRead<TransformComponent>();
 	Vec3 final = Vec3(slotTransform.GetPosition().x, slotTransform.GetPosition().y, zLayers[FOREGROUND_3_LAYER]);
 
-	Ref<Tween> translationTween = m_scene->CreateTween(card, &transform.GetPositionRef(), transform.GetPosition(), final, 0.6f, EasingType::SINE_OUT);
-	translationTween->Start();
+	Tween translationTween = m_scene->CreateTween(card, TweenTarget::Create(card, transform, &transform.GetPositionRef()), transform.GetPosition(), final, 0.6f, EasingType::SINE_OUT);
+	translationTween.Start();
 
 	if (flipCard)
 	{
 		TweenWaitStep waitStep(0.25f);
-		Ref<Tween> rotationTween = m_scene->CreateTween(card, waitStep);
+		Tween rotationTween = m_scene->CreateTween(card, waitStep);
 
 		TweenCallbackStep callbackStep(&SetCardBackSprite, card);
-		rotationTween->AddTweenStep(callbackStep);
-		rotationTween->Start();
+		rotationTween.AddTweenStep(callbackStep);
+		rotationTween.Start();
 
 		/*Ref<Tween> rotationTween = m_scene->CreateTween(card, &transform.m_rotation.y, 0.0f, (3.14f / 2.0f), 1.0f, EasingType::CUBIC_IN);
 		rotationTween->AddCallbackStep(&SetCardBackSprite, card);
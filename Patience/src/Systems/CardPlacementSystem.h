@@ -23,5 +23,8 @@ public:
 	EntityID CheckForCardSlot(Entity cardEntity);
 	void ReleaseMonster(Entity slotEntity);
 	void MoveCardToSlot(Entity card, Entity slot, bool flipCard);
+
+private:
+	std::vector<QueryHit> m_areaHits;
 };
 
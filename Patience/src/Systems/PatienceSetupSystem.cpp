@@ -56,7 +56,7 @@ void PatienceSetupSystem::Init()
 				SpriteRendererComponent& spriteRendererComponent = cardEntity.AddComponent<SpriteRendererComponent>();
 				std::string texturePath = cardData.sprite;
 				auto path = Project::GetAssetFileSystemPath(texturePath);
-				spriteRendererComponent.m_texture = Texture2D::Create(path.string());
+				spriteRendererComponent.m_texture = AssetManager::GetTextureAsync(path);
 
 				Entity cardColumnsEntity = { cardColumns[i], m_scene };
 				CardSlotComponent& cardSlotComponent = cardColumnsEntity.GetComponent<CardSlotComponent>();
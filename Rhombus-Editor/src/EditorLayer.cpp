@@ -118,10 +118,28 @@ namespace rhombus
 		RB_PROFILE_FUNCTION();
 	}
 
+	void EditorLayer::OnFixedUpdate(DeltaTime dt)
+	{
+		RB_PROFILE_FUNCTION();
+
+		if (m_SceneState == SceneState::Play)
+		{
+			m_ActiveScene->OnFixedUpdateRuntime(dt);
+		}
+	}
+
 	void EditorLayer::OnUpdate(DeltaTime dt)
 	{
 		RB_PROFILE_FUNCTION();
 
+		// Textures edited on disk are picked up about once a second, checking stats every cached file
+		m_TextureReloadTimer += dt;
+		if (m_TextureReloadTimer >= 1.0f)
+		{
+			m_TextureReloadTimer = 0.0f;
+			AssetManager::ReloadChangedTextures();
+		}
+
 		// Resize
 		if (FramebufferSpecification spec = m_Framebuffer->GetSpecification();
 			m_ViewportSize.x > 0.0f && m_ViewportSize.y > 0.0f &&		// zero sized framebuffer is invalid
@@ -143,6 +161,7 @@ namespace rhombus
 		// Clear our entity ID attachment to -1
 #if RB_EDITOR
 		m_Framebuffer->ClearAttachment(1, -1);
+		m_ActiveScene->SetPickingEnabled(!m_UseGPUPicking);
 #endif
 
 		// Update Scene
@@ -177,10 +196,30 @@ namespace rhombus
 		int mouseX = (int)mx;
 		int mouseY = (int)my;
 
-		if (mouseX >= 0 && mouseY >= 0 && mouseX < (int)viewportSize.x && mouseY < (int)viewportSize.y)
+		bool mouseInViewport = mouseX >= 0 && mouseY >= 0 && mouseX < (int)viewportSize.x && mouseY < (int)viewportSize.y;
+		if (m_UseGPUPicking)
 		{
-			int pixelData = m_Framebuffer->ReadPixel(1, mouseX, mouseY);
-			m_HoveredEntity = pixelData == -1 ? Entity() : Entity((EntityID)pixelData, m_ActiveScene.get());
+			// Result is from the read queued on an earlier frame so it never waits on the GPU
+			int pixelData;
+			if (m_Framebuffer->GetAsyncPixel(pixelData))
+			{
+				m_HoveredEntity = pixelData == -1 || !mouseInViewport ? Entity() : Entity((EntityID)pixelData, m_ActiveScene.get());
+			}
+
+			if (mouseInViewport)
+			{
+				m_Framebuffer->ReadPixelAsync(1, mouseX, mouseY);
+			}
+			else
+			{
+				m_HoveredEntity = Entity();
+			}
+		}
+		else if (mouseInViewport)
+		{
+			Vec2 ndc = { (mx / viewportSize.x) * 2.0f - 1.0f, (my / viewportSize.y) * 2.0f - 1.0f };
+			EntityID entity = m_ActiveScene->PickEntity(ndc);
+			m_HoveredEntity = entity == INVALID_ENTITY ? Entity() : Entity(entity, m_ActiveScene.get());
 		}
 		else
 		{
@@ -338,6 +377,21 @@ namespace rhombus
 					m_ShowRenderStats = !m_ShowRenderStats;
 				}
 
+				if (ImGui::MenuItem("Show Asset Manager", NULL, m_ShowAssetManager))
+				{
+					m_ShowAssetManager = !m_ShowAssetManager;
+				}
+
+				if (ImGui::MenuItem("Show Script Engine", NULL, m_ShowScriptEngine))
+				{
+					m_ShowScriptEngine = !m_ShowScriptEngine;
+				}
+
+				if (ImGui::MenuItem("Show Script Profiler", NULL, m_ShowScriptProfiler))
+				{
+					m_ShowScriptProfiler = !m_ShowScriptProfiler;
+				}
+
 				ImGui::EndMenu();
 			}
 
@@ -350,6 +404,9 @@ namespace rhombus
 		m_contentBrowserPanel->OnImGuiRender();
 		m_tilesetPanel->OnImGuiRender();
 		m_animtationPanel.OnImGuiRender();
+		m_assetManagerPanel.OnImGuiRender(m_ShowAssetManager);
+		m_scriptEnginePanel.OnImGuiRender(m_ShowScriptEngine);
+		m_scriptProfilerPanel.OnImGuiRender(m_ShowScriptProfiler);
 
 		if (m_ShowRenderStats)
 		{
@@ -377,6 +434,7 @@ namespace rhombus
 			ImGui::Checkbox("Show physics colliders", &m_ShowPhysicsColliders);
 			ImGui::Checkbox("Show game screen size rect", &m_ShowGameScreenSizeRect);
 			ImGui::Checkbox("Show tile map grid", &m_ShowTileMapGrid);
+			ImGui::Checkbox("Use GPU picking", &m_UseGPUPicking);
 			ImGui::ColorEdit4("Physics colliders color", m_PhysicsColliderColor.ToPtr());
 			ImGui::ColorEdit4("Area color", m_AreaColor.ToPtr());
 			ImGui::End();
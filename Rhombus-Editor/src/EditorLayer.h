@@ -8,6 +8,9 @@
 #include "Panels/TilesetPanel.h";
 #include "Panels/EntityViewPanel.h";
 #include "Panels/AnimationPanel.h";
+#include "Panels/AssetManagerPanel.h"
+#include "Panels/ScriptEnginePanel.h"
+#include "Panels/ScriptProfilerPanel.h"
 #include "Rhombus/Renderer/EditorCamera.h"
 
 #define RB_EDITOR 1
@@ -25,6 +28,7 @@ namespace rhombus
 		virtual void OnDetach() override;
 
 		void OnUpdate(DeltaTime dt) override;
+		void OnFixedUpdate(DeltaTime dt) override;
 		virtual void OnImGuiRender() override;
 		void OnEvent(Event& e) override;
 
@@ -100,13 +104,18 @@ namespace rhombus
 
 		bool m_ShowEditorSettings = false;
 		bool m_ShowRenderStats = false;
+		bool m_ShowAssetManager = false;
+		bool m_ShowScriptEngine = false;
+		bool m_ShowScriptProfiler = false;
 		bool m_ShowPhysicsColliders = false;
 		bool m_ShowGameScreenSizeRect = true;
 		bool m_ShowTileMapGrid = false;
+		bool m_UseGPUPicking = false;			// Read the entity ID attachment back a frame late instead of picking on the CPU
 		int m_ScreenResolutionPreset = -1;
 		Color m_PhysicsColliderColor = Color(0.0, 0.5, 1.0, 1.0);
 		float m_PhysicsColliderAlpha = 0.5f;
 		Color m_AreaColor = Color(0.0, 0.0, 1.0, 1.0);
+		float m_TextureReloadTimer = 0.0f;		// Seconds since changed textures were last looked for
 
 		enum SceneState
 		{
@@ -124,6 +133,9 @@ namespace rhombus
 		SceneHierarchyPanel m_sceneHierarchyPanel;
 		EntityViewPanel m_entityViewPanel;
 		AnimationPanel m_animtationPanel;
+		AssetManagerPanel m_assetManagerPanel;
+		ScriptEnginePanel m_scriptEnginePanel;
+		ScriptProfilerPanel m_scriptProfilerPanel;
 		Scope<ContentBrowserPanel> m_contentBrowserPanel;
 		Scope<TilesetPanel> m_tilesetPanel;
 		Ref<EditorExtension> m_editorExtension;
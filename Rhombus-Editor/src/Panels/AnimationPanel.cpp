@@ -117,14 +117,15 @@ namespace rhombus
 
 		ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
 
-		if ((EntityID)m_currentEntity != INVALID_ENTITY && m_currentEntity.HasComponent<AnimatorComponent>())
+		if ((EntityID)m_currentEntity != INVALID_ENTITY && m_currentEntity.HasComponent<AnimatorComponent>()
+			&& item_current_idx < m_currentEntity.GetComponentRead<AnimatorComponent>().GetAnimationCount())
 		{
 			const float thumbnailSize = 64.0f;
 			const float thumbnailPadding = 8.0f;
 
 			const AnimatorComponent& animator = m_currentEntity.GetComponentRead<AnimatorComponent>();
 			const SpriteRendererComponent& spriteRenderer = m_currentEntity.GetComponentRead<SpriteRendererComponent>();
-			const AnimationClip clip = animator.GetAnimationClip(item_current_idx);
+			const AnimationClip& clip = animator.GetAnimationClip(item_current_idx);
 			static ImGuiTableFlags flags = ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_NoHostExtendX;
 			if (ImGui::BeginTable("Timeline", clip.m_samples.size() + 1, flags))
 			{
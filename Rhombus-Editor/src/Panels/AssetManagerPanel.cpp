@@ -0,0 +1,92 @@
+#include "AssetManagerPanel.h"
+
+#include <imgui/imgui.h>
+
+namespace rhombus
+{
+	static float ToMegabytes(size_t bytes)
+	{
+		return (float)bytes / (1024.0f * 1024.0f);
+	}
+
+	void AssetManagerPanel::OnImGuiRender(bool& show)
+	{
+		if (!show)
+			return;
+
+		ImGui::Begin("Asset Manager", &show);
+
+		const AssetManagerStats& stats = AssetManager::GetStats();
+		ImGui::Text("Textures: %u", stats.TextureCount);
+		ImGui::Text("Texture Memory: %.2f MB", ToMegabytes(stats.TextureMemory));
+		ImGui::Text("Loads: %u", stats.TextureLoads);
+		ImGui::Text("Cache Hits: %u", stats.TextureCacheHits);
+		ImGui::Text("Evictions: %u", stats.TextureEvictions);
+
+		int budgetMegabytes = (int)(AssetManager::GetTextureBudget() / (1024 * 1024));
+		if (ImGui::DragInt("Budget (MB)", &budgetMegabytes, 1.0f, 0, 4096))
+		{
+			AssetManager::SetTextureBudget((size_t)budgetMegabytes * 1024 * 1024);
+		}
+
+		if (ImGui::Button("Unload Unused"))
+		{
+			AssetManager::UnloadUnusedTextures();
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Reset Stats"))
+		{
+			AssetManager::ResetStats();
+		}
+
+		ImGui::Separator();
+
+		AssetManager::GetTextureInfos(m_textureInfos);
+		std::sort(m_textureInfos.begin(), m_textureInfos.end(), [](const TextureAssetInfo& a, const TextureAssetInfo& b) { return a.DecodedSize > b.DecodedSize; });
+
+		if (ImGui::BeginTable("Textures", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY))
+		{
+			ImGui::TableSetupColumn("Path");
+			ImGui::TableSetupColumn("Size");
+			ImGui::TableSetupColumn("Memory");
+			ImGui::TableSetupColumn("Refs");
+			ImGui::TableSetupColumn("");
+			ImGui::TableHeadersRow();
+
+			for (const TextureAssetInfo& info : m_textureInfos)
+			{
+				ImGui::PushID((void*)(uintptr_t)info.ContentHash);
+				ImGui::TableNextRow();
+
+				ImGui::TableNextColumn();
+				const std::string filename = std::filesystem::path(info.Path).filename().string();
+				ImGui::TextUnformatted(filename.c_str());
+				if (ImGui::IsItemHovered())
+				{
+					ImGui::SetTooltip("%s\n%u path(s)", info.Path.c_str(), info.AliasCount);
+				}
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%ux%u", info.Width, info.Height);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f KB", (float)info.DecodedSize / 1024.0f);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%ld", info.RefCount);
+
+				ImGui::TableNextColumn();
+				if (ImGui::SmallButton("Unload"))
+				{
+					AssetManager::UnloadTexture(info.Path);
+				}
+
+				ImGui::PopID();
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Rhombus/Assets/AssetManager.h"
+
+namespace rhombus
+{
+	class AssetManagerPanel
+	{
+	public:
+		AssetManagerPanel() = default;
+
+		void OnImGuiRender(bool& show);
+
+	private:
+		std::vector<TextureAssetInfo> m_textureInfos;
+	};
+}
@@ -4,6 +4,7 @@
 
 #include "Rhombus/Core/Application.h"
 #include "Rhombus/Project/Project.h"
+#include "Rhombus/Assets/TextureLoader.h"
 #include "Rhombus/Math/MAth.h"
 
 #include <imgui/imgui.h>
@@ -55,14 +56,17 @@ namespace rhombus
 
 			if (bIsImageFile)
 			{
-				if (const Ref<Texture2D> foundIcon = GetImageInCache(filepath))
+				Ref<Texture2D> imageIcon = GetImageInCache(filepath);
+				if (!imageIcon)
 				{
-					icon = foundIcon;
+					// Thumbnails decode in the background, the file icon is shown until they are ready
+					imageIcon = TextureLoader::LoadAsync(filepath);
+					m_ImageIconCache.push_back(imageIcon);
 				}
-				else
+
+				if (imageIcon->GetLoadState() == TextureLoadState::Ready)
 				{
-					m_ImageIconCache.push_back(Texture2D::Create(filepath));
-					icon = m_ImageIconCache.back();
+					icon = imageIcon;
 				}
 			}
 
@@ -16,7 +16,6 @@
 #include "Rhombus/ECS/Components/ScriptComponent.h"
 #include "Rhombus/ECS/Components/SpriteRendererComponent.h"
 #include "Rhombus/ECS/Components/TransformComponent.h"
-#include "Rhombus/ECS/Components/TweenComponent.h"
 #include "Rhombus/ECS/Components/TileMapComponent.h"
 #include "Rhombus/Scenes/SceneGraphNode.h"
 #include "Rhombus/Tiles/TileSerializer.h"
@@ -723,6 +722,8 @@ namespace rhombus
 					std::string path = "assets\\tilemaps\\" + component.GetOwnerEntity().GetName() + ".rtm";
 					TileSerializer::SerializeTileMap(path, component.m_tilemap);
 				}
+
+				ImGui::Checkbox("Generate Collision", &component.m_generateCollision);
 			}
 		});
 
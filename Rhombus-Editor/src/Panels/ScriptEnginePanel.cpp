@@ -0,0 +1,79 @@
+#include "ScriptEnginePanel.h"
+
+#include "Rhombus/Scripting/ScriptScheduler.h"
+
+#include <imgui/imgui.h>
+
+namespace rhombus
+{
+	static float ToKilobytes(size_t bytes)
+	{
+		return (float)bytes / 1024.0f;
+	}
+
+	void ScriptEnginePanel::OnImGuiRender(bool& show)
+	{
+		if (!show)
+			return;
+
+		ImGui::Begin("Script Engine", &show);
+
+		const ScriptMemoryStats& memoryStats = ScriptEngine::GetMemoryStats();
+		ImGui::Text("Memory: %.1f KB", ToKilobytes(memoryStats.LiveBytes));
+		ImGui::Text("Peak Memory: %.1f KB", ToKilobytes(memoryStats.PeakBytes));
+		ImGui::Text("Allocations: %u (%.1f KB) last frame", memoryStats.FrameAllocations, ToKilobytes(memoryStats.FrameAllocatedBytes));
+
+		int budgetMegabytes = (int)(ScriptEngine::GetMemoryBudget() / (1024 * 1024));
+		if (ImGui::DragInt("Budget (MB)", &budgetMegabytes, 1.0f, 1, 4096))
+		{
+			ScriptEngine::SetMemoryBudget((size_t)budgetMegabytes * 1024 * 1024);
+		}
+
+		ImGui::Separator();
+
+		const ScriptGarbageCollectionStats& gcStats = ScriptEngine::GetGarbageCollectionStats();
+		ImGui::Text("GC Time: %.3f ms (%u steps) last frame", gcStats.TimeMs, gcStats.Steps);
+		ImGui::Text("GC Cycles: %u", gcStats.Cycles);
+		ImGui::Text("Full Collections: %u", gcStats.FullCollections);
+
+		ImGui::Separator();
+
+		const ScriptSchedulerStats& schedulerStats = ScriptScheduler::GetStats();
+		ImGui::Text("Coroutines: %u (%u resumed last frame)", schedulerStats.Coroutines, schedulerStats.Resumed);
+		ImGui::Text("Waiting: %u for time, %u for frames, %u for tweens", schedulerStats.WaitingForTime, schedulerStats.WaitingForFrames, schedulerStats.WaitingForTweens);
+
+		ImGui::Separator();
+
+		ScriptEngine::GetScriptMemoryStats(m_scriptMemoryStats);
+
+		if (ImGui::BeginTable("Scripts", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY))
+		{
+			ImGui::TableSetupColumn("Script");
+			ImGui::TableSetupColumn("Memory");
+			ImGui::TableSetupColumn("Peak");
+			ImGui::TableSetupColumn("Allocations");
+			ImGui::TableHeadersRow();
+
+			for (const ScriptMemoryStats& stats : m_scriptMemoryStats)
+			{
+				ImGui::TableNextRow();
+
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(stats.Name.c_str());
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f KB", ToKilobytes(stats.LiveBytes));
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.1f KB", ToKilobytes(stats.PeakBytes));
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", stats.FrameAllocations);
+			}
+
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+}
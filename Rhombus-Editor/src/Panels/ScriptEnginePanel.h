@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Rhombus/Scripting/ScriptEngine.h"
+
+namespace rhombus
+{
+	class ScriptEnginePanel
+	{
+	public:
+		ScriptEnginePanel() = default;
+
+		void OnImGuiRender(bool& show);
+
+	private:
+		std::vector<ScriptMemoryStats> m_scriptMemoryStats;
+	};
+}
@@ -0,0 +1,205 @@
+#include "ScriptProfilerPanel.h"
+
+#include <imgui/imgui.h>
+
+namespace rhombus
+{
+	// Only the most expensive rows are listed
+	static constexpr size_t MAX_ROWS = 100;
+
+	static const char* s_profilerModeNames[] = { "Off", "Instrumentation", "Sampling" };
+
+	static const ImGuiTableFlags s_tableFlags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+
+	void ScriptProfilerPanel::OnImGuiRender(bool& show)
+	{
+		if (!show)
+			return;
+
+		ImGui::Begin("Script Profiler", &show);
+
+		int mode = (int)ScriptProfiler::GetMode();
+		if (ImGui::Combo("Mode", &mode, s_profilerModeNames, IM_ARRAYSIZE(s_profilerModeNames)))
+		{
+			ScriptProfiler::SetMode((ScriptProfilerMode)mode);
+		}
+
+		if (ScriptProfiler::GetMode() == ScriptProfilerMode::Sampling)
+		{
+			int sampleInterval = ScriptProfiler::GetSampleInterval();
+			if (ImGui::DragInt("Sample Interval (instructions)", &sampleInterval, 10.0f, 1, 1000000))
+			{
+				ScriptProfiler::SetSampleInterval(sampleInterval);
+			}
+		}
+
+		if (ImGui::Button("Reset"))
+		{
+			ScriptProfiler::Reset();
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Export Trace"))
+		{
+			ScriptProfiler::ExportChromeTrace("ScriptProfile.json");
+		}
+		ImGui::SameLine();
+		ImGui::Text("%u calls recorded", ScriptProfiler::GetTraceEventCount());
+
+		if (ImGui::BeginTabBar("ScriptProfilerTabs"))
+		{
+			if (ImGui::BeginTabItem("Callbacks"))
+			{
+				DrawCallbacks();
+				ImGui::EndTabItem();
+			}
+
+			if (ImGui::BeginTabItem("Functions"))
+			{
+				DrawFunctions();
+				ImGui::EndTabItem();
+			}
+
+			if (ImGui::BeginTabItem("Lines"))
+			{
+				DrawLines();
+				ImGui::EndTabItem();
+			}
+
+			ImGui::EndTabBar();
+		}
+
+		ImGui::End();
+	}
+
+	void ScriptProfilerPanel::DrawCallbacks()
+	{
+		m_callbackProfiles.clear();
+		for (const ScriptCallbackProfile& profile : ScriptProfiler::GetCallbackProfiles())
+		{
+			if (profile.Calls > 0)
+			{
+				m_callbackProfiles.push_back(profile);
+			}
+		}
+		std::sort(m_callbackProfiles.begin(), m_callbackProfiles.end(), [](const ScriptCallbackProfile& a, const ScriptCallbackProfile& b) { return a.TotalMs > b.TotalMs; });
+
+		if (ImGui::BeginTable("Callbacks", 6, s_tableFlags))
+		{
+			ImGui::TableSetupColumn("Script");
+			ImGui::TableSetupColumn("Callback");
+			ImGui::TableSetupColumn("Calls");
+			ImGui::TableSetupColumn("Total (ms)");
+			ImGui::TableSetupColumn("Average (us)");
+			ImGui::TableSetupColumn("Max (ms)");
+			ImGui::TableHeadersRow();
+
+			for (size_t i = 0; i < std::min(m_callbackProfiles.size(), MAX_ROWS); i++)
+			{
+				const ScriptCallbackProfile& profile = m_callbackProfiles[i];
+				ImGui::TableNextRow();
+
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(profile.ScriptName.c_str());
+
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(profile.CallbackName.c_str());
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", profile.Calls);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", profile.TotalMs);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.2f", profile.TotalMs * 1000.0 / profile.Calls);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", profile.MaxMs);
+			}
+
+			ImGui::EndTable();
+		}
+	}
+
+	void ScriptProfilerPanel::DrawFunctions()
+	{
+		if (ScriptProfiler::GetMode() != ScriptProfilerMode::Sampling && ScriptProfiler::GetFunctionProfiles().empty())
+		{
+			ImGui::TextUnformatted("Functions are only profiled in sampling mode");
+			return;
+		}
+
+		m_functionProfiles = ScriptProfiler::GetFunctionProfiles();
+		std::sort(m_functionProfiles.begin(), m_functionProfiles.end(), [](const ScriptFunctionProfile& a, const ScriptFunctionProfile& b) { return a.SelfMs > b.SelfMs; });
+
+		if (ImGui::BeginTable("Functions", 5, s_tableFlags))
+		{
+			ImGui::TableSetupColumn("Function");
+			ImGui::TableSetupColumn("Source");
+			ImGui::TableSetupColumn("Samples");
+			ImGui::TableSetupColumn("Self (ms)");
+			ImGui::TableSetupColumn("Total (ms)");
+			ImGui::TableHeadersRow();
+
+			for (size_t i = 0; i < std::min(m_functionProfiles.size(), MAX_ROWS); i++)
+			{
+				const ScriptFunctionProfile& profile = m_functionProfiles[i];
+				ImGui::TableNextRow();
+
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(profile.Name.empty() ? "?" : profile.Name.c_str());
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%s:%d", profile.Source.c_str(), profile.Line);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", profile.Samples);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", profile.SelfMs);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", profile.TotalMs);
+			}
+
+			ImGui::EndTable();
+		}
+	}
+
+	void ScriptProfilerPanel::DrawLines()
+	{
+		if (ScriptProfiler::GetMode() != ScriptProfilerMode::Sampling && ScriptProfiler::GetLineProfiles().empty())
+		{
+			ImGui::TextUnformatted("Lines are only profiled in sampling mode");
+			return;
+		}
+
+		m_lineProfiles = ScriptProfiler::GetLineProfiles();
+		std::sort(m_lineProfiles.begin(), m_lineProfiles.end(), [](const ScriptLineProfile& a, const ScriptLineProfile& b) { return a.SelfMs > b.SelfMs; });
+
+		if (ImGui::BeginTable("Lines", 3, s_tableFlags))
+		{
+			ImGui::TableSetupColumn("Line");
+			ImGui::TableSetupColumn("Samples");
+			ImGui::TableSetupColumn("Self (ms)");
+			ImGui::TableHeadersRow();
+
+			for (size_t i = 0; i < std::min(m_lineProfiles.size(), MAX_ROWS); i++)
+			{
+				const ScriptLineProfile& profile = m_lineProfiles[i];
+				ImGui::TableNextRow();
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%s:%d", profile.Source.c_str(), profile.Line);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%u", profile.Samples);
+
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", profile.SelfMs);
+			}
+
+			ImGui::EndTable();
+		}
+	}
+}
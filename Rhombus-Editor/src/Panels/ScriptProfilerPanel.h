@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Rhombus/Scripting/ScriptProfiler.h"
+
+namespace rhombus
+{
+	class ScriptProfilerPanel
+	{
+	public:
+		ScriptProfilerPanel() = default;
+
+		void OnImGuiRender(bool& show);
+
+	private:
+		void DrawCallbacks();
+		void DrawFunctions();
+		void DrawLines();
+
+	private:
+		std::vector<ScriptCallbackProfile> m_callbackProfiles;
+		std::vector<ScriptFunctionProfile> m_functionProfiles;
+		std::vector<ScriptLineProfile> m_lineProfiles;
+	};
+}
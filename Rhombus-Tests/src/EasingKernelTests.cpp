@@ -0,0 +1,378 @@
+#include "Rhombus/Animation/EasingKernels.h"
+#include "Test.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		using EaseFunction = float(*)(float, float, float, float);
+
+		struct Curve
+		{
+			const char* m_name;
+			EaseFunction m_function;
+		};
+
+		// In the order of EasingType
+		const Curve CURVES[EASING_TYPE_COUNT] =
+		{
+			{ "LINEAR", easing::Linear },
+			{ "SINE_IN", easing::SineIn }, { "SINE_OUT", easing::SineOut }, { "SINE_IN_OUT", easing::SineInOut },
+			{ "QUAD_IN", easing::QuadIn }, { "QUAD_OUT", easing::QuadOut }, { "QUAD_IN_OUT", easing::QuadInOut },
+			{ "CUBIC_IN", easing::CubicIn }, { "CUBIC_OUT", easing::CubicOut }, { "CUBIC_IN_OUT", easing::CubicInOut },
+			{ "QUART_IN", easing::QuartIn }, { "QUART_OUT", easing::QuartOut }, { "QUART_IN_OUT", easing::QuartInOut },
+			{ "QUINT_IN", easing::QuintIn }, { "QUINT_OUT", easing::QuintOut }, { "QUINT_IN_OUT", easing::QuintInOut },
+			{ "EXPO_IN", easing::ExpoIn }, { "EXPO_OUT", easing::ExpoOut }, { "EXPO_IN_OUT", easing::ExpoInOut },
+			{ "CIRC_IN", easing::CircIn }, { "CIRC_OUT", easing::CircOut }, { "CIRC_IN_OUT", easing::CircInOut },
+			{ "BACK_IN", easing::BackIn }, { "BACK_OUT", easing::BackOut }, { "BACK_IN_OUT", easing::BackInOut },
+			{ "ELASTIC_IN", easing::ElasticIn }, { "ELASTIC_OUT", easing::ElasticOut }, { "ELASTIC_IN_OUT", easing::ElasticInOut },
+			{ "BOUNCE_IN", easing::BounceIn }, { "BOUNCE_OUT", easing::BounceOut }, { "BOUNCE_IN_OUT", easing::BounceInOut }
+		};
+
+		// The shape of each curve on normalised time x, in double so the float paths are measured against the curve rather
+		// than against each other. Uses the engine's PI, which is what the curves are defined with
+		double EaseIn(EasingType easingType, double x)
+		{
+			const double pi = (double)math::PI;
+			switch (easingType)
+			{
+			case EasingType::SINE_IN: return 1.0 - std::cos(x * pi / 2.0);
+			case EasingType::QUAD_IN: return x * x;
+			case EasingType::CUBIC_IN: return x * x * x;
+			case EasingType::QUART_IN: return x * x * x * x;
+			case EasingType::QUINT_IN: return x * x * x * x * x;
+			case EasingType::EXPO_IN: return std::exp2(10.0 * (x - 1.0));
+			case EasingType::CIRC_IN: return 1.0 - std::sqrt(1.0 - x * x);
+			default: return x;
+			}
+		}
+
+		double BounceOut(double x)
+		{
+			if (x < 1.0 / 2.75)
+			{
+				return 7.5625 * x * x;
+			}
+			if (x < 2.0 / 2.75)
+			{
+				x -= 1.5 / 2.75;
+				return 7.5625 * x * x + 0.75;
+			}
+			if (x < 2.5 / 2.75)
+			{
+				x -= 2.25 / 2.75;
+				return 7.5625 * x * x + 0.9375;
+			}
+			x -= 2.625 / 2.75;
+			return 7.5625 * x * x + 0.984375;
+		}
+
+		double Back(double x, double s)
+		{
+			return x * x * ((s + 1.0) * x - s);
+		}
+
+		// A wave of period p dying away either side of w = 0
+		double ElasticWave(double w, double p)
+		{
+			return std::exp2(-10.0 * std::abs(w)) * std::sin((w - p / 4.0) * (2.0 * (double)math::PI) / p);
+		}
+
+		double GetReferenceShape(EasingType easingType, double x)
+		{
+			const double back = 1.70158;
+			const double backInOut = 1.70158 * 1.525;
+			switch (easingType)
+			{
+			case EasingType::SINE_OUT:
+				return std::sin(x * (double)math::PI / 2.0);
+			case EasingType::SINE_IN_OUT:
+				return 0.5 * (1.0 - std::cos(x * (double)math::PI));
+			case EasingType::LINEAR:
+			case EasingType::SINE_IN: case EasingType::QUAD_IN: case EasingType::CUBIC_IN: case EasingType::QUART_IN:
+			case EasingType::QUINT_IN: case EasingType::EXPO_IN: case EasingType::CIRC_IN:
+				return EaseIn(easingType, x);
+			case EasingType::QUAD_OUT: case EasingType::CUBIC_OUT: case EasingType::QUART_OUT:
+			case EasingType::QUINT_OUT: case EasingType::EXPO_OUT: case EasingType::CIRC_OUT:
+				return 1.0 - EaseIn((EasingType)((int)easingType - 1), 1.0 - x);
+			case EasingType::QUAD_IN_OUT: case EasingType::CUBIC_IN_OUT: case EasingType::QUART_IN_OUT:
+			case EasingType::QUINT_IN_OUT: case EasingType::EXPO_IN_OUT: case EasingType::CIRC_IN_OUT:
+			{
+				const EasingType in = (EasingType)((int)easingType - 2);
+				return x < 0.5 ? 0.5 * EaseIn(in, 2.0 * x) : 1.0 - 0.5 * EaseIn(in, 2.0 - 2.0 * x);
+			}
+			case EasingType::BACK_IN:
+				return Back(x, back);
+			case EasingType::BACK_OUT:
+				return 1.0 - Back(1.0 - x, back);
+			case EasingType::BACK_IN_OUT:
+				return x < 0.5 ? 0.5 * Back(2.0 * x, backInOut) : 1.0 - 0.5 * Back(2.0 - 2.0 * x, backInOut);
+			case EasingType::ELASTIC_IN:
+				return x == 0.0 || x == 1.0 ? x : -ElasticWave(x - 1.0, 0.3);
+			case EasingType::ELASTIC_OUT:
+				return x == 0.0 || x == 1.0 ? x : 1.0 + ElasticWave(x, 0.3);
+			case EasingType::ELASTIC_IN_OUT:
+				if (x == 0.0 || x == 1.0)
+				{
+					return x;
+				}
+				return x < 0.5 ? -0.5 * ElasticWave(2.0 * x - 1.0, 0.45) : 1.0 + 0.5 * ElasticWave(2.0 * x - 1.0, 0.45);
+			case EasingType::BOUNCE_IN:
+				return 1.0 - BounceOut(1.0 - x);
+			case EasingType::BOUNCE_OUT:
+				return BounceOut(x);
+			case EasingType::BOUNCE_IN_OUT:
+				return x < 0.5 ? 0.5 - 0.5 * BounceOut(1.0 - 2.0 * x) : 0.5 + 0.5 * BounceOut(2.0 * x - 1.0);
+			}
+			return x;
+		}
+
+		// Steps across [0, 1], both ends included
+		const uint32_t TIME_STEPS = 4096;
+		const uint32_t BENCHMARK_COUNT = 1 << 16;
+		const uint32_t BENCHMARK_REPEATS = 50;
+
+		// Float evaluation of a curve, of the normalised time and of b + c * f, in ulps of |b| + |c|. The scalar functions
+		// themselves reach 10 on the steep ends of CIRC_IN and ELASTIC_IN
+		const double MAX_ROUNDING_ULPS = 16.0;
+
+		enum class Path { Scalar, Batch, Table, Function };
+
+		const char* GetPathName(Path path)
+		{
+			switch (path)
+			{
+			case Path::Scalar: return "scalar";
+			case Path::Batch: return "batch";
+			case Path::Table: return "table";
+			default: return "function";
+			}
+		}
+
+		struct AccuracyError
+		{
+			double m_ulps = 0.0;			// Of |b| + |c|
+			double m_relative = 0.0;		// To |c|
+
+			void Add(const AccuracyError& other)
+			{
+				m_ulps = std::max(m_ulps, other.m_ulps);
+				m_relative = std::max(m_relative, other.m_relative);
+			}
+		};
+
+		struct Values
+		{
+			std::vector<float> m_t, m_b, m_c, m_d;
+
+			void Add(float t, float b, float c, float d)
+			{
+				m_t.push_back(t);
+				m_b.push_back(b);
+				m_c.push_back(c);
+				m_d.push_back(d);
+			}
+
+			uint32_t Size() const { return (uint32_t)m_t.size(); }
+		};
+
+		// Every curve over the whole of [0, 1] with a few begins, changes and durations, plus times either side of it
+		// that the kernels clamp. Exactly 0 and exactly d are among them
+		Values CreateAccuracyValues()
+		{
+			const float ranges[][3] = { { 0.0f, 1.0f, 1.0f }, { -3.0f, 250.0f, 0.37f }, { 10.0f, -40.0f, 2.5f }, { 1000.0f, 0.5f, 60.0f } };
+
+			Values values;
+			for (const auto& range : ranges)
+			{
+				const float b = range[0];
+				const float c = range[1];
+				const float d = range[2];
+				for (uint32_t i = 0; i <= TIME_STEPS; i++)
+				{
+					values.Add(d * ((float)i / (float)TIME_STEPS), b, c, d);
+				}
+				values.Add(-d, b, c, d);
+				values.Add(2.0f * d, b, c, d);
+			}
+			return values;
+		}
+
+		void Evaluate(Path path, EasingType easingType, const Values& values, float* out, uint32_t count)
+		{
+			switch (path)
+			{
+			case Path::Scalar:
+				easing::EvaluateBatchScalar(easingType, values.m_t.data(), values.m_b.data(), values.m_c.data(), values.m_d.data(), out, count);
+				break;
+			case Path::Batch:
+				easing::EvaluateBatch(easingType, values.m_t.data(), values.m_b.data(), values.m_c.data(), values.m_d.data(), out, count);
+				break;
+			case Path::Table:
+				easing::EvaluateBatch(easingType, values.m_t.data(), values.m_b.data(), values.m_c.data(), values.m_d.data(), out, count, true);
+				break;
+			case Path::Function:
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const float t = std::min(std::max(values.m_t[i], 0.0f), values.m_d[i]);
+					out[i] = CURVES[(int)easingType].m_function(t, values.m_b[i], values.m_c[i], values.m_d[i]);
+				}
+				break;
+			}
+		}
+
+		// Largest error of the path against the curve worked out in double, as it is with nothing taken off. Checked
+		// against maxError * |c| for the approximations of the path plus MAX_ROUNDING_ULPS
+		AccuracyError CheckAccuracy(Path path, int easingType, const Values& values, float maxError)
+		{
+			std::vector<float> out(values.Size());
+			Evaluate(path, (EasingType)easingType, values, out.data(), values.Size());
+
+			AccuracyError worstError;
+			for (uint32_t i = 0; i < values.Size(); i++)
+			{
+				const float b = values.m_b[i];
+				const float c = values.m_c[i];
+				const float d = values.m_d[i];
+				const float t = std::min(std::max(values.m_t[i], 0.0f), d);
+				const double expected = (double)b + (double)c * GetReferenceShape((EasingType)easingType, (double)t / (double)d);
+
+				const float scale = std::abs(b) + std::abs(c);
+				const double ulp = (double)(std::nextafter(scale, FLT_MAX) - scale);
+				const double error = std::abs((double)out[i] - expected);
+				worstError.Add({ error / ulp, error / std::abs((double)c) });
+
+				RB_TEST_CHECK(error <= (double)maxError * std::abs((double)c) + MAX_ROUNDING_ULPS * ulp, "%s, %s path, t %g of %g, b %g, c %g: got %.9g, expected %.9g",
+					CURVES[easingType].m_name, GetPathName(path), values.m_t[i], d, b, c, out[i], expected);
+			}
+			return worstError;
+		}
+
+		// Counts that leave a partial register, written over the times they were read from
+		void CheckTailsInPlace()
+		{
+			const float b[9] = { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f };
+			const float c[9] = { 1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f, 7.0f, -8.0f, 9.0f };
+			const float d[9] = { 1.0f, 0.5f, 2.0f, 1.5f, 1.0f, 3.0f, 0.25f, 1.0f, 2.0f };
+			for (uint32_t count = 0; count <= 9; count++)
+			{
+				float t[10];
+				for (uint32_t i = 0; i < 10; i++)
+				{
+					t[i] = 0.3f * (float)i;
+				}
+
+				easing::EvaluateBatch(EasingType::QUAD_IN_OUT, t, b, c, d, t, count);
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const double expected = (double)b[i] + (double)c[i] * GetReferenceShape(EasingType::QUAD_IN_OUT, (double)std::min(0.3f * (float)i, d[i]) / (double)d[i]);
+					const float scale = std::abs(b[i]) + std::abs(c[i]);
+					const double maxError = (double)easing::EASING_KERNEL_MAX_ERROR * std::abs(c[i]) + MAX_ROUNDING_ULPS * (double)(std::nextafter(scale, FLT_MAX) - scale);
+					RB_TEST_CHECK(std::abs((double)t[i] - expected) <= maxError, "count %u, value %u: got %g, expected %g", count, i, t[i], expected);
+				}
+				RB_TEST_CHECK(t[count] == 0.3f * (float)count, "count %u wrote past the end", count);
+			}
+		}
+
+		double MeasureNanoseconds(const std::function<void()>& evaluate)
+		{
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (uint32_t repeat = 0; repeat < BENCHMARK_REPEATS; repeat++)
+			{
+				evaluate();
+			}
+			return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ((double)BENCHMARK_REPEATS * BENCHMARK_COUNT);
+		}
+
+		// The scalar functions a value at a time against the kernels one at a time and four at a time, and the tables
+		void PrintThroughput()
+		{
+			std::mt19937 random(7);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+			Values values;
+			for (uint32_t i = 0; i < BENCHMARK_COUNT; i++)
+			{
+				const float d = 0.1f + 4.0f * unit(random);
+				values.Add(d * unit(random), 10.0f * unit(random) - 5.0f, 200.0f * unit(random) - 100.0f, d);
+			}
+
+			std::vector<float> out(BENCHMARK_COUNT);
+			float checksum = 0.0f;
+
+			printf("Easing ns/value:\n  %-22s %10s %15s %15s %7s\n", "", "functions", "scalar kernels", easing::HasSse2EasingKernels() ? "SSE2 kernels" : "batch kernels", "table");
+			for (int easingType = 0; easingType < EASING_TYPE_COUNT; easingType++)
+			{
+				const EaseFunction function = CURVES[easingType].m_function;
+				const double functionNs = MeasureNanoseconds([&]()
+				{
+					for (uint32_t i = 0; i < BENCHMARK_COUNT; i++)
+					{
+						out[i] = function(values.m_t[i], values.m_b[i], values.m_c[i], values.m_d[i]);
+					}
+					checksum += out[0];
+				});
+
+				double pathNs[3] = {};
+				for (Path path : { Path::Scalar, Path::Batch, Path::Table })
+				{
+					if (path == Path::Table && !easing::HasEasingTable((EasingType)easingType))
+					{
+						continue;
+					}
+
+					pathNs[(int)path] = MeasureNanoseconds([&]()
+					{
+						Evaluate(path, (EasingType)easingType, values, out.data(), BENCHMARK_COUNT);
+						checksum += out[0];
+					});
+				}
+
+				printf("  %-22s %10.2f %15.2f %15.2f", CURVES[easingType].m_name, functionNs, pathNs[(int)Path::Scalar], pathNs[(int)Path::Batch]);
+				if (easing::HasEasingTable((EasingType)easingType))
+				{
+					printf(" %7.2f", pathNs[(int)Path::Table]);
+				}
+				printf("\n");
+			}
+
+			// Keeps the work from being optimised away
+			printf("  (checksum %g)\n", checksum);
+		}
+	}
+
+	void RunEasingKernelTests()
+	{
+		const Values values = CreateAccuracyValues();
+
+		AccuracyError functionError;
+		AccuracyError kernelError;
+		AccuracyError tableError;
+		for (int easingType = 0; easingType < EASING_TYPE_COUNT; easingType++)
+		{
+			functionError.Add(CheckAccuracy(Path::Function, easingType, values, 0.0f));
+			kernelError.Add(CheckAccuracy(Path::Scalar, easingType, values, easing::EASING_KERNEL_MAX_ERROR));
+			kernelError.Add(CheckAccuracy(Path::Batch, easingType, values, easing::EASING_KERNEL_MAX_ERROR));
+
+			if (easing::HasEasingTable((EasingType)easingType))
+			{
+				const bool elastic = easingType <= (int)EasingType::ELASTIC_IN_OUT;
+				const float maxError = elastic ? easing::EASING_TABLE_MAX_ERROR_ELASTIC : easing::EASING_TABLE_MAX_ERROR_BOUNCE;
+				tableError.Add(CheckAccuracy(Path::Table, easingType, values, maxError));
+			}
+		}
+		printf("Easing curves against double, worst error: functions %.3g ulps of |b| + |c|, kernels %.3g ulps, tables %.3g * |c|\n",
+			functionError.m_ulps, kernelError.m_ulps, tableError.m_relative);
+
+		CheckTailsInPlace();
+		PrintThroughput();
+	}
+}
@@ -0,0 +1,170 @@
+#include "Rhombus/Scripting/LuaAllocator.h"
+#include "Test.h"
+
+#include <random>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		const uint32_t CHURN_STEPS = 200000;
+		const uint32_t CHURN_BLOCKS = 4000;
+		const uint32_t REUSE_BLOCKS = 10000;
+
+		struct TestBlock
+		{
+			void* m_memory = nullptr;
+			size_t m_size = 0;
+			uint32_t m_owner = 0;
+			uint8_t m_fill = 0;
+		};
+
+		// Up to a little past the largest size class, so blocks move in and out of the pages
+		size_t GetRandomSize(std::mt19937& random)
+		{
+			return random() % 4 == 0 ? 1 + random() % 1024 : 1 + random() % 256;
+		}
+
+		void Fill(TestBlock& block, uint8_t fill)
+		{
+			block.m_fill = fill;
+			memset(block.m_memory, fill, block.m_size);
+		}
+
+		// The first size bytes still hold what the block was filled with
+		bool IsIntact(const TestBlock& block, size_t size)
+		{
+			const uint8_t* bytes = (const uint8_t*)block.m_memory;
+			for (size_t i = 0; i < size; i++)
+			{
+				if (bytes[i] != block.m_fill)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Pages needed for the blocks of one size, on top of the reserve page
+		uint32_t CountPagesFor(size_t size)
+		{
+			LuaAllocator allocator;
+			std::vector<void*> blocks;
+			for (uint32_t i = 0; i < REUSE_BLOCKS; i++)
+			{
+				blocks.push_back(LuaAllocator::Allocate(&allocator, nullptr, 0, size));
+			}
+			const uint32_t pageCount = allocator.GetPageCount();
+			for (void* block : blocks)
+			{
+				LuaAllocator::Allocate(&allocator, block, size, 0);
+			}
+			return pageCount;
+		}
+	}
+
+	// Allocates, resizes and frees blocks for a few owners the way Lua would, checking no two blocks overlap and the
+	// counts per owner, then checks the pages emptied by one owner are reused by another
+	void RunLuaAllocatorTests()
+	{
+		const int failedBefore = g_failedChecks;
+
+		{
+			LuaAllocator allocator;
+			const uint32_t owners[] = { LuaAllocator::ENGINE_OWNER, allocator.RegisterOwner("First"), allocator.RegisterOwner("Second") };
+			RB_TEST_CHECK(allocator.RegisterOwner("First") == owners[1], "registering an owner again gave it a new index");
+
+			std::mt19937 random(20241019);
+			std::vector<TestBlock> blocks(CHURN_BLOCKS);
+			size_t liveBytes[std::size(owners)] = {};
+			uint32_t damagedBlocks = 0;
+			for (uint32_t step = 0; step < CHURN_STEPS; step++)
+			{
+				TestBlock& block = blocks[random() % blocks.size()];
+				if (!block.m_memory)
+				{
+					block.m_owner = random() % std::size(owners);
+					block.m_size = GetRandomSize(random);
+					allocator.SetOwner(owners[block.m_owner]);
+					block.m_memory = LuaAllocator::Allocate(&allocator, nullptr, 0, block.m_size);
+					Fill(block, (uint8_t)step);
+					liveBytes[block.m_owner] += block.m_size;
+					continue;
+				}
+
+				damagedBlocks += IsIntact(block, block.m_size) ? 0 : 1;
+				if (random() % 3 == 0)
+				{
+					LuaAllocator::Allocate(&allocator, block.m_memory, block.m_size, 0);
+					liveBytes[block.m_owner] -= block.m_size;
+					block.m_memory = nullptr;
+					continue;
+				}
+
+				// Resized while another owner is current, the block stays with the one it was allocated for
+				const size_t newSize = GetRandomSize(random);
+				allocator.SetOwner(owners[random() % std::size(owners)]);
+				block.m_memory = LuaAllocator::Allocate(&allocator, block.m_memory, block.m_size, newSize);
+				damagedBlocks += IsIntact(block, std::min(block.m_size, newSize)) ? 0 : 1;
+				liveBytes[block.m_owner] += newSize;
+				liveBytes[block.m_owner] -= block.m_size;
+				block.m_size = newSize;
+				Fill(block, (uint8_t)step);
+			}
+			RB_TEST_CHECK(damagedBlocks == 0, "%u blocks were overwritten while they were live", damagedBlocks);
+
+			std::vector<ScriptMemoryStats> stats;
+			allocator.GetOwnerStats(stats);
+			for (uint32_t i = 0; i < std::size(owners); i++)
+			{
+				RB_TEST_CHECK(stats[owners[i]].LiveBytes == liveBytes[i], "owner %s has %zu live bytes counted, %zu allocated", stats[owners[i]].Name.c_str(), stats[owners[i]].LiveBytes, liveBytes[i]);
+			}
+
+			for (TestBlock& block : blocks)
+			{
+				if (block.m_memory)
+				{
+					LuaAllocator::Allocate(&allocator, block.m_memory, block.m_size, 0);
+				}
+			}
+			RB_TEST_CHECK(allocator.GetLiveBytes() == 0, "%zu bytes still live once every block was freed", allocator.GetLiveBytes());
+			RB_TEST_CHECK(allocator.GetFreePageCount() == allocator.GetPageCount(), "%u of %u pages were returned once every block was freed", allocator.GetFreePageCount(), allocator.GetPageCount());
+		}
+
+		// One owner's small blocks freed, then another owner's blocks of a different size class. The second needs no
+		// more pages than if it had been alone
+		const uint32_t smallPages = CountPagesFor(32);
+		const uint32_t largerPages = CountPagesFor(96);
+		{
+			LuaAllocator allocator;
+			allocator.SetOwner(allocator.RegisterOwner("First"));
+			std::vector<void*> blocks;
+			for (uint32_t i = 0; i < REUSE_BLOCKS; i++)
+			{
+				blocks.push_back(LuaAllocator::Allocate(&allocator, nullptr, 0, 32));
+			}
+			for (void* block : blocks)
+			{
+				LuaAllocator::Allocate(&allocator, block, 32, 0);
+			}
+
+			blocks.clear();
+			allocator.SetOwner(allocator.RegisterOwner("Second"));
+			for (uint32_t i = 0; i < REUSE_BLOCKS; i++)
+			{
+				blocks.push_back(LuaAllocator::Allocate(&allocator, nullptr, 0, 96));
+			}
+			RB_TEST_CHECK(allocator.GetPageCount() == std::max(smallPages, largerPages), "%u pages for blocks that fit in %u pages alone and %u before them", allocator.GetPageCount(), largerPages, smallPages);
+
+			for (void* block : blocks)
+			{
+				LuaAllocator::Allocate(&allocator, block, 96, 0);
+			}
+		}
+
+		if (g_failedChecks == failedBefore)
+		{
+			printf("Lua allocator: %u allocations, resizes and frees over 3 owners, freed pages reused by other owners\n", CHURN_STEPS);
+		}
+	}
+}
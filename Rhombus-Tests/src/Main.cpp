@@ -0,0 +1,48 @@
+#include "Rhombus/Core/JobSystem.h"
+#include "Rhombus/Core/Log.h"
+#include "Test.h"
+
+#include <cstring>
+
+namespace rhombus::tests
+{
+	int g_failedChecks = 0;
+	bool g_updateGoldens = false;
+}
+
+int main(int argc, char** argv)
+{
+	rhombus::Log::Init();
+	rhombus::JobSystem::Init();
+
+	// Golden images are read relative to the working directory, run from Rhombus-Tests
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--update-goldens") == 0)
+		{
+			rhombus::tests::g_updateGoldens = true;
+		}
+	}
+
+	rhombus::tests::RunSoftwareRendererGoldenTests();
+	rhombus::tests::RunTextureLoaderTests();
+	rhombus::tests::RunPixelPlatformerPhysicsTests();
+	rhombus::tests::RunPixelPlatformerSweepTests();
+	rhombus::tests::RunPhysicsSyncTests();
+	rhombus::tests::RunSceneQueryTests();
+	rhombus::tests::RunScriptBindingTests();
+	rhombus::tests::RunLuaAllocatorTests();
+	rhombus::tests::RunTweenEngineTests();
+	rhombus::tests::RunEasingKernelTests();
+
+	rhombus::JobSystem::Shutdown();
+
+	if (rhombus::tests::g_failedChecks > 0)
+	{
+		printf("%d checks failed\n", rhombus::tests::g_failedChecks);
+		return 1;
+	}
+
+	printf("All checks passed\n");
+	return 0;
+}
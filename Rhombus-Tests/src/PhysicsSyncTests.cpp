@@ -0,0 +1,138 @@
+#include "Rhombus/Physics/PhysicsThread.h"
+#include "Test.h"
+
+#include <box2d/b2_body.h>
+#include <box2d/b2_fixture.h>
+#include <box2d/b2_polygon_shape.h>
+#include <box2d/b2_world.h>
+
+#include <chrono>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		// Straight to Box2D, a scene only holds MAX_ENTITIES
+		const uint32_t PILE_COLUMNS = 100;
+		const uint32_t PILE_ROWS = 100;
+		const uint32_t SETTLE_STEPS = 240;
+		const uint32_t GATHER_REPEATS = 100;
+		const float STEP_TIME = 1.0f / 60.0f;
+
+		b2World* CreatePile()
+		{
+			b2World* world = new b2World({ 0.0f, -9.8f });
+
+			b2BodyDef groundDef;
+			groundDef.position.Set(0.0f, -1.0f);
+			b2Body* ground = world->CreateBody(&groundDef);
+			b2PolygonShape groundShape;
+			groundShape.SetAsBox((float)PILE_COLUMNS, 1.0f);
+			ground->CreateFixture(&groundShape, 0.0f);
+
+			b2PolygonShape boxShape;
+			boxShape.SetAsBox(0.25f, 0.25f);
+			b2FixtureDef fixtureDef;
+			fixtureDef.shape = &boxShape;
+			fixtureDef.density = 1.0f;
+			fixtureDef.friction = 0.5f;
+
+			for (uint32_t row = 0; row < PILE_ROWS; row++)
+			{
+				for (uint32_t column = 0; column < PILE_COLUMNS; column++)
+				{
+					b2BodyDef bodyDef;
+					bodyDef.type = b2_dynamicBody;
+					bodyDef.position.Set(((float)column - 0.5f * (float)PILE_COLUMNS) * 0.6f, 0.25f + (float)row * 0.55f);
+					bodyDef.userData.pointer = GetBodyUserData(row * PILE_COLUMNS + column, row);
+					world->CreateBody(&bodyDef)->CreateFixture(&fixtureDef);
+				}
+			}
+
+			return world;
+		}
+
+		// What the sync used to visit, every body whether it could have moved or not
+		void GatherEveryBody(b2World* world, std::vector<PhysicsBodyTransform>& outTransforms)
+		{
+			outTransforms.clear();
+			for (b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+			{
+				const b2Vec2& position = body->GetPosition();
+				const uintptr_t userData = body->GetUserData().pointer;
+				outTransforms.push_back({ GetBodyEntity(userData), GetBodyGeneration(userData), Vec2(position.x, position.y), body->GetAngle() });
+			}
+		}
+
+		double GetGatherMicroseconds(b2World* world, void (*gather)(b2World*, std::vector<PhysicsBodyTransform>&), std::vector<PhysicsBodyTransform>& transforms)
+		{
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < GATHER_REPEATS; i++)
+			{
+				gather(world, transforms);
+			}
+			return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / GATHER_REPEATS;
+		}
+
+		// Every awake moving body exactly once, with the entity, generation and transform it was given
+		void CheckGathered(b2World* world, const std::vector<PhysicsBodyTransform>& transforms, uint32_t step)
+		{
+			uint32_t expected = 0;
+			uint32_t found = 0;
+			size_t next = 0;
+			for (b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+			{
+				if (body->GetType() == b2_staticBody || !body->IsAwake())
+				{
+					continue;
+				}
+
+				expected++;
+				if (next < transforms.size())
+				{
+					const PhysicsBodyTransform& transform = transforms[next++];
+					const uintptr_t userData = body->GetUserData().pointer;
+					const b2Vec2& position = body->GetPosition();
+					found += transform.m_entity == GetBodyEntity(userData) && transform.m_generation == GetBodyGeneration(userData)
+						&& transform.m_position.x == position.x && transform.m_position.y == position.y && transform.m_angle == body->GetAngle() ? 1 : 0;
+				}
+			}
+			RB_TEST_CHECK(transforms.size() == expected && found == expected, "step %u: gathered %zu transforms, %u of them right, for %u awake bodies", step, transforms.size(), found, expected);
+		}
+	}
+
+	// Settles a 10k box pile and checks the sync only gathers the awake ones, timing it against visiting every body
+	// as the pile goes to sleep
+	void RunPhysicsSyncTests()
+	{
+		const int failedBefore = g_failedChecks;
+
+		b2World* world = CreatePile();
+		std::vector<PhysicsBodyTransform> transforms;
+
+		printf("Physics sync, %u body pile:\n  %6s %8s %16s %16s\n", PILE_COLUMNS * PILE_ROWS, "step", "awake", "awake only us", "every body us");
+		for (uint32_t step = 1; step <= SETTLE_STEPS; step++)
+		{
+			world->Step(STEP_TIME, 6, 2);
+			if (step % 60 != 0)
+			{
+				continue;
+			}
+
+			PhysicsThread::GatherTransforms(world, transforms);
+			CheckGathered(world, transforms, step);
+
+			const double awakeMicroseconds = GetGatherMicroseconds(world, &PhysicsThread::GatherTransforms, transforms);
+			const size_t awakeCount = transforms.size();
+			const double everyMicroseconds = GetGatherMicroseconds(world, &GatherEveryBody, transforms);
+			printf("  %6u %8zu %16.1f %16.1f\n", step, awakeCount, awakeMicroseconds, everyMicroseconds);
+		}
+
+		delete world;
+
+		if (g_failedChecks == failedBefore)
+		{
+			printf("Physics sync: only awake moving bodies were gathered\n");
+		}
+	}
+}
@@ -0,0 +1,164 @@
+#include "Rhombus/ECS/ECSTypes.h"
+#include "Rhombus/ECS/Components/Collider2DComponent.h"
+#include "Rhombus/ECS/Components/PixelPlatformerBodyComponent.h"
+#include "Rhombus/ECS/Components/TransformComponent.h"
+#include "Rhombus/ECS/Systems/PixelPlatformerPhysicsSystem.h"
+#include "Rhombus/Scenes/Scene.h"
+#include "Test.h"
+
+#include <chrono>
+#include <random>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		// As many statics as fit in a scene of MAX_ENTITIES next to the dynamic bodies
+		const uint32_t STATIC_COLUMNS = 96;
+		const uint32_t STATIC_ROWS = 49;
+		const float ROW_SPACING = 48.0f;
+		const uint32_t DYNAMIC_COUNT = 200;
+		const uint32_t BENCHMARK_TICKS = 120;
+		const float TICK_TIME = 1.0f / 60.0f;
+
+		Entity CreateBody(Scene& scene, PixelPlatformerBodyComponent::BodyType type, const Vec2& position, const Vec2& halfSize)
+		{
+			Entity entity = scene.CreateEntity();
+			entity.GetComponent<TransformComponent>().SetPosition(position);
+			entity.AddComponent<PixelPlatformerBodyComponent>().m_type = type;
+			entity.AddComponent<BoxCollider2DComponent>().m_size = halfSize;
+			return entity;
+		}
+
+		double GetMilliseconds(const std::chrono::steady_clock::time_point& start)
+		{
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// What every tick cost before statics were tracked, a lookup and a world position for each of them
+		double TimeStaticLookups(const std::vector<Entity>& statics, float& outChecksum)
+		{
+			float checksum = 0.0f;
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (uint32_t tick = 0; tick < BENCHMARK_TICKS; tick++)
+			{
+				for (Entity entity : statics)
+				{
+					if (entity.GetComponent<PixelPlatformerBodyComponent>().m_type != PixelPlatformerBodyComponent::BodyType::Static || !entity.HasComponent<BoxCollider2DComponent>())
+					{
+						continue;
+					}
+					checksum += entity.GetComponent<TransformComponent>().GetWorldPosition().x + entity.GetComponent<BoxCollider2DComponent>().m_offset.x;
+				}
+			}
+			outChecksum = checksum;
+			return GetMilliseconds(start) / BENCHMARK_TICKS;
+		}
+
+		void Simulate(PixelPlatformerPhysicsSystem& system, uint32_t ticks)
+		{
+			for (uint32_t tick = 0; tick < ticks; tick++)
+			{
+				system.Update(TICK_TIME);
+			}
+		}
+
+		// Above the platform rather than grounded, a body at rest only moves, and so touches the ground, every few ticks
+		bool IsResting(Entity entity, const Vec2& platform)
+		{
+			return entity.GetComponent<TransformComponent>().GetPosition().y > platform.y;
+		}
+
+		void Drop(Entity entity, const Vec2& position)
+		{
+			entity.GetComponent<TransformComponent>().SetPosition(position);
+			entity.GetComponent<PixelPlatformerBodyComponent>().m_velocity = Vec2(0.0f);
+		}
+	}
+
+	// Dynamic bodies falling through a field of static ones, timing a tick against looking every static up each tick,
+	// and checking statics that move or are added after the grid was built are still collided with
+	void RunPixelPlatformerPhysicsTests()
+	{
+		const int failedBefore = g_failedChecks;
+
+		static_assert(STATIC_COLUMNS * STATIC_ROWS + DYNAMIC_COUNT < MAX_ENTITIES, "no room left for the platform");
+
+		Scene scene;
+		PixelPlatformerPhysicsSystem system(&scene);
+
+		std::vector<Entity> statics;
+		for (uint32_t row = 0; row < STATIC_ROWS; row++)
+		{
+			for (uint32_t column = 0; column < STATIC_COLUMNS; column++)
+			{
+				statics.push_back(CreateBody(scene, PixelPlatformerBodyComponent::BodyType::Static, Vec2((float)column * 24.0f, (float)row * ROW_SPACING), Vec2(12.0f, 4.0f)));
+			}
+		}
+
+		std::mt19937 random(20241019);
+		std::uniform_real_distribution<float> x(0.0f, (float)(STATIC_COLUMNS - 1) * 24.0f);
+		std::uniform_real_distribution<float> y(ROW_SPACING, (float)STATIC_ROWS * ROW_SPACING);
+		std::vector<Entity> dynamics;
+		std::vector<float> startHeights;
+		for (uint32_t i = 0; i < DYNAMIC_COUNT; i++)
+		{
+			const Vec2 position = Vec2(math::Round(x(random)), math::Round(y(random)));
+			dynamics.push_back(CreateBody(scene, PixelPlatformerBodyComponent::BodyType::Dynamic, position, Vec2(3.0f, 3.0f)));
+			startHeights.push_back(position.y);
+		}
+
+		// The first tick builds the grid
+		Simulate(system, 1);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		Simulate(system, BENCHMARK_TICKS);
+		const double tickMilliseconds = GetMilliseconds(start) / BENCHMARK_TICKS;
+		float checksum;
+		const double lookupMilliseconds = TimeStaticLookups(statics, checksum);
+
+		// The rows are solid floors, so every body stops on the one below where it started
+		for (uint32_t i = 0; i < DYNAMIC_COUNT; i++)
+		{
+			const float fallen = startHeights[i] - dynamics[i].GetComponent<TransformComponent>().GetPosition().y;
+			RB_TEST_CHECK(fallen <= ROW_SPACING, "dynamic body %u fell %g pixels, through a floor", i, fallen);
+		}
+
+		// A platform away from the field, moved once a body has landed on it. The body dropped again where it was
+		// has to fall through and one dropped where it went has to land
+		const Vec2 oldPlatform = Vec2(-1000.0f, 0.0f);
+		const Vec2 newPlatform = Vec2(-2000.0f, 0.0f);
+		Entity platform = CreateBody(scene, PixelPlatformerBodyComponent::BodyType::Static, oldPlatform, Vec2(16.0f, 4.0f));
+		Entity probe = dynamics[0];
+		Entity otherProbe = dynamics[1];
+		Drop(probe, oldPlatform + Vec2(0.0f, 20.0f));
+		Simulate(system, 60);
+		RB_TEST_CHECK(IsResting(probe, oldPlatform), "a body did not land on a static added after the grid was built");
+
+		platform.GetComponent<TransformComponent>().SetPosition(newPlatform);
+		Drop(probe, oldPlatform + Vec2(0.0f, 20.0f));
+		Drop(otherProbe, newPlatform + Vec2(0.0f, 20.0f));
+		Simulate(system, 60);
+		RB_TEST_CHECK(!IsResting(probe, oldPlatform), "a body landed where a static used to be");
+		RB_TEST_CHECK(IsResting(otherProbe, newPlatform), "a body did not land on a static that moved");
+
+		// Turning a body static or destroying it needs no transform change to be seen
+		scene.DestroyEntity(platform);
+		Drop(otherProbe, newPlatform + Vec2(0.0f, 20.0f));
+		Simulate(system, 60);
+		RB_TEST_CHECK(!IsResting(otherProbe, newPlatform), "a body landed on a destroyed static");
+
+		Entity staticProbe = dynamics[2];
+		Drop(staticProbe, newPlatform);
+		staticProbe.GetComponent<PixelPlatformerBodyComponent>().m_type = PixelPlatformerBodyComponent::BodyType::Static;
+		Drop(otherProbe, newPlatform + Vec2(0.0f, 20.0f));
+		Simulate(system, 60);
+		RB_TEST_CHECK(IsResting(otherProbe, newPlatform), "a body did not land on a body made static");
+
+		if (g_failedChecks == failedBefore)
+		{
+			printf("Pixel platformer physics: %u static and %u dynamic bodies, %.3f ms a tick, looking every static up costs %.3f ms a tick (checksum %g)\n",
+				STATIC_COLUMNS * STATIC_ROWS, DYNAMIC_COUNT, tickMilliseconds, lookupMilliseconds, checksum);
+		}
+	}
+}
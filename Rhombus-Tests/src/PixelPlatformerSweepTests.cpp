@@ -0,0 +1,246 @@
+#include "Rhombus/ECS/Systems/PixelPlatformerPhysicsSystem.h"
+#include "Rhombus/Physics/AABB.h"
+#include "Rhombus/Physics/PrimitiveTests.h"
+#include "Test.h"
+
+#include <random>
+
+namespace rhombus
+{
+	// Moves bodies around random tile maps the way PixelPlatformerPhysicsSystem::Move does, once with Sweep and once with
+	// the pixel at a time stepper Sweep replaced, and checks both end every step in the same place with the same hits
+	class PixelPlatformerSweepTest
+	{
+	public:
+		using BodyShape = PixelPlatformerPhysicsSystem::BodyShape;
+
+		PixelPlatformerSweepTest(const std::vector<AABB>& staticColliders) : m_system(nullptr), m_staticColliders(staticColliders)
+		{
+			m_system.m_staticColliders = staticColliders;
+			m_system.m_staticGrid.Build(m_system.m_staticColliders);
+		}
+
+		int Sweep(const BodyShape& shape, const Vec3& position, const Vec2& appliedTranslation, int axis, int translation, bool& outHit) const
+		{
+			return m_system.Sweep(shape, position, appliedTranslation, axis, translation, outHit);
+		}
+
+		// How Move used to find out how far a body could go, copied from before the grid and Sweep: one Collide per
+		// pixel, each testing the body against every static collider in turn
+		int StepPixels(const BodyShape& shape, const Vec3& position, const Vec2& appliedTranslation, int axis, int translation, bool& outHit) const
+		{
+			outHit = false;
+			const int step = math::Sign(translation);
+			Vec2 applied = appliedTranslation;
+			int moved = 0;
+			while (translation != 0)
+			{
+				Vec2 stepTranslation = Vec2(0.0f);
+				stepTranslation[axis] = (float)step;
+				if (!CollideLinear(shape, position + applied + stepTranslation))
+				{
+					applied[axis] += (float)step;
+					translation -= step;
+					moved++;
+				}
+				else
+				{
+					outHit = true;
+					break;
+				}
+			}
+
+			return moved;
+		}
+
+		// The per entity Collide from before the grid, with the colliders it looked up each time passed in
+		bool CollideLinear(const BodyShape& shape, Vec2 position) const
+		{
+			for (const AABB& otherAABB : m_staticColliders)
+			{
+				// Check the type of collider that the dyanamic body has, and do the appropriate test
+				if (shape.m_type == BodyShape::Type::Box)
+				{
+					AABB myAABB;
+					myAABB.c = Vec3(position.x, position.y, 0.0f) + shape.m_offset;
+					myAABB.r = Vec3(shape.m_halfSize.x, shape.m_halfSize.y, 10.0f);
+
+					if (AABB::TestAABBAABB(myAABB, otherAABB))
+					{
+						return true;
+					}
+				}
+				else if (shape.m_type == BodyShape::Type::Circle)
+				{
+					Sphere mySphere;
+					mySphere.c = Vec3(position.x, position.y, 0.0f) + shape.m_offset;
+					mySphere.r = shape.m_radius;
+
+					if (PrimitiveTests::TestSphereAABB(mySphere, otherAABB))
+					{
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		bool Collide(const BodyShape& shape, const Vec2& position) const
+		{
+			return m_system.Collide(shape, position);
+		}
+
+	private:
+		PixelPlatformerPhysicsSystem m_system;
+		std::vector<AABB> m_staticColliders;
+	};
+}
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		const uint32_t LEVEL_COUNT = 200;
+		const uint32_t BODIES_PER_LEVEL = 40;
+		const uint32_t STEPS_PER_BODY = 240;
+		const float STEP_TIME = 1.0f / 60.0f;
+
+		struct Body
+		{
+			PixelPlatformerSweepTest::BodyShape m_shape;
+			Vec3 m_position = Vec3(0.0f);
+			Vec2 m_velocity = Vec2(0.0f);
+			Vec2 m_remainder = Vec2(0.0f);
+		};
+
+		// Solid border with random tiles inside. Half the maps sit on whole pixels like hand placed ones, the other half
+		// use fractional origins and tile sizes to catch rounding at touching edges
+		std::vector<AABB> CreateTileMap(std::mt19937& random, bool fractional, Vec2& outMin, Vec2& outMax)
+		{
+			const int columns = std::uniform_int_distribution<int>(12, 48)(random);
+			const int rows = std::uniform_int_distribution<int>(10, 32)(random);
+			const float solidChance = std::uniform_real_distribution<float>(0.05f, 0.3f)(random);
+
+			float tileSize = (float)(std::uniform_int_distribution<int>(1, 2)(random) * 8);
+			Vec2 origin = Vec2((float)std::uniform_int_distribution<int>(-200, 200)(random), (float)std::uniform_int_distribution<int>(-200, 200)(random));
+			if (fractional)
+			{
+				tileSize += std::uniform_real_distribution<float>(-0.75f, 0.75f)(random);
+				origin += Vec2(std::uniform_real_distribution<float>(0.0f, 1.0f)(random), std::uniform_real_distribution<float>(0.0f, 1.0f)(random));
+			}
+
+			std::bernoulli_distribution solid(solidChance);
+			std::vector<AABB> colliders;
+			for (int y = 0; y < rows; y++)
+			{
+				for (int x = 0; x < columns; x++)
+				{
+					const bool border = x == 0 || y == 0 || x == columns - 1 || y == rows - 1;
+					if (border || solid(random))
+					{
+						AABB aabb;
+						aabb.c = Vec3(origin.x + ((float)x + 0.5f) * tileSize, origin.y + ((float)y + 0.5f) * tileSize, 0.0f);
+						aabb.r = Vec3(0.5f * tileSize, 0.5f * tileSize, 10.0f);
+						colliders.push_back(aabb);
+					}
+				}
+			}
+
+			outMin = origin + Vec2(tileSize);
+			outMax = origin + Vec2((float)(columns - 1) * tileSize, (float)(rows - 1) * tileSize);
+			return colliders;
+		}
+
+		Body CreateBody(std::mt19937& random, const PixelPlatformerSweepTest& test, const Vec2& min, const Vec2& max)
+		{
+			Body body;
+			if (std::bernoulli_distribution(0.5)(random))
+			{
+				body.m_shape.m_type = PixelPlatformerSweepTest::BodyShape::Type::Box;
+				body.m_shape.m_halfSize = Vec2(std::uniform_real_distribution<float>(1.5f, 9.0f)(random), std::uniform_real_distribution<float>(1.5f, 9.0f)(random));
+			}
+			else
+			{
+				body.m_shape.m_type = PixelPlatformerSweepTest::BodyShape::Type::Circle;
+				body.m_shape.m_radius = std::uniform_real_distribution<float>(1.5f, 9.0f)(random);
+			}
+			body.m_shape.m_offset = Vec3(std::uniform_real_distribution<float>(-2.0f, 2.0f)(random), std::uniform_real_distribution<float>(-2.0f, 2.0f)(random), 0.0f);
+
+			// Start somewhere free when there is room, bodies stuck in a wall are worth covering too though
+			std::uniform_real_distribution<float> x(min.x, max.x);
+			std::uniform_real_distribution<float> y(min.y, max.y);
+			for (int attempt = 0; attempt < 20; attempt++)
+			{
+				body.m_position = Vec3(math::Round(x(random)), math::Round(y(random)), 0.0f);
+				if (!test.Collide(body.m_shape, body.m_position))
+				{
+					break;
+				}
+			}
+
+			return body;
+		}
+	}
+
+	void RunPixelPlatformerSweepTests()
+	{
+		std::mt19937 random(20240917);
+		std::uniform_real_distribution<float> jump(-400.0f, 400.0f);
+		std::bernoulli_distribution kick(0.05);
+
+		uint64_t sweepCount = 0;
+		uint64_t hitCount = 0;
+		for (uint32_t level = 0; level < LEVEL_COUNT; level++)
+		{
+			Vec2 min, max;
+			const PixelPlatformerSweepTest test(CreateTileMap(random, level % 2 == 1, min, max));
+
+			for (uint32_t bodyIndex = 0; bodyIndex < BODIES_PER_LEVEL; bodyIndex++)
+			{
+				Body body = CreateBody(random, test, min, max);
+				for (uint32_t step = 0; step < STEPS_PER_BODY; step++)
+				{
+					// Gravity plus the odd shove, some fast enough to cross several tiles in one step
+					body.m_velocity.y += GRAVITY * STEP_TIME;
+					if (kick(random))
+					{
+						body.m_velocity = Vec2(jump(random), jump(random));
+					}
+
+					body.m_remainder += body.m_velocity * STEP_TIME;
+					const int translation[2] = { math::RoundInt(body.m_remainder.x), math::RoundInt(body.m_remainder.y) };
+
+					Vec2 appliedTranslation = Vec2(0.0f);
+					for (int axis = 0; axis < 2; axis++)
+					{
+						if (translation[axis] == 0)
+						{
+							continue;
+						}
+
+						body.m_remainder[axis] -= (float)translation[axis];
+
+						bool sweepHit, stepHit;
+						const int swept = test.Sweep(body.m_shape, body.m_position, appliedTranslation, axis, translation[axis], sweepHit);
+						const int stepped = test.StepPixels(body.m_shape, body.m_position, appliedTranslation, axis, translation[axis], stepHit);
+						RB_TEST_CHECK(swept == stepped && sweepHit == stepHit, "level %u, body %u, step %u, axis %d: swept %d (hit %d), stepped %d (hit %d)",
+							level, bodyIndex, step, axis, swept, (int)sweepHit, stepped, (int)stepHit);
+
+						appliedTranslation[axis] += (float)(math::Sign(translation[axis]) * stepped);
+						if (stepHit)
+						{
+							body.m_velocity[axis] = 0.0f;
+							hitCount++;
+						}
+						sweepCount++;
+					}
+
+					body.m_position += Vec3(appliedTranslation, 0.0f);
+				}
+			}
+		}
+
+		printf("Pixel platformer sweep: %llu sweeps, %llu hits\n", (unsigned long long)sweepCount, (unsigned long long)hitCount);
+	}
+}
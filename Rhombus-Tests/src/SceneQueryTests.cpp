@@ -0,0 +1,440 @@
+#include "Rhombus/ECS/ECSTypes.h"
+#include "Rhombus/ECS/Components/Area2DComponent.h"
+#include "Rhombus/ECS/Components/Collider2DComponent.h"
+#include "Rhombus/ECS/Components/TransformComponent.h"
+#include "Rhombus/Scenes/Scene.h"
+#include "Rhombus/Scenes/SceneGraphNode.h"
+#include "Test.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		const uint32_t SHAPE_ENTITY_COUNT = 4000;
+		const uint32_t PARENT_COUNT = 50;
+		const uint32_t ROUNDS = 20;
+		const uint32_t QUERIES_PER_ROUND = 100;
+		const uint32_t NEAREST_HITS = 8;
+		const uint32_t BENCHMARK_QUERIES = 2000;
+		const uint32_t BENCHMARK_SYNCS = 100;
+		const float WORLD_SIZE = 2000.0f;
+
+		// Transforms are only ever translated, so every shape is axis aligned and the linear scan stays simple
+		struct ReferenceShape
+		{
+			EntityID m_entity = INVALID_ENTITY;
+			QueryShapeType m_type = QueryShapeType::BoxCollider;
+			Vec2 m_center;
+			Vec2 m_halfSize;			// The radius in x for circles
+		};
+
+		bool IsHitBefore(const QueryHit& a, const QueryHit& b)
+		{
+			return a.m_entity != b.m_entity ? a.m_entity < b.m_entity : a.m_shape < b.m_shape;
+		}
+
+		// The hits in any order against the expected ones, sorted
+		bool HasSameHits(std::vector<QueryHit>& hits, uint32_t count, const std::vector<QueryHit>& expected)
+		{
+			std::sort(hits.begin(), hits.begin() + count, &IsHitBefore);
+			return count == expected.size() && std::equal(expected.begin(), expected.end(), hits.begin(), [](const QueryHit& a, const QueryHit& b)
+			{
+				return a.m_entity == b.m_entity && a.m_shape == b.m_shape;
+			});
+		}
+
+		// Straight from the components, what the query has to agree with
+		void GatherShapes(Scene& scene, std::vector<ReferenceShape>& outShapes)
+		{
+			outShapes.clear();
+			Registry& registry = scene.GetRegistry();
+			for (EntityID e : registry.GetEntityList<BoxCollider2DComponent>())
+			{
+				const BoxCollider2DComponent& collider = registry.GetComponent<BoxCollider2DComponent>(e);
+				const Vec3 position = registry.GetComponent<TransformComponent>(e).GetWorldPosition();
+				outShapes.push_back({ e, QueryShapeType::BoxCollider, Vec2(position.x, position.y) + collider.m_offset, collider.m_size });
+			}
+			for (EntityID e : registry.GetEntityList<CircleCollider2DComponent>())
+			{
+				const CircleCollider2DComponent& collider = registry.GetComponent<CircleCollider2DComponent>(e);
+				const Vec3 position = registry.GetComponent<TransformComponent>(e).GetWorldPosition();
+				outShapes.push_back({ e, QueryShapeType::CircleCollider, Vec2(position.x, position.y) + collider.m_offset, Vec2(collider.m_radius, 0.0f) });
+			}
+			for (EntityID e : registry.GetEntityList<BoxArea2DComponent>())
+			{
+				const BoxArea2DComponent& area = registry.GetComponent<BoxArea2DComponent>(e);
+				const Vec3 position = registry.GetComponent<TransformComponent>(e).GetWorldPosition();
+				outShapes.push_back({ e, QueryShapeType::BoxArea, Vec2(position.x, position.y) + area.m_offset, area.m_size });
+			}
+		}
+
+		bool IsCircle(const ReferenceShape& shape)
+		{
+			return shape.m_type == QueryShapeType::CircleCollider;
+		}
+
+		bool Contains(const ReferenceShape& shape, const Vec2& point)
+		{
+			const Vec2 offset = point - shape.m_center;
+			if (IsCircle(shape))
+			{
+				return offset.GetMag2() < shape.m_halfSize.x * shape.m_halfSize.x;
+			}
+			return std::abs(offset.x) < shape.m_halfSize.x && std::abs(offset.y) < shape.m_halfSize.y;
+		}
+
+		bool Overlaps(const ReferenceShape& shape, const Vec2& min, const Vec2& max)
+		{
+			if (IsCircle(shape))
+			{
+				const Vec2 closest = Vec2(std::clamp(shape.m_center.x, min.x, max.x), std::clamp(shape.m_center.y, min.y, max.y));
+				return (closest - shape.m_center).GetMag2() < shape.m_halfSize.x * shape.m_halfSize.x;
+			}
+			return shape.m_center.x - shape.m_halfSize.x < max.x && shape.m_center.x + shape.m_halfSize.x > min.x &&
+				shape.m_center.y - shape.m_halfSize.y < max.y && shape.m_center.y + shape.m_halfSize.y > min.y;
+		}
+
+		float GetDistance(const ReferenceShape& shape, const Vec2& point)
+		{
+			const Vec2 offset = point - shape.m_center;
+			if (IsCircle(shape))
+			{
+				return std::max(offset.GetMagnitude() - shape.m_halfSize.x, 0.0f);
+			}
+			return Vec2(std::max(std::abs(offset.x) - shape.m_halfSize.x, 0.0f), std::max(std::abs(offset.y) - shape.m_halfSize.y, 0.0f)).GetMagnitude();
+		}
+
+		// Where the segment enters the shape, shapes the segment starts in are not hit
+		bool Raycast(const ReferenceShape& shape, const Vec2& start, const Vec2& end, float& outFraction)
+		{
+			if (Contains(shape, start))
+			{
+				return false;
+			}
+
+			const Vec2 delta = end - start;
+			if (IsCircle(shape))
+			{
+				const Vec2 offset = start - shape.m_center;
+				const float a = delta.GetMag2();
+				const float b = offset.Dot(delta);
+				const float c = offset.GetMag2() - shape.m_halfSize.x * shape.m_halfSize.x;
+				const float discriminant = b * b - a * c;
+				if (discriminant < 0.0f)
+				{
+					return false;
+				}
+				outFraction = (-b - std::sqrt(discriminant)) / a;
+				return outFraction >= 0.0f && outFraction <= 1.0f;
+			}
+
+			float fractionIn = 0.0f;
+			float fractionOut = 1.0f;
+			for (int axis = 0; axis < 2; axis++)
+			{
+				const float low = (shape.m_center[axis] - shape.m_halfSize[axis] - start[axis]) / delta[axis];
+				const float high = (shape.m_center[axis] + shape.m_halfSize[axis] - start[axis]) / delta[axis];
+				fractionIn = std::max(fractionIn, std::min(low, high));
+				fractionOut = std::min(fractionOut, std::max(low, high));
+			}
+			outFraction = fractionIn;
+			return fractionIn <= fractionOut;
+		}
+
+		Vec2 RandomPoint(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> coordinate(0.0f, WORLD_SIZE);
+			return Vec2(coordinate(random), coordinate(random));
+		}
+
+		void AddShape(Entity entity, QueryShapeType type, std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> size(1.0f, 20.0f);
+			std::uniform_real_distribution<float> offset(-5.0f, 5.0f);
+			switch (type)
+			{
+			case QueryShapeType::BoxCollider:
+			{
+				BoxCollider2DComponent& collider = entity.AddComponent<BoxCollider2DComponent>();
+				collider.m_offset = Vec2(offset(random), offset(random));
+				collider.m_size = Vec2(size(random), size(random));
+				break;
+			}
+			case QueryShapeType::CircleCollider:
+			{
+				CircleCollider2DComponent& collider = entity.AddComponent<CircleCollider2DComponent>();
+				collider.m_offset = Vec2(offset(random), offset(random));
+				collider.m_radius = size(random);
+				break;
+			}
+			default:
+			{
+				BoxArea2DComponent& area = entity.AddComponent<BoxArea2DComponent>();
+				area.m_offset = Vec2(offset(random), offset(random));
+				area.m_size = Vec2(size(random), size(random));
+				break;
+			}
+			}
+		}
+
+		// One shape, sometimes an area as well, and every tenth one under a parent that moves
+		Entity CreateShapeEntity(Scene& scene, const std::vector<Entity>& parents, std::mt19937& random)
+		{
+			Entity entity = scene.CreateEntity();
+			AddShape(entity, (QueryShapeType)(random() % (uint32_t)QueryShapeType::BoxArea), random);
+			if (random() % 4 == 0)
+			{
+				AddShape(entity, QueryShapeType::BoxArea, random);
+			}
+
+			Vec2 position = RandomPoint(random);
+			if (random() % 10 == 0)
+			{
+				Entity parent = parents[random() % parents.size()];
+				parent.GetSceneGraphNode()->AddChild(entity.GetSceneGraphNode());
+				const Vec3 parentPosition = parent.GetComponent<TransformComponent>().GetWorldPosition();
+				position = position - Vec2(parentPosition.x, parentPosition.y);
+			}
+			entity.GetComponent<TransformComponent>().SetPosition(position);
+			return entity;
+		}
+
+		// Moves, resizes, destroys, creates and swaps shapes around, as a frame of a game would
+		void Mutate(Scene& scene, std::vector<Entity>& shapeEntities, std::vector<Entity>& parents, std::mt19937& random)
+		{
+			for (uint32_t i = 0; i < SHAPE_ENTITY_COUNT / 20; i++)
+			{
+				shapeEntities[random() % shapeEntities.size()].GetComponent<TransformComponent>().SetPosition(RandomPoint(random));
+			}
+
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				parents[random() % parents.size()].GetComponent<TransformComponent>().SetPosition(RandomPoint(random));
+			}
+
+			for (uint32_t i = 0; i < SHAPE_ENTITY_COUNT / 100; i++)
+			{
+				Entity entity = shapeEntities[random() % shapeEntities.size()];
+				if (entity.HasComponent<BoxCollider2DComponent>())
+				{
+					entity.GetComponent<BoxCollider2DComponent>().m_size = Vec2(25.0f, 2.0f);
+				}
+				else if (entity.HasComponent<CircleCollider2DComponent>())
+				{
+					entity.GetComponent<CircleCollider2DComponent>().m_offset = Vec2(10.0f, -10.0f);
+				}
+			}
+
+			// New entities reuse the IDs just freed, with a shape of a different type
+			for (uint32_t i = 0; i < 20; i++)
+			{
+				const size_t index = random() % shapeEntities.size();
+				scene.DestroyEntity(shapeEntities[index]);
+				shapeEntities[index] = CreateShapeEntity(scene, parents, random);
+			}
+
+			for (uint32_t i = 0; i < 5; i++)
+			{
+				Entity entity = shapeEntities[random() % shapeEntities.size()];
+				if (entity.HasComponent<BoxArea2DComponent>())
+				{
+					entity.RemoveComponent<BoxArea2DComponent>();
+				}
+				else
+				{
+					AddShape(entity, QueryShapeType::BoxArea, random);
+				}
+			}
+
+			scene.InvalidateQuery();
+		}
+
+		void CheckQueries(Scene& scene, const std::vector<ReferenceShape>& shapes, std::vector<QueryHit>& hits, uint32_t round, std::mt19937& random)
+		{
+			SceneQuery& query = scene.Query();
+			RB_TEST_CHECK(query.GetShapeCount() == shapes.size(), "round %u: %u shapes in the query, %zu in the scene", round, query.GetShapeCount(), shapes.size());
+
+			std::vector<QueryHit> expected;
+			std::vector<float> distances;
+			uint32_t wrongPoints = 0;
+			uint32_t wrongBoxes = 0;
+			uint32_t wrongNearest = 0;
+			uint32_t wrongRaycasts = 0;
+			for (uint32_t i = 0; i < QUERIES_PER_ROUND; i++)
+			{
+				const Vec2 point = RandomPoint(random);
+				uint32_t count = query.OverlapPoint(point, hits.data(), (uint32_t)hits.size());
+				expected.clear();
+				for (const ReferenceShape& shape : shapes)
+				{
+					if (Contains(shape, point))
+					{
+						expected.push_back({ shape.m_entity, shape.m_type, 0.0f });
+					}
+				}
+				std::sort(expected.begin(), expected.end(), &IsHitBefore);
+				wrongPoints += HasSameHits(hits, count, expected) ? 0 : 1;
+
+				const Vec2 min = RandomPoint(random);
+				const Vec2 max = min + Vec2(50.0f, 30.0f);
+				count = query.OverlapBox(min, max, hits.data(), (uint32_t)hits.size());
+				expected.clear();
+				for (const ReferenceShape& shape : shapes)
+				{
+					if (Overlaps(shape, min, max))
+					{
+						expected.push_back({ shape.m_entity, shape.m_type, 0.0f });
+					}
+				}
+				std::sort(expected.begin(), expected.end(), &IsHitBefore);
+				wrongBoxes += HasSameHits(hits, count, expected) ? 0 : 1;
+
+				// Distances rather than entities, two shapes can be as near as each other
+				count = query.Nearest(point, hits.data(), NEAREST_HITS);
+				distances.clear();
+				for (const ReferenceShape& shape : shapes)
+				{
+					distances.push_back(GetDistance(shape, point));
+				}
+				std::partial_sort(distances.begin(), distances.begin() + NEAREST_HITS, distances.end());
+				bool nearestMatches = count == NEAREST_HITS;
+				for (uint32_t hit = 0; hit < count && nearestMatches; hit++)
+				{
+					nearestMatches = std::abs(hits[hit].m_distance - distances[hit]) <= 1e-3f;
+				}
+				wrongNearest += nearestMatches ? 0 : 1;
+
+				const Vec2 end = RandomPoint(random);
+				RaycastHit raycastHit;
+				const bool hasHit = query.Raycast(point, end, raycastHit);
+				float nearestFraction = FLT_MAX;
+				for (const ReferenceShape& shape : shapes)
+				{
+					float fraction;
+					if (Raycast(shape, point, end, fraction))
+					{
+						nearestFraction = std::min(nearestFraction, fraction);
+					}
+				}
+				wrongRaycasts += hasHit != (nearestFraction != FLT_MAX) || (hasHit && std::abs(raycastHit.m_fraction - nearestFraction) > 1e-4f) ? 1 : 0;
+			}
+
+			RB_TEST_CHECK(wrongPoints == 0, "round %u: %u of %u point overlaps differ from a linear scan", round, wrongPoints, QUERIES_PER_ROUND);
+			RB_TEST_CHECK(wrongBoxes == 0, "round %u: %u of %u box overlaps differ from a linear scan", round, wrongBoxes, QUERIES_PER_ROUND);
+			RB_TEST_CHECK(wrongNearest == 0, "round %u: %u of %u nearest queries differ from a linear scan", round, wrongNearest, QUERIES_PER_ROUND);
+			RB_TEST_CHECK(wrongRaycasts == 0, "round %u: %u of %u raycasts differ from a linear scan", round, wrongRaycasts, QUERIES_PER_ROUND);
+		}
+
+		double GetMicroseconds(const std::chrono::steady_clock::time_point& start, uint32_t repeats)
+		{
+			return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeats;
+		}
+	}
+
+	// Checks every query against a linear scan of the components while the scene changes between syncs, then times
+	// syncs and queries against scanning every shape
+	void RunSceneQueryTests()
+	{
+		const int failedBefore = g_failedChecks;
+
+		Scene scene;
+		std::mt19937 random(20241019);
+
+		std::vector<Entity> parents;
+		for (uint32_t i = 0; i < PARENT_COUNT; i++)
+		{
+			parents.push_back(scene.CreateEntity());
+			parents.back().GetComponent<TransformComponent>().SetPosition(RandomPoint(random));
+		}
+
+		std::vector<Entity> shapeEntities;
+		for (uint32_t i = 0; i < SHAPE_ENTITY_COUNT; i++)
+		{
+			shapeEntities.push_back(CreateShapeEntity(scene, parents, random));
+		}
+
+		std::vector<ReferenceShape> shapes;
+		std::vector<QueryHit> hits(SHAPE_ENTITY_COUNT * 2);
+		for (uint32_t round = 0; round < ROUNDS; round++)
+		{
+			GatherShapes(scene, shapes);
+			CheckQueries(scene, shapes, hits, round, random);
+			Mutate(scene, shapeEntities, parents, random);
+		}
+
+		// Syncing with nothing changed, with a frame's worth of changes and from nothing at all
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < BENCHMARK_SYNCS; i++)
+		{
+			scene.InvalidateQuery();
+			scene.Query();
+		}
+		const double unchangedSyncMicroseconds = GetMicroseconds(start, BENCHMARK_SYNCS);
+
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < BENCHMARK_SYNCS; i++)
+		{
+			for (uint32_t moved = 0; moved < SHAPE_ENTITY_COUNT / 100; moved++)
+			{
+				shapeEntities[random() % shapeEntities.size()].GetComponent<TransformComponent>().SetPosition(RandomPoint(random));
+			}
+			scene.InvalidateQuery();
+			scene.Query();
+		}
+		const double movedSyncMicroseconds = GetMicroseconds(start, BENCHMARK_SYNCS);
+
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < BENCHMARK_SYNCS; i++)
+		{
+			scene.Query().Clear();
+			scene.InvalidateQuery();
+			scene.Query();
+		}
+		const double rebuildMicroseconds = GetMicroseconds(start, BENCHMARK_SYNCS);
+
+		GatherShapes(scene, shapes);
+		CheckQueries(scene, shapes, hits, ROUNDS, random);
+
+		// The same box and nearest queries through the tree and by scanning every shape
+		std::vector<Vec2> points;
+		for (uint32_t i = 0; i < BENCHMARK_QUERIES; i++)
+		{
+			points.push_back(RandomPoint(random));
+		}
+
+		uint32_t treeHits = 0;
+		start = std::chrono::steady_clock::now();
+		for (const Vec2& point : points)
+		{
+			treeHits += scene.Query().OverlapBox(point, point + Vec2(50.0f, 30.0f), hits.data(), (uint32_t)hits.size());
+			treeHits += scene.Query().Nearest(point, hits.data(), 1);
+		}
+		const double treeMicroseconds = GetMicroseconds(start, BENCHMARK_QUERIES);
+
+		uint32_t scanHits = 0;
+		start = std::chrono::steady_clock::now();
+		for (const Vec2& point : points)
+		{
+			float nearestDistance = FLT_MAX;
+			for (const ReferenceShape& shape : shapes)
+			{
+				scanHits += Overlaps(shape, point, point + Vec2(50.0f, 30.0f)) ? 1 : 0;
+				nearestDistance = std::min(nearestDistance, GetDistance(shape, point));
+			}
+			scanHits += nearestDistance != FLT_MAX ? 1 : 0;
+		}
+		const double scanMicroseconds = GetMicroseconds(start, BENCHMARK_QUERIES);
+		RB_TEST_CHECK(treeHits == scanHits, "the tree found %u hits and the scan %u", treeHits, scanHits);
+
+		if (g_failedChecks == failedBefore)
+		{
+			printf("Scene query: %zu shapes matched a linear scan over %u rounds of changes. Sync %.1f us unchanged, %.1f us with %u moved, %.1f us from nothing. "
+				"Box and nearest query %.2f us, scanning %.2f us\n", shapes.size(), ROUNDS, unchangedSyncMicroseconds, movedSyncMicroseconds, SHAPE_ENTITY_COUNT / 100,
+				rebuildMicroseconds, treeMicroseconds, scanMicroseconds);
+		}
+	}
+}
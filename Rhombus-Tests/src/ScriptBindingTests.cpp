@@ -0,0 +1,234 @@
+#include "Rhombus/ECS/Components/Area2DComponent.h"
+#include "Rhombus/ECS/Components/ScriptComponent.h"
+#include "Rhombus/ECS/Components/TransformComponent.h"
+#include "Rhombus/Project/Project.h"
+#include "Rhombus/Scenes/Scene.h"
+#include "Rhombus/Scripting/ScriptEngine.h"
+#include "Rhombus/Scripting/ScriptScheduler.h"
+#include "Test.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		const uint32_t CALL_COUNT = 1000000;
+		const uint32_t PARALLEL_STATE_COUNT = 2;
+		const uint32_t THREAD_SAFE_ENTITY_COUNT = 64;
+
+		struct BindingBenchmark
+		{
+			const char* m_name;
+			const char* m_update;			// The body of the loop, run CALL_COUNT times with entity and i in scope
+			Vec3 m_expectedPosition;		// Where the entity ends up, starting at 3, 0, 0
+		};
+
+		// Each is a script of its own whose Update makes the calls and then leaves what it saw in the position, so the
+		// calls can't have been skipped. The first makes no glue calls and is what the others are compared against
+		const BindingBenchmark s_benchmarks[] =
+		{
+			{ "BindingLuaCall", "sum = sum + Identity(3)", Vec3(4.0f, 0.0f, 0.0f) },
+			{ "BindingGetPosition", "sum = sum + entity:GetPosition()", Vec3(4.0f, 0.0f, 0.0f) },
+			{ "BindingSelfGetPosition", "sum = sum + rhombus.GetPosition(self)", Vec3(4.0f, 0.0f, 0.0f) },
+			{ "BindingSetPosition", "rhombus.SetPosition(entity, i, 0, 0)", Vec3((float)CALL_COUNT, 0.0f, 0.0f) },
+			{ "BindingTranslate", "entity:Translate(1, 0)", Vec3(3.0f + CALL_COUNT, 0.0f, 0.0f) },
+		};
+
+		void WriteBenchmarkScript(const std::filesystem::path& directory, const BindingBenchmark& benchmark)
+		{
+			std::ofstream script(directory / (std::string(benchmark.m_name) + ".lua"));
+			script << benchmark.m_name << " = {}\n"
+				<< "local function Identity(x) return x end\n"
+				<< "function " << benchmark.m_name << ":Update(dt)\n"
+				<< "\tlocal entity = self.entity\n"
+				<< "\tlocal sum = 0\n"
+				<< "\tfor i = 1, " << CALL_COUNT << " do\n"
+				<< "\t\t" << benchmark.m_update << "\n"
+				<< "\tend\n"
+				<< "\tif sum ~= 0 then entity:SetPosition(sum / " << CALL_COUNT << " + 1, 0, 0) end\n"
+				<< "end\n";
+		}
+
+		// A handle kept past its entity's destruction, the ID can be given to a new entity at any time after
+		void WriteHandleScript(const std::filesystem::path& directory)
+		{
+			std::ofstream script(directory / "BindingHandles.lua");
+			script << "BindingHandles = {}\n"
+				<< "function BindingHandles:Init()\n"
+				<< "\tBindingHandles.First = BindingHandles.First or self.entity\n"
+				<< "end\n"
+				<< "function BindingHandles:Update(dt)\n"
+				<< "\tlocal valid = rhombus.IsValid(BindingHandles.First)\n"
+				<< "\tlocal failed = not pcall(rhombus.GetPosition, BindingHandles.First)\n"
+				<< "\tself.entity:SetPosition(0, valid and 1 or 0, failed and 1 or 0)\n"
+				<< "end\n";
+		}
+
+		// The glue on the workers' own Lua states, reading an area and moving through the command queue. Clicks are
+		// called on the main thread, in the parallel state the entity's instance lives in
+		void WriteThreadSafeScript(const std::filesystem::path& directory)
+		{
+			std::ofstream script(directory / "BindingThreadSafe.lua");
+			script << "BindingThreadSafe = { ThreadSafe = true }\n"
+				<< "function BindingThreadSafe:Update(dt)\n"
+				<< "\tlocal x = self.entity:GetPosition()\n"
+				<< "\tself.entity:SetPosition(x + 1, self.entity:IsMouseInArea() and 1 or 0, 0)\n"
+				<< "end\n"
+				<< "function BindingThreadSafe:OnMouseButtonPressed(button)\n"
+				<< "\tself.entity:SetPosition(button, 0, 0)\n"
+				<< "end\n"
+				<< "function BindingThreadSafe:OnMouseButtonReleased(button)\n"
+				<< "\tlocal x = self.entity:GetPosition()\n"
+				<< "\tself.entity:SetPosition(x, button, 0)\n"
+				<< "end\n";
+		}
+
+		// The first entity tweens itself for a long time, the others wait for its tween in a coroutine and mark
+		// themselves once it is over
+		void WriteTweenWaitScript(const std::filesystem::path& directory)
+		{
+			std::ofstream script(directory / "BindingTweenWait.lua");
+			script << "BindingTweenWait = {}\n"
+				<< "function BindingTweenWait:Init()\n"
+				<< "\tif not BindingTweenWait.Tween then\n"
+				<< "\t\tBindingTweenWait.Tween = self.entity:TweenPosition(9, 9, 9, 1000)\n"
+				<< "\t\treturn\n"
+				<< "\tend\n"
+				<< "\tlocal entity = self.entity\n"
+				<< "\tentity:StartCoroutine(function(tween)\n"
+				<< "\t\trhombus.WaitForTween(tween)\n"
+				<< "\t\tentity:SetPosition(1, 2, 3)\n"
+				<< "\tend, BindingTweenWait.Tween)\n"
+				<< "end\n";
+		}
+
+		Entity CreateScriptedEntity(Scene& scene, const char* scriptName)
+		{
+			Entity entity = scene.CreateEntity();
+			entity.GetComponent<TransformComponent>().SetPosition(Vec3(3.0f, 0.0f, 0.0f));
+			entity.AddComponent<ScriptComponent>().m_scriptName = scriptName;
+			return entity;
+		}
+	}
+
+	// A million calls through each of the Lua glue functions on entity handles, timed against a million calls to a Lua
+	// function, then checks a handle kept past its entity's destruction is seen to be stale, that handles and click
+	// callbacks work in the parallel states, and that a stopped tween resumes the coroutines waiting for it
+	void RunScriptBindingTests()
+	{
+		const int failedBefore = g_failedChecks;
+
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "RhombusScriptBindingTests";
+		std::filesystem::create_directories(directory);
+		for (const BindingBenchmark& benchmark : s_benchmarks)
+		{
+			WriteBenchmarkScript(directory, benchmark);
+		}
+		WriteHandleScript(directory);
+		WriteThreadSafeScript(directory);
+		WriteTweenWaitScript(directory);
+
+		Ref<Project> project = Project::New();
+		project->GetConfig().AssetDirectory = directory;
+		project->GetConfig().ScriptDirectory = ".";
+
+		ScriptEngine::Init();
+		ScriptEngine::SetParallelStateCount(PARALLEL_STATE_COUNT);
+		{
+			Scene scene;
+			ScriptEngine::OnRuntimeStart(&scene);
+
+			double nanoseconds[std::size(s_benchmarks)];
+			for (size_t i = 0; i < std::size(s_benchmarks); i++)
+			{
+				Entity entity = CreateScriptedEntity(scene, s_benchmarks[i].m_name);
+				ScriptEngine::OnInitEntity(entity);
+
+				const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				ScriptEngine::OnUpdateEntity(entity, 1.0f / 60.0f);
+				nanoseconds[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALL_COUNT;
+
+				const Vec3 position = entity.GetComponent<TransformComponent>().GetPosition();
+				RB_TEST_CHECK(position == s_benchmarks[i].m_expectedPosition, "%s left the entity at %g, %g, %g", s_benchmarks[i].m_name, position.x, position.y, position.z);
+			}
+
+			Entity first = CreateScriptedEntity(scene, "BindingHandles");
+			ScriptEngine::OnInitEntity(first);
+			scene.DestroyEntity(first);
+
+			Entity second = CreateScriptedEntity(scene, "BindingHandles");
+			ScriptEngine::OnInitEntity(second);
+			ScriptEngine::OnUpdateEntity(second, 1.0f / 60.0f);
+			const Vec3 handleResults = second.GetComponent<TransformComponent>().GetPosition();
+			RB_TEST_CHECK(handleResults.y == 0.0f, "a handle to a destroyed entity is still valid");
+			RB_TEST_CHECK(handleResults.z == 1.0f, "a glue call on a handle to a destroyed entity did not raise an error");
+
+			std::vector<Entity> threadSafeEntities;
+			for (uint32_t i = 0; i < THREAD_SAFE_ENTITY_COUNT; i++)
+			{
+				Entity entity = CreateScriptedEntity(scene, "BindingThreadSafe");
+				entity.AddComponent<BoxArea2DComponent>().m_isMouseInArea = i % 2 == 0;
+				ScriptEngine::OnInitEntity(entity);
+				threadSafeEntities.push_back(entity);
+			}
+
+			ScriptEngine::OnUpdateParallel(1.0f / 60.0f);
+			uint32_t wrongPositions = 0;
+			for (uint32_t i = 0; i < THREAD_SAFE_ENTITY_COUNT; i++)
+			{
+				wrongPositions += threadSafeEntities[i].GetComponent<TransformComponent>().GetPosition() != Vec3(4.0f, i % 2 == 0 ? 1.0f : 0.0f, 0.0f) ? 1 : 0;
+			}
+			RB_TEST_CHECK(wrongPositions == 0, "%u of %u thread safe entities were not moved by their update on the %u parallel states", wrongPositions, THREAD_SAFE_ENTITY_COUNT, PARALLEL_STATE_COUNT);
+
+			// Pressed with one button and released with another, the script puts what it was given in the position
+			uint32_t wrongButtons = 0;
+			for (uint32_t i = 0; i < THREAD_SAFE_ENTITY_COUNT; i++)
+			{
+				const int pressedButton = 1 + i % 3;
+				const int releasedButton = 4 + i % 2;
+				ScriptEngine::OnMouseButtonPressed(threadSafeEntities[i], pressedButton);
+				ScriptEngine::OnMouseButtonReleased(threadSafeEntities[i], releasedButton);
+				wrongButtons += threadSafeEntities[i].GetComponent<TransformComponent>().GetPosition() != Vec3((float)pressedButton, (float)releasedButton, 0.0f) ? 1 : 0;
+			}
+			RB_TEST_CHECK(wrongButtons == 0, "%u of %u thread safe entities were not given the button they were clicked with", wrongButtons, THREAD_SAFE_ENTITY_COUNT);
+
+			// Destroying the tweened entity stops its tween, which has to let the coroutines waiting for it go
+			Entity tweened = CreateScriptedEntity(scene, "BindingTweenWait");
+			ScriptEngine::OnInitEntity(tweened);
+			std::vector<Entity> waiting;
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				waiting.push_back(CreateScriptedEntity(scene, "BindingTweenWait"));
+				ScriptEngine::OnInitEntity(waiting.back());
+			}
+			RB_TEST_CHECK(ScriptScheduler::GetStats().WaitingForTweens == (uint32_t)waiting.size(), "%u coroutines are waiting for the tween, %zu started", ScriptScheduler::GetStats().WaitingForTweens, waiting.size());
+
+			scene.DestroyEntity(tweened);
+			ScriptEngine::OnUpdateCoroutines(1.0f / 60.0f);
+			uint32_t stillWaiting = 0;
+			for (Entity entity : waiting)
+			{
+				stillWaiting += entity.GetComponent<TransformComponent>().GetPosition() != Vec3(1.0f, 2.0f, 3.0f) ? 1 : 0;
+			}
+			RB_TEST_CHECK(stillWaiting == 0 && ScriptScheduler::GetStats().WaitingForTweens == 0, "%u of %zu coroutines were not resumed once the tween they waited for was stopped", stillWaiting, waiting.size());
+
+			ScriptEngine::OnRuntimeStop();
+
+			if (g_failedChecks == failedBefore)
+			{
+				printf("Script bindings, ns per call over %u calls:\n", CALL_COUNT);
+				for (size_t i = 0; i < std::size(s_benchmarks); i++)
+				{
+					printf("  %-24s %8.1f\n", s_benchmarks[i].m_name, nanoseconds[i]);
+				}
+			}
+		}
+		ScriptEngine::Shutdown();
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+}
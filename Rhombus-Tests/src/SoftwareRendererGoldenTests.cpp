@@ -0,0 +1,364 @@
+#include "Rhombus/Core/JobSystem.h"
+#include "Rhombus/Renderer/Framebuffer.h"
+#include "Rhombus/Renderer/RenderCommand.h"
+#include "Rhombus/Renderer/Shader.h"
+#include "Rhombus/Renderer/Texture.h"
+#include "Rhombus/Renderer/UniformBuffer.h"
+#include "Platform/Null/NullFramebuffer.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
+#include "Test.h"
+
+#include "stb_image/stb_image.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		// Wider than 65535 bytes of scanlines so the zlib stream needs more than one stored block
+		const uint32_t FRAME_WIDTH = 160;
+		const uint32_t FRAME_HEIGHT = 120;
+
+		const char* GOLDEN_PATH = "assets/golden/SoftwareRenderer.png";
+
+		// Vertex formats of Renderer2D, the software rasterizer finds attributes by these names
+		struct QuadVertex
+		{
+			float m_position[3];
+			float m_color[4];
+			float m_texCoord[2];
+			float m_textureIndex;
+			float m_tilingFactor;
+			int m_entityID;
+		};
+
+		struct CircleVertex
+		{
+			float m_worldPosition[3];
+			float m_localPosition[3];
+			float m_color[4];
+			float m_thickness;
+			float m_fade;
+			int m_entityID;
+		};
+
+		struct LineVertex
+		{
+			float m_position[3];
+			float m_color[4];
+			int m_entityID;
+		};
+
+		Ref<VertexArray> CreateVertexArray(const void* vertices, uint32_t size, const BufferLayout& layout, uint32_t quadCount)
+		{
+			Ref<VertexArray> vertexArray = VertexArray::Create();
+			Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create(size);
+			vertexBuffer->SetLayout(layout);
+			vertexBuffer->SetData(vertices, size);
+			vertexArray->AddVertexBuffer(vertexBuffer);
+
+			if (quadCount > 0)
+			{
+				std::vector<uint32_t> indices;
+				for (uint32_t quad = 0; quad < quadCount; quad++)
+				{
+					const uint32_t first = quad * 4;
+					indices.insert(indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first });
+				}
+				vertexArray->SetIndexBuffer(IndexBuffer::Create(indices.data(), (uint32_t)indices.size()));
+			}
+
+			return vertexArray;
+		}
+
+		void AddQuad(std::vector<QuadVertex>& vertices, float x, float y, float width, float height, float z, const Color& color, float textureIndex, float tiling)
+		{
+			const float corners[4][2] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+			for (const auto& corner : corners)
+			{
+				vertices.push_back({ { x + corner[0] * width, y + corner[1] * height, z }, { color.r, color.g, color.b, color.a }, { corner[0], corner[1] }, textureIndex, tiling, (int)vertices.size() / 4 });
+			}
+		}
+
+		void AddCircle(std::vector<CircleVertex>& vertices, float x, float y, float radius, const Color& color, float thickness, float fade)
+		{
+			const float corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+			for (const auto& corner : corners)
+			{
+				vertices.push_back({ { x + corner[0] * radius, y + corner[1] * radius, 0.5f }, { corner[0], corner[1], 0.0f }, { color.r, color.g, color.b, color.a }, thickness, fade, 100 });
+			}
+		}
+
+		// Quads with alpha blending, a repeating texture and overlap order, rings with and without fade, and lines at
+		// a few slopes. Camera maps world units to pixels with the origin bottom left
+		void RenderScene(NullFramebuffer& framebuffer)
+		{
+			framebuffer.Bind();
+			RenderCommand::SetViewport(0, 0, FRAME_WIDTH, FRAME_HEIGHT);
+			RenderCommand::SetClearColor(Color(0.1f, 0.12f, 0.15f, 1.0f));
+			RenderCommand::Clear();
+			framebuffer.ClearAttachment(1, -1);
+
+			const Mat4 viewProjection = Mat4::Ortho(0.0f, (float)FRAME_WIDTH, 0.0f, (float)FRAME_HEIGHT, -1.0f, 1.0f);
+			Ref<UniformBuffer> camera = UniformBuffer::Create(sizeof(Mat4), UniformBuffer::CameraBinding);
+			camera->SetData(viewProjection.ToPtr(), sizeof(Mat4));
+
+			Ref<Texture2D> white = Texture2D::Create(1, 1);
+			uint32_t whiteTexel = 0xFFFFFFFF;
+			white->SetData(&whiteTexel, sizeof(whiteTexel));
+
+			Ref<Texture2D> checker = Texture2D::Create(2, 2);
+			uint32_t checkerTexels[4] = { 0xFF2020E0, 0xFFE0E0E0, 0xFFE0E0E0, 0xFF2020E0 };
+			checker->SetData(checkerTexels, sizeof(checkerTexels));
+
+			white->Bind(0);
+			checker->Bind(1);
+
+			std::vector<QuadVertex> quads;
+			AddQuad(quads, 8.0f, 8.0f, 64.0f, 48.0f, 0.0f, Color(0.9f, 0.6f, 0.1f, 1.0f), 0.0f, 1.0f);
+			AddQuad(quads, 40.0f, 30.0f, 64.0f, 48.0f, 0.1f, Color(0.2f, 0.5f, 0.9f, 0.5f), 0.0f, 1.0f);
+			AddQuad(quads, 100.5f, 60.25f, 50.0f, 50.0f, 0.2f, Color(1.0f, 1.0f, 1.0f, 1.0f), 1.0f, 4.0f);
+			AddQuad(quads, 12.0f, 70.0f, 30.0f, 30.0f, 0.3f, Color(0.3f, 0.9f, 0.3f, 0.0f), 0.0f, 1.0f);
+
+			Ref<Shader> quadShader = Shader::Create("Renderer2D_Quad", "", "");
+			quadShader->Bind();
+			RenderCommand::DrawIndexed(CreateVertexArray(quads.data(), (uint32_t)(quads.size() * sizeof(QuadVertex)), {
+				{ ShaderDataType::Float3, "a_Position" },
+				{ ShaderDataType::Float4, "a_Color" },
+				{ ShaderDataType::Float2, "a_TexCoord" },
+				{ ShaderDataType::Float, "a_TextureIndex" },
+				{ ShaderDataType::Float, "a_TilingFactor" },
+				{ ShaderDataType::Int, "a_EntityID" }
+			}, (uint32_t)quads.size() / 4));
+
+			std::vector<CircleVertex> circles;
+			AddCircle(circles, 120.0f, 30.0f, 22.0f, Color(1.0f, 0.9f, 0.2f, 1.0f), 1.0f, 0.0f);
+			AddCircle(circles, 60.0f, 90.0f, 18.0f, Color(0.8f, 0.2f, 0.8f, 1.0f), 0.3f, 0.05f);
+			AddCircle(circles, 150.0f, 110.0f, 25.0f, Color(0.2f, 0.9f, 0.9f, 0.75f), 1.0f, 0.2f);
+
+			Ref<Shader> circleShader = Shader::Create("Renderer2D_Circle", "", "");
+			circleShader->Bind();
+			RenderCommand::DrawIndexed(CreateVertexArray(circles.data(), (uint32_t)(circles.size() * sizeof(CircleVertex)), {
+				{ ShaderDataType::Float3, "a_WorldPosition" },
+				{ ShaderDataType::Float3, "a_LocalPosition" },
+				{ ShaderDataType::Float4, "a_Color" },
+				{ ShaderDataType::Float, "a_Thickness" },
+				{ ShaderDataType::Float, "a_Fade" },
+				{ ShaderDataType::Int, "a_EntityID" }
+			}, (uint32_t)circles.size() / 4));
+
+			std::vector<LineVertex> lines;
+			const float ends[][4] = { { 4.0f, 4.0f, 156.0f, 116.0f }, { 4.0f, 116.0f, 156.0f, 100.0f }, { 80.0f, 2.0f, 84.0f, 118.0f } };
+			for (const auto& end : ends)
+			{
+				lines.push_back({ { end[0], end[1], 0.9f }, { 1.0f, 1.0f, 1.0f, 1.0f }, 200 });
+				lines.push_back({ { end[2], end[3], 0.9f }, { 1.0f, 1.0f, 1.0f, 1.0f }, 200 });
+			}
+
+			Ref<Shader> lineShader = Shader::Create("Renderer2D_Line", "", "");
+			lineShader->Bind();
+			RenderCommand::SetLineWidth(2.0f);
+			RenderCommand::DrawLines(CreateVertexArray(lines.data(), (uint32_t)(lines.size() * sizeof(LineVertex)), {
+				{ ShaderDataType::Float3, "a_Position" },
+				{ ShaderDataType::Float4, "a_Color" },
+				{ ShaderDataType::Int, "a_EntityID" }
+			}, 0), (uint32_t)lines.size());
+
+			framebuffer.Unbind();
+		}
+
+		bool ReadFile(const std::string& path, std::vector<uint8_t>& outBytes)
+		{
+			std::ifstream stream(path, std::ios::in | std::ios::binary);
+			if (!stream)
+				return false;
+
+			outBytes.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+			return true;
+		}
+
+		uint32_t ReadBigEndian(const uint8_t* bytes)
+		{
+			return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3];
+		}
+
+		// Bit at a time, so it does not share a table or any code with the writer
+		uint32_t Crc32(const uint8_t* data, size_t length)
+		{
+			uint32_t crc = 0xFFFFFFFFu;
+			for (size_t i = 0; i < length; i++)
+			{
+				crc ^= data[i];
+				for (int bit = 0; bit < 8; bit++)
+				{
+					crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+				}
+			}
+			return ~crc;
+		}
+
+		// Walks the chunks checking lengths and CRCs, then unpacks the stored deflate blocks of the zlib stream and
+		// checks their lengths and the Adler-32 against the scanlines they hold
+		void CheckPNGStructure(const std::vector<uint8_t>& file, uint32_t width, uint32_t height)
+		{
+			const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			RB_TEST_CHECK(file.size() > sizeof(signature) && memcmp(file.data(), signature, sizeof(signature)) == 0, "missing PNG signature");
+
+			std::vector<uint8_t> zlib;
+			std::vector<std::string> chunkTypes;
+			size_t offset = sizeof(signature);
+			while (offset + 12 <= file.size())
+			{
+				const uint32_t length = ReadBigEndian(&file[offset]);
+				if (offset + 12 + length > file.size())
+				{
+					RB_TEST_CHECK(false, "chunk at %zu runs past the end of the file", offset);
+					return;
+				}
+
+				const std::string type((const char*)&file[offset + 4], 4);
+				chunkTypes.push_back(type);
+				RB_TEST_CHECK(Crc32(&file[offset + 4], length + 4) == ReadBigEndian(&file[offset + 8 + length]), "bad CRC on %s chunk", type.c_str());
+
+				if (type == "IHDR")
+				{
+					RB_TEST_CHECK(length == 13 && ReadBigEndian(&file[offset + 8]) == width && ReadBigEndian(&file[offset + 12]) == height, "bad IHDR");
+				}
+				else if (type == "IDAT")
+				{
+					zlib.insert(zlib.end(), file.begin() + offset + 8, file.begin() + offset + 8 + length);
+				}
+				offset += 12 + length;
+			}
+			RB_TEST_CHECK(offset == file.size(), "%zu trailing bytes after the last chunk", file.size() - offset);
+			RB_TEST_CHECK(chunkTypes.size() == 3 && chunkTypes[0] == "IHDR" && chunkTypes[1] == "IDAT" && chunkTypes[2] == "IEND", "unexpected chunk order");
+
+			RB_TEST_CHECK(zlib.size() > 6 && ((zlib[0] << 8) | zlib[1]) % 31 == 0 && (zlib[0] & 0x0F) == 8, "bad zlib header");
+			if (zlib.size() <= 6)
+				return;
+
+			std::vector<uint8_t> scanlines;
+			uint32_t blockCount = 0;
+			size_t position = 2;
+			bool lastBlock = false;
+			while (!lastBlock && position + 5 <= zlib.size() - 4)
+			{
+				lastBlock = (zlib[position] & 1) != 0;
+				RB_TEST_CHECK((zlib[position] >> 1) == 0, "block %u is not a stored block", blockCount);
+				const uint32_t length = zlib[position + 1] | (zlib[position + 2] << 8);
+				const uint32_t inverse = zlib[position + 3] | (zlib[position + 4] << 8);
+				RB_TEST_CHECK((length ^ inverse) == 0xFFFF, "block %u length %u does not match its complement", blockCount, length);
+				position += 5;
+
+				if (position + length > zlib.size() - 4)
+				{
+					RB_TEST_CHECK(false, "block %u runs past the end of the stream", blockCount);
+					return;
+				}
+				scanlines.insert(scanlines.end(), zlib.begin() + position, zlib.begin() + position + length);
+				position += length;
+				blockCount++;
+			}
+			RB_TEST_CHECK(lastBlock && position == zlib.size() - 4, "zlib stream does not end after its last block");
+			RB_TEST_CHECK(blockCount > 1, "expected the scanlines to need more than one stored block, got %u", blockCount);
+			RB_TEST_CHECK(scanlines.size() == (size_t)height * (width * 4 + 1), "%zu bytes of scanlines", scanlines.size());
+
+			uint32_t a = 1, b = 0;
+			for (uint8_t byte : scanlines)
+			{
+				a = (a + byte) % 65521;
+				b = (b + a) % 65521;
+			}
+			RB_TEST_CHECK(((b << 16) | a) == ReadBigEndian(&zlib[zlib.size() - 4]), "bad Adler-32");
+		}
+
+		// Bottom row first like the framebuffer, 0xAABBGGRR texels
+		bool DecodePNG(const std::vector<uint8_t>& file, std::vector<uint32_t>& outTexels, int& outWidth, int& outHeight)
+		{
+			stbi_set_flip_vertically_on_load(1);
+			int channels;
+			stbi_uc* data = stbi_load_from_memory(file.data(), (int)file.size(), &outWidth, &outHeight, &channels, 4);
+			if (!data)
+				return false;
+
+			outTexels.resize((size_t)outWidth * outHeight);
+			memcpy(outTexels.data(), data, outTexels.size() * sizeof(uint32_t));
+			stbi_image_free(data);
+			return true;
+		}
+
+		uint32_t CountDifferentTexels(const uint32_t* a, const uint32_t* b, size_t count)
+		{
+			uint32_t different = 0;
+			for (size_t i = 0; i < count; i++)
+			{
+				different += a[i] != b[i] ? 1 : 0;
+			}
+			return different;
+		}
+	}
+
+	void RunSoftwareRendererGoldenTests()
+	{
+		const int failedBefore = g_failedChecks;
+		const std::string outputPath = (std::filesystem::temp_directory_path() / "SoftwareRenderer.png").string();
+
+		RendererAPI::SetAPI(RendererAPI::API::Software);
+		RenderCommand::Init();
+
+		FramebufferSpecification spec;
+		spec.Width = FRAME_WIDTH;
+		spec.Height = FRAME_HEIGHT;
+		spec.Attachments = { FramebufferTextureFormat::RGBA8, FramebufferTextureFormat::RED_INTEGER, FramebufferTextureFormat::Depth };
+		Ref<Framebuffer> framebuffer = Framebuffer::Create(spec);
+		NullFramebuffer& frame = static_cast<NullFramebuffer&>(*framebuffer);
+
+		RenderScene(frame);
+		const uint32_t* texels = frame.GetColorAttachmentData(0);
+		const size_t texelCount = (size_t)FRAME_WIDTH * FRAME_HEIGHT;
+
+		// The same scene again has to come out identical, tiles are rasterized on several threads
+		std::vector<uint32_t> firstFrame(texels, texels + texelCount);
+		RenderScene(frame);
+		RB_TEST_CHECK(CountDifferentTexels(firstFrame.data(), texels, texelCount) == 0, "rendering the same scene twice differs");
+
+		std::vector<uint8_t> file;
+		RB_TEST_CHECK(SoftwareRendererAPI::WriteFramebufferToPNG(*framebuffer, outputPath), "could not write %s", outputPath.c_str());
+		RB_TEST_CHECK(ReadFile(outputPath, file), "could not read back %s", outputPath.c_str());
+		CheckPNGStructure(file, FRAME_WIDTH, FRAME_HEIGHT);
+
+		std::vector<uint32_t> decoded;
+		int width = 0, height = 0;
+		RB_TEST_CHECK(DecodePNG(file, decoded, width, height) && width == (int)FRAME_WIDTH && height == (int)FRAME_HEIGHT, "stb_image could not decode %s", outputPath.c_str());
+		if (decoded.size() == texelCount)
+		{
+			RB_TEST_CHECK(CountDifferentTexels(decoded.data(), texels, texelCount) == 0, "decoded PNG does not match the framebuffer");
+		}
+
+		if (g_updateGoldens)
+		{
+			std::filesystem::create_directories(std::filesystem::path(GOLDEN_PATH).parent_path());
+			std::filesystem::copy_file(outputPath, GOLDEN_PATH, std::filesystem::copy_options::overwrite_existing);
+			printf("Software renderer: golden image written to %s\n", GOLDEN_PATH);
+			return;
+		}
+
+		std::vector<uint8_t> goldenFile;
+		std::vector<uint32_t> golden;
+		RB_TEST_CHECK(ReadFile(GOLDEN_PATH, goldenFile) && DecodePNG(goldenFile, golden, width, height) && width == (int)FRAME_WIDTH && height == (int)FRAME_HEIGHT,
+			"could not load golden image %s, run with --update-goldens to create it", GOLDEN_PATH);
+		if (golden.size() == texelCount)
+		{
+			const uint32_t different = CountDifferentTexels(golden.data(), texels, texelCount);
+			RB_TEST_CHECK(different == 0, "%u of %zu pixels differ from %s, see %s", different, texelCount, GOLDEN_PATH, outputPath.c_str());
+			RB_TEST_CHECK(goldenFile == file, "PNG bytes differ from %s", GOLDEN_PATH);
+		}
+
+		if (g_failedChecks == failedBefore)
+		{
+			printf("Software renderer: %ux%u frame, %zu byte PNG matches the golden image\n", FRAME_WIDTH, FRAME_HEIGHT, file.size());
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdio>
+
+namespace rhombus::tests
+{
+	// Failed checks across every test run so far, the process exit code is non zero if there are any
+	extern int g_failedChecks;
+	// Set by --update-goldens. Golden image tests write what they render instead of comparing against it
+	extern bool g_updateGoldens;
+
+	void RunSoftwareRendererGoldenTests();
+	void RunTextureLoaderTests();
+	void RunPixelPlatformerPhysicsTests();
+	void RunPixelPlatformerSweepTests();
+	void RunPhysicsSyncTests();
+	void RunSceneQueryTests();
+	void RunScriptBindingTests();
+	void RunLuaAllocatorTests();
+	void RunTweenEngineTests();
+	void RunEasingKernelTests();
+}
+
+// Reports the first few failures of a check with where they came from, and counts all of them
+#define RB_TEST_CHECK(condition, ...) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			if (::rhombus::tests::g_failedChecks++ < 20) \
+			{ \
+				printf("%s(%d): check failed: %s: ", __FILE__, __LINE__, #condition); \
+				printf(__VA_ARGS__); \
+				printf("\n"); \
+			} \
+		} \
+	} while (0)
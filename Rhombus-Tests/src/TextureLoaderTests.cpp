@@ -0,0 +1,169 @@
+#include "Rhombus/Assets/TextureLoader.h"
+#include "Rhombus/Core/JobSystem.h"
+#include "Rhombus/Renderer/Framebuffer.h"
+#include "Rhombus/Renderer/RenderCommand.h"
+#include "Platform/Null/NullFramebuffer.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
+#include "Test.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		const uint32_t IMAGE_COUNT = 24;
+
+		struct TestImage
+		{
+			std::string m_path;
+			uint32_t m_width = 0;
+			uint32_t m_height = 0;
+		};
+
+		// Packed 0xAABBGGRR, different for every texel and image so a flip, a transpose or a mixed up file shows
+		uint32_t GetTexel(uint32_t image, uint32_t x, uint32_t y)
+		{
+			const uint32_t r = (x * 7 + image) & 0xFF;
+			const uint32_t g = (y * 5 + image * 3) & 0xFF;
+			const uint32_t b = (x ^ y) & 0xFF;
+			const uint32_t a = (x + y) % 3 == 0 ? 0x80 : 0xFF;
+			return (a << 24) | (b << 16) | (g << 8) | r;
+		}
+
+		// PNGs written through the software renderer's writer, so no image library is needed to make them
+		std::vector<TestImage> WriteTestImages(const std::filesystem::path& directory)
+		{
+			std::vector<TestImage> images;
+			for (uint32_t i = 0; i < IMAGE_COUNT; i++)
+			{
+				FramebufferSpecification spec;
+				spec.Width = 1 + (i * 37) % 200;
+				spec.Height = 1 + (i * 53) % 150;
+				spec.Attachments = { FramebufferTextureFormat::RGBA8 };
+				Ref<Framebuffer> framebuffer = Framebuffer::Create(spec);
+
+				uint32_t* texels = static_cast<NullFramebuffer&>(*framebuffer).GetColorAttachmentData(0);
+				for (uint32_t y = 0; y < spec.Height; y++)
+				{
+					for (uint32_t x = 0; x < spec.Width; x++)
+					{
+						texels[y * spec.Width + x] = GetTexel(i, x, y);
+					}
+				}
+
+				TestImage& image = images.emplace_back();
+				image.m_path = (directory / ("Image" + std::to_string(i) + ".png")).string();
+				image.m_width = spec.Width;
+				image.m_height = spec.Height;
+				RB_TEST_CHECK(SoftwareRendererAPI::WriteFramebufferToPNG(*framebuffer, image.m_path), "could not write %s", image.m_path.c_str());
+			}
+			return images;
+		}
+
+		void CheckImage(uint32_t index, const TestImage& expected, const TextureImage& image)
+		{
+			RB_TEST_CHECK(image.Width == expected.m_width && image.Height == expected.m_height, "image %u is %ux%u, expected %ux%u", index, image.Width, image.Height, expected.m_width, expected.m_height);
+			if (image.Pixels.size() != (size_t)expected.m_width * expected.m_height * 4)
+			{
+				RB_TEST_CHECK(false, "image %u has %zu bytes of pixels", index, image.Pixels.size());
+				return;
+			}
+
+			uint32_t wrongTexels = 0;
+			for (uint32_t y = 0; y < image.Height; y++)
+			{
+				for (uint32_t x = 0; x < image.Width; x++)
+				{
+					uint32_t texel;
+					memcpy(&texel, &image.Pixels[((size_t)y * image.Width + x) * 4], sizeof(texel));
+					wrongTexels += texel != GetTexel(index, x, y) ? 1 : 0;
+				}
+			}
+			RB_TEST_CHECK(wrongTexels == 0, "image %u has %u wrong texels", index, wrongTexels);
+		}
+	}
+
+	// Decodes on the job workers with no renderer initialised, then loads asynchronously into null textures and checks
+	// the placeholder, the load states and the per call upload budget
+	void RunTextureLoaderTests()
+	{
+		const int failedBefore = g_failedChecks;
+
+		RendererAPI::SetAPI(RendererAPI::API::None);
+		RenderCommand::Init();
+
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "RhombusTextureLoaderTests";
+		std::filesystem::create_directories(directory);
+		const std::vector<TestImage> images = WriteTestImages(directory);
+
+		std::vector<TextureImage> decoded(images.size());
+		std::vector<uint8_t> decodeResults(images.size(), 0);
+		JobSystem::Dispatch((uint32_t)images.size(), [&](uint32_t i)
+		{
+			decodeResults[i] = TextureLoader::DecodeImage(images[i].m_path, decoded[i]) ? 1 : 0;
+		});
+
+		for (uint32_t i = 0; i < images.size(); i++)
+		{
+			RB_TEST_CHECK(decodeResults[i] == 1, "could not decode %s", images[i].m_path.c_str());
+			CheckImage(i, images[i], decoded[i]);
+
+			std::vector<uint8_t> encoded;
+			RB_TEST_CHECK(TextureLoader::ReadFile(images[i].m_path, encoded) && TextureLoader::HashContent(encoded) == decoded[i].ContentHash, "image %u content hash does not match its file", i);
+		}
+
+		TextureImage missing;
+		RB_TEST_CHECK(!TextureLoader::DecodeImage((directory / "Missing.png").string(), missing), "decoded a file that does not exist");
+
+		const std::string garbagePath = (directory / "Garbage.png").string();
+		{
+			std::ofstream garbage(garbagePath, std::ios::out | std::ios::binary);
+			garbage << "not a png at all";
+		}
+		TextureImage garbage;
+		RB_TEST_CHECK(!TextureLoader::DecodeImage(garbagePath, garbage), "decoded a file that is not an image");
+
+		// Asynchronous loads. Placeholders until uploaded, one image per call with a budget smaller than any image
+		std::vector<Ref<Texture2D>> textures;
+		uint32_t callbacks = 0;
+		for (const TestImage& image : images)
+		{
+			textures.push_back(TextureLoader::LoadAsync(image.m_path, [&callbacks](const Ref<Texture2D>&, const TextureImage&) { callbacks++; }));
+		}
+		Ref<Texture2D> failed = TextureLoader::LoadAsync(garbagePath);
+
+		for (const Ref<Texture2D>& texture : textures)
+		{
+			RB_TEST_CHECK(texture->GetLoadState() == TextureLoadState::Loading && texture->GetWidth() == 1 && texture->GetHeight() == 1, "%s is not a 1x1 placeholder while loading", texture->GetPath().c_str());
+		}
+
+		JobSystem::Wait();
+		uint32_t uploadCalls = 0;
+		uint32_t uploaded = 0;
+		while (TextureLoader::GetPendingCount() > 0 && uploadCalls < 1000)
+		{
+			const uint32_t completed = TextureLoader::ProcessUploads(1);
+			RB_TEST_CHECK(completed <= 1, "upload budget let %u textures through in one call", completed);
+			uploaded += completed;
+			uploadCalls++;
+		}
+
+		RB_TEST_CHECK(uploaded == images.size() + 1 && callbacks == images.size(), "%u uploads and %u callbacks for %zu images", uploaded, callbacks, images.size());
+		for (uint32_t i = 0; i < textures.size(); i++)
+		{
+			RB_TEST_CHECK(textures[i]->GetLoadState() == TextureLoadState::Ready && textures[i]->IsLoaded(), "image %u did not finish loading", i);
+			RB_TEST_CHECK(textures[i]->GetWidth() == images[i].m_width && textures[i]->GetHeight() == images[i].m_height, "image %u texture is %ux%u", i, textures[i]->GetWidth(), textures[i]->GetHeight());
+		}
+		RB_TEST_CHECK(failed->GetLoadState() == TextureLoadState::Failed, "a file that is not an image did not fail to load");
+
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+
+		if (g_failedChecks == failedBefore)
+		{
+			printf("Texture loader: %u images decoded without a graphics context and loaded asynchronously\n", IMAGE_COUNT);
+		}
+	}
+}
@@ -0,0 +1,279 @@
+#include "Rhombus/Animation/EasingFunctions.h"
+#include "Rhombus/Animation/TweenEngine.h"
+#include "Rhombus/ECS/Components/Area2DComponent.h"
+#include "Rhombus/ECS/Components/TransformComponent.h"
+#include "Rhombus/Scenes/Scene.h"
+#include "Test.h"
+
+#include <chrono>
+
+namespace rhombus::tests
+{
+	namespace
+	{
+		const uint32_t ENTITY_COUNT = 4200;
+		const uint32_t PARALLEL_TWEENS = 150;
+		const uint32_t BENCHMARK_UPDATES = 1000;
+		const uint32_t BENCHMARK_TWEEN_COUNTS[] = { 150, 4000 };
+
+		TweenTarget GetPositionTarget(Entity entity)
+		{
+			TransformComponent& transform = entity.GetComponent<TransformComponent>();
+			return TweenTarget::Create(entity, transform, &transform.GetPositionRef());
+		}
+
+		Vec3 GetPosition(Entity entity)
+		{
+			return entity.GetComponent<TransformComponent>().GetPosition();
+		}
+
+		void SetPosition(Entity entity, const Vec3& position)
+		{
+			entity.GetComponent<TransformComponent>().SetPosition(position);
+		}
+
+		bool IsNear(float value, float expected)
+		{
+			return std::abs(value - expected) < 1e-4f;
+		}
+
+		struct TweenTiming
+		{
+			uint32_t m_tweenCount;
+			double m_updateMicroseconds;
+			double m_startMicroseconds;
+		};
+
+		// Tweens that don't finish during the updates timed, then the same number created and started from nothing
+		TweenTiming TimeTweens(TweenEngine& tweens, const std::vector<Entity>& entities, uint32_t tweenCount)
+		{
+			for (uint32_t i = 0; i < tweenCount; i++)
+			{
+				tweens.CreateTween(entities[i], TweenParameterStep(GetPositionTarget(entities[i]), Vec3(0.0f), Vec3(1.0f), 1e9f, EasingType::SINE_OUT)).Start();
+			}
+			tweens.Update(0.01f);
+
+			const std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < BENCHMARK_UPDATES; i++)
+			{
+				tweens.Update(0.001f);
+			}
+			const double updateMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - updateStart).count() / BENCHMARK_UPDATES;
+			tweens.Clear();
+
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < tweenCount; i++)
+			{
+				tweens.CreateTween(entities[i], TweenParameterStep(GetPositionTarget(entities[i]), Vec3(0.0f), Vec3(1.0f), 1.0f, EasingType::SINE_OUT)).Start();
+			}
+			const double startMicroseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+			tweens.Clear();
+
+			return { tweenCount, updateMicroseconds, startMicroseconds };
+		}
+	}
+
+	// Runs tweens through a scene's components, checking the eased values, pausing, stopping, sequences with time
+	// carried between steps, callbacks that start and stop tweens, that a finished tween's handle stays harmless once its
+	// slot is reused and that targets follow their components as they move, then times updates with many tweens running
+	void RunTweenEngineTests()
+	{
+		const int failedBefore = g_failedChecks;
+
+		Scene scene;
+		TweenEngine tweens(&scene);
+		std::vector<Entity> entities;
+		for (uint32_t i = 0; i < ENTITY_COUNT; i++)
+		{
+			entities.push_back(scene.CreateEntity());
+		}
+
+		// Many tweens at once, each with a wait and a callback alongside
+		{
+			uint32_t callbacks = 0;
+			std::vector<Tween> moves;
+			for (uint32_t i = 0; i < PARALLEL_TWEENS; i++)
+			{
+				moves.push_back(tweens.CreateTween(entities[i], TweenParameterStep(GetPositionTarget(entities[i]), Vec3(0.0f), Vec3((float)i, 2.0f * i, 1.0f), 0.6f, EasingType::SINE_OUT)));
+				moves.back().Start();
+
+				Tween wait = tweens.CreateTween(entities[i], TweenWaitStep(0.25f));
+				wait.AddTweenStep(TweenCallbackStep([&callbacks](Entity) { callbacks++; }, Entity()));
+				wait.Start();
+			}
+			RB_TEST_CHECK(tweens.GetTweenCount() == 2 * PARALLEL_TWEENS && tweens.GetLaneCount() == 4 * PARALLEL_TWEENS, "%u tweens and %u lanes running", tweens.GetTweenCount(), tweens.GetLaneCount());
+
+			tweens.Update(0.1f);
+			RB_TEST_CHECK(IsNear(GetPosition(entities[10]).x, easing::SineOut(0.1f, 0.0f, 10.0f, 0.6f)), "eased to %g", GetPosition(entities[10]).x);
+			tweens.Update(0.2f);
+			RB_TEST_CHECK(callbacks == PARALLEL_TWEENS, "%u of %u callbacks were run", callbacks, PARALLEL_TWEENS);
+
+			// A paused tween isn't written, so whatever else sets the position stays
+			moves[3].Pause();
+			SetPosition(entities[3], Vec3(-1.0f));
+			tweens.Update(0.2f);
+			RB_TEST_CHECK(GetPosition(entities[3]) == Vec3(-1.0f), "a paused tween was written");
+
+			// Nor is one that didn't move
+			SetPosition(entities[6], Vec3(-1.0f));
+			tweens.Update(0.0f);
+			RB_TEST_CHECK(GetPosition(entities[6]) == Vec3(-1.0f), "a tween was written by an update that took no time");
+
+			moves[4].Stop();
+			RB_TEST_CHECK(moves[4].GetIsFinished(), "a stopped tween isn't finished");
+			tweens.Update(0.5f);
+			RB_TEST_CHECK(GetPosition(entities[10]) == Vec3(10.0f, 20.0f, 1.0f) && moves[5].GetIsFinished(), "a tween didn't end at its finish");
+			RB_TEST_CHECK(!moves[3].GetIsFinished() && GetPosition(entities[3]) == Vec3(-1.0f), "a paused tween moved on");
+			moves[3].Resume();
+			tweens.Update(0.5f);
+			RB_TEST_CHECK(moves[3].GetIsFinished() && GetPosition(entities[3]).x == 3.0f, "a resumed tween didn't finish");
+			RB_TEST_CHECK(tweens.GetTweenCount() == 0 && tweens.GetLaneCount() == 0, "%u tweens and %u lanes left once all finished", tweens.GetTweenCount(), tweens.GetLaneCount());
+		}
+
+		// Starting writes the begin values at once
+		{
+			SetPosition(entities[20], Vec3(0.0f));
+			tweens.CreateTween(entities[20], TweenParameterStep(GetPositionTarget(entities[20]), Vec3(5.0f), Vec3(6.0f), 1.0f, EasingType::BOUNCE_OUT)).Start();
+			RB_TEST_CHECK(GetPosition(entities[20]) == Vec3(5.0f), "a started tween wasn't at its begin value until the update");
+			tweens.Clear();
+		}
+
+		// Time left over from a step carries into the next, a step with no duration goes straight to its end
+		{
+			const TweenTarget target = GetPositionTarget(entities[30]);
+			Tween sequence = tweens.CreateTween(entities[30], TweenParameterStep(target, 0.0f, 1.0f, 1.0f, EasingType::LINEAR));
+			sequence.AddTweenStep(TweenParameterStep(target, 5.0f, 6.0f, 0.0f, EasingType::LINEAR));
+			sequence.AddTweenStep(TweenParameterStep(target, 10.0f, 20.0f, 1.0f, EasingType::LINEAR));
+			sequence.Start();
+			tweens.Update(1.5f);
+			RB_TEST_CHECK(IsNear(GetPosition(entities[30]).x, 15.0f), "a sequence was at %g half way through its last step", GetPosition(entities[30]).x);
+			tweens.Update(1.0f);
+			RB_TEST_CHECK(GetPosition(entities[30]).x == 20.0f && sequence.GetIsFinished(), "a sequence didn't finish at the end of its last step");
+		}
+
+		// A callback that starts a tween and stops its own, then the stale handle is used once its slot is reused
+		{
+			Tween inner;
+			Tween outer;
+			outer = tweens.CreateTween(entities[31], TweenCallbackStep([&](Entity)
+			{
+				inner = tweens.CreateTween(entities[31], TweenParameterStep(GetPositionTarget(entities[31]), 0.0f, 1.0f, 1.0f, EasingType::BOUNCE_OUT));
+				inner.Start();
+				outer.Stop();
+			}, Entity()));
+			outer.AddTweenStep(TweenWaitStep(1.0f));
+			outer.Start();
+			RB_TEST_CHECK(outer.GetIsFinished() && !inner.GetIsFinished(), "a tween stopped by its own callback");
+			tweens.Update(2.0f);
+			RB_TEST_CHECK(GetPosition(entities[31]).x == 1.0f && inner.GetIsFinished(), "a tween started by a callback didn't finish");
+
+			Tween reused = tweens.CreateTween(entities[32], TweenWaitStep(1.0f));
+			outer.Stop();
+			RB_TEST_CHECK(!reused.GetIsFinished(), "stopping a finished tween stopped the one given its slot");
+			tweens.StopEntity(entities[32]);
+			RB_TEST_CHECK(reused.GetIsFinished() && tweens.GetTweenCount() == 0, "stopping an entity's tweens left %u running", tweens.GetTweenCount());
+
+			Tween none;
+			none.Start();
+			RB_TEST_CHECK(none.GetIsFinished(), "a handle never given a tween isn't finished");
+		}
+
+		// OnFinished is called once however the tween ends
+		{
+			uint32_t finished[4] = {};
+			Tween ran = tweens.CreateTween(entities[33], TweenWaitStep(0.5f));
+			Tween stopped = tweens.CreateTween(entities[33], TweenWaitStep(0.5f));
+			Tween entityStopped = tweens.CreateTween(entities[34], TweenWaitStep(0.5f));
+			Tween cleared = tweens.CreateTween(entities[35], TweenWaitStep(0.5f));
+			const Tween all[] = { ran, stopped, entityStopped, cleared };
+			for (uint32_t i = 0; i < 4; i++)
+			{
+				Tween tween = all[i];
+				tween.SetOnFinished([&finished, i]() { finished[i]++; });
+				tween.Start();
+			}
+
+			stopped.Stop();
+			tweens.StopEntity(entities[34]);
+			tweens.Update(1.0f);
+			tweens.Clear();
+			tweens.Update(1.0f);
+			RB_TEST_CHECK(finished[0] == 1 && finished[1] == 1 && finished[2] == 1 && finished[3] == 1, "OnFinished called %u, %u, %u and %u times", finished[0], finished[1], finished[2], finished[3]);
+
+			bool finishedAlready = false;
+			ran.SetOnFinished([&finishedAlready]() { finishedAlready = true; });
+			RB_TEST_CHECK(finishedAlready, "OnFinished on a finished tween wasn't called right away");
+		}
+
+		// Lanes stopped by a callback during the update they are evaluated in, around lanes that began part way through it
+		{
+			std::vector<Tween> longTweens;
+			for (uint32_t i = 40; i < 90; i++)
+			{
+				longTweens.push_back(tweens.CreateTween(entities[i], TweenParameterStep(GetPositionTarget(entities[i]), 0.0f, 100.0f, 10.0f, EasingType::LINEAR)));
+				longTweens.back().Start();
+			}
+
+			const TweenTarget target = GetPositionTarget(entities[35]);
+			Tween sequence = tweens.CreateTween(entities[35], TweenParameterStep(target, 0.0f, 1.0f, 0.5f, EasingType::LINEAR));
+			sequence.AddTweenStep(TweenParameterStep(target, 10.0f, 20.0f, 1.0f, EasingType::LINEAR));
+			sequence.Start();
+
+			Tween stopper = tweens.CreateTween(entities[36], TweenWaitStep(0.6f));
+			stopper.AddTweenStep(TweenCallbackStep([&longTweens](Entity) { longTweens[0].Stop(); longTweens[10].Stop(); longTweens[49].Stop(); }, Entity()));
+			stopper.Start();
+
+			tweens.Update(1.0f);
+			tweens.Update(1.0f);
+			RB_TEST_CHECK(GetPosition(entities[35]).x == 20.0f && sequence.GetIsFinished(), "a sequence begun part way through an update didn't finish");
+
+			uint32_t wrongPositions = 0;
+			for (uint32_t i = 40; i < 90; i++)
+			{
+				const bool stopped = i == 40 || i == 50 || i == 89;
+				wrongPositions += IsNear(GetPosition(entities[i]).x, stopped ? 10.0f : 20.0f) ? 0 : 1;
+			}
+			RB_TEST_CHECK(wrongPositions == 0, "%u of 50 tweens were left in the wrong place around tweens stopped by a callback", wrongPositions);
+			RB_TEST_CHECK(tweens.GetLaneCount() == 47, "%u lanes left running", tweens.GetLaneCount());
+			tweens.Clear();
+		}
+
+		// Targets are found through the registry, so a tween keeps writing its component after another is removed and
+		// the last one is moved into its place, and stops writing once its entity is destroyed
+		{
+			for (uint32_t i = 100; i < 200; i++)
+			{
+				entities[i].AddComponent<BoxArea2DComponent>();
+			}
+
+			BoxArea2DComponent& area = entities[199].GetComponent<BoxArea2DComponent>();
+			const TweenTarget target = TweenTarget::Create(entities[199], area, &area.m_size);
+			tweens.CreateTween(entities[199], TweenParameterStep(target, Vec2(0.0f), Vec2(7.0f), 1.0f, EasingType::LINEAR)).Start();
+			entities[100].RemoveComponent<BoxArea2DComponent>();
+			tweens.Update(2.0f);
+			RB_TEST_CHECK(entities[199].GetComponent<BoxArea2DComponent>().m_size == Vec2(7.0f), "a tween lost its component when the component was moved");
+
+			Entity destroyed = entities[198];
+			Tween orphan = tweens.CreateTween(destroyed, TweenParameterStep(GetPositionTarget(destroyed), Vec3(0.0f), Vec3(7.0f), 1.0f, EasingType::LINEAR));
+			orphan.Start();
+			scene.DestroyEntity(destroyed);
+			tweens.Update(2.0f);
+			RB_TEST_CHECK(orphan.GetIsFinished() && tweens.GetTweenCount() == 0, "a tween of a destroyed entity didn't finish");
+		}
+
+		TweenTiming timings[std::size(BENCHMARK_TWEEN_COUNTS)];
+		for (size_t i = 0; i < std::size(BENCHMARK_TWEEN_COUNTS); i++)
+		{
+			timings[i] = TimeTweens(tweens, entities, BENCHMARK_TWEEN_COUNTS[i]);
+		}
+
+		if (g_failedChecks == failedBefore)
+		{
+			printf("Tween engine, us per update and to create and start every tween:\n");
+			for (const TweenTiming& timing : timings)
+			{
+				printf("  %6u tweens %10.2f %10.2f\n", timing.m_tweenCount, timing.m_updateMicroseconds, timing.m_startMicroseconds);
+			}
+		}
+	}
+}
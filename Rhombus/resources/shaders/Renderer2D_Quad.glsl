@@ -10,7 +10,10 @@ layout(location = 3) in float a_TextureIndex;
 layout(location = 4) in float a_TilingFactor;
 layout(location = 5) in int a_EntityID;
 
-uniform mat4 u_ViewProjection;
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 u_ViewProjection;
+};
 
 out vec4 v_Color;
 out vec2 v_TexCoord;
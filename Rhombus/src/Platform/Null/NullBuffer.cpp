@@ -0,0 +1,37 @@
+#include "rbpch.h"
+#include "NullBuffer.h"
+
+namespace rhombus {
+
+	///////////////////////////////////////////////////////////////////////
+	// Vertex Buffer //////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	NullVertexBuffer::NullVertexBuffer(float* vertices, uint32_t size)
+		: m_Data((uint8_t*)vertices, (uint8_t*)vertices + size), m_DataSize(size)
+	{
+	}
+
+	NullVertexBuffer::NullVertexBuffer(uint32_t size)
+		: m_Data(size, 0)
+	{
+	}
+
+	void NullVertexBuffer::SetData(const void* data, uint32_t size)
+	{
+		Log::Assert(size <= m_Data.size(), "Vertex buffer upload of %u bytes exceeds buffer size of %u bytes", size, (uint32_t)m_Data.size());
+
+		size = std::min(size, (uint32_t)m_Data.size());
+		memcpy(m_Data.data(), data, size);
+		m_DataSize = size;
+	}
+
+	///////////////////////////////////////////////////////////////////////
+	// Index Buffer ///////////////////////////////////////////////////////
+	///////////////////////////////////////////////////////////////////////
+
+	NullIndexBuffer::NullIndexBuffer(uint32_t* indices, uint32_t count)
+		: m_Indices(indices, indices + count)
+	{
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Rhombus/Renderer/Buffer.h"
+
+namespace rhombus {
+
+	class NullVertexBuffer : public VertexBuffer
+	{
+	public:
+		// Static Vertex Buffer
+		NullVertexBuffer(float* vertices, uint32_t size);
+		// Dyanmic Vertex Buffer
+		NullVertexBuffer(uint32_t size);
+		virtual ~NullVertexBuffer() = default;
+
+		virtual void Bind() const override {}
+		virtual void Unbind() const override {}
+
+		virtual void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+		virtual const BufferLayout& GetLayout() const override { return m_Layout; }
+
+		virtual void SetData(const void* data, uint32_t size) override;
+
+		const uint8_t* GetData() const { return m_Data.data(); }
+		uint32_t GetDataSize() const { return m_DataSize; }
+		uint32_t GetCapacity() const { return (uint32_t)m_Data.size(); }
+	private:
+		std::vector<uint8_t> m_Data;
+		uint32_t m_DataSize = 0;		// Bytes written by the last upload
+		BufferLayout m_Layout;
+	};
+
+	class NullIndexBuffer : public IndexBuffer
+	{
+	public:
+		NullIndexBuffer(uint32_t* indices, uint32_t count);
+		virtual ~NullIndexBuffer() = default;
+
+		virtual void Bind() const {}
+		virtual void Unbind() const {}
+
+		virtual uint32_t GetCount() const { return (uint32_t)m_Indices.size(); }
+
+		const uint32_t* GetIndices() const { return m_Indices.data(); }
+	private:
+		std::vector<uint32_t> m_Indices;
+	};
+
+}
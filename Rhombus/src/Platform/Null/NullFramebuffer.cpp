@@ -0,0 +1,174 @@
+#include "rbpch.h"
+#include "NullFramebuffer.h"
+#include "NullRendererAPI.h"
+
+#include "Rhombus/Renderer/RenderCommand.h"
+
+namespace rhombus
+{
+	static const uint32_t s_MaxFramebufferSize = 8192;
+
+	namespace utils
+	{
+		static bool IsDepthFormat(FramebufferTextureFormat format)
+		{
+			switch (format)
+			{
+				case FramebufferTextureFormat::DEPTH24STENCIL8:		return true;
+			}
+
+			return false;
+		}
+	}
+
+	NullFramebuffer::NullFramebuffer(const FramebufferSpecification& spec)
+		: m_Specification(spec)
+	{
+		for (auto texSpec : m_Specification.Attachments.Attachments)
+		{
+			if (!utils::IsDepthFormat(texSpec.TextureFormat))
+				m_colorAttachmentSpecifications.emplace_back(texSpec);
+			else
+				m_depthAttachmentSpecification = texSpec;
+		}
+
+		m_RendererID = NullRendererAPI::GenerateRendererID();
+		m_colorAttachmentIDs.resize(m_colorAttachmentSpecifications.size());
+		for (size_t i = 0; i < m_colorAttachmentIDs.size(); i++)
+		{
+			m_colorAttachmentIDs[i] = NullRendererAPI::GenerateRendererID();
+		}
+
+		Invalidate();
+	}
+
+	NullFramebuffer::~NullFramebuffer()
+	{
+		if (NullRendererAPI::GetBoundFramebuffer() == this)
+		{
+			NullRendererAPI::BindFramebuffer(nullptr);
+		}
+
+		for (uint32_t id : m_colorAttachmentIDs)
+		{
+			NullRendererAPI::UnbindTexture(id);
+		}
+	}
+
+	void NullFramebuffer::Invalidate()
+	{
+		const size_t pixelCount = (size_t)m_Specification.Width * m_Specification.Height;
+
+		// Storage is reallocated so anything still sampling the old attachments must rebind
+		for (uint32_t id : m_colorAttachmentIDs)
+		{
+			NullRendererAPI::UnbindTexture(id);
+		}
+
+		m_colorAttachments.resize(m_colorAttachmentSpecifications.size());
+		for (auto& attachment : m_colorAttachments)
+		{
+			attachment.assign(pixelCount, 0);
+		}
+
+		if (m_depthAttachmentSpecification.TextureFormat != FramebufferTextureFormat::None)
+		{
+			m_depthAttachment.assign(pixelCount, 1.0f);
+		}
+
+		Log::Assert(m_colorAttachments.size() <= 4, "Exceeded the maximum of 4 color buffers!");
+	}
+
+	void NullFramebuffer::Bind()
+	{
+		NullRendererAPI::BindFramebuffer(this);
+		RenderCommand::SetViewport(0, 0, m_Specification.Width, m_Specification.Height);
+	}
+
+	void NullFramebuffer::Unbind()
+	{
+		NullRendererAPI::BindFramebuffer(nullptr);
+	}
+
+	void NullFramebuffer::BindTexture()
+	{
+		Log::Assert(!m_colorAttachments.empty(), "Framebuffer has no color attachment to bind!");
+		NullRendererAPI::BindTexture(0, { GetColorAttachmentRendererID(), m_colorAttachments[0].data(), m_Specification.Width, m_Specification.Height, true });
+	}
+
+	void NullFramebuffer::Resize(uint32_t width, uint32_t height)
+	{
+		if (width == 0 || height == 0 || width > s_MaxFramebufferSize || height > s_MaxFramebufferSize)
+		{
+			Log::Warn("Attempted to rezize framebuffer to %i, %i", width, height);
+			return;
+		}
+
+		m_Specification.Width = width;
+		m_Specification.Height = height;
+		Invalidate();
+	}
+
+	int NullFramebuffer::ReadPixel(uint32_t attachmentIndex, int x, int y)
+	{
+		Log::Assert(attachmentIndex < m_colorAttachments.size(), "Invalid attachment index!");
+		if (x < 0 || y < 0 || x >= (int)m_Specification.Width || y >= (int)m_Specification.Height)
+		{
+			return 0;
+		}
+
+		return (int)m_colorAttachments[attachmentIndex][(size_t)y * m_Specification.Width + x];
+	}
+
+	void NullFramebuffer::ReadPixelAsync(uint32_t attachmentIndex, int x, int y)
+	{
+		if (m_asyncPixelPending)
+		{
+			return;
+		}
+
+		// Nothing to wait on, keep the value so it is seen at the same point as on a GPU backend
+		m_asyncPixel = ReadPixel(attachmentIndex, x, y);
+		m_asyncPixelPending = true;
+	}
+
+	bool NullFramebuffer::GetAsyncPixel(int& outValue)
+	{
+		if (!m_asyncPixelPending)
+		{
+			return false;
+		}
+
+		outValue = m_asyncPixel;
+		m_asyncPixelPending = false;
+		return true;
+	}
+
+	void NullFramebuffer::ClearAttachment(uint32_t attachmentIndex, int value)
+	{
+		Log::Assert(attachmentIndex < m_colorAttachments.size(), "Invalid color attachment ID!");
+
+		auto& attachment = m_colorAttachments[attachmentIndex];
+		std::fill(attachment.begin(), attachment.end(), (uint32_t)value);
+	}
+
+	void NullFramebuffer::Clear(const Color& color)
+	{
+		const uint32_t packedColor = PackColor(color);
+		for (size_t i = 0; i < m_colorAttachments.size(); i++)
+		{
+			if (m_colorAttachmentSpecifications[i].TextureFormat == FramebufferTextureFormat::RGBA8)
+			{
+				std::fill(m_colorAttachments[i].begin(), m_colorAttachments[i].end(), packedColor);
+			}
+		}
+
+		std::fill(m_depthAttachment.begin(), m_depthAttachment.end(), 1.0f);
+	}
+
+	uint32_t NullFramebuffer::PackColor(const Color& color)
+	{
+		auto toByte = [](float channel) { return (uint32_t)(std::clamp(channel, 0.0f, 1.0f) * 255.0f + 0.5f); };
+		return toByte(color.r) | (toByte(color.g) << 8) | (toByte(color.b) << 16) | (toByte(color.a) << 24);
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Rhombus/Renderer/Framebuffer.h"
+#include "Rhombus/Core/Color.h"
+
+namespace rhombus
+{
+	// Framebuffer backed by plain memory. RGBA8 attachments store packed 0xAABBGGRR texels, RED_INTEGER attachments store the raw int
+	class NullFramebuffer : public Framebuffer
+	{
+	public:
+		NullFramebuffer(const FramebufferSpecification& spec);
+		virtual ~NullFramebuffer();
+
+		void Invalidate();
+
+		virtual void Bind() override;
+		virtual void Unbind() override;
+		virtual void BindTexture() override;
+
+		virtual void Resize(uint32_t width, uint32_t height) override;
+		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) override;
+		virtual void ReadPixelAsync(uint32_t attachmentIndex, int x, int y) override;
+		virtual bool GetAsyncPixel(int& outValue) override;
+
+		virtual void ClearAttachment(uint32_t attachmentIndex, int value) override;
+
+		virtual uint32_t GetColorAttachmentRendererID(uint32_t index = 0) const override { Log::Assert(index < m_colorAttachmentIDs.size(), "Invalid color attachment index!"); return m_colorAttachmentIDs[index]; }
+
+		virtual const FramebufferSpecification& GetSpecification() const override { return m_Specification; }
+
+		// Clears every RGBA8 attachment to the color and the depth attachment to the far plane
+		void Clear(const Color& color);
+
+		uint32_t GetColorAttachmentCount() const { return (uint32_t)m_colorAttachments.size(); }
+		FramebufferTextureFormat GetColorAttachmentFormat(uint32_t index) const { return m_colorAttachmentSpecifications[index].TextureFormat; }
+		uint32_t* GetColorAttachmentData(uint32_t index) { return m_colorAttachments[index].data(); }
+		const uint32_t* GetColorAttachmentData(uint32_t index) const { return m_colorAttachments[index].data(); }
+		float* GetDepthAttachmentData() { return m_depthAttachment.empty() ? nullptr : m_depthAttachment.data(); }
+
+		static uint32_t PackColor(const Color& color);
+
+	private:
+		uint32_t m_RendererID = 0;
+		FramebufferSpecification m_Specification;
+
+		std::vector<FramebufferTextureSpecification> m_colorAttachmentSpecifications;
+		FramebufferTextureSpecification m_depthAttachmentSpecification;
+
+		std::vector<uint32_t> m_colorAttachmentIDs;
+		std::vector<std::vector<uint32_t>> m_colorAttachments;
+		std::vector<float> m_depthAttachment;
+
+		bool m_asyncPixelPending = false;
+		int m_asyncPixel = 0;
+	};
+}
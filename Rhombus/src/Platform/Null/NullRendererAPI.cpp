@@ -0,0 +1,224 @@
+#include "rbpch.h"
+#include "NullRendererAPI.h"
+#include "NullBuffer.h"
+#include "NullFramebuffer.h"
+#include "NullShader.h"
+
+namespace rhombus {
+
+	struct NullRendererData
+	{
+		static const uint32_t MaxTextureSlots = 32;
+		static const uint32_t MaxUniformBufferBindings = 16;
+
+		uint32_t NextRendererID = 1;		// 0 is reserved for "nothing bound"
+		const NullShader* BoundShader = nullptr;
+		NullFramebuffer* BoundFramebuffer = nullptr;
+		std::array<NullTextureBinding, MaxTextureSlots> BoundTextures = {};
+		std::array<const NullUniformBuffer*, MaxUniformBufferBindings> BoundUniformBuffers = {};
+		NullViewport Viewport;
+
+		Color ClearColor = Color(0.0f, 0.0f, 0.0f, 0.0f);
+		float LineWidth = 1.0f;
+		uint32_t ClearCount = 0;
+		NullCallCounts CallCounts;
+
+		std::vector<NullDrawCommand> DrawCommands;
+	};
+
+	static NullRendererData s_NullData;
+
+	void NullRendererAPI::Init()
+	{
+		RB_PROFILE_FUNCTION();
+
+		ResetRecording();
+	}
+
+	void NullRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		s_NullData.Viewport = { x, y, width, height };
+	}
+
+	void NullRendererAPI::SetClearColor(const Color& color)
+	{
+		s_NullData.ClearColor = color;
+	}
+
+	void NullRendererAPI::Clear()
+	{
+		if (s_NullData.BoundFramebuffer)
+		{
+			s_NullData.BoundFramebuffer->Clear(s_NullData.ClearColor);
+		}
+
+		s_NullData.ClearCount++;
+	}
+
+	void NullRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
+	{
+		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+		RecordDraw(NullDrawCommand::Type::Indexed, vertexArray.get(), count);
+	}
+
+	void NullRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+	{
+		RecordDraw(NullDrawCommand::Type::Lines, vertexArray.get(), vertexCount);
+	}
+
+	void NullRendererAPI::DrawQuad()
+	{
+		RecordDraw(NullDrawCommand::Type::Quad, nullptr, 6);
+	}
+
+	void NullRendererAPI::SetLineWidth(float width)
+	{
+		s_NullData.LineWidth = width;
+	}
+
+	const std::vector<NullDrawCommand>& NullRendererAPI::GetDrawCommands()
+	{
+		return s_NullData.DrawCommands;
+	}
+
+	uint32_t NullRendererAPI::GetClearCount()
+	{
+		return s_NullData.ClearCount;
+	}
+
+	const Color& NullRendererAPI::GetClearColor()
+	{
+		return s_NullData.ClearColor;
+	}
+
+	float NullRendererAPI::GetLineWidth()
+	{
+		return s_NullData.LineWidth;
+	}
+
+	const NullCallCounts& NullRendererAPI::GetCallCounts()
+	{
+		return s_NullData.CallCounts;
+	}
+
+	void NullRendererAPI::ResetRecording()
+	{
+		s_NullData.DrawCommands.clear();
+		s_NullData.ClearCount = 0;
+		s_NullData.CallCounts = NullCallCounts();
+	}
+
+	uint32_t NullRendererAPI::GenerateRendererID()
+	{
+		return s_NullData.NextRendererID++;
+	}
+
+	void NullRendererAPI::BindTexture(uint32_t slot, const NullTextureBinding& binding)
+	{
+		Log::Assert(slot < NullRendererData::MaxTextureSlots, "Texture slot %u is out of range", slot);
+		if (slot < NullRendererData::MaxTextureSlots)
+		{
+			s_NullData.BoundTextures[slot] = binding;
+		}
+	}
+
+	void NullRendererAPI::UnbindTexture(uint32_t rendererID)
+	{
+		for (NullTextureBinding& binding : s_NullData.BoundTextures)
+		{
+			if (binding.RendererID == rendererID)
+			{
+				binding = NullTextureBinding();
+			}
+		}
+	}
+
+	void NullRendererAPI::BindShader(const NullShader* shader)
+	{
+		s_NullData.BoundShader = shader;
+
+		if (shader)
+		{
+			s_NullData.CallCounts.ShaderBinds++;
+		}
+	}
+
+	void NullRendererAPI::BindFramebuffer(NullFramebuffer* framebuffer)
+	{
+		s_NullData.BoundFramebuffer = framebuffer;
+	}
+
+	void NullRendererAPI::BindUniformBuffer(uint32_t binding, const NullUniformBuffer* uniformBuffer)
+	{
+		Log::Assert(binding < NullRendererData::MaxUniformBufferBindings, "Uniform buffer binding %u is out of range", binding);
+		if (binding < NullRendererData::MaxUniformBufferBindings)
+		{
+			s_NullData.BoundUniformBuffers[binding] = uniformBuffer;
+		}
+	}
+
+	void NullRendererAPI::RecordUniformUpload()
+	{
+		s_NullData.CallCounts.UniformUploads++;
+	}
+
+	void NullRendererAPI::RecordUniformBufferUpdate()
+	{
+		s_NullData.CallCounts.UniformBufferUpdates++;
+	}
+
+	const NullTextureBinding& NullRendererAPI::GetBoundTexture(uint32_t slot)
+	{
+		return s_NullData.BoundTextures[slot];
+	}
+
+	const NullShader* NullRendererAPI::GetBoundShader()
+	{
+		return s_NullData.BoundShader;
+	}
+
+	NullFramebuffer* NullRendererAPI::GetBoundFramebuffer()
+	{
+		return s_NullData.BoundFramebuffer;
+	}
+
+	const NullUniformBuffer* NullRendererAPI::GetBoundUniformBuffer(uint32_t binding)
+	{
+		return binding < NullRendererData::MaxUniformBufferBindings ? s_NullData.BoundUniformBuffers[binding] : nullptr;
+	}
+
+	const NullViewport& NullRendererAPI::GetViewport()
+	{
+		return s_NullData.Viewport;
+	}
+
+	void NullRendererAPI::RecordDraw(NullDrawCommand::Type type, const VertexArray* vertexArray, uint32_t count)
+	{
+		NullDrawCommand& command = s_NullData.DrawCommands.emplace_back();
+		command.DrawType = type;
+		command.Count = count;
+		command.ShaderID = s_NullData.BoundShader ? s_NullData.BoundShader->GetRendererID() : 0;
+		command.FramebufferID = s_NullData.BoundFramebuffer ? s_NullData.BoundFramebuffer->GetColorAttachmentRendererID() : 0;
+
+		if (vertexArray)
+		{
+			for (const Ref<VertexBuffer>& vertexBuffer : vertexArray->GetVertexBuffers())
+			{
+				command.VertexBytes += std::static_pointer_cast<NullVertexBuffer>(vertexBuffer)->GetDataSize();
+			}
+		}
+
+		// Only keep slots up to the last bound texture
+		uint32_t slotCount = NullRendererData::MaxTextureSlots;
+		while (slotCount > 0 && s_NullData.BoundTextures[slotCount - 1].RendererID == 0)
+		{
+			slotCount--;
+		}
+
+		command.BoundTextures.resize(slotCount);
+		for (uint32_t i = 0; i < slotCount; i++)
+		{
+			command.BoundTextures[i] = s_NullData.BoundTextures[i].RendererID;
+		}
+	}
+}
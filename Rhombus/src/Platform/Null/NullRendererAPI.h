@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Rhombus/Renderer/RendererAPI.h"
+
+namespace rhombus {
+
+	class NullFramebuffer;
+	class NullShader;
+	class NullUniformBuffer;
+
+	// What is bound to a texture slot. Texels are packed RGBA8 (0xAABBGGRR), bottom row first
+	struct NullTextureBinding
+	{
+		uint32_t RendererID = 0;
+		const uint32_t* Texels = nullptr;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		bool ClampToEdge = false;			// Framebuffer attachments clamp, textures repeat
+	};
+
+	struct NullViewport
+	{
+		uint32_t x = 0, y = 0, width = 0, height = 0;
+	};
+
+	// A single draw recorded by the null backend so headless runs can inspect what would have been submitted
+	struct NullDrawCommand
+	{
+		enum class Type { Indexed, Lines, Quad };
+
+		Type DrawType = Type::Indexed;
+		uint32_t Count = 0;						// Index count for indexed draws, vertex count otherwise
+		uint32_t VertexBytes = 0;				// Bytes last uploaded to the vertex buffers of the vertex array
+		uint32_t ShaderID = 0;
+		uint32_t FramebufferID = 0;
+		std::vector<uint32_t> BoundTextures;	// Renderer ID bound to each texture slot (0 if unbound)
+	};
+
+	// State changes counted since the last ResetRecording, to check how much work a frame asks of the driver
+	struct NullCallCounts
+	{
+		uint32_t ShaderBinds = 0;
+		uint32_t UniformUploads = 0;			// Individual Shader::Set* calls
+		uint32_t UniformBufferUpdates = 0;
+	};
+
+	// Headless backend that keeps every resource in memory and records draw commands instead of submitting them
+	class NullRendererAPI : public RendererAPI {
+	public:
+		virtual void Init() override;
+		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+
+		virtual void SetClearColor(const Color& color) override;
+		virtual void Clear() override;
+
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		virtual void DrawQuad() override;
+
+		virtual void SetLineWidth(float width) override;
+
+		// Recorded state
+		static const std::vector<NullDrawCommand>& GetDrawCommands();
+		static uint32_t GetClearCount();
+		static const Color& GetClearColor();
+		static float GetLineWidth();
+		static const NullCallCounts& GetCallCounts();
+		static void ResetRecording();
+
+		// Called by the null resources to mirror the binding state of a real context
+		static uint32_t GenerateRendererID();
+		static void BindTexture(uint32_t slot, const NullTextureBinding& binding);
+		static void UnbindTexture(uint32_t rendererID);
+		static void BindShader(const NullShader* shader);
+		static void BindFramebuffer(NullFramebuffer* framebuffer);
+		static void BindUniformBuffer(uint32_t binding, const NullUniformBuffer* uniformBuffer);
+		static void RecordUniformUpload();
+		static void RecordUniformBufferUpdate();
+		static const NullTextureBinding& GetBoundTexture(uint32_t slot);
+		static const NullShader* GetBoundShader();
+		static NullFramebuffer* GetBoundFramebuffer();
+		static const NullUniformBuffer* GetBoundUniformBuffer(uint32_t binding);
+		static const NullViewport& GetViewport();
+
+	protected:
+		static void RecordDraw(NullDrawCommand::Type type, const VertexArray* vertexArray, uint32_t count);
+	};
+}
@@ -0,0 +1,155 @@
+#include "rbpch.h"
+#include "NullShader.h"
+#include "NullRendererAPI.h"
+
+namespace rhombus {
+
+	NullShader::NullShader(const std::string& filepath)
+		: m_RendererID(NullRendererAPI::GenerateRendererID())
+	{
+		// Extract name from filepath
+		// resources/shaders/Texture.glsl
+		auto lastSlash = filepath.find_last_of("/\\");
+		lastSlash = lastSlash == std::string::npos ? 0 : lastSlash + 1;
+		auto lastDot = filepath.rfind('.');
+		auto count = lastDot == std::string::npos ? filepath.size() - lastSlash : lastDot - lastSlash;
+		m_Name = filepath.substr(lastSlash, count);
+	}
+
+	NullShader::NullShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc)
+		: m_RendererID(NullRendererAPI::GenerateRendererID()), m_Name(name)
+	{
+	}
+
+	NullShader::~NullShader()
+	{
+		if (NullRendererAPI::GetBoundShader() == this)
+		{
+			NullRendererAPI::BindShader(nullptr);
+		}
+	}
+
+	void NullShader::Bind() const
+	{
+		NullRendererAPI::BindShader(this);
+	}
+
+	void NullShader::Unbind() const
+	{
+		NullRendererAPI::BindShader(nullptr);
+	}
+
+	void NullShader::SetInt(const std::string& name, int value)
+	{
+		NullRendererAPI::RecordUniformUpload();
+		m_IntUniforms[name].assign(1, value);
+	}
+
+	void NullShader::SetIntArray(const std::string& name, int* values, uint32_t count)
+	{
+		NullRendererAPI::RecordUniformUpload();
+		m_IntUniforms[name].assign(values, values + count);
+	}
+
+	void NullShader::SetFloat(const std::string& name, const float value)
+	{
+		NullRendererAPI::RecordUniformUpload();
+		m_FloatUniforms[name].assign(1, value);
+	}
+
+	void NullShader::SetFloat2(const std::string& name, const Vec2& value)
+	{
+		NullRendererAPI::RecordUniformUpload();
+		m_FloatUniforms[name].assign({ value.x, value.y });
+	}
+
+	void NullShader::SetFloat3(const std::string& name, const Vec3& value)
+	{
+		NullRendererAPI::RecordUniformUpload();
+		m_FloatUniforms[name].assign({ value.x, value.y, value.z });
+	}
+
+	void NullShader::SetFloat4(const std::string& name, const Vec4& value)
+	{
+		NullRendererAPI::RecordUniformUpload();
+		m_FloatUniforms[name].assign({ value.x, value.y, value.z, value.w });
+	}
+
+	void NullShader::SetMat4(const std::string& name, const Mat4& value)
+	{
+		NullRendererAPI::RecordUniformUpload();
+		const float* data = value.ToPtr();
+		m_FloatUniforms[name].assign(data, data + 16);
+	}
+
+	UniformHandle NullShader::GetUniformHandle(const std::string& name) const
+	{
+		for (size_t i = 0; i < m_UniformNames.size(); i++)
+		{
+			if (m_UniformNames[i] == name)
+				return { (int32_t)i };
+		}
+
+		m_UniformNames.push_back(name);
+		return { (int32_t)m_UniformNames.size() - 1 };
+	}
+
+	const std::string* NullShader::GetHandleName(UniformHandle handle) const
+	{
+		return handle.IsValid() && (size_t)handle.Location < m_UniformNames.size() ? &m_UniformNames[handle.Location] : nullptr;
+	}
+
+	void NullShader::SetInt(UniformHandle handle, int value)
+	{
+		if (const std::string* name = GetHandleName(handle))
+			SetInt(*name, value);
+	}
+
+	void NullShader::SetIntArray(UniformHandle handle, int* values, uint32_t count)
+	{
+		if (const std::string* name = GetHandleName(handle))
+			SetIntArray(*name, values, count);
+	}
+
+	void NullShader::SetFloat(UniformHandle handle, const float value)
+	{
+		if (const std::string* name = GetHandleName(handle))
+			SetFloat(*name, value);
+	}
+
+	void NullShader::SetFloat2(UniformHandle handle, const Vec2& value)
+	{
+		if (const std::string* name = GetHandleName(handle))
+			SetFloat2(*name, value);
+	}
+
+	void NullShader::SetFloat3(UniformHandle handle, const Vec3& value)
+	{
+		if (const std::string* name = GetHandleName(handle))
+			SetFloat3(*name, value);
+	}
+
+	void NullShader::SetFloat4(UniformHandle handle, const Vec4& value)
+	{
+		if (const std::string* name = GetHandleName(handle))
+			SetFloat4(*name, value);
+	}
+
+	void NullShader::SetMat4(UniformHandle handle, const Mat4& value)
+	{
+		if (const std::string* name = GetHandleName(handle))
+			SetMat4(*name, value);
+	}
+
+	const std::vector<int>* NullShader::GetIntUniform(const std::string& name) const
+	{
+		auto it = m_IntUniforms.find(name);
+		return it != m_IntUniforms.end() ? &it->second : nullptr;
+	}
+
+	const std::vector<float>* NullShader::GetFloatUniform(const std::string& name) const
+	{
+		auto it = m_FloatUniforms.find(name);
+		return it != m_FloatUniforms.end() ? &it->second : nullptr;
+	}
+}
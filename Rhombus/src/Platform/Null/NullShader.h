@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Rhombus/Renderer/Shader.h"
+
+namespace rhombus {
+
+	// Shader that does not compile anything, uniform values are kept so tests can inspect what was uploaded
+	class NullShader : public Shader
+	{
+	public:
+		NullShader(const std::string& filepath);
+		NullShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
+		virtual ~NullShader();
+
+		virtual void Bind() const override;
+		virtual void Unbind() const override;
+
+		virtual void SetInt(const std::string& name, int value) override;
+		virtual void SetIntArray(const std::string& name, int* values, uint32_t count) override;
+		virtual void SetFloat(const std::string& name, const float value) override;
+		virtual void SetFloat2(const std::string& name, const Vec2& value) override;
+		virtual void SetFloat3(const std::string& name, const Vec3& value) override;
+		virtual void SetFloat4(const std::string& name, const Vec4& value) override;
+		virtual void SetMat4(const std::string& name, const Mat4& value) override;
+
+		// Nothing is compiled to reflect, so every name gets a handle the first time it is asked for
+		virtual UniformHandle GetUniformHandle(const std::string& name) const override;
+
+		virtual void SetInt(UniformHandle handle, int value) override;
+		virtual void SetIntArray(UniformHandle handle, int* values, uint32_t count) override;
+		virtual void SetFloat(UniformHandle handle, const float value) override;
+		virtual void SetFloat2(UniformHandle handle, const Vec2& value) override;
+		virtual void SetFloat3(UniformHandle handle, const Vec3& value) override;
+		virtual void SetFloat4(UniformHandle handle, const Vec4& value) override;
+		virtual void SetMat4(UniformHandle handle, const Mat4& value) override;
+
+		virtual const std::string& GetName() const override { return m_Name; }
+
+		uint32_t GetRendererID() const { return m_RendererID; }
+
+		// Returns nullptr if the uniform has never been set
+		const std::vector<int>* GetIntUniform(const std::string& name) const;
+		const std::vector<float>* GetFloatUniform(const std::string& name) const;
+
+	private:
+		const std::string* GetHandleName(UniformHandle handle) const;
+
+	private:
+		uint32_t m_RendererID;
+		std::string m_Name;
+		std::unordered_map<std::string, std::vector<int>> m_IntUniforms;
+		std::unordered_map<std::string, std::vector<float>> m_FloatUniforms;
+		mutable std::vector<std::string> m_UniformNames;			// Indexed by handle location
+	};
+}
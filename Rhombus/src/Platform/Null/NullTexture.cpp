@@ -0,0 +1,86 @@
+#include "rbpch.h"
+#include "NullTexture.h"
+#include "NullRendererAPI.h"
+
+#include "stb_image.h"
+
+namespace rhombus {
+
+	NullTexture2D::NullTexture2D(uint32_t width, uint32_t height)
+		: m_Width(width), m_Height(height), m_RendererID(NullRendererAPI::GenerateRendererID())
+	{
+		RB_PROFILE_FUNCTION();
+
+		m_Pixels.resize((size_t)m_Width * m_Height * 4, 0);
+	}
+
+	NullTexture2D::NullTexture2D(const TextureImage& image, const std::string& path)
+		: m_Path(path), m_RendererID(NullRendererAPI::GenerateRendererID())
+	{
+		RB_PROFILE_FUNCTION();
+
+		SetImage(image);
+	}
+
+	NullTexture2D::NullTexture2D(const std::string& path)
+		: m_Path(path), m_RendererID(NullRendererAPI::GenerateRendererID())
+	{
+		RB_PROFILE_FUNCTION();
+
+		// Load image, always expanded to RGBA so sampling does not need to care about the source format
+		int width, height, channels;
+		stbi_set_flip_vertically_on_load(1);		// Match the OpenGL backend's row order
+		stbi_uc* data = nullptr;
+		{
+			RB_PROFILE_SCOPE("stbi_load - NullTexture2D::NullTexture2D(const std::string&)");
+			data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+		}
+
+		if (data)
+		{
+			m_IsLoaded = true;
+			m_Width = width;
+			m_Height = height;
+			m_Pixels.assign(data, data + (size_t)m_Width * m_Height * 4);
+			UpdateVisibilityMask(m_Pixels.data(), m_Width, m_Height, 4);
+
+			stbi_image_free(data);
+		}
+		else
+		{
+			m_LoadState = TextureLoadState::Failed;
+		}
+	}
+
+	NullTexture2D::~NullTexture2D()
+	{
+		NullRendererAPI::UnbindTexture(m_RendererID);
+	}
+
+	void NullTexture2D::SetData(void* data, uint32_t size)
+	{
+		RB_PROFILE_FUNCTION();
+
+		Log::Assert(size == m_Pixels.size(), "Data must be entire texture!");
+		memcpy(m_Pixels.data(), data, std::min((size_t)size, m_Pixels.size()));
+		UpdateVisibilityMask(m_Pixels.data(), m_Width, m_Height, 4);
+	}
+
+	void NullTexture2D::SetImage(const TextureImage& image)
+	{
+		RB_PROFILE_FUNCTION();
+
+		Log::Assert(image.Pixels.size() == (size_t)image.Width * image.Height * 4, "Texture images must be RGBA8");
+
+		m_Width = image.Width;
+		m_Height = image.Height;
+		m_Pixels = image.Pixels;
+		m_IsLoaded = true;
+		UpdateVisibilityMask(m_Pixels.data(), m_Width, m_Height, 4);
+	}
+
+	void NullTexture2D::Bind(uint32_t slot) const
+	{
+		NullRendererAPI::BindTexture(slot, { m_RendererID, (const uint32_t*)m_Pixels.data(), m_Width, m_Height, false });
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Rhombus/Renderer/Texture.h"
+
+namespace rhombus {
+
+	// Texture that keeps its pixels in memory as tightly packed RGBA8, bottom row first like OpenGL
+	class NullTexture2D : public Texture2D
+	{
+	public:
+		NullTexture2D(const std::string& path);
+		NullTexture2D(uint32_t width, uint32_t height);
+		NullTexture2D(const TextureImage& image, const std::string& path);
+		virtual ~NullTexture2D();
+
+		virtual uint32_t GetWidth() const override { return m_Width; }
+		virtual uint32_t GetHeight() const override { return m_Height; }
+		virtual uint32_t GetRendererID() const override { return m_RendererID; }
+		virtual std::string GetPath() const override { return m_Path; }
+
+		virtual void SetData(void* data, uint32_t size) override;
+		virtual void SetImage(const TextureImage& image) override;
+
+		virtual void Bind(uint32_t slot = 0) const override;
+
+		virtual bool IsLoaded() const override { return m_IsLoaded; }
+
+		virtual bool operator==(const Texture& other) const override
+		{
+			return m_RendererID == other.GetRendererID();
+		}
+
+		const uint8_t* GetPixels() const { return m_Pixels.data(); }
+
+	private:
+		std::string m_Path;
+		bool m_IsLoaded = false;
+		uint32_t m_Width = 0, m_Height = 0;
+		uint32_t m_RendererID;
+		std::vector<uint8_t> m_Pixels;
+	};
+}
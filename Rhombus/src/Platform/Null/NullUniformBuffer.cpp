@@ -0,0 +1,31 @@
+#include "rbpch.h"
+#include "NullUniformBuffer.h"
+#include "NullRendererAPI.h"
+
+namespace rhombus {
+
+	NullUniformBuffer::NullUniformBuffer(uint32_t size, uint32_t binding)
+		: m_Data(size, 0), m_Binding(binding)
+	{
+		NullRendererAPI::BindUniformBuffer(binding, this);
+	}
+
+	NullUniformBuffer::~NullUniformBuffer()
+	{
+		if (NullRendererAPI::GetBoundUniformBuffer(m_Binding) == this)
+		{
+			NullRendererAPI::BindUniformBuffer(m_Binding, nullptr);
+		}
+	}
+
+	void NullUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		Log::Assert(offset + size <= m_Data.size(), "Uniform buffer upload of %u bytes at offset %u exceeds buffer size of %u bytes", size, offset, (uint32_t)m_Data.size());
+
+		if (offset + size > m_Data.size())
+			return;
+
+		memcpy(m_Data.data() + offset, data, size);
+		NullRendererAPI::RecordUniformBufferUpdate();
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Rhombus/Renderer/UniformBuffer.h"
+
+namespace rhombus {
+
+	class NullUniformBuffer : public UniformBuffer
+	{
+	public:
+		NullUniformBuffer(uint32_t size, uint32_t binding);
+		virtual ~NullUniformBuffer();
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+
+		const uint8_t* GetData() const { return m_Data.data(); }
+		uint32_t GetSize() const { return (uint32_t)m_Data.size(); }
+		uint32_t GetBinding() const { return m_Binding; }
+	private:
+		std::vector<uint8_t> m_Data;
+		uint32_t m_Binding = 0;
+	};
+}
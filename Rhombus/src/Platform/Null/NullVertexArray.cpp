@@ -0,0 +1,23 @@
+#include "rbpch.h"
+#include "NullVertexArray.h"
+#include "NullRendererAPI.h"
+
+namespace rhombus {
+
+	NullVertexArray::NullVertexArray()
+		: m_RendererID(NullRendererAPI::GenerateRendererID())
+	{
+	}
+
+	void NullVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+	{
+		Log::Assert(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
+
+		m_VertexBuffers.push_back(vertexBuffer);
+	}
+
+	void NullVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
+	{
+		m_IndexBuffer = indexBuffer;
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Rhombus/Renderer/VertexArray.h"
+
+namespace rhombus {
+
+	class NullVertexArray : public VertexArray
+	{
+	public:
+		NullVertexArray();
+		virtual ~NullVertexArray() = default;
+
+		virtual void Bind() const override {}
+		virtual void Unbind() const override {}
+
+		virtual void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override;
+		virtual void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override;
+
+		virtual const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const { return m_VertexBuffers; }
+		virtual const Ref<IndexBuffer>& GetIndexBuffer() const { return m_IndexBuffer; }
+
+		uint32_t GetRendererID() const { return m_RendererID; }
+	private:
+		uint32_t m_RendererID;
+		std::vector<Ref<VertexBuffer>> m_VertexBuffers;
+		Ref<IndexBuffer> m_IndexBuffer;
+	};
+}
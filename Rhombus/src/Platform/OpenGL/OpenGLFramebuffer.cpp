@@ -109,6 +109,12 @@ namespace rhombus
 		glDeleteFramebuffers(1, &m_RendererID);
 		glDeleteTextures((GLsizei)m_colorAttachmentIDs.size(), m_colorAttachmentIDs.data());
 		glDeleteTextures((GLsizei)1, &m_depthAttachmentID);
+
+		if (m_pixelReadFence)
+		{
+			glDeleteSync((GLsync)m_pixelReadFence);
+		}
+		glDeleteBuffers(1, &m_pixelPackBufferID);
 	}
 
 	void OpenGLFramebuffer::Invalidate()
@@ -216,6 +222,50 @@ namespace rhombus
 		return pixelData;
 	}
 
+	void OpenGLFramebuffer::ReadPixelAsync(uint32_t attachmentIndex, int x, int y)
+	{
+		Log::Assert(attachmentIndex < m_colorAttachmentIDs.size(), "Invalid attachment index!");
+		if (m_pixelReadFence)
+		{
+			return;
+		}
+
+		if (m_pixelPackBufferID == 0)
+		{
+			glCreateBuffers(1, &m_pixelPackBufferID);
+			glNamedBufferData(m_pixelPackBufferID, sizeof(int), nullptr, GL_STREAM_READ);
+		}
+
+		// Reading into a pixel pack buffer returns straight away, the fence tells us when the copy is done
+		glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelPackBufferID);
+		glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		m_pixelReadFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	bool OpenGLFramebuffer::GetAsyncPixel(int& outValue)
+	{
+		if (!m_pixelReadFence)
+		{
+			return false;
+		}
+
+		GLsync fence = (GLsync)m_pixelReadFence;
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+		{
+			return false;
+		}
+
+		glDeleteSync(fence);
+		m_pixelReadFence = nullptr;
+
+		glGetNamedBufferSubData(m_pixelPackBufferID, 0, sizeof(int), &outValue);
+		return true;
+	}
+
 	void OpenGLFramebuffer::ClearAttachment(uint32_t attachmentIndex, int value)
 	{
 		Log::Assert(attachmentIndex < m_colorAttachmentIDs.size(), "Invalid color attachment ID!");
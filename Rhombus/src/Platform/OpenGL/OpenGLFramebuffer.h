@@ -18,6 +18,8 @@ namespace rhombus
 
 		virtual void Resize(uint32_t width, uint32_t height) override;
 		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) override;
+		virtual void ReadPixelAsync(uint32_t attachmentIndex, int x, int y) override;
+		virtual bool GetAsyncPixel(int& outValue) override;
 
 		virtual void ClearAttachment(uint32_t attachmentIndex, int value) override;
 
@@ -33,5 +35,8 @@ namespace rhombus
 
 		std::vector<uint32_t> m_colorAttachmentIDs;
 		uint32_t m_depthAttachmentID = 0;
+
+		uint32_t m_pixelPackBufferID = 0;
+		void* m_pixelReadFence = nullptr;		// GLsync
 	};
 }
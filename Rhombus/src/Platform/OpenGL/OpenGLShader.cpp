@@ -150,6 +150,54 @@ namespace rhombus {
 
 		// Now time to link them together into a program.
 		m_RendererID = program;
+
+		ReflectUniforms();
+	}
+
+	void OpenGLShader::ReflectUniforms()
+	{
+		RB_PROFILE_FUNCTION();
+
+		m_UniformLocations.clear();
+
+		GLint uniformCount = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &uniformCount);
+		GLint maxNameLength = 0;
+		glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+		std::vector<GLchar> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			GLint size = 0;
+			GLenum type = 0;
+			GLsizei length = 0;
+			glGetActiveUniform(m_RendererID, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+
+			std::string name(nameBuffer.data(), length);
+			GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+
+			// Uniforms inside blocks have no location
+			if (location < 0)
+				continue;
+
+			m_UniformLocations[name] = location;
+
+			// Arrays are reported as "name[0]", allow them to be set by their plain name too
+			size_t bracket = name.find('[');
+			if (bracket != std::string::npos)
+				m_UniformLocations[name.substr(0, bracket)] = location;
+		}
+	}
+
+	int32_t OpenGLShader::GetUniformLocation(const std::string& name) const
+	{
+		auto it = m_UniformLocations.find(name);
+		return it != m_UniformLocations.end() ? it->second : -1;
+	}
+
+	UniformHandle OpenGLShader::GetUniformHandle(const std::string& name) const
+	{
+		return { GetUniformLocation(name) };
 	}
 
 	std::string OpenGLShader::ReadFile(const std::string& filepath)
@@ -263,53 +311,88 @@ namespace rhombus {
 		UploadUniformMat4(name, value);
 	}
 
+	void OpenGLShader::SetInt(UniformHandle handle, int value)
+	{
+		glUniform1i(handle.Location, value);
+	}
+
+	void OpenGLShader::SetIntArray(UniformHandle handle, int* values, uint32_t count)
+	{
+		glUniform1iv(handle.Location, count, values);
+	}
+
+	void OpenGLShader::SetFloat(UniformHandle handle, const float value)
+	{
+		glUniform1f(handle.Location, value);
+	}
+
+	void OpenGLShader::SetFloat2(UniformHandle handle, const Vec2& value)
+	{
+		glUniform2f(handle.Location, value.x, value.y);
+	}
+
+	void OpenGLShader::SetFloat3(UniformHandle handle, const Vec3& value)
+	{
+		glUniform3f(handle.Location, value.x, value.y, value.z);
+	}
+
+	void OpenGLShader::SetFloat4(UniformHandle handle, const Vec4& value)
+	{
+		glUniform4f(handle.Location, value.x, value.y, value.z, value.w);
+	}
+
+	void OpenGLShader::SetMat4(UniformHandle handle, const Mat4& value)
+	{
+		glUniformMatrix4fv(handle.Location, 1, GL_FALSE, value.ToPtr());
+	}
+
 	void OpenGLShader::UploadUniformInt(const std::string& name, int value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1i(location, value);
 	}
 
 	void OpenGLShader::UploadUniformIntArray(const std::string& name, int* values, uint32_t count)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1iv(location, count, values);
 	}
 
 	void OpenGLShader::UploadUniformFloat(const std::string& name, const float value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform1f(location, value);
 	}
 
 	void OpenGLShader::UploadUniformFloat2(const std::string& name, const Vec2& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform2f(location, value.x, value.y);
 	}
 
 	void OpenGLShader::UploadUniformFloat3(const std::string& name, const Vec3& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		glUniform3f(location, value.x, value.y, value.z);
 	}
 
 	void OpenGLShader::UploadUniformFloat4(const std::string& name, const Vec4& value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		// f in this function name means "float"
 		glUniform4f(location, value.x, value.y, value.z, value.w);
 	}
 
 	void OpenGLShader::UploadUniformMat3(const std::string& name, const Mat3& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		// f in this function name means "float" and v means "array of" floats
 		glUniformMatrix3fv(location, 1, GL_FALSE, matrix.ToPtr());
 	}
 
 	void OpenGLShader::UploadUniformMat4(const std::string& name, const Mat4& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
+		GLint location = GetUniformLocation(name);
 		// f in this function name means "float" and v means "array of" floats
 		glUniformMatrix4fv(location, 1, GL_FALSE, matrix.ToPtr());
 	}
@@ -25,6 +25,16 @@ namespace rhombus {
 		virtual void SetFloat4(const std::string& name, const Vec4& value) override;
 		virtual void SetMat4(const std::string& name, const Mat4& value) override;
 
+		virtual UniformHandle GetUniformHandle(const std::string& name) const override;
+
+		virtual void SetInt(UniformHandle handle, int value) override;
+		virtual void SetIntArray(UniformHandle handle, int* values, uint32_t count) override;
+		virtual void SetFloat(UniformHandle handle, const float value) override;
+		virtual void SetFloat2(UniformHandle handle, const Vec2& value) override;
+		virtual void SetFloat3(UniformHandle handle, const Vec3& value) override;
+		virtual void SetFloat4(UniformHandle handle, const Vec4& value) override;
+		virtual void SetMat4(UniformHandle handle, const Mat4& value) override;
+
 		virtual const std::string& GetName() const override { return m_Name; }
 
 		void UploadUniformInt(const std::string& name, int value);
@@ -41,8 +51,11 @@ namespace rhombus {
 		std::string ReadFile(const std::string& filepath);
 		std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
 		void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+		void ReflectUniforms();
+		int32_t GetUniformLocation(const std::string& name) const;
 	private:
 		uint32_t m_RendererID;		// Number that identifies this object in OpenGL
 		std::string m_Name;
+		std::unordered_map<std::string, int32_t> m_UniformLocations;		// Filled from the active uniforms after linking
 	};
 }
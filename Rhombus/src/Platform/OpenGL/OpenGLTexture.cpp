@@ -13,16 +13,15 @@ namespace rhombus {
 		m_InternalFormat = GL_RGBA8;
 		m_DataFormat = GL_RGBA;
 
-		// Upload to OpenGL
-		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-		glTextureStorage2D(m_RendererID, 1, m_InternalFormat, m_Width, m_Height);
+		CreateStorage();
+	}
 
-		// Defining parameters (for scaling)
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	OpenGLTexture2D::OpenGLTexture2D(const TextureImage& image, const std::string& path)
+		: m_Path(path)
+	{
+		RB_PROFILE_FUNCTION();
 
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		SetImage(image);
 	}
 
 	OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
@@ -64,22 +63,19 @@ namespace rhombus {
 			Log::Assert(internalFormat & dataFormat, "Format not supported!");
 
 			// Upload to OpenGL
-			glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-			glTextureStorage2D(m_RendererID, 1, internalFormat, m_Width, m_Height);
-
-			// Defining parameters (for scaling)
-			glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-			glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
-			glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			CreateStorage();
 
 			// Upload Texture
 			glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, dataFormat, GL_UNSIGNED_BYTE, data);
+			UpdateVisibilityMask(data, m_Width, m_Height, channels);
 
 			// Deallocate memory
 			stbi_image_free(data);
 		}
+		else
+		{
+			m_LoadState = TextureLoadState::Failed;
+		}
 	}
 
 	OpenGLTexture2D::~OpenGLTexture2D()
@@ -96,6 +92,45 @@ namespace rhombus {
 		uint32_t bytesPerPixel = m_DataFormat == GL_RGBA ? 4 : 3;
 		Log::Assert(size = m_Width * m_Height * bytesPerPixel, "Data must be entire texture!");
 		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data);
+		UpdateVisibilityMask((const uint8_t*)data, m_Width, m_Height, bytesPerPixel);
+	}
+
+	void OpenGLTexture2D::SetImage(const TextureImage& image)
+	{
+		RB_PROFILE_FUNCTION();
+
+		Log::Assert(image.Pixels.size() == (size_t)image.Width * image.Height * 4, "Texture images must be RGBA8");
+
+		// Storage is immutable so a new size means a new texture object
+		if (m_RendererID)
+		{
+			glDeleteTextures(1, &m_RendererID);
+			m_RendererID = 0;
+		}
+
+		m_Width = image.Width;
+		m_Height = image.Height;
+		m_InternalFormat = GL_RGBA8;
+		m_DataFormat = GL_RGBA;
+
+		CreateStorage();
+		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, image.Pixels.data());
+		UpdateVisibilityMask(image.Pixels.data(), m_Width, m_Height, 4);
+
+		m_IsLoaded = true;
+	}
+
+	void OpenGLTexture2D::CreateStorage()
+	{
+		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
+		glTextureStorage2D(m_RendererID, 1, m_InternalFormat, m_Width, m_Height);
+
+		// Defining parameters (for scaling)
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
 	}
 
 	void OpenGLTexture2D::Bind(uint32_t slot) const
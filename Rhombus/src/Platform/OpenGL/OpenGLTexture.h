@@ -10,6 +10,7 @@ namespace rhombus {
 	public:
 		OpenGLTexture2D(const std::string& path);
 		OpenGLTexture2D(uint32_t width, uint32_t height);
+		OpenGLTexture2D(const TextureImage& image, const std::string& path);
 		virtual ~OpenGLTexture2D();
 
 		virtual uint32_t GetWidth() const override { return m_Width; }
@@ -18,6 +19,7 @@ namespace rhombus {
 		virtual std::string GetPath() const override { return m_Path; }
 
 		virtual void SetData(void* data, uint32_t size) override;
+		virtual void SetImage(const TextureImage& image) override;
 
 		virtual void Bind(uint32_t slot = 0) const override;
 
@@ -28,11 +30,14 @@ namespace rhombus {
 			return m_RendererID == other.GetRendererID();
 		}
 
+	private:
+		void CreateStorage();
+
 	private:
 		std::string m_Path;
 		bool m_IsLoaded = false;
 		uint32_t m_Width, m_Height;
-		uint32_t m_RendererID;
+		uint32_t m_RendererID = 0;
 		GLenum m_InternalFormat, m_DataFormat;
 	};
 }
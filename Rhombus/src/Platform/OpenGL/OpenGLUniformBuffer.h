@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Rhombus/Renderer/UniformBuffer.h"
+
+namespace rhombus {
+
+	class OpenGLUniformBuffer : public UniformBuffer
+	{
+	public:
+		OpenGLUniformBuffer(uint32_t size, uint32_t binding);
+		virtual ~OpenGLUniformBuffer();
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+	private:
+		uint32_t m_RendererID = 0;
+	};
+}
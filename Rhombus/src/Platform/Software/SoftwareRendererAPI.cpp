@@ -0,0 +1,1038 @@
+#include "rbpch.h"
+#include "SoftwareRendererAPI.h"
+
+#include "Platform/Null/NullBuffer.h"
+#include "Platform/Null/NullFramebuffer.h"
+#include "Platform/Null/NullShader.h"
+#include "Platform/Null/NullUniformBuffer.h"
+#include "Rhombus/Core/JobSystem.h"
+
+#include <fstream>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#define RB_SOFTWARE_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define RB_SOFTWARE_SSE2 0
+#endif
+
+namespace rhombus {
+
+	static const int s_TileSize = 64;
+	static const uint32_t s_SetupBatchSize = 1024;
+	static const uint32_t s_MaxAttributes = 8;
+
+	// Which Renderer2D shader the bound null shader stands in for
+	enum class RasterProgram
+	{
+		Unknown = 0, Quad, Circle, Line, Screen
+	};
+
+	struct RasterVertex
+	{
+		float x, y;								// Window coordinates
+		float invW;
+		float Attributes[s_MaxAttributes];		// Pre-multiplied by invW for perspective correct interpolation unless the triangle is affine
+	};
+
+	struct RasterTriangle
+	{
+		RasterVertex Vertices[3];
+		float A[3], B[3], C[3];					// Edge functions, the edge opposite vertex i gives its barycentric weight
+		bool IncludeEdge[3];					// Tie breaking so shared edges are only drawn once
+		float InvA[3];
+		float InvArea;
+		int MinX, MinY, MaxX, MaxY;				// Inclusive pixel bounds
+		int TextureSlot;
+		int EntityID;
+		bool ConstantColor;
+		float Color[4];
+		bool Affine;							// Equal w on every vertex (any orthographic camera), attributes are planes in screen space
+		float Planes[s_MaxAttributes][3];		// Attribute = Planes[a][0] * x + Planes[a][1] * y + Planes[a][2] when affine
+		bool Valid;
+	};
+
+	struct RenderTarget
+	{
+		uint32_t* Color = nullptr;
+		int32_t* EntityIDs = nullptr;
+		int Width = 0, Height = 0;
+		int ClipMinX = 0, ClipMinY = 0, ClipMaxX = 0, ClipMaxY = 0;		// Viewport clipped to the target, max is exclusive
+	};
+
+	struct SoftwareRendererData
+	{
+		Scope<NullFramebuffer> DefaultFramebuffer;
+
+		// Scratch storage reused between draws
+		std::vector<RasterTriangle> Triangles;
+		std::vector<std::vector<uint32_t>> TileBins;
+	};
+
+	static SoftwareRendererData s_SoftwareData;
+
+	namespace utils
+	{
+		static RasterProgram GetRasterProgram(const NullShader* shader)
+		{
+			if (!shader)
+				return RasterProgram::Unknown;
+
+			const std::string& name = shader->GetName();
+			if (name == "Renderer2D_Quad")		return RasterProgram::Quad;
+			if (name == "Renderer2D_Circle")	return RasterProgram::Circle;
+			if (name == "Renderer2D_Line")		return RasterProgram::Line;
+			if (name == "Renderer2D_Screen")	return RasterProgram::Screen;
+
+			return RasterProgram::Unknown;
+		}
+
+		// Column major matrix from the camera uniform block, or from a plain uniform for shaders without the block
+		static const float* GetViewProjection(const NullShader* shader)
+		{
+			const NullUniformBuffer* camera = NullRendererAPI::GetBoundUniformBuffer(UniformBuffer::CameraBinding);
+			if (camera && camera->GetSize() >= 16 * sizeof(float))
+				return (const float*)camera->GetData();
+
+			const std::vector<float>* viewProjection = shader ? shader->GetFloatUniform("u_ViewProjection") : nullptr;
+			return viewProjection && viewProjection->size() >= 16 ? viewProjection->data() : nullptr;
+		}
+
+		static int FindAttributeOffset(const BufferLayout& layout, const char* name)
+		{
+			for (const BufferElement& element : layout)
+			{
+				if (element.Name == name)
+					return (int)element.Offset;
+			}
+
+			Log::Assert(false, "Vertex layout is missing attribute %s", name);
+			return -1;
+		}
+
+		static inline float ReadFloat(const uint8_t* vertex, int offset)
+		{
+			float value;
+			memcpy(&value, vertex + offset, sizeof(float));
+			return value;
+		}
+
+		static inline int ReadInt(const uint8_t* vertex, int offset)
+		{
+			int value;
+			memcpy(&value, vertex + offset, sizeof(int));
+			return value;
+		}
+
+		// Column major like Mat4::ToPtr()
+		static inline void TransformPoint(const float* m, float x, float y, float z, float out[4])
+		{
+			for (int r = 0; r < 4; r++)
+			{
+				out[r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r];
+			}
+		}
+
+		static inline void UnpackColor(uint32_t packed, float out[4])
+		{
+			const float scale = 1.0f / 255.0f;
+			out[0] = (float)(packed & 0xFF) * scale;
+			out[1] = (float)((packed >> 8) & 0xFF) * scale;
+			out[2] = (float)((packed >> 16) & 0xFF) * scale;
+			out[3] = (float)((packed >> 24) & 0xFF) * scale;
+		}
+
+		static inline int FastFloor(float value)
+		{
+			const int i = (int)value;
+			return i - (value < (float)i ? 1 : 0);
+		}
+
+		static inline int ToByte(float value)
+		{
+			int i = (int)lrintf(value);
+			return i < 0 ? 0 : (i > 255 ? 255 : i);
+		}
+
+		// glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) applied to every channel, alpha included
+		static inline uint32_t BlendPixel(const float src[4], uint32_t dst)
+		{
+			const float alpha = std::clamp(src[3], 0.0f, 1.0f);
+			const float invAlpha = 1.0f - alpha;
+
+#if RB_SOFTWARE_SSE2
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+			const __m128 srcTerm = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), zero), one), _mm_set1_ps(255.0f * alpha));
+			const __m128i dst32 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)dst), _mm_setzero_si128()), _mm_setzero_si128());
+			const __m128 result = _mm_add_ps(srcTerm, _mm_mul_ps(_mm_cvtepi32_ps(dst32), _mm_set1_ps(invAlpha)));
+			const __m128i packed = _mm_cvtps_epi32(result);
+			return (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(packed, packed), _mm_setzero_si128()));
+#else
+			uint32_t result = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				const float srcTerm = std::clamp(src[c], 0.0f, 1.0f) * 255.0f * alpha;
+				const float dstChannel = (float)((dst >> (c * 8)) & 0xFF);
+				result |= (uint32_t)ToByte(srcTerm + dstChannel * invAlpha) << (c * 8);
+			}
+
+			return result;
+#endif
+		}
+
+		// GL_NEAREST sampling with GL_REPEAT for textures and GL_CLAMP_TO_EDGE for framebuffer attachments
+		static inline uint32_t SampleNearest(const NullTextureBinding& texture, float u, float v)
+		{
+			if (!texture.Texels || texture.Width == 0 || texture.Height == 0)
+				return 0xFF000000;
+
+			const int width = (int)texture.Width;
+			const int height = (int)texture.Height;
+			int x = FastFloor(u * (float)width);
+			int y = FastFloor(v * (float)height);
+			if (texture.ClampToEdge)
+			{
+				x = std::clamp(x, 0, width - 1);
+				y = std::clamp(y, 0, height - 1);
+			}
+			else
+			{
+				// Only wrap when needed, most sprites sample inside [0, 1)
+				if ((uint32_t)x >= (uint32_t)width)
+				{
+					x %= width;
+					x += x < 0 ? width : 0;
+				}
+				if ((uint32_t)y >= (uint32_t)height)
+				{
+					y %= height;
+					y += y < 0 ? height : 0;
+				}
+			}
+
+			return texture.Texels[(size_t)y * width + x];
+		}
+
+		static inline float SmoothStep(float edge0, float edge1, float x)
+		{
+			float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+			return t * t * (3.0f - 2.0f * t);
+		}
+
+		// Fills a span with a single color, the hot path for untextured quads and solid sprites
+		static void FillSpan(uint32_t* dst, int count, const float src[4])
+		{
+			const float alpha = std::clamp(src[3], 0.0f, 1.0f);
+			int i = 0;
+
+			if (alpha >= 1.0f)
+			{
+				const uint32_t packed = BlendPixel(src, 0);
+#if RB_SOFTWARE_SSE2
+				const __m128i packed4 = _mm_set1_epi32((int)packed);
+				for (; i + 4 <= count; i += 4)
+				{
+					_mm_storeu_si128((__m128i*)(dst + i), packed4);
+				}
+#endif
+				for (; i < count; i++)
+				{
+					dst[i] = packed;
+				}
+				return;
+			}
+
+#if RB_SOFTWARE_SSE2
+			// Same arithmetic as BlendPixel, four pixels at a time
+			const float invAlpha = 1.0f - alpha;
+			const __m128 srcTerm = _mm_setr_ps(
+				std::clamp(src[0], 0.0f, 1.0f) * 255.0f * alpha,
+				std::clamp(src[1], 0.0f, 1.0f) * 255.0f * alpha,
+				std::clamp(src[2], 0.0f, 1.0f) * 255.0f * alpha,
+				std::clamp(src[3], 0.0f, 1.0f) * 255.0f * alpha);
+			const __m128 invAlpha4 = _mm_set1_ps(invAlpha);
+			const __m128i zero = _mm_setzero_si128();
+
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128i pixels = _mm_loadu_si128((const __m128i*)(dst + i));
+				__m128i low16 = _mm_unpacklo_epi8(pixels, zero);
+				__m128i high16 = _mm_unpackhi_epi8(pixels, zero);
+
+				__m128 p0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low16, zero));
+				__m128 p1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low16, zero));
+				__m128 p2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high16, zero));
+				__m128 p3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high16, zero));
+
+				p0 = _mm_add_ps(srcTerm, _mm_mul_ps(p0, invAlpha4));
+				p1 = _mm_add_ps(srcTerm, _mm_mul_ps(p1, invAlpha4));
+				p2 = _mm_add_ps(srcTerm, _mm_mul_ps(p2, invAlpha4));
+				p3 = _mm_add_ps(srcTerm, _mm_mul_ps(p3, invAlpha4));
+
+				__m128i packedLow = _mm_packs_epi32(_mm_cvtps_epi32(p0), _mm_cvtps_epi32(p1));
+				__m128i packedHigh = _mm_packs_epi32(_mm_cvtps_epi32(p2), _mm_cvtps_epi32(p3));
+				_mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(packedLow, packedHigh));
+			}
+#endif
+			for (; i < count; i++)
+			{
+				dst[i] = BlendPixel(src, dst[i]);
+			}
+		}
+
+		static void SetupTriangle(RasterTriangle& triangle, const RenderTarget& target)
+		{
+			triangle.Valid = false;
+
+			RasterVertex* v = triangle.Vertices;
+			float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[1].y - v[0].y) * (v[2].x - v[0].x);
+			if (area == 0.0f || !std::isfinite(area))
+				return;
+
+			// No face culling in the OpenGL backend either, so just make every triangle counter clockwise
+			if (area < 0.0f)
+			{
+				std::swap(v[1], v[2]);
+				area = -area;
+			}
+
+			for (int i = 0; i < 3; i++)
+			{
+				const RasterVertex& a = v[(i + 1) % 3];
+				const RasterVertex& b = v[(i + 2) % 3];
+				triangle.A[i] = -(b.y - a.y);
+				triangle.B[i] = b.x - a.x;
+
+				// Evaluate C from the same endpoint whichever way round the edge is, so the neighbouring triangle
+				// gets the exact negation and the tie breaking rule stays watertight
+				const RasterVertex& origin = (a.x < b.x || (a.x == b.x && a.y < b.y)) ? a : b;
+				triangle.C[i] = -(triangle.A[i] * origin.x + triangle.B[i] * origin.y);
+				triangle.InvA[i] = triangle.A[i] != 0.0f ? 1.0f / triangle.A[i] : 0.0f;
+				triangle.IncludeEdge[i] = triangle.A[i] > 0.0f || (triangle.A[i] == 0.0f && triangle.B[i] > 0.0f);
+			}
+
+			triangle.InvArea = 1.0f / area;
+
+			if (triangle.Affine)
+			{
+				for (uint32_t a = 0; a < s_MaxAttributes; a++)
+				{
+					for (int k = 0; k < 3; k++)
+					{
+						const float* edge = k == 0 ? triangle.A : (k == 1 ? triangle.B : triangle.C);
+						triangle.Planes[a][k] = (edge[0] * v[0].Attributes[a] + edge[1] * v[1].Attributes[a] + edge[2] * v[2].Attributes[a]) * triangle.InvArea;
+					}
+				}
+			}
+
+			const float minX = std::min({ v[0].x, v[1].x, v[2].x });
+			const float maxX = std::max({ v[0].x, v[1].x, v[2].x });
+			const float minY = std::min({ v[0].y, v[1].y, v[2].y });
+			const float maxY = std::max({ v[0].y, v[1].y, v[2].y });
+
+			// Pixel centers are at +0.5
+			triangle.MinX = std::max((int)floorf(minX - 0.5f), target.ClipMinX);
+			triangle.MinY = std::max((int)floorf(minY - 0.5f), target.ClipMinY);
+			triangle.MaxX = std::min((int)ceilf(maxX - 0.5f), target.ClipMaxX - 1);
+			triangle.MaxY = std::min((int)ceilf(maxY - 0.5f), target.ClipMaxY - 1);
+
+			triangle.Valid = triangle.MinX <= triangle.MaxX && triangle.MinY <= triangle.MaxY;
+		}
+
+		static inline bool EdgeCovers(const RasterTriangle& triangle, int i, float x, float y)
+		{
+			const float e = triangle.A[i] * x + triangle.B[i] * y + triangle.C[i];
+			return e > 0.0f || (e == 0.0f && triangle.IncludeEdge[i]);
+		}
+
+		// Finds the covered pixels of a row. Returns false if the row is empty
+		static bool FindSpan(const RasterTriangle& triangle, int y, int minX, int maxX, int& outStart, int& outEnd)
+		{
+			const float yc = (float)y + 0.5f;
+			int start = minX, end = maxX;
+
+			for (int i = 0; i < 3; i++)
+			{
+				if (triangle.A[i] == 0.0f)
+				{
+					if (!EdgeCovers(triangle, i, 0.0f, yc))
+						return false;
+					continue;
+				}
+
+				// Analytic crossing, then nudged with the exact edge test in case rounding put it one pixel off
+				const float crossing = std::clamp(-(triangle.B[i] * yc + triangle.C[i]) * triangle.InvA[i] - 0.5f, (float)start - 1.0f, (float)end + 1.0f);
+				if (triangle.A[i] > 0.0f)
+				{
+					int x = -FastFloor(-crossing);
+					while (x > start && EdgeCovers(triangle, i, (float)(x - 1) + 0.5f, yc))
+						x--;
+					while (x <= end && !EdgeCovers(triangle, i, (float)x + 0.5f, yc))
+						x++;
+					start = std::max(start, x);
+				}
+				else
+				{
+					int x = FastFloor(crossing);
+					while (x < end && EdgeCovers(triangle, i, (float)(x + 1) + 0.5f, yc))
+						x++;
+					while (x >= start && !EdgeCovers(triangle, i, (float)x + 0.5f, yc))
+						x--;
+					end = std::min(end, x);
+				}
+
+				if (start > end)
+					return false;
+			}
+
+			outStart = start;
+			outEnd = end;
+			return true;
+		}
+
+		template<RasterProgram Program>
+		static inline uint32_t ShadePixel(const NullTextureBinding& texture, const float attributes[s_MaxAttributes], uint32_t dst, bool& outDiscard)
+		{
+			float color[4];
+			bool discard;
+			if (Program == RasterProgram::Quad)
+			{
+				// Renderer2D_Quad.glsl
+				float texel[4];
+				UnpackColor(SampleNearest(texture, attributes[4], attributes[5]), texel);
+				for (int c = 0; c < 4; c++)
+				{
+					color[c] = attributes[c] * texel[c];
+				}
+				discard = color[3] == 0.0f;
+			}
+			else
+			{
+				// Renderer2D_Circle.glsl
+				const float thickness = attributes[6];
+				const float fade = attributes[7];
+				const float distance = 1.0f - sqrtf(attributes[0] * attributes[0] + attributes[1] * attributes[1]);
+
+				float circle;
+				if (fade <= 0.0f)
+				{
+					circle = (distance >= 0.0f ? 1.0f : 0.0f) * (distance >= thickness ? 0.0f : 1.0f);
+				}
+				else
+				{
+					circle = SmoothStep(0.0f, fade, distance) * SmoothStep(thickness + fade, thickness, distance);
+				}
+
+				color[0] = attributes[2];
+				color[1] = attributes[3];
+				color[2] = attributes[4];
+				color[3] = attributes[5] * circle;
+				discard = circle == 0.0f;
+			}
+
+			outDiscard = discard;
+			return discard ? dst : BlendPixel(color, dst);
+		}
+
+		template<RasterProgram Program>
+		static void RasterizeTriangle(const RasterTriangle& triangle, const RenderTarget& target, int tileMinX, int tileMinY, int tileMaxX, int tileMaxY)
+		{
+			const int minX = std::max(triangle.MinX, tileMinX);
+			const int maxX = std::min(triangle.MaxX, tileMaxX);
+			const int minY = std::max(triangle.MinY, tileMinY);
+			const int maxY = std::min(triangle.MaxY, tileMaxY);
+			if (minX > maxX || minY > maxY)
+				return;
+
+			const NullTextureBinding& texture = NullRendererAPI::GetBoundTexture(triangle.TextureSlot);
+			const RasterVertex* v = triangle.Vertices;
+			const uint32_t attributeCount = Program == RasterProgram::Quad ? 6 : 8;
+
+			for (int y = minY; y <= maxY; y++)
+			{
+				int start, end;
+				if (!FindSpan(triangle, y, minX, maxX, start, end))
+					continue;
+
+				uint32_t* colorRow = target.Color + (size_t)y * target.Width;
+				int32_t* entityRow = target.EntityIDs ? target.EntityIDs + (size_t)y * target.Width : nullptr;
+
+				if (triangle.ConstantColor)
+				{
+					if (triangle.Color[3] <= 0.0f)
+						continue;		// Fully transparent fragments are discarded by the quad shader
+
+					FillSpan(colorRow + start, end - start + 1, triangle.Color);
+					if (entityRow)
+						std::fill(entityRow + start, entityRow + end + 1, triangle.EntityID);
+					continue;
+				}
+
+				const float xc = (float)start + 0.5f;
+				const float yc = (float)y + 0.5f;
+				float attributes[s_MaxAttributes];
+				bool discard;
+
+				if (triangle.Affine)
+				{
+					// Attributes are linear in screen space, step them along the row
+					for (uint32_t a = 0; a < attributeCount; a++)
+					{
+						attributes[a] = triangle.Planes[a][0] * xc + triangle.Planes[a][1] * yc + triangle.Planes[a][2];
+					}
+
+					for (int x = start; x <= end; x++)
+					{
+						colorRow[x] = ShadePixel<Program>(texture, attributes, colorRow[x], discard);
+						if (entityRow && !discard)
+							entityRow[x] = triangle.EntityID;
+
+						for (uint32_t a = 0; a < attributeCount; a++)
+						{
+							attributes[a] += triangle.Planes[a][0];
+						}
+					}
+					continue;
+				}
+
+				float e[3];
+				for (int i = 0; i < 3; i++)
+				{
+					e[i] = triangle.A[i] * xc + triangle.B[i] * yc + triangle.C[i];
+				}
+
+				for (int x = start; x <= end; x++)
+				{
+					const float l0 = e[0] * triangle.InvArea;
+					const float l1 = e[1] * triangle.InvArea;
+					const float l2 = e[2] * triangle.InvArea;
+					e[0] += triangle.A[0];
+					e[1] += triangle.A[1];
+					e[2] += triangle.A[2];
+
+					const float w = 1.0f / (l0 * v[0].invW + l1 * v[1].invW + l2 * v[2].invW);
+					for (uint32_t a = 0; a < attributeCount; a++)
+					{
+						attributes[a] = (l0 * v[0].Attributes[a] + l1 * v[1].Attributes[a] + l2 * v[2].Attributes[a]) * w;
+					}
+
+					colorRow[x] = ShadePixel<Program>(texture, attributes, colorRow[x], discard);
+					if (entityRow && !discard)
+						entityRow[x] = triangle.EntityID;
+				}
+			}
+		}
+
+		static void WriteBigEndian(std::vector<uint8_t>& buffer, uint32_t value)
+		{
+			buffer.push_back((uint8_t)(value >> 24));
+			buffer.push_back((uint8_t)(value >> 16));
+			buffer.push_back((uint8_t)(value >> 8));
+			buffer.push_back((uint8_t)value);
+		}
+
+		static uint32_t Crc32(const uint8_t* data, size_t length)
+		{
+			static const std::array<uint32_t, 256> table = []()
+			{
+				std::array<uint32_t, 256> result;
+				for (uint32_t i = 0; i < 256; i++)
+				{
+					uint32_t c = i;
+					for (int k = 0; k < 8; k++)
+					{
+						c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+					}
+					result[i] = c;
+				}
+				return result;
+			}();
+
+			uint32_t crc = 0xFFFFFFFFu;
+			for (size_t i = 0; i < length; i++)
+			{
+				crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+			}
+			return crc ^ 0xFFFFFFFFu;
+		}
+
+		static void WritePNGChunk(std::ofstream& stream, const char* type, const std::vector<uint8_t>& data)
+		{
+			std::vector<uint8_t> chunk;
+			chunk.reserve(data.size() + 12);
+			WriteBigEndian(chunk, (uint32_t)data.size());
+			chunk.insert(chunk.end(), type, type + 4);
+			chunk.insert(chunk.end(), data.begin(), data.end());
+			WriteBigEndian(chunk, Crc32(chunk.data() + 4, chunk.size() - 4));
+
+			stream.write((const char*)chunk.data(), chunk.size());
+		}
+	}
+
+	static RenderTarget GetRenderTarget()
+	{
+		RenderTarget target;
+
+		NullFramebuffer* framebuffer = NullRendererAPI::GetBoundFramebuffer();
+		if (!framebuffer)
+			framebuffer = s_SoftwareData.DefaultFramebuffer.get();
+
+		if (!framebuffer)
+			return target;
+
+		for (uint32_t i = 0; i < framebuffer->GetColorAttachmentCount(); i++)
+		{
+			if (!target.Color && framebuffer->GetColorAttachmentFormat(i) == FramebufferTextureFormat::RGBA8)
+				target.Color = framebuffer->GetColorAttachmentData(i);
+			else if (!target.EntityIDs && framebuffer->GetColorAttachmentFormat(i) == FramebufferTextureFormat::RED_INTEGER)
+				target.EntityIDs = (int32_t*)framebuffer->GetColorAttachmentData(i);
+		}
+
+		target.Width = (int)framebuffer->GetSpecification().Width;
+		target.Height = (int)framebuffer->GetSpecification().Height;
+
+		const NullViewport& viewport = NullRendererAPI::GetViewport();
+		target.ClipMinX = std::min((int)viewport.x, target.Width);
+		target.ClipMinY = std::min((int)viewport.y, target.Height);
+		target.ClipMaxX = std::min((int)(viewport.x + viewport.width), target.Width);
+		target.ClipMaxY = std::min((int)(viewport.y + viewport.height), target.Height);
+
+		return target;
+	}
+
+	void SoftwareRendererAPI::Init()
+	{
+		RB_PROFILE_FUNCTION();
+
+		NullRendererAPI::Init();
+
+		FramebufferSpecification spec;
+		spec.Attachments = { FramebufferTextureFormat::RGBA8 };
+		spec.Width = 1;
+		spec.Height = 1;
+		s_SoftwareData.DefaultFramebuffer = CreateScope<NullFramebuffer>(spec);
+	}
+
+	void SoftwareRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		NullRendererAPI::SetViewport(x, y, width, height);
+
+		// With nothing bound the viewport describes the window, so the default framebuffer follows it
+		if (!GetBoundFramebuffer() && s_SoftwareData.DefaultFramebuffer)
+		{
+			const FramebufferSpecification& spec = s_SoftwareData.DefaultFramebuffer->GetSpecification();
+			if (spec.Width != x + width || spec.Height != y + height)
+			{
+				s_SoftwareData.DefaultFramebuffer->Resize(x + width, y + height);
+			}
+		}
+	}
+
+	void SoftwareRendererAPI::Clear()
+	{
+		NullRendererAPI::Clear();
+
+		if (!GetBoundFramebuffer() && s_SoftwareData.DefaultFramebuffer)
+		{
+			s_SoftwareData.DefaultFramebuffer->Clear(GetClearColor());
+		}
+	}
+
+	void SoftwareRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
+	{
+		RB_PROFILE_FUNCTION();
+
+		NullRendererAPI::DrawIndexed(vertexArray, indexCount);
+
+		const NullShader* shader = GetBoundShader();
+		const RasterProgram program = utils::GetRasterProgram(shader);
+		if (program != RasterProgram::Quad && program != RasterProgram::Circle)
+		{
+			Log::Warn("Software renderer cannot draw indexed geometry with shader %s", shader ? shader->GetName().c_str() : "None");
+			return;
+		}
+
+		const RenderTarget target = GetRenderTarget();
+		const float* matrix = utils::GetViewProjection(shader);
+		if (!target.Color || !matrix || vertexArray->GetVertexBuffers().empty() || !vertexArray->GetIndexBuffer())
+			return;
+
+		const NullVertexBuffer& vertexBuffer = *std::static_pointer_cast<NullVertexBuffer>(vertexArray->GetVertexBuffers()[0]);
+		const NullIndexBuffer& indexBuffer = *std::static_pointer_cast<NullIndexBuffer>(vertexArray->GetIndexBuffer());
+		const BufferLayout& layout = vertexBuffer.GetLayout();
+		const uint32_t stride = layout.GetStride();
+		const uint32_t count = indexCount ? std::min(indexCount, indexBuffer.GetCount()) : indexBuffer.GetCount();
+		const uint32_t triangleCount = count / 3;
+		const uint32_t vertexCount = vertexBuffer.GetDataSize() / stride;
+
+		// Attribute offsets for the vertex formats written by Renderer2D
+		const bool isQuad = program == RasterProgram::Quad;
+		const int positionOffset = utils::FindAttributeOffset(layout, isQuad ? "a_Position" : "a_WorldPosition");
+		const int colorOffset = utils::FindAttributeOffset(layout, "a_Color");
+		const int entityOffset = utils::FindAttributeOffset(layout, "a_EntityID");
+		const int texCoordOffset = isQuad ? utils::FindAttributeOffset(layout, "a_TexCoord") : -1;
+		const int textureIndexOffset = isQuad ? utils::FindAttributeOffset(layout, "a_TextureIndex") : -1;
+		const int tilingOffset = isQuad ? utils::FindAttributeOffset(layout, "a_TilingFactor") : -1;
+		const int localOffset = !isQuad ? utils::FindAttributeOffset(layout, "a_LocalPosition") : -1;
+		const int thicknessOffset = !isQuad ? utils::FindAttributeOffset(layout, "a_Thickness") : -1;
+		const int fadeOffset = !isQuad ? utils::FindAttributeOffset(layout, "a_Fade") : -1;
+
+		const uint8_t* vertexData = vertexBuffer.GetData();
+		const uint32_t* indices = indexBuffer.GetIndices();
+		const NullViewport& viewport = GetViewport();
+
+		std::vector<RasterTriangle>& triangles = s_SoftwareData.Triangles;
+		triangles.resize(triangleCount);
+
+		// Vertex processing and triangle setup
+		const uint32_t setupBatches = (triangleCount + s_SetupBatchSize - 1) / s_SetupBatchSize;
+		JobSystem::Dispatch(setupBatches, [&](uint32_t batch)
+		{
+			const uint32_t first = batch * s_SetupBatchSize;
+			const uint32_t last = std::min(first + s_SetupBatchSize, triangleCount);
+			for (uint32_t t = first; t < last; t++)
+			{
+				RasterTriangle& triangle = triangles[t];
+				triangle.Valid = false;
+
+				bool behindCamera = false;
+				bool outOfRange = false;
+				for (int corner = 0; corner < 3; corner++)
+				{
+					const uint32_t index = indices[t * 3 + corner];
+					if (index >= vertexCount)
+					{
+						outOfRange = true;
+						break;
+					}
+
+					const uint8_t* vertex = vertexData + (size_t)index * stride;
+					float clip[4];
+					utils::TransformPoint(matrix, utils::ReadFloat(vertex, positionOffset), utils::ReadFloat(vertex, positionOffset + 4), utils::ReadFloat(vertex, positionOffset + 8), clip);
+
+					// There is no near plane clipping, triangles crossing the camera plane are dropped
+					if (clip[3] <= 1e-6f)
+					{
+						behindCamera = true;
+						break;
+					}
+
+					RasterVertex& out = triangle.Vertices[corner];
+					out.invW = 1.0f / clip[3];
+					out.x = (float)viewport.x + (clip[0] * out.invW * 0.5f + 0.5f) * (float)viewport.width;
+					out.y = (float)viewport.y + (clip[1] * out.invW * 0.5f + 0.5f) * (float)viewport.height;
+
+					float* attributes = out.Attributes;
+					if (isQuad)
+					{
+						const float tiling = utils::ReadFloat(vertex, tilingOffset);
+						for (int c = 0; c < 4; c++)
+						{
+							attributes[c] = utils::ReadFloat(vertex, colorOffset + c * 4);
+						}
+						attributes[4] = utils::ReadFloat(vertex, texCoordOffset) * tiling;
+						attributes[5] = utils::ReadFloat(vertex, texCoordOffset + 4) * tiling;
+						attributes[6] = attributes[7] = 0.0f;
+					}
+					else
+					{
+						attributes[0] = utils::ReadFloat(vertex, localOffset);
+						attributes[1] = utils::ReadFloat(vertex, localOffset + 4);
+						for (int c = 0; c < 4; c++)
+						{
+							attributes[2 + c] = utils::ReadFloat(vertex, colorOffset + c * 4);
+						}
+						attributes[6] = utils::ReadFloat(vertex, thicknessOffset);
+						attributes[7] = utils::ReadFloat(vertex, fadeOffset);
+					}
+
+					// Flat attributes come from the provoking (last) vertex, as in OpenGL
+					if (corner == 2)
+					{
+						triangle.EntityID = utils::ReadInt(vertex, entityOffset);
+						triangle.TextureSlot = isQuad ? std::clamp((int)utils::ReadFloat(vertex, textureIndexOffset), 0, 31) : 0;
+					}
+				}
+
+				if (behindCamera || outOfRange)
+					continue;
+
+				// A 1x1 texture (the blank white texture) with matching vertex colors shades the whole triangle the same
+				triangle.ConstantColor = false;
+				const NullTextureBinding& texture = GetBoundTexture(triangle.TextureSlot);
+				const RasterVertex* v = triangle.Vertices;
+				triangle.Affine = v[0].invW == v[1].invW && v[1].invW == v[2].invW;
+				if (isQuad && texture.Width == 1 && texture.Height == 1 && triangle.Affine
+					&& memcmp(v[0].Attributes, v[1].Attributes, sizeof(float) * 4) == 0 && memcmp(v[1].Attributes, v[2].Attributes, sizeof(float) * 4) == 0)
+				{
+					float texel[4];
+					utils::UnpackColor(utils::SampleNearest(texture, 0.0f, 0.0f), texel);
+					for (int c = 0; c < 4; c++)
+					{
+						triangle.Color[c] = v[0].Attributes[c] * texel[c];
+					}
+					triangle.ConstantColor = true;
+				}
+
+				if (!triangle.Affine)
+				{
+					for (int corner = 0; corner < 3; corner++)
+					{
+						for (uint32_t a = 0; a < s_MaxAttributes; a++)
+						{
+							triangle.Vertices[corner].Attributes[a] *= triangle.Vertices[corner].invW;
+						}
+					}
+				}
+
+				utils::SetupTriangle(triangle, target);
+			}
+		});
+
+		// Bin triangles into screen tiles, keeping submission order inside every bin
+		const int tilesX = (target.ClipMaxX - target.ClipMinX + s_TileSize - 1) / s_TileSize;
+		const int tilesY = (target.ClipMaxY - target.ClipMinY + s_TileSize - 1) / s_TileSize;
+		if (tilesX <= 0 || tilesY <= 0)
+			return;
+
+		std::vector<std::vector<uint32_t>>& bins = s_SoftwareData.TileBins;
+		if (bins.size() < (size_t)(tilesX * tilesY))
+			bins.resize(tilesX * tilesY);
+		for (std::vector<uint32_t>& bin : bins)
+			bin.clear();
+
+		for (uint32_t t = 0; t < triangleCount; t++)
+		{
+			const RasterTriangle& triangle = triangles[t];
+			if (!triangle.Valid)
+				continue;
+
+			const int firstTileX = (triangle.MinX - target.ClipMinX) / s_TileSize;
+			const int lastTileX = (triangle.MaxX - target.ClipMinX) / s_TileSize;
+			const int firstTileY = (triangle.MinY - target.ClipMinY) / s_TileSize;
+			const int lastTileY = (triangle.MaxY - target.ClipMinY) / s_TileSize;
+			for (int tileY = firstTileY; tileY <= lastTileY; tileY++)
+			{
+				for (int tileX = firstTileX; tileX <= lastTileX; tileX++)
+				{
+					bins[tileY * tilesX + tileX].push_back(t);
+				}
+			}
+		}
+
+		// Tiles never share pixels so they can be rasterized in parallel
+		JobSystem::Dispatch(tilesX * tilesY, [&](uint32_t tileIndex)
+		{
+			const int tileMinX = target.ClipMinX + (int)(tileIndex % tilesX) * s_TileSize;
+			const int tileMinY = target.ClipMinY + (int)(tileIndex / tilesX) * s_TileSize;
+			const int tileMaxX = std::min(tileMinX + s_TileSize, target.ClipMaxX) - 1;
+			const int tileMaxY = std::min(tileMinY + s_TileSize, target.ClipMaxY) - 1;
+
+			for (uint32_t t : bins[tileIndex])
+			{
+				if (isQuad)
+					utils::RasterizeTriangle<RasterProgram::Quad>(triangles[t], target, tileMinX, tileMinY, tileMaxX, tileMaxY);
+				else
+					utils::RasterizeTriangle<RasterProgram::Circle>(triangles[t], target, tileMinX, tileMinY, tileMaxX, tileMaxY);
+			}
+		});
+	}
+
+	void SoftwareRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+	{
+		RB_PROFILE_FUNCTION();
+
+		NullRendererAPI::DrawLines(vertexArray, vertexCount);
+
+		const NullShader* shader = GetBoundShader();
+		const RenderTarget target = GetRenderTarget();
+		const float* matrix = utils::GetViewProjection(shader);
+		if (utils::GetRasterProgram(shader) != RasterProgram::Line || !target.Color || !matrix || vertexArray->GetVertexBuffers().empty())
+			return;
+
+		const NullVertexBuffer& vertexBuffer = *std::static_pointer_cast<NullVertexBuffer>(vertexArray->GetVertexBuffers()[0]);
+		const BufferLayout& layout = vertexBuffer.GetLayout();
+		const uint32_t stride = layout.GetStride();
+		const int positionOffset = utils::FindAttributeOffset(layout, "a_Position");
+		const int colorOffset = utils::FindAttributeOffset(layout, "a_Color");
+		const int entityOffset = utils::FindAttributeOffset(layout, "a_EntityID");
+
+		const NullViewport& viewport = GetViewport();
+		const int lineWidth = std::max((int)lrintf(GetLineWidth()), 1);
+		vertexCount = std::min(vertexCount, vertexBuffer.GetDataSize() / stride);
+
+		for (uint32_t i = 0; i + 1 < vertexCount; i += 2)
+		{
+			const uint8_t* vertices[2] = { vertexBuffer.GetData() + (size_t)i * stride, vertexBuffer.GetData() + (size_t)(i + 1) * stride };
+
+			float windowX[2], windowY[2];
+			bool behindCamera = false;
+			for (int end = 0; end < 2; end++)
+			{
+				float clip[4];
+				utils::TransformPoint(matrix, utils::ReadFloat(vertices[end], positionOffset), utils::ReadFloat(vertices[end], positionOffset + 4), utils::ReadFloat(vertices[end], positionOffset + 8), clip);
+				behindCamera |= clip[3] <= 1e-6f;
+				windowX[end] = (float)viewport.x + (clip[0] / clip[3] * 0.5f + 0.5f) * (float)viewport.width;
+				windowY[end] = (float)viewport.y + (clip[1] / clip[3] * 0.5f + 0.5f) * (float)viewport.height;
+			}
+
+			if (behindCamera)
+				continue;
+
+			float color[4];
+			for (int c = 0; c < 4; c++)
+			{
+				color[c] = utils::ReadFloat(vertices[1], colorOffset + c * 4);
+			}
+			const int entityID = utils::ReadInt(vertices[1], entityOffset);
+
+			// DDA along the major axis, wide lines extend along the minor axis like aliased GL lines
+			const float dx = windowX[1] - windowX[0];
+			const float dy = windowY[1] - windowY[0];
+			const bool xMajor = fabsf(dx) >= fabsf(dy);
+			const int steps = std::max((int)ceilf(std::max(fabsf(dx), fabsf(dy))), 1);
+			const float stepX = dx / (float)steps;
+			const float stepY = dy / (float)steps;
+
+			for (int s = 0; s < steps; s++)
+			{
+				const float x = windowX[0] + stepX * ((float)s + 0.5f);
+				const float y = windowY[0] + stepY * ((float)s + 0.5f);
+				for (int w = 0; w < lineWidth; w++)
+				{
+					const float offset = (float)w - (float)(lineWidth - 1) * 0.5f;
+					const int px = (int)floorf(xMajor ? x : x + offset);
+					const int py = (int)floorf(xMajor ? y + offset : y);
+					if (px < target.ClipMinX || py < target.ClipMinY || px >= target.ClipMaxX || py >= target.ClipMaxY)
+						continue;
+
+					const size_t pixel = (size_t)py * target.Width + px;
+					target.Color[pixel] = utils::BlendPixel(color, target.Color[pixel]);
+					if (target.EntityIDs)
+						target.EntityIDs[pixel] = entityID;
+				}
+			}
+		}
+	}
+
+	void SoftwareRendererAPI::DrawQuad()
+	{
+		RB_PROFILE_FUNCTION();
+
+		NullRendererAPI::DrawQuad();
+
+		// Only the screen shader issues raw quads, it covers the viewport with the texture in slot 0
+		const NullShader* shader = GetBoundShader();
+		const RenderTarget target = GetRenderTarget();
+		if (utils::GetRasterProgram(shader) != RasterProgram::Screen || !target.Color)
+			return;
+
+		const NullTextureBinding& texture = GetBoundTexture(0);
+		const NullViewport& viewport = GetViewport();
+		if (viewport.width == 0 || viewport.height == 0)
+			return;
+
+		const int rows = target.ClipMaxY - target.ClipMinY;
+		const uint32_t rowBlocks = (uint32_t)std::max((rows + s_TileSize - 1) / s_TileSize, 0);
+		JobSystem::Dispatch(rowBlocks, [&](uint32_t block)
+		{
+			const int firstRow = target.ClipMinY + (int)block * s_TileSize;
+			const int lastRow = std::min(firstRow + s_TileSize, target.ClipMaxY);
+			for (int y = firstRow; y < lastRow; y++)
+			{
+				const float v = ((float)y + 0.5f - (float)viewport.y) / (float)viewport.height;
+				uint32_t* colorRow = target.Color + (size_t)y * target.Width;
+				for (int x = target.ClipMinX; x < target.ClipMaxX; x++)
+				{
+					const float u = ((float)x + 0.5f - (float)viewport.x) / (float)viewport.width;
+					float color[4];
+					utils::UnpackColor(utils::SampleNearest(texture, u, v), color);
+					colorRow[x] = utils::BlendPixel(color, colorRow[x]);
+				}
+			}
+		});
+	}
+
+	NullFramebuffer* SoftwareRendererAPI::GetDefaultFramebuffer()
+	{
+		return s_SoftwareData.DefaultFramebuffer.get();
+	}
+
+	bool SoftwareRendererAPI::WriteFramebufferToPNG(const Framebuffer& framebuffer, const std::string& path, uint32_t attachmentIndex)
+	{
+		RB_PROFILE_FUNCTION();
+
+		Log::Assert(RendererAPI::GetAPI() != RendererAPI::API::OpenGL, "Only in-memory framebuffers can be written to PNG");
+		const NullFramebuffer& source = static_cast<const NullFramebuffer&>(framebuffer);
+		if (attachmentIndex >= source.GetColorAttachmentCount() || source.GetColorAttachmentFormat(attachmentIndex) != FramebufferTextureFormat::RGBA8)
+		{
+			Log::Error("Framebuffer attachment %u is not an RGBA8 attachment", attachmentIndex);
+			return false;
+		}
+
+		const uint32_t width = source.GetSpecification().Width;
+		const uint32_t height = source.GetSpecification().Height;
+		const uint32_t* texels = source.GetColorAttachmentData(attachmentIndex);
+
+		// Scanlines with filter type 0, top row first since the framebuffer is stored bottom row first
+		std::vector<uint8_t> scanlines;
+		scanlines.reserve((size_t)height * (width * 4 + 1));
+		for (uint32_t row = 0; row < height; row++)
+		{
+			const uint32_t* texelRow = texels + (size_t)(height - 1 - row) * width;
+			scanlines.push_back(0);
+			for (uint32_t x = 0; x < width; x++)
+			{
+				scanlines.push_back((uint8_t)(texelRow[x]));
+				scanlines.push_back((uint8_t)(texelRow[x] >> 8));
+				scanlines.push_back((uint8_t)(texelRow[x] >> 16));
+				scanlines.push_back((uint8_t)(texelRow[x] >> 24));
+			}
+		}
+
+		// zlib stream made of stored (uncompressed) deflate blocks
+		std::vector<uint8_t> compressed = { 0x78, 0x01 };
+		size_t offset = 0;
+		do
+		{
+			const size_t blockSize = std::min(scanlines.size() - offset, (size_t)65535);
+			const bool lastBlock = offset + blockSize == scanlines.size();
+			compressed.push_back(lastBlock ? 1 : 0);
+			compressed.push_back((uint8_t)blockSize);
+			compressed.push_back((uint8_t)(blockSize >> 8));
+			compressed.push_back((uint8_t)~blockSize);
+			compressed.push_back((uint8_t)(~blockSize >> 8));
+			compressed.insert(compressed.end(), scanlines.begin() + offset, scanlines.begin() + offset + blockSize);
+			offset += blockSize;
+		} while (offset < scanlines.size());
+
+		uint32_t adlerA = 1, adlerB = 0;
+		for (uint8_t byte : scanlines)
+		{
+			adlerA = (adlerA + byte) % 65521;
+			adlerB = (adlerB + adlerA) % 65521;
+		}
+		utils::WriteBigEndian(compressed, (adlerB << 16) | adlerA);
+
+		std::vector<uint8_t> header;
+		utils::WriteBigEndian(header, width);
+		utils::WriteBigEndian(header, height);
+		header.insert(header.end(), { 8, 6, 0, 0, 0 });		// 8 bit RGBA, no interlacing
+
+		std::ofstream stream(path, std::ios::out | std::ios::binary);
+		if (!stream)
+		{
+			Log::Error("Could not open file %s", path.c_str());
+			return false;
+		}
+
+		const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		stream.write((const char*)signature, sizeof(signature));
+		utils::WritePNGChunk(stream, "IHDR", header);
+		utils::WritePNGChunk(stream, "IDAT", compressed);
+		utils::WritePNGChunk(stream, "IEND", {});
+
+		return true;
+	}
+}
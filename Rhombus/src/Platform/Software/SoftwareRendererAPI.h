@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Platform/Null/NullRendererAPI.h"
+
+namespace rhombus {
+
+	class Framebuffer;
+
+	// CPU reference rasterizer. Resources are the in-memory null ones and draws are rasterized on the CPU with the
+	// semantics of the Renderer2D quad, circle, line and screen shaders. Output goes to the bound framebuffer, or to
+	// a default framebuffer sized to the viewport when nothing is bound (standing in for the window)
+	class SoftwareRendererAPI : public NullRendererAPI {
+	public:
+		virtual void Init() override;
+		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+
+		virtual void Clear() override;
+
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
+		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		virtual void DrawQuad() override;
+
+		static NullFramebuffer* GetDefaultFramebuffer();
+
+		// Writes an RGBA8 color attachment as a PNG. Only valid for framebuffers created by the None or Software API
+		static bool WriteFramebufferToPNG(const Framebuffer& framebuffer, const std::string& path, uint32_t attachmentIndex = 0);
+	};
+}
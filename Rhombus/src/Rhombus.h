@@ -32,7 +32,6 @@
 #include "Rhombus/ECS/Components/ScriptComponent.h"
 #include "Rhombus/ECS/Components/SpriteRendererComponent.h"
 #include "Rhombus/ECS/Components/TransformComponent.h"
-#include "Rhombus/ECS/Components/TweenComponent.h"
 #include "Rhombus/ECS/Components/TileMapComponent.h"
 
 #include "Rhombus/Math/Quat.h"
@@ -40,6 +39,7 @@
 #include "Rhombus/Math/Vector.h"
 
 #include "Rhombus/Project/Project.h"
+#include "Rhombus/Assets/AssetManager.h"
 
 // ---Renderer--------------------
 #include "Rhombus/Renderer/Renderer.h"
@@ -0,0 +1,40 @@
+#include "rbpch.h"
+#include "AnimationClip.h"
+
+namespace rhombus
+{
+	void AnimationClip::BuildTimeTable()
+	{
+		m_sampleEndTimes.resize(m_samples.size());
+		m_duration = 0.0f;
+		for (size_t i = 0; i < m_samples.size(); i++)
+		{
+			m_duration += m_samples[i].m_duration;
+			m_sampleEndTimes[i] = m_duration;
+		}
+
+		m_uniformSampleDuration = m_samples.empty() ? 0.0f : m_samples[0].m_duration;
+		for (const AnimationSample& sample : m_samples)
+		{
+			if (sample.m_duration != m_uniformSampleDuration)
+			{
+				m_uniformSampleDuration = 0.0f;
+				break;
+			}
+		}
+	}
+
+	uint32_t AnimationClip::FindSample(float time) const
+	{
+		const uint32_t lastSample = GetSampleCount() - 1;
+		if (m_uniformSampleDuration > 0.0f)
+		{
+			const float sample = time / m_uniformSampleDuration;
+			return sample < (float)lastSample ? (uint32_t)std::max(sample, 0.0f) : lastSample;
+		}
+
+		// First sample ending after time
+		const uint32_t sample = (uint32_t)(std::upper_bound(m_sampleEndTimes.begin(), m_sampleEndTimes.end(), time) - m_sampleEndTimes.begin());
+		return std::min(sample, lastSample);
+	}
+}
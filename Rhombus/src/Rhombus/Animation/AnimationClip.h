@@ -20,6 +20,23 @@ namespace rhombus
 		std::string m_name;
 		bool m_looping = true;
 		std::vector<AnimationSample> m_samples;
-		float m_duration;
+		float m_duration = 0.0f;
+
+		// Built by BuildTimeTable once the samples are in
+		std::vector<float> m_sampleEndTimes;		// From the start of the clip to the end of each sample
+		float m_uniformSampleDuration = 0.0f;		// When every sample lasts as long, otherwise 0
+
+		// Sets the duration and the time table from the samples
+		void BuildTimeTable();
+
+		uint32_t GetSampleCount() const { return (uint32_t)m_samples.size(); }
+		float GetSampleStartTime(uint32_t sample) const { return sample > 0 ? m_sampleEndTimes[sample - 1] : 0.0f; }
+		float GetSampleEndTime(uint32_t sample) const { return m_sampleEndTimes[sample]; }
+
+		// The sample playing at time into the clip, times past the end give the last sample. The clip must have samples
+		uint32_t FindSample(float time) const;
 	};
+
+	// Clips loaded from one file, shared by every animator that uses the file and never changed once loaded
+	using AnimationClipSet = std::vector<AnimationClip>;
 }
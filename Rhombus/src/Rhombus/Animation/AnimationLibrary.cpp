@@ -0,0 +1,53 @@
+#include "rbpch.h"
+#include "AnimationLibrary.h"
+
+#include "AnimationSerializer.h"
+
+namespace rhombus
+{
+	static std::unordered_map<std::string, Ref<const AnimationClipSet>> s_clipSets;
+
+	namespace utils
+	{
+		static std::string GetCanonicalPath(const std::filesystem::path& path)
+		{
+			std::error_code error;
+			std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+			if (error)
+				canonical = std::filesystem::absolute(path, error).lexically_normal();
+
+			return canonical.generic_string();
+		}
+	}
+
+	void AnimationLibrary::Shutdown()
+	{
+		s_clipSets.clear();
+	}
+
+	Ref<const AnimationClipSet> AnimationLibrary::GetClips(const std::filesystem::path& path)
+	{
+		RB_PROFILE_FUNCTION();
+
+		const std::string canonicalPath = utils::GetCanonicalPath(path);
+		auto it = s_clipSets.find(canonicalPath);
+		if (it != s_clipSets.end())
+		{
+			return it->second;
+		}
+
+		Ref<AnimationClipSet> clips = AnimationSerializer::DeserializeClips(path.string());
+		if (!clips)
+		{
+			return nullptr;
+		}
+
+		s_clipSets[canonicalPath] = clips;
+		return clips;
+	}
+
+	bool AnimationLibrary::UnloadClips(const std::filesystem::path& path)
+	{
+		return s_clipSets.erase(utils::GetCanonicalPath(path)) > 0;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "AnimationClip.h"
+
+#include <filesystem>
+
+namespace rhombus
+{
+	// Loads each animation file once. Animators using the same file share its clips
+	class AnimationLibrary
+	{
+	public:
+		static void Shutdown();
+
+		// Returns the cached clips or loads them. nullptr if the file can't be loaded
+		static Ref<const AnimationClipSet> GetClips(const std::filesystem::path& path);
+
+		// Removes the file from the library so it is loaded again next time. Animators keep the clips they have
+		static bool UnloadClips(const std::filesystem::path& path);
+	};
+}
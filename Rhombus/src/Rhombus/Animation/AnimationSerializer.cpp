@@ -1,6 +1,7 @@
 #include "rbpch.h"
 #include "AnimationSerializer.h"
 
+#include "AnimationLibrary.h"
 #include "Rhombus/ECS/Components/AnimatorComponent.h"
 
 #include <fstream>
@@ -15,26 +16,37 @@ namespace rhombus
 	}
 
 	bool AnimationSerializer::DeserializeAnimations(const std::string& filepath, Entity entity)
+	{
+		if (!entity.HasComponent<AnimatorComponent>())
+		{
+			return false;
+		}
+
+		Ref<const AnimationClipSet> clips = AnimationLibrary::GetClips(filepath);
+		if (!clips)
+		{
+			return false;
+		}
+
+		entity.GetComponent<AnimatorComponent>().SetAnimations(clips);
+		return true;
+	}
+
+	Ref<AnimationClipSet> AnimationSerializer::DeserializeClips(const std::string& filepath)
 	{
 		YAML::Node data;
 		try
 		{
 			data = YAML::LoadFile(filepath);
 		}
-		catch (YAML::ParserException e)
+		catch (YAML::Exception e)
 		{
-			Log::Error("Failed to load animations file '%s'\n     %s", filepath, e.what());
+			Log::Error("Failed to load animations file '%s'\n     %s", filepath.c_str(), e.what());
 			return nullptr;
 		}
 
-		
-		if (!entity.HasComponent<AnimatorComponent>())
-		{
-			return false;
-		}
+		Ref<AnimationClipSet> clips = CreateRef<AnimationClipSet>();
 
-		AnimatorComponent& animator = entity.GetComponent<AnimatorComponent>();
-		
 		auto animClips = data["Clips"];
 		if (animClips)
 		{
@@ -43,7 +55,6 @@ namespace rhombus
 				AnimationClip clip;
 				clip.m_name = clipData["Name"].as<std::string>();
 				clip.m_looping = clipData["Looping"].as<bool>();
-				clip.m_duration = 0.0f;
 				auto samplesData = clipData["Samples"];
 				if (samplesData)
 				{
@@ -51,15 +62,15 @@ namespace rhombus
 					{
 						AnimationSample sample;
 						sample.m_duration = sampleData["Duration"].as<float>();
-						clip.m_duration += sample.m_duration;
 						sample.m_spriteFrame = sampleData["Frame"].as<int>();
 						clip.m_samples.push_back(sample);
 					}
 				}
-				animator.AddAnimation(clip);
+				clip.BuildTimeTable();
+				clips->push_back(std::move(clip));
 			}
 		}
 
-		return true;
+		return clips;
 	}
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Rhombus/Scenes/Entity.h"
+#include "AnimationClip.h"
 
 #include <filesystem>
 
@@ -10,7 +11,10 @@ namespace rhombus
 	{
 	public:
 		static void SerializeAnimations(const std::string& filepath, Entity entity);
+		// Gives the entity's animator the clips of the file through the AnimationLibrary
 		static bool DeserializeAnimations(const std::string& filepath, Entity entity);
+		// Reads every clip in the file and builds its time table. nullptr if the file can't be parsed
+		static Ref<AnimationClipSet> DeserializeClips(const std::string& filepath);
 
 	private:
 		AnimationSerializer();
@@ -17,6 +17,8 @@ namespace rhombus
 		ELASTIC_IN, ELASTIC_OUT, ELASTIC_IN_OUT,
 		BOUNCE_IN, BOUNCE_OUT, BOUNCE_IN_OUT
 	};
+
+	const int EASING_TYPE_COUNT = (int)EasingType::BOUNCE_IN_OUT + 1;
 }
 
 namespace rhombus::easing
@@ -58,7 +60,8 @@ namespace rhombus::easing
 		t = t / d * 2;
 		if (t < 1)
 			return c / 2 * t * t + b;
-		return -c / 2 * ((--t) * (t - 2) - 1) + b;
+		t -= 1;
+		return -c / 2 * (t * (t - 2) - 1) + b;
 	}
 
 	static float CubicIn(float t, float b, float c, float d)
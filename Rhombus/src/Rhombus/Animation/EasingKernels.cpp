@@ -0,0 +1,473 @@
+#include "rbpch.h"
+#include "EasingKernels.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+	#define RB_EASING_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define RB_EASING_SSE2 0
+#endif
+
+namespace rhombus::easing
+{
+	// The kernels are written once for any register of floats operated on together: a plain float, or four floats with
+	// SSE2. Lanes says how many values a register holds and moves them in and out of memory
+	template<typename F>
+	struct Lanes;
+
+	template<>
+	struct Lanes<float>
+	{
+		static const uint32_t COUNT = 1;
+		static inline float Load(const float* data) { return *data; }
+		static inline void Store(float* data, float a) { *data = a; }
+	};
+
+	static inline float Min(float a, float b) { return std::min(a, b); }
+	static inline float Max(float a, float b) { return std::max(a, b); }
+	static inline float Sqrt(float a) { return std::sqrt(a); }
+
+	static inline bool Less(float a, float b) { return a < b; }
+	static inline bool Equal(float a, float b) { return a == b; }
+	static inline float Select(bool mask, float a, float b) { return mask ? a : b; }
+
+#if RB_EASING_SSE2
+	// Comparisons give a mask register, all bits set in the lanes where they hold
+	struct Floats4
+	{
+		__m128 v;
+
+		Floats4() = default;
+		Floats4(__m128 value) : v(value) {}
+		Floats4(float value) : v(_mm_set1_ps(value)) {}
+	};
+
+	template<>
+	struct Lanes<Floats4>
+	{
+		static const uint32_t COUNT = 4;
+		static inline Floats4 Load(const float* data) { return _mm_loadu_ps(data); }
+		static inline void Store(float* data, Floats4 a) { _mm_storeu_ps(data, a.v); }
+	};
+
+	static inline Floats4 operator + (Floats4 a, Floats4 b) { return _mm_add_ps(a.v, b.v); }
+	static inline Floats4 operator - (Floats4 a, Floats4 b) { return _mm_sub_ps(a.v, b.v); }
+	static inline Floats4 operator * (Floats4 a, Floats4 b) { return _mm_mul_ps(a.v, b.v); }
+	static inline Floats4 operator / (Floats4 a, Floats4 b) { return _mm_div_ps(a.v, b.v); }
+	static inline Floats4 operator - (Floats4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+	static inline Floats4 Min(Floats4 a, Floats4 b) { return _mm_min_ps(a.v, b.v); }
+	static inline Floats4 Max(Floats4 a, Floats4 b) { return _mm_max_ps(a.v, b.v); }
+	static inline Floats4 Sqrt(Floats4 a) { return _mm_sqrt_ps(a.v); }
+
+	static inline Floats4 Less(Floats4 a, Floats4 b) { return _mm_cmplt_ps(a.v, b.v); }
+	static inline Floats4 Equal(Floats4 a, Floats4 b) { return _mm_cmpeq_ps(a.v, b.v); }
+	static inline Floats4 Select(Floats4 mask, Floats4 a, Floats4 b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+#endif
+
+	// sin(r) and cos(r) for r in [-pi/4, pi/4], Taylor series to r^11 and r^12. The first terms dropped are below 2e-10
+	// there
+	template<typename F>
+	static inline F SinPolynomial(F r)
+	{
+		const F r2 = r * r;
+		return r + r * r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f + r2 * (1.0f / 362880.0f + r2 * (-1.0f / 39916800.0f)))));
+	}
+
+	template<typename F>
+	static inline F CosPolynomial(F r)
+	{
+		const F r2 = r * r;
+		return 1.0f + r2 * (-1.0f / 2.0f + r2 * (1.0f / 24.0f + r2 * (-1.0f / 720.0f + r2 * (1.0f / 40320.0f
+			+ r2 * (-1.0f / 3628800.0f + r2 * (1.0f / 479001600.0f))))));
+	}
+
+	// 2^f for f in [-0.5, 0.5], Taylor series of e^(f ln 2) to f^7. The first term dropped is below 6e-9 there
+	template<typename F>
+	static inline F Exp2Polynomial(F f)
+	{
+		return 1.0f + f * (6.93147181e-1f + f * (2.40226507e-1f + f * (5.55041087e-2f + f * (9.61812911e-3f
+			+ f * (1.33335581e-3f + f * (1.54035304e-4f + f * 1.52527338e-5f))))));
+	}
+
+	// pi / 2 split so that k * HALF_PI_HIGH is exact for the small k seen here
+	static const float TWO_OVER_PI = 0.636619772f;
+	static const float HALF_PI_HIGH = 1.5703125f;
+	static const float HALF_PI_LOW = 4.83826794897e-4f;
+
+	// sin(x + quarterTurns pi / 2). x is reduced to r = x - k pi / 2 with k the nearest whole number to x / (pi / 2), then
+	// the quarter turns k pick between sin and cos of r and their sign. sin(pi / 2) and cos(0) come out exactly 1
+	static inline float SinQuarterTurns(float x, int quarterTurns)
+	{
+		const float k = std::floor(x * TWO_OVER_PI + 0.5f);
+		const float r = (x - k * HALF_PI_HIGH) - k * HALF_PI_LOW;
+		const int turns = (int)k + quarterTurns;
+		const float value = (turns & 1) ? CosPolynomial(r) : SinPolynomial(r);
+		return (turns & 2) ? -value : value;
+	}
+
+	// 2^x = 2^n 2^f, with n the nearest whole number to x. The power of two is built straight into the exponent bits
+	static inline float Exp2(float x)
+	{
+		x = Min(Max(x, -126.0f), 127.0f);
+		const float n = std::floor(x + 0.5f);
+		const uint32_t bits = (uint32_t)((int)n + 127) << 23;
+		float scale;
+		memcpy(&scale, &bits, sizeof(float));
+		return Exp2Polynomial(x - n) * scale;
+	}
+
+#if RB_EASING_SSE2
+	static inline Floats4 SinQuarterTurns(Floats4 x, int quarterTurns)
+	{
+		const __m128i k = _mm_cvtps_epi32(_mm_mul_ps(x.v, _mm_set1_ps(TWO_OVER_PI)));
+		const Floats4 kf = _mm_cvtepi32_ps(k);
+		const Floats4 r = (x - kf * HALF_PI_HIGH) - kf * HALF_PI_LOW;
+		const __m128i turns = _mm_add_epi32(k, _mm_set1_epi32(quarterTurns));
+		const Floats4 useCos = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(turns, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		const __m128 sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(turns, _mm_set1_epi32(2)), 30));
+		return _mm_xor_ps(Select(useCos, CosPolynomial(r), SinPolynomial(r)).v, sign);
+	}
+
+	static inline Floats4 Exp2(Floats4 x)
+	{
+		x = Min(Max(x, -126.0f), 127.0f);
+		const __m128i n = _mm_cvtps_epi32(x.v);
+		const Floats4 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+		return Exp2Polynomial(x - Floats4(_mm_cvtepi32_ps(n))) * scale;
+	}
+#endif
+
+	template<typename F>
+	static inline F Sin(F x) { return SinQuarterTurns(x, 0); }
+	template<typename F>
+	static inline F Cos(F x) { return SinQuarterTurns(x, 1); }
+
+	// The curves f(u) of the easing functions for normalised time u, worked through from the scalar versions
+
+	template<typename F>
+	static inline F LinearShape(F u) { return u; }
+
+	template<typename F>
+	static inline F SineInShape(F u) { return 1.0f - Cos(u * (math::PI / 2.0f)); }
+	template<typename F>
+	static inline F SineOutShape(F u) { return Sin(u * (math::PI / 2.0f)); }
+	template<typename F>
+	static inline F SineInOutShape(F u) { return 0.5f * (1.0f - Cos(u * math::PI)); }
+
+	template<typename F>
+	static inline F QuadInShape(F u) { return u * u; }
+	template<typename F>
+	static inline F QuadOutShape(F u) { return -u * (u - 2.0f); }
+	template<typename F>
+	static inline F QuadInOutShape(F u)
+	{
+		const F v = u * 2.0f;
+		const F w = v - 1.0f;
+		return Select(Less(v, 1.0f), 0.5f * v * v, -0.5f * (w * (w - 2.0f) - 1.0f));
+	}
+
+	template<typename F>
+	static inline F CubicInShape(F u) { return u * u * u; }
+	template<typename F>
+	static inline F CubicOutShape(F u)
+	{
+		const F w = u - 1.0f;
+		return w * w * w + 1.0f;
+	}
+	template<typename F>
+	static inline F CubicInOutShape(F u)
+	{
+		const F v = u * 2.0f;
+		const F w = v - 2.0f;
+		return Select(Less(v, 1.0f), 0.5f * v * v * v, 0.5f * (w * w * w + 2.0f));
+	}
+
+	template<typename F>
+	static inline F QuartInShape(F u)
+	{
+		const F u2 = u * u;
+		return u2 * u2;
+	}
+	template<typename F>
+	static inline F QuartOutShape(F u)
+	{
+		const F w = u - 1.0f;
+		const F w2 = w * w;
+		return 1.0f - w2 * w2;
+	}
+	template<typename F>
+	static inline F QuartInOutShape(F u)
+	{
+		const F v = u * 2.0f;
+		const F w = v - 2.0f;
+		const F v2 = v * v;
+		const F w2 = w * w;
+		return Select(Less(v, 1.0f), 0.5f * v2 * v2, -0.5f * (w2 * w2 - 2.0f));
+	}
+
+	template<typename F>
+	static inline F QuintInShape(F u)
+	{
+		const F u2 = u * u;
+		return u2 * u2 * u;
+	}
+	template<typename F>
+	static inline F QuintOutShape(F u)
+	{
+		const F w = u - 1.0f;
+		const F w2 = w * w;
+		return w2 * w2 * w + 1.0f;
+	}
+	template<typename F>
+	static inline F QuintInOutShape(F u)
+	{
+		const F v = u * 2.0f;
+		const F w = v - 2.0f;
+		const F v2 = v * v;
+		const F w2 = w * w;
+		return Select(Less(v, 1.0f), 0.5f * v2 * v2 * v, 0.5f * (w2 * w2 * w + 2.0f));
+	}
+
+	template<typename F>
+	static inline F ExpoInShape(F u) { return Exp2(10.0f * (u - 1.0f)); }
+	template<typename F>
+	static inline F ExpoOutShape(F u) { return 1.0f - Exp2(-10.0f * u); }
+	template<typename F>
+	static inline F ExpoInOutShape(F u)
+	{
+		const F w = u * 2.0f - 1.0f;
+		const auto firstHalf = Less(w, 0.0f);
+		const F e = Exp2(Select(firstHalf, 10.0f * w, -10.0f * w));
+		return Select(firstHalf, 0.5f * e, 0.5f * (2.0f - e));
+	}
+
+	template<typename F>
+	static inline F CircInShape(F u) { return 1.0f - Sqrt(Max(1.0f - u * u, 0.0f)); }
+	template<typename F>
+	static inline F CircOutShape(F u)
+	{
+		const F w = u - 1.0f;
+		return Sqrt(Max(1.0f - w * w, 0.0f));
+	}
+	template<typename F>
+	static inline F CircInOutShape(F u)
+	{
+		const F v = u * 2.0f;
+		const auto firstHalf = Less(v, 1.0f);
+		const F w = Select(firstHalf, v, v - 2.0f);
+		const F root = Sqrt(Max(1.0f - w * w, 0.0f));
+		return Select(firstHalf, 0.5f * (1.0f - root), 0.5f * (root + 1.0f));
+	}
+
+	template<typename F>
+	static inline F BackInShape(F u)
+	{
+		const float s = 1.70158f;
+		return u * u * ((s + 1.0f) * u - s);
+	}
+	template<typename F>
+	static inline F BackOutShape(F u)
+	{
+		const float s = 1.70158f;
+		const F w = u - 1.0f;
+		return w * w * ((s + 1.0f) * w + s) + 1.0f;
+	}
+	template<typename F>
+	static inline F BackInOutShape(F u)
+	{
+		const float s = 1.70158f * 1.525f;
+		const F v = u * 2.0f;
+		const F w = v - 2.0f;
+		return Select(Less(v, 1.0f), 0.5f * (v * v * ((s + 1.0f) * v - s)), 0.5f * (w * w * ((s + 1.0f) * w + s) + 2.0f));
+	}
+
+	// The elastic curves don't depend on the duration once time is normalised, the period is a fixed share of it
+	template<typename F>
+	static inline F ElasticEnds(F u, F shape)
+	{
+		return Select(Equal(u, 0.0f), 0.0f, Select(Equal(u, 1.0f), 1.0f, shape));
+	}
+
+	template<typename F>
+	static inline F ElasticInShape(F u)
+	{
+		const F w = u - 1.0f;
+		return ElasticEnds(u, -(Exp2(10.0f * w) * Sin((w - 0.075f) * (2.0f * math::PI / 0.3f))));
+	}
+	template<typename F>
+	static inline F ElasticOutShape(F u)
+	{
+		return ElasticEnds(u, Exp2(-10.0f * u) * Sin((u - 0.075f) * (2.0f * math::PI / 0.3f)) + 1.0f);
+	}
+	template<typename F>
+	static inline F ElasticInOutShape(F u)
+	{
+		const F w = u * 2.0f - 1.0f;
+		const auto firstHalf = Less(w, 0.0f);
+		const F wave = Exp2(Select(firstHalf, 10.0f * w, -10.0f * w)) * Sin((w - 0.1125f) * (2.0f * math::PI / 0.45f));
+		return ElasticEnds(u, Select(firstHalf, -0.5f * wave, 0.5f * wave + 1.0f));
+	}
+
+	// Each bounce is the same parabola, moved along and raised
+	template<typename F>
+	static inline F BounceOutShape(F u)
+	{
+		const auto first = Less(u, 1.0f / 2.75f);
+		const auto second = Less(u, 2.0f / 2.75f);
+		const auto third = Less(u, 2.5f / 2.75f);
+		const F offset = Select(first, 0.0f, Select(second, 1.5f / 2.75f, Select(third, 2.25f / 2.75f, 2.625f / 2.75f)));
+		const F height = Select(first, 0.0f, Select(second, 0.75f, Select(third, 0.9375f, 0.984375f)));
+		const F w = u - offset;
+		return 7.5625f * w * w + height;
+	}
+	template<typename F>
+	static inline F BounceInShape(F u) { return 1.0f - BounceOutShape(1.0f - u); }
+	template<typename F>
+	static inline F BounceInOutShape(F u)
+	{
+		const F v = u * 2.0f;
+		const auto firstHalf = Less(v, 1.0f);
+		const F bounce = BounceOutShape(Select(firstHalf, 1.0f - v, v - 1.0f));
+		return Select(firstHalf, 0.5f * (1.0f - bounce), 0.5f + 0.5f * bounce);
+	}
+
+	template<typename F, F(*Shape)(F)>
+	static inline F Ease(F t, F b, F c, F d)
+	{
+		const F u = Min(Max(t / d, 0.0f), 1.0f);
+		return b + c * Shape(u);
+	}
+
+	template<typename F, F(*Shape)(F)>
+	static void EvaluateShape(const float* t, const float* b, const float* c, const float* d, float* out, uint32_t count)
+	{
+		const uint32_t laneCount = Lanes<F>::COUNT;
+
+		uint32_t i = 0;
+		for (; i + laneCount <= count; i += laneCount)
+		{
+			Lanes<F>::Store(out + i, Ease<F, Shape>(Lanes<F>::Load(t + i), Lanes<F>::Load(b + i), Lanes<F>::Load(c + i), Lanes<F>::Load(d + i)));
+		}
+
+		// The last few are padded out to a full register
+		if (i < count)
+		{
+			float tail[4][laneCount] = {};
+			for (uint32_t j = 0; j < laneCount; j++)
+			{
+				tail[3][j] = 1.0f;
+			}
+			for (uint32_t j = 0; i + j < count; j++)
+			{
+				tail[0][j] = t[i + j];
+				tail[1][j] = b[i + j];
+				tail[2][j] = c[i + j];
+				tail[3][j] = d[i + j];
+			}
+
+			float result[laneCount];
+			Lanes<F>::Store(result, Ease<F, Shape>(Lanes<F>::Load(tail[0]), Lanes<F>::Load(tail[1]), Lanes<F>::Load(tail[2]), Lanes<F>::Load(tail[3])));
+			for (uint32_t j = 0; i + j < count; j++)
+			{
+				out[i + j] = result[j];
+			}
+		}
+	}
+
+	using EvaluateBatchFunction = void(*)(const float*, const float*, const float*, const float*, float*, uint32_t);
+
+	// In the order of EasingType
+	template<typename F>
+	static const EvaluateBatchFunction* GetBatchFunctions()
+	{
+		static const EvaluateBatchFunction functions[EASING_TYPE_COUNT] =
+		{
+			EvaluateShape<F, LinearShape<F>>,
+			EvaluateShape<F, SineInShape<F>>, EvaluateShape<F, SineOutShape<F>>, EvaluateShape<F, SineInOutShape<F>>,
+			EvaluateShape<F, QuadInShape<F>>, EvaluateShape<F, QuadOutShape<F>>, EvaluateShape<F, QuadInOutShape<F>>,
+			EvaluateShape<F, CubicInShape<F>>, EvaluateShape<F, CubicOutShape<F>>, EvaluateShape<F, CubicInOutShape<F>>,
+			EvaluateShape<F, QuartInShape<F>>, EvaluateShape<F, QuartOutShape<F>>, EvaluateShape<F, QuartInOutShape<F>>,
+			EvaluateShape<F, QuintInShape<F>>, EvaluateShape<F, QuintOutShape<F>>, EvaluateShape<F, QuintInOutShape<F>>,
+			EvaluateShape<F, ExpoInShape<F>>, EvaluateShape<F, ExpoOutShape<F>>, EvaluateShape<F, ExpoInOutShape<F>>,
+			EvaluateShape<F, CircInShape<F>>, EvaluateShape<F, CircOutShape<F>>, EvaluateShape<F, CircInOutShape<F>>,
+			EvaluateShape<F, BackInShape<F>>, EvaluateShape<F, BackOutShape<F>>, EvaluateShape<F, BackInOutShape<F>>,
+			EvaluateShape<F, ElasticInShape<F>>, EvaluateShape<F, ElasticOutShape<F>>, EvaluateShape<F, ElasticInOutShape<F>>,
+			EvaluateShape<F, BounceInShape<F>>, EvaluateShape<F, BounceOutShape<F>>, EvaluateShape<F, BounceInOutShape<F>>
+		};
+		return functions;
+	}
+
+	// Tables run from ELASTIC_IN to BOUNCE_IN_OUT
+	static const int FIRST_TABLE_TYPE = (int)EasingType::ELASTIC_IN;
+	static const int TABLE_COUNT = (int)EasingType::BOUNCE_IN_OUT - FIRST_TABLE_TYPE + 1;
+
+	struct EasingTable
+	{
+		float m_values[EASING_TABLE_SIZE + 1];
+	};
+
+	// Sampled from the scalar functions the first time they are needed
+	static const EasingTable* GetEasingTables()
+	{
+		static const std::vector<EasingTable> tables = []()
+		{
+			using EaseFunction = float(*)(float, float, float, float);
+			const EaseFunction functions[TABLE_COUNT] = { ElasticIn, ElasticOut, ElasticInOut, BounceIn, BounceOut, BounceInOut };
+
+			std::vector<EasingTable> result(TABLE_COUNT);
+			for (int table = 0; table < TABLE_COUNT; table++)
+			{
+				for (uint32_t i = 0; i <= EASING_TABLE_SIZE; i++)
+				{
+					result[table].m_values[i] = functions[table]((float)i / (float)EASING_TABLE_SIZE, 0.0f, 1.0f, 1.0f);
+				}
+			}
+			return result;
+		}();
+
+		return tables.data();
+	}
+
+	// SSE2 has no gather, so the table is read a value at a time
+	static void EvaluateTable(const EasingTable& table, const float* t, const float* b, const float* c, const float* d, float* out, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const float x = std::min(std::max(t[i] / d[i], 0.0f), 1.0f) * (float)EASING_TABLE_SIZE;
+			const uint32_t index = std::min((uint32_t)x, EASING_TABLE_SIZE - 1);
+			const float a = table.m_values[index];
+			out[i] = b[i] + c[i] * (a + (table.m_values[index + 1] - a) * (x - (float)index));
+		}
+	}
+
+	bool HasEasingTable(EasingType easingType)
+	{
+		return (int)easingType >= FIRST_TABLE_TYPE && (int)easingType < FIRST_TABLE_TYPE + TABLE_COUNT;
+	}
+
+	bool HasSse2EasingKernels()
+	{
+		return RB_EASING_SSE2;
+	}
+
+	void EvaluateBatch(EasingType easingType, const float* t, const float* b, const float* c, const float* d, float* out, uint32_t count, bool useTable)
+	{
+		if (useTable && HasEasingTable(easingType))
+		{
+			EvaluateTable(GetEasingTables()[(int)easingType - FIRST_TABLE_TYPE], t, b, c, d, out, count);
+			return;
+		}
+
+#if RB_EASING_SSE2
+		GetBatchFunctions<Floats4>()[(int)easingType](t, b, c, d, out, count);
+#else
+		GetBatchFunctions<float>()[(int)easingType](t, b, c, d, out, count);
+#endif
+	}
+
+	void EvaluateBatchScalar(EasingType easingType, const float* t, const float* b, const float* c, const float* d, float* out, uint32_t count)
+	{
+		GetBatchFunctions<float>()[(int)easingType](t, b, c, d, out, count);
+	}
+}
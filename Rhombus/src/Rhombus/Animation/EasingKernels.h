@@ -0,0 +1,30 @@
+#pragma once
+
+#include "EasingFunctions.h"
+
+namespace rhombus::easing
+{
+	// Bulk versions of the easing functions, for tweens and anything else easing many values at once. Each call
+	// evaluates one curve over arrays, four values at a time where SSE2 is available
+	//
+	// Every curve is b + c * f(t / d), so f is evaluated on the normalised time. Time is clamped to [0, d] and d must be
+	// above 0. The sine, expo and elastic curves use polynomial approximations of sin and exp2, and match the scalar
+	// functions to within EASING_KERNEL_MAX_ERROR * |c| plus float rounding of b + c * f
+	const float EASING_KERNEL_MAX_ERROR = 1.0e-6f;
+
+	// Elastic and bounce curves can instead be read from tables of f sampled at EASING_TABLE_SIZE intervals, linearly
+	// interpolated. Worth it for elastic curves, or for any of them without SSE2. Less accurate: elastic, where the
+	// scalar functions jump to the end values, and bounce, whose bounces end in corners a straight line cuts across
+	const uint32_t EASING_TABLE_SIZE = 1024;
+	const float EASING_TABLE_MAX_ERROR_ELASTIC = 5.0e-4f;
+	const float EASING_TABLE_MAX_ERROR_BOUNCE = 2.0e-3f;
+
+	bool HasEasingTable(EasingType easingType);
+
+	bool HasSse2EasingKernels();
+
+	// out may be any of the inputs. When useTable is set curves that have a table use it
+	void EvaluateBatch(EasingType easingType, const float* t, const float* b, const float* c, const float* d, float* out, uint32_t count, bool useTable = false);
+	// The same kernels a value at a time, as EvaluateBatch runs them without SSE2. Lets the two be checked against each other
+	void EvaluateBatchScalar(EasingType easingType, const float* t, const float* b, const float* c, const float* d, float* out, uint32_t count);
+}
@@ -1,83 +1,110 @@
 #pragma once
 
 #include "Rhombus/Math/Vector.h"
-#include "Rhombus/Core/DeltaTime.h"
 #include "EasingFunctions.h"
 #include "Rhombus/Scenes/Entity.h"
 
-#include <queue>
-
-namespace rhombus 
+namespace rhombus
 {
 	const int MAX_TWEEN_COMPONENTS = 4;
+	const uint32_t TWEEN_COMPONENT_STRIDE = (uint32_t)sizeof(float);		// Between the floats of a vector field
+
+	class TweenEngine;
+
+	// Where a tween writes: a float field of a component, found through the registry on every update so the tween
+	// stays valid however the component arrays move. Vector fields are written as consecutive floats from the offset
+	struct TweenTarget
+	{
+		EntityID m_entity = INVALID_ENTITY;
+		uint32_t m_generation = 0;				// Of the entity, the tween stops writing if it is destroyed
+		ComponentType m_componentType = 0;
+		uint32_t m_offset = 0;					// Bytes from the start of the component
+		uint32_t m_componentSize = 0;			// Parameter steps check the floats they write fit in it
+
+		// field must point into component, which belongs to entity
+		template<typename T>
+		static TweenTarget Create(Entity entity, const T& component, const void* field)
+		{
+			const ptrdiff_t offset = (const char*)field - (const char*)&component;
+			Log::Assert(offset >= 0 && (size_t)offset + sizeof(float) <= sizeof(T), "Tween field isn't part of the component");
+
+			const Registry& registry = entity.GetContext()->GetRegistry();
+			return { entity, registry.GetEntityGeneration(entity), registry.GetComponentType<T>(), (uint32_t)offset, (uint32_t)sizeof(T) };
+		}
+
+		// Whether numComponents consecutive floats from the offset are all part of the component
+		bool Fits(int numComponents) const
+		{
+			return m_offset + (uint32_t)numComponents * TWEEN_COMPONENT_STRIDE <= m_componentSize;
+		}
+	};
 
 	struct TweenParamsDOF
 	{
-		float* m_fParameter = nullptr;
+		uint32_t m_offset = 0;					// Of this float from the start of the component
 		float m_fBegin = 0.0f;
 		float m_fFinish = 0.0f;
 
 		TweenParamsDOF() = default;
-		TweenParamsDOF(float* x, float begin, float finish)
-			: m_fParameter(x), m_fBegin(begin), m_fFinish(finish)
+		TweenParamsDOF(uint32_t offset, float begin, float finish)
+			: m_offset(offset), m_fBegin(begin), m_fFinish(finish)
 		{
 
 		}
 	};
 
+	// Steps only describe what a tween does, the TweenEngine copies them in when they are added
 	class TweenStep
 	{
 	public:
-		
-		virtual float Step(DeltaTime dt) = 0;
+		float GetDuration() const { return m_fDuration; }
 
 	protected:
-		TweenStep(float duration) : m_fDuration(duration), m_fCurrentTime(0.0f) {};
+		TweenStep(float duration) : m_fDuration(duration) {};
 
 	protected:
-		friend Tween;
+		friend TweenEngine;
 
 		float m_fDuration;
-		float m_fCurrentTime;
 	};
 
 	class TweenParameterStep : public TweenStep
 	{
 	public:
-		TweenParameterStep(float* param, float begin, float finish, float duration, EasingType easingType)
-			: m_iNumComponents(1), m_easingType(easingType), TweenStep(duration)
+		TweenParameterStep(const TweenTarget& target, float begin, float finish, float duration, EasingType easingType)
+			: m_target(target), m_iNumComponents(1), m_easingType(easingType), TweenStep(duration)
 		{
-			m_tweenParamsDOF[0] = { param, begin, finish };
+			Log::Assert(target.Fits(1), "Tween field runs past the end of the component");
+			m_tweenParamsDOF[0] = { target.m_offset, begin, finish };
 		}
 
-		TweenParameterStep(Vec2* param, Vec2 begin, Vec2 finish, float duration, EasingType easingType)
-			: m_iNumComponents(2), m_easingType(easingType), TweenStep(duration)
+		TweenParameterStep(const TweenTarget& target, Vec2 begin, Vec2 finish, float duration, EasingType easingType)
+			: m_target(target), m_iNumComponents(2), m_easingType(easingType), TweenStep(duration)
 		{
-			m_tweenParamsDOF[0] = { &(param->x), begin.x, finish.x };
-			m_tweenParamsDOF[1] = { &(param->y), begin.y, finish.y };
+			Log::Assert(target.Fits(2), "Tween field runs past the end of the component");
+			m_tweenParamsDOF[0] = { target.m_offset, begin.x, finish.x };
+			m_tweenParamsDOF[1] = { target.m_offset + TWEEN_COMPONENT_STRIDE, begin.y, finish.y };
 		}
 
-		TweenParameterStep(Vec3* param, Vec3 begin, Vec3 finish, float duration, EasingType easingType)
-			: m_iNumComponents(3), m_easingType(easingType), TweenStep(duration)
+		TweenParameterStep(const TweenTarget& target, Vec3 begin, Vec3 finish, float duration, EasingType easingType)
+			: m_target(target), m_iNumComponents(3), m_easingType(easingType), TweenStep(duration)
 		{
-			m_tweenParamsDOF[0] = { &(param->x), begin.x, finish.x };
-			m_tweenParamsDOF[1] = { &(param->y), begin.y, finish.y };
-			m_tweenParamsDOF[2] = { &(param->z), begin.z, finish.z };
+			Log::Assert(target.Fits(3), "Tween field runs past the end of the component");
+			m_tweenParamsDOF[0] = { target.m_offset, begin.x, finish.x };
+			m_tweenParamsDOF[1] = { target.m_offset + TWEEN_COMPONENT_STRIDE, begin.y, finish.y };
+			m_tweenParamsDOF[2] = { target.m_offset + 2 * TWEEN_COMPONENT_STRIDE, begin.z, finish.z };
 		}
 
-		TweenParameterStep(Vec4* param, Vec4 begin, Vec4 finish, float duration, EasingType easingType)
-			: m_iNumComponents(4), m_easingType(easingType), TweenStep(duration)
+		TweenParameterStep(const TweenTarget& target, Vec4 begin, Vec4 finish, float duration, EasingType easingType)
+			: m_target(target), m_iNumComponents(4), m_easingType(easingType), TweenStep(duration)
 		{
-			m_tweenParamsDOF[0] = { &(param->x), begin.x, finish.x };
-			m_tweenParamsDOF[1] = { &(param->y), begin.y, finish.y };
-			m_tweenParamsDOF[2] = { &(param->z), begin.z, finish.z };
-			m_tweenParamsDOF[3] = { &(param->w), begin.w, finish.w };
+			Log::Assert(target.Fits(4), "Tween field runs past the end of the component");
+			m_tweenParamsDOF[0] = { target.m_offset, begin.x, finish.x };
+			m_tweenParamsDOF[1] = { target.m_offset + TWEEN_COMPONENT_STRIDE, begin.y, finish.y };
+			m_tweenParamsDOF[2] = { target.m_offset + 2 * TWEEN_COMPONENT_STRIDE, begin.z, finish.z };
+			m_tweenParamsDOF[3] = { target.m_offset + 3 * TWEEN_COMPONENT_STRIDE, begin.w, finish.w };
 		}
 
-		virtual float Step(DeltaTime dt) override;
-
-		float ApplyEasing(EasingType easingType, float t, float b, float c, float d);
-
 		inline TweenParamsDOF operator [] (const int idx) const
 		{
 			return m_tweenParamsDOF[idx];
@@ -88,6 +115,9 @@ namespace rhombus
 			return m_tweenParamsDOF[idx];
 		}
 	private:
+		friend TweenEngine;
+
+		TweenTarget m_target;
 		TweenParamsDOF m_tweenParamsDOF[MAX_TWEEN_COMPONENTS];
 		int m_iNumComponents = 1;
 		EasingType m_easingType;
@@ -101,8 +131,9 @@ namespace rhombus
 		{
 		}
 
-		virtual float Step(DeltaTime dt) override;
 	private:
+		friend TweenEngine;
+
 		Entity m_callbackEntity;
 		std::function<void(Entity)> m_callback;
 	};
@@ -114,50 +145,43 @@ namespace rhombus
 			: TweenStep(duration)
 		{
 		}
-
-		virtual float Step(DeltaTime dt) override;
 	};
 
+	// Handle to a tween run by the TweenEngine of a scene. It is only an index and a generation, so it can be copied
+	// freely and stays safe to use once the tween has finished, when it no longer does anything
 	class Tween
 	{
 	public:
 		Tween() = default;
-		Tween(const TweenParameterStep& tweenStep);
-		Tween(const TweenCallbackStep& tweenStep);
-		Tween(const TweenWaitStep& tweenStep);
-		Tween(float* param, float begin, float finish, float duration, EasingType easingType = EasingType::LINEAR);
-		Tween(Vec2* param, Vec2 begin, Vec2 finish, float duration, EasingType easingType = EasingType::LINEAR);
-		Tween(Vec3* param, Vec3 begin, Vec3 finish, float duration, EasingType easingType = EasingType::LINEAR);
-		Tween(Vec4* param, Vec4 begin, Vec4 finish, float duration, EasingType easingType = EasingType::LINEAR);
 
+		// Writes the begin values of the first step right away, then the tween moves on with each update
 		void Start();
-		void Resume() { m_bIsRunning = true; }
-		void Pause() { m_bIsRunning = false; }
+		void Resume();
+		void Pause();
+		// Drops the steps that haven't finished, parameters are left where they are
+		void Stop();
 
-		bool GetIsFinished() const { return m_bIsFinished; }
-
-		void Step(DeltaTime dt);
+		// Also true for a handle that was never given a tween
+		bool GetIsFinished() const;
+		// Called once when the tween is done, whether it ran out of steps or was stopped, on its own or with its entity.
+		// Right away if it already is
+		void SetOnFinished(std::function<void()> onFinished);
 
 		void AddTweenStep(const TweenParameterStep& tweenStep);
 		void AddTweenStep(const TweenCallbackStep& tweenStep);
 		void AddTweenStep(const TweenWaitStep& tweenStep);
+
 	private:
-		struct TweenParamsDOF
+		Tween(TweenEngine* engine, uint32_t index, uint32_t generation)
+			: m_engine(engine), m_index(index), m_generation(generation)
 		{
-			float* m_fParameter = nullptr;
-			float m_fBegin = 0.0f;
-			float m_fFinish = 0.0f;
-
-			TweenParamsDOF() = default;
-			TweenParamsDOF(float* x, float begin, float finish)
-				: m_fParameter(x), m_fBegin(begin), m_fFinish(finish)
-			{
+		}
 
-			}
-		};
+	private:
+		friend TweenEngine;
 
-		std::queue<Ref<TweenStep>> m_tweenSteps;
-		bool m_bIsRunning;
-		bool m_bIsFinished;
+		TweenEngine* m_engine = nullptr;
+		uint32_t m_index = 0;
+		uint32_t m_generation = 0;
 	};
 }
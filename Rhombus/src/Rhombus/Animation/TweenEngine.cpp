@@ -0,0 +1,668 @@
+#include "rbpch.h"
+#include "TweenEngine.h"
+
+#include "EasingKernels.h"
+
+namespace rhombus
+{
+	static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+	// Advances and evaluates the lanes of one easing group from firstLane on, as separate passes over the arrays. The
+	// easing kernels clamp time to the duration
+	static void EvaluateLanes(TweenEngine::TweenLanes& lanes, EasingType easingType, float dt, uint32_t firstLane = 0)
+	{
+		const uint32_t count = lanes.Size() - firstLane;
+		float* times = lanes.m_times.data() + firstLane;
+		const float* rates = lanes.m_rates.data() + firstLane;
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			times[i] += dt * rates[i];
+		}
+
+		easing::EvaluateBatch(easingType, times, lanes.m_begins.data() + firstLane, lanes.m_changes.data() + firstLane, lanes.m_durations.data() + firstLane,
+			lanes.m_values.data() + firstLane, count);
+	}
+
+	void TweenEngine::TweenLanes::Add(uint32_t tween, float time, float duration, float rate, float begin, float change, const TweenTarget& target, uint32_t offset)
+	{
+		m_tweens.push_back(tween);
+		m_times.push_back(time);
+		m_durations.push_back(duration);
+		m_rates.push_back(rate);
+		m_begins.push_back(begin);
+		m_changes.push_back(change);
+		m_values.push_back(begin);
+		m_entities.push_back(target.m_entity);
+		m_generations.push_back(target.m_generation);
+		m_componentTypes.push_back(target.m_componentType);
+		m_offsets.push_back(offset);
+	}
+
+	void TweenEngine::TweenLanes::Remove(uint32_t lane)
+	{
+		// An old lane is filled by the last old lane, whose place is then filled by the last lane
+		if (lane < m_firstNewLane)
+		{
+			m_firstNewLane--;
+			CopyLane(m_firstNewLane, lane);
+			lane = m_firstNewLane;
+		}
+		CopyLane(Size() - 1, lane);
+
+		m_tweens.pop_back();
+		m_times.pop_back();
+		m_durations.pop_back();
+		m_rates.pop_back();
+		m_begins.pop_back();
+		m_changes.pop_back();
+		m_values.pop_back();
+		m_entities.pop_back();
+		m_generations.pop_back();
+		m_componentTypes.pop_back();
+		m_offsets.pop_back();
+	}
+
+	void TweenEngine::TweenLanes::Clear()
+	{
+		m_tweens.clear();
+		m_times.clear();
+		m_durations.clear();
+		m_rates.clear();
+		m_begins.clear();
+		m_changes.clear();
+		m_values.clear();
+		m_entities.clear();
+		m_generations.clear();
+		m_componentTypes.clear();
+		m_offsets.clear();
+		m_firstNewLane = 0;
+	}
+
+	void TweenEngine::TweenLanes::CopyLane(uint32_t from, uint32_t to)
+	{
+		if (from == to)
+		{
+			return;
+		}
+
+		m_tweens[to] = m_tweens[from];
+		m_times[to] = m_times[from];
+		m_durations[to] = m_durations[from];
+		m_rates[to] = m_rates[from];
+		m_begins[to] = m_begins[from];
+		m_changes[to] = m_changes[from];
+		m_values[to] = m_values[from];
+		m_entities[to] = m_entities[from];
+		m_generations[to] = m_generations[from];
+		m_componentTypes[to] = m_componentTypes[from];
+		m_offsets[to] = m_offsets[from];
+	}
+
+	Tween TweenEngine::CreateTween(Entity entity, const TweenParameterStep& tweenStep)
+	{
+		Tween tween = CreateTween(entity, INVALID_INDEX);
+		AddTweenStep(tween, tweenStep);
+		return tween;
+	}
+
+	Tween TweenEngine::CreateTween(Entity entity, const TweenCallbackStep& tweenStep)
+	{
+		Tween tween = CreateTween(entity, INVALID_INDEX);
+		AddTweenStep(tween, tweenStep);
+		return tween;
+	}
+
+	Tween TweenEngine::CreateTween(Entity entity, const TweenWaitStep& tweenStep)
+	{
+		Tween tween = CreateTween(entity, INVALID_INDEX);
+		AddTweenStep(tween, tweenStep);
+		return tween;
+	}
+
+	Tween TweenEngine::CreateTween(Entity entity, uint32_t step)
+	{
+		uint32_t index;
+		if (m_freeTweens.empty())
+		{
+			index = (uint32_t)m_tweens.size();
+			m_tweens.emplace_back();
+		}
+		else
+		{
+			index = m_freeTweens.back();
+			m_freeTweens.pop_back();
+		}
+
+		TweenData& tween = m_tweens[index];
+		tween.m_entity = entity;
+		tween.m_firstStep = step;
+		tween.m_lastStep = step;
+		tween.m_activeLanes = 0;
+		tween.m_inUse = true;
+		tween.m_started = false;
+		tween.m_paused = false;
+
+		m_entityTweenCounts[tween.m_entity]++;
+		m_tweenCount++;
+		return Tween(this, index, tween.m_generation);
+	}
+
+	void TweenEngine::AddTweenStep(const Tween& tween, const TweenParameterStep& tweenStep)
+	{
+		const uint32_t step = AllocateStep(StepType::Parameter, tweenStep.m_fDuration);
+		StepData& stepData = m_steps[step];
+		stepData.m_easingType = tweenStep.m_easingType;
+		stepData.m_numComponents = tweenStep.m_iNumComponents;
+		stepData.m_target = tweenStep.m_target;
+		for (int i = 0; i < tweenStep.m_iNumComponents; i++)
+		{
+			stepData.m_tweenParamsDOF[i] = tweenStep.m_tweenParamsDOF[i];
+		}
+		AppendStep(tween, step);
+	}
+
+	void TweenEngine::AddTweenStep(const Tween& tween, const TweenCallbackStep& tweenStep)
+	{
+		const uint32_t step = AllocateStep(StepType::Callback, 0.0f);
+		m_steps[step].m_callback = tweenStep.m_callback;
+		m_steps[step].m_callbackEntity = tweenStep.m_callbackEntity;
+		AppendStep(tween, step);
+	}
+
+	void TweenEngine::AddTweenStep(const Tween& tween, const TweenWaitStep& tweenStep)
+	{
+		AppendStep(tween, AllocateStep(StepType::Wait, tweenStep.m_fDuration));
+	}
+
+	void TweenEngine::Start(const Tween& tween)
+	{
+		TweenData* tweenData = GetTweenData(tween);
+		if (!tweenData)
+		{
+			return;
+		}
+
+		if (tweenData->m_started)
+		{
+			Resume(tween);
+			return;
+		}
+
+		tweenData->m_started = true;
+		BeginNextStep(tween.m_index, 0.0f, true);
+		FlushWrites();
+	}
+
+	void TweenEngine::Resume(const Tween& tween)
+	{
+		TweenData* tweenData = GetTweenData(tween);
+		if (tweenData && tweenData->m_paused)
+		{
+			tweenData->m_paused = false;
+			SetRate(tween.m_index, 1.0f);
+		}
+	}
+
+	void TweenEngine::Pause(const Tween& tween)
+	{
+		TweenData* tweenData = GetTweenData(tween);
+		if (tweenData && !tweenData->m_paused)
+		{
+			tweenData->m_paused = true;
+			SetRate(tween.m_index, 0.0f);
+		}
+	}
+
+	void TweenEngine::Stop(const Tween& tween)
+	{
+		if (GetTweenData(tween))
+		{
+			StopTween(tween.m_index);
+		}
+	}
+
+	bool TweenEngine::IsFinished(const Tween& tween) const
+	{
+		return tween.m_index >= m_tweens.size() || m_tweens[tween.m_index].m_generation != tween.m_generation;
+	}
+
+	void TweenEngine::SetOnFinished(const Tween& tween, std::function<void()> onFinished)
+	{
+		TweenData* tweenData = GetTweenData(tween);
+		if (tweenData)
+		{
+			tweenData->m_onFinished = std::move(onFinished);
+		}
+		else if (onFinished)
+		{
+			onFinished();
+		}
+	}
+
+	void TweenEngine::Update(DeltaTime dt)
+	{
+		RB_PROFILE_FUNCTION();
+
+		// Nothing moves without time passing, but lanes may still have finished when they began
+		const bool advanced = dt > 0.0f;
+		for (int easingType = 0; easingType < EASING_TYPE_COUNT; easingType++)
+		{
+			if (advanced && m_parameterLanes[easingType].Size() > 0)
+			{
+				EvaluateLanes(m_parameterLanes[easingType], (EasingType)easingType, dt);
+			}
+		}
+
+		const uint32_t waitCount = m_waitLanes.Size();
+		float* waitTimes = m_waitLanes.m_times.data();
+		const float* waitRates = m_waitLanes.m_rates.data();
+		for (uint32_t i = 0; i < waitCount; i++)
+		{
+			waitTimes[i] += dt * waitRates[i];
+		}
+
+		// Lanes that finish this update are written at their end value before they are removed. Paused lanes keep the
+		// value they were last written with
+		for (TweenLanes& lanes : m_parameterLanes)
+		{
+			if (advanced)
+			{
+				AddWrites(lanes, 0, true);
+			}
+			CollectFinishedLanes(lanes);
+			lanes.m_firstNewLane = lanes.Size();
+		}
+		CollectFinishedLanes(m_waitLanes);
+
+		// The lanes of a step share their time and duration so finish together, the tween moves on with the last.
+		// Callbacks may stop tweens, which is caught by the generation
+		for (size_t i = 0; i < m_finishedLanes.size(); i++)
+		{
+			const FinishedLane finishedLane = m_finishedLanes[i];
+			TweenData& tween = m_tweens[finishedLane.m_tween];
+			if (tween.m_generation == finishedLane.m_generation && --tween.m_activeLanes == 0)
+			{
+				BeginNextStep(finishedLane.m_tween, finishedLane.m_overshoot, false);
+			}
+		}
+		m_finishedLanes.clear();
+
+		// Steps that began part way through the update are written at the time left over from the last
+		for (int easingType = 0; easingType < EASING_TYPE_COUNT; easingType++)
+		{
+			TweenLanes& lanes = m_parameterLanes[easingType];
+			if (lanes.m_firstNewLane < lanes.Size())
+			{
+				EvaluateLanes(lanes, (EasingType)easingType, 0.0f, lanes.m_firstNewLane);
+				AddWrites(lanes, lanes.m_firstNewLane);
+				lanes.m_firstNewLane = lanes.Size();
+			}
+		}
+
+		FlushWrites();
+	}
+
+	void TweenEngine::StopEntity(EntityID entity)
+	{
+		auto it = m_entityTweenCounts.find(entity);
+		if (it == m_entityTweenCounts.end())
+		{
+			return;
+		}
+
+		for (uint32_t i = 0; i < (uint32_t)m_tweens.size(); i++)
+		{
+			if (m_tweens[i].m_inUse && m_tweens[i].m_entity == entity)
+			{
+				StopTween(i);
+			}
+		}
+	}
+
+	void TweenEngine::Clear()
+	{
+		for (uint32_t i = 0; i < (uint32_t)m_tweens.size(); i++)
+		{
+			if (m_tweens[i].m_inUse)
+			{
+				ReleaseTween(i);
+			}
+		}
+
+		for (TweenLanes& lanes : m_parameterLanes)
+		{
+			lanes.Clear();
+		}
+		m_waitLanes.Clear();
+		m_finishedLanes.clear();
+		m_writes.clear();
+	}
+
+	uint32_t TweenEngine::GetLaneCount() const
+	{
+		uint32_t laneCount = m_waitLanes.Size();
+		for (const TweenLanes& lanes : m_parameterLanes)
+		{
+			laneCount += lanes.Size();
+		}
+		return laneCount;
+	}
+
+	TweenEngine::TweenData* TweenEngine::GetTweenData(const Tween& tween)
+	{
+		return IsFinished(tween) ? nullptr : &m_tweens[tween.m_index];
+	}
+
+	void TweenEngine::ReleaseTween(uint32_t tween)
+	{
+		TweenData& tweenData = m_tweens[tween];
+		uint32_t step = tweenData.m_firstStep;
+		while (step != INVALID_INDEX)
+		{
+			const uint32_t next = m_steps[step].m_next;
+			ReleaseStep(step);
+			step = next;
+		}
+
+		auto it = m_entityTweenCounts.find(tweenData.m_entity);
+		if (--it->second == 0)
+		{
+			m_entityTweenCounts.erase(it);
+		}
+
+		tweenData.m_generation++;
+		tweenData.m_entity = INVALID_ENTITY;
+		tweenData.m_firstStep = INVALID_INDEX;
+		tweenData.m_lastStep = INVALID_INDEX;
+		tweenData.m_activeLanes = 0;
+		tweenData.m_inUse = false;
+
+		// Run once the tween is gone, it may create or stop tweens
+		std::function<void()> onFinished = std::move(tweenData.m_onFinished);
+		tweenData.m_onFinished = nullptr;
+
+		m_freeTweens.push_back(tween);
+		m_tweenCount--;
+
+		if (onFinished)
+		{
+			onFinished();
+		}
+	}
+
+	void TweenEngine::StopTween(uint32_t tween)
+	{
+		if (m_tweens[tween].m_activeLanes > 0)
+		{
+			RemoveLanes(tween);
+		}
+		ReleaseTween(tween);
+	}
+
+	uint32_t TweenEngine::AllocateStep(StepType type, float duration)
+	{
+		uint32_t step;
+		if (m_freeSteps.empty())
+		{
+			step = (uint32_t)m_steps.size();
+			m_steps.emplace_back();
+		}
+		else
+		{
+			step = m_freeSteps.back();
+			m_freeSteps.pop_back();
+		}
+
+		StepData& stepData = m_steps[step];
+		stepData.m_type = type;
+		stepData.m_duration = std::max(duration, 0.0f);
+		stepData.m_next = INVALID_INDEX;
+		return step;
+	}
+
+	void TweenEngine::ReleaseStep(uint32_t step)
+	{
+		// Callbacks can hold on to anything
+		m_steps[step].m_callback = nullptr;
+		m_freeSteps.push_back(step);
+	}
+
+	void TweenEngine::AppendStep(const Tween& tween, uint32_t step)
+	{
+		TweenData* tweenData = GetTweenData(tween);
+		if (!tweenData)
+		{
+			ReleaseStep(step);
+			return;
+		}
+
+		if (tweenData->m_lastStep == INVALID_INDEX)
+		{
+			tweenData->m_firstStep = step;
+		}
+		else
+		{
+			m_steps[tweenData->m_lastStep].m_next = step;
+		}
+		tweenData->m_lastStep = step;
+	}
+
+	void TweenEngine::BeginNextStep(uint32_t tween, float time, bool writeBegins)
+	{
+		while (true)
+		{
+			// Callbacks can create tweens, which may move the pool
+			TweenData& tweenData = m_tweens[tween];
+			const uint32_t step = tweenData.m_firstStep;
+			if (step == INVALID_INDEX)
+			{
+				ReleaseTween(tween);
+				return;
+			}
+
+			tweenData.m_firstStep = m_steps[step].m_next;
+			if (tweenData.m_firstStep == INVALID_INDEX)
+			{
+				tweenData.m_lastStep = INVALID_INDEX;
+			}
+
+			const StepData& stepData = m_steps[step];
+			const float rate = tweenData.m_paused ? 0.0f : 1.0f;
+			switch (stepData.m_type)
+			{
+			case StepType::Parameter:
+				for (int i = 0; i < stepData.m_numComponents; i++)
+				{
+					const TweenParamsDOF& dof = stepData.m_tweenParamsDOF[i];
+
+					// Nothing to ease over, the parameter goes straight to the end
+					if (stepData.m_duration <= 0.0f)
+					{
+						AddWrite(stepData.m_target, dof.m_offset, dof.m_fFinish);
+						continue;
+					}
+
+					m_parameterLanes[(int)stepData.m_easingType].Add(tween, time, stepData.m_duration, rate, dof.m_fBegin, dof.m_fFinish - dof.m_fBegin, stepData.m_target, dof.m_offset);
+					tweenData.m_activeLanes++;
+					if (writeBegins)
+					{
+						AddWrite(stepData.m_target, dof.m_offset, dof.m_fBegin);
+					}
+				}
+				break;
+			case StepType::Wait:
+				if (stepData.m_duration > 0.0f)
+				{
+					m_waitLanes.Add(tween, time, stepData.m_duration, rate, 0.0f, 0.0f, TweenTarget(), 0);
+					tweenData.m_activeLanes++;
+				}
+				break;
+			case StepType::Callback:
+			{
+				std::function<void(Entity)> callback = std::move(m_steps[step].m_callback);
+				const Entity callbackEntity = stepData.m_callbackEntity;
+				const uint32_t generation = tweenData.m_generation;
+				ReleaseStep(step);
+
+				callback(callbackEntity);
+
+				// Stopped by its own callback
+				if (m_tweens[tween].m_generation != generation)
+				{
+					return;
+				}
+				continue;
+			}
+			}
+
+			ReleaseStep(step);
+			if (m_tweens[tween].m_activeLanes > 0)
+			{
+				return;
+			}
+		}
+	}
+
+	void TweenEngine::CollectFinishedLanes(TweenLanes& lanes)
+	{
+		uint32_t lane = 0;
+		while (lane < lanes.Size())
+		{
+			if (lanes.m_times[lane] >= lanes.m_durations[lane])
+			{
+				const uint32_t tween = lanes.m_tweens[lane];
+				m_finishedLanes.push_back({ tween, m_tweens[tween].m_generation, lanes.m_times[lane] - lanes.m_durations[lane] });
+				lanes.Remove(lane);
+			}
+			else
+			{
+				lane++;
+			}
+		}
+	}
+
+	void TweenEngine::SetRate(uint32_t tween, float rate)
+	{
+		if (m_tweens[tween].m_activeLanes == 0)
+		{
+			return;
+		}
+
+		auto setRate = [tween, rate](TweenLanes& lanes)
+		{
+			for (uint32_t lane = 0; lane < lanes.Size(); lane++)
+			{
+				if (lanes.m_tweens[lane] == tween)
+				{
+					lanes.m_rates[lane] = rate;
+				}
+			}
+		};
+
+		for (TweenLanes& lanes : m_parameterLanes)
+		{
+			setRate(lanes);
+		}
+		setRate(m_waitLanes);
+	}
+
+	void TweenEngine::RemoveLanes(uint32_t tween)
+	{
+		auto removeLanes = [tween](TweenLanes& lanes)
+		{
+			uint32_t lane = 0;
+			while (lane < lanes.Size())
+			{
+				if (lanes.m_tweens[lane] == tween)
+				{
+					lanes.Remove(lane);
+				}
+				else
+				{
+					lane++;
+				}
+			}
+		};
+
+		for (TweenLanes& lanes : m_parameterLanes)
+		{
+			removeLanes(lanes);
+		}
+		removeLanes(m_waitLanes);
+	}
+
+	void TweenEngine::AddWrite(const TweenTarget& target, uint32_t offset, float value)
+	{
+		const uint64_t order = (uint64_t)m_writes.size();
+		Log::Assert(order < (1ull << 24), "Too many tween writes in one update");
+
+		const uint64_t key = ((uint64_t)target.m_componentType << 56) | ((uint64_t)target.m_entity << 24) | order;
+		m_writes.push_back({ key, target.m_generation, offset, value });
+	}
+
+	void TweenEngine::AddWrites(const TweenLanes& lanes, uint32_t firstLane, bool skipPaused)
+	{
+		const uint32_t count = lanes.Size();
+		for (uint32_t lane = firstLane; lane < count; lane++)
+		{
+			if (skipPaused && lanes.m_rates[lane] == 0.0f)
+			{
+				continue;
+			}
+
+			const uint64_t order = (uint64_t)m_writes.size();
+			const uint64_t key = ((uint64_t)lanes.m_componentTypes[lane] << 56) | ((uint64_t)lanes.m_entities[lane] << 24) | order;
+			m_writes.push_back({ key, lanes.m_generations[lane], lanes.m_offsets[lane], lanes.m_values[lane] });
+		}
+		Log::Assert(m_writes.size() <= (1ull << 24), "Too many tween writes in one update");
+	}
+
+	void TweenEngine::FlushWrites()
+	{
+		if (m_writes.empty())
+		{
+			return;
+		}
+
+		std::sort(m_writes.begin(), m_writes.end(), [](const TweenWrite& a, const TweenWrite& b) { return a.m_key < b.m_key; });
+
+		const Registry& registry = m_scene->GetRegistry();
+		ComponentArrayBase* componentArray = nullptr;
+		char* component = nullptr;
+		uint64_t componentKey = ~0ull;
+		uint32_t generation = 0;
+
+		for (const TweenWrite& write : m_writes)
+		{
+			// Writes to the same component are together, it is found once and told it changed after the last
+			if ((write.m_key >> 24) != componentKey)
+			{
+				if (component)
+				{
+					componentArray->OnDataChanged(component);
+				}
+
+				componentKey = write.m_key >> 24;
+				const ComponentType componentType = (ComponentType)(componentKey >> 32);
+				const EntityID entity = (EntityID)componentKey;
+
+				componentArray = registry.GetComponentArray(componentType);
+				component = (char*)componentArray->GetDataPointer(entity);
+				generation = registry.GetEntityGeneration(entity);
+			}
+
+			// Tweens made for an entity that was destroyed, whose ID has been reused, are left out
+			if (component && write.m_generation == generation)
+			{
+				std::memcpy(component + write.m_offset, &write.m_value, sizeof(float));
+			}
+		}
+
+		if (component)
+		{
+			componentArray->OnDataChanged(component);
+		}
+		m_writes.clear();
+	}
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Tween.h"
+#include "Rhombus/Core/DeltaTime.h"
+
+namespace rhombus
+{
+	// Runs the tweens of a scene. Each degree of freedom of a running parameter step is a lane, and lanes are kept as
+	// arrays grouped by easing type so a group is evaluated in one loop with no branching on the easing per value.
+	// Values are written to their components once per update, sorted by component type and entity so each component
+	// is looked up once and told it changed. Tweens and steps are pooled, so once the pools have grown starting a tween
+	// doesn't allocate
+	class TweenEngine
+	{
+	public:
+		TweenEngine(Scene* scene) : m_scene(scene) {}
+
+		Tween CreateTween(Entity entity, const TweenParameterStep& tweenStep);
+		Tween CreateTween(Entity entity, const TweenCallbackStep& tweenStep);
+		Tween CreateTween(Entity entity, const TweenWaitStep& tweenStep);
+
+		void AddTweenStep(const Tween& tween, const TweenParameterStep& tweenStep);
+		void AddTweenStep(const Tween& tween, const TweenCallbackStep& tweenStep);
+		void AddTweenStep(const Tween& tween, const TweenWaitStep& tweenStep);
+
+		void Start(const Tween& tween);
+		void Resume(const Tween& tween);
+		void Pause(const Tween& tween);
+		void Stop(const Tween& tween);
+		bool IsFinished(const Tween& tween) const;
+		void SetOnFinished(const Tween& tween, std::function<void()> onFinished);
+
+		// Advances the running steps, then moves the tweens whose step finished on to their next step. Time left over
+		// from a step carries into the next one. Callbacks reached are run here and may create or stop tweens. Only
+		// lanes that moved are written
+		void Update(DeltaTime dt);
+
+		// Stops the tweens created for the entity
+		void StopEntity(EntityID entity);
+		void Clear();
+
+		uint32_t GetTweenCount() const { return m_tweenCount; }
+		uint32_t GetLaneCount() const;
+
+		// Lanes of running steps, the arrays are indexed by lane
+		struct TweenLanes
+		{
+			std::vector<uint32_t> m_tweens;
+			std::vector<float> m_times;				// Not clamped, a lane has finished once its time reaches the duration
+			std::vector<float> m_durations;
+			std::vector<float> m_rates;				// 0 while the tween is paused
+			std::vector<float> m_begins;
+			std::vector<float> m_changes;
+			std::vector<float> m_values;
+			std::vector<EntityID> m_entities;
+			std::vector<uint32_t> m_generations;
+			std::vector<ComponentType> m_componentTypes;
+			std::vector<uint32_t> m_offsets;
+			uint32_t m_firstNewLane = 0;			// Lanes added since the update evaluated the rest are at the end, from here
+
+			uint32_t Size() const { return (uint32_t)m_tweens.size(); }
+			void Add(uint32_t tween, float time, float duration, float rate, float begin, float change, const TweenTarget& target, uint32_t offset);
+			// Swaps the last lane into its place, keeping the new lanes at the end
+			void Remove(uint32_t lane);
+			void Clear();
+
+		private:
+			void CopyLane(uint32_t from, uint32_t to);
+		};
+
+	private:
+		enum class StepType : uint8_t { Parameter, Callback, Wait };
+
+		struct StepData
+		{
+			StepType m_type = StepType::Wait;
+			float m_duration = 0.0f;
+			EasingType m_easingType = EasingType::LINEAR;
+			int m_numComponents = 0;
+			TweenTarget m_target;
+			TweenParamsDOF m_tweenParamsDOF[MAX_TWEEN_COMPONENTS];
+			std::function<void(Entity)> m_callback;
+			Entity m_callbackEntity;
+			uint32_t m_next;
+		};
+
+		struct TweenData
+		{
+			uint32_t m_generation = 0;
+			EntityID m_entity = INVALID_ENTITY;
+			uint32_t m_firstStep;				// Steps that haven't been reached, in order
+			uint32_t m_lastStep;
+			uint32_t m_activeLanes = 0;			// Lanes of the current step that haven't finished
+			std::function<void()> m_onFinished;
+			bool m_inUse = false;
+			bool m_started = false;
+			bool m_paused = false;
+		};
+
+		struct FinishedLane
+		{
+			uint32_t m_tween;
+			uint32_t m_generation;
+			float m_overshoot;
+		};
+
+		struct TweenWrite
+		{
+			uint64_t m_key;						// Component type, then entity, then the order it was made in
+			uint32_t m_generation;
+			uint32_t m_offset;
+			float m_value;
+		};
+
+		Tween CreateTween(Entity entity, uint32_t step);
+		TweenData* GetTweenData(const Tween& tween);
+		void ReleaseTween(uint32_t tween);
+		void StopTween(uint32_t tween);
+
+		uint32_t AllocateStep(StepType type, float duration);
+		void ReleaseStep(uint32_t step);
+		void AppendStep(const Tween& tween, uint32_t step);
+
+		// Runs steps from the front of the tween starting time into the first, until one has lanes to run. Releases
+		// the tween when it runs out of steps. writeBegins writes the lanes' begin values, for steps begun outside
+		// the update
+		void BeginNextStep(uint32_t tween, float time, bool writeBegins);
+		void CollectFinishedLanes(TweenLanes& lanes);
+		void SetRate(uint32_t tween, float rate);
+		void RemoveLanes(uint32_t tween);
+
+		void AddWrite(const TweenTarget& target, uint32_t offset, float value);
+		void AddWrites(const TweenLanes& lanes, uint32_t firstLane = 0, bool skipPaused = false);
+		// Writes the values to the components of entities that still exist, last written wins
+		void FlushWrites();
+
+	private:
+		Scene* m_scene;
+
+		std::vector<TweenData> m_tweens;
+		std::vector<uint32_t> m_freeTweens;
+		std::vector<StepData> m_steps;
+		std::vector<uint32_t> m_freeSteps;
+
+		TweenLanes m_parameterLanes[EASING_TYPE_COUNT];
+		TweenLanes m_waitLanes;					// Only times, durations and rates are used
+		std::vector<FinishedLane> m_finishedLanes;
+		std::vector<TweenWrite> m_writes;
+
+		std::unordered_map<EntityID, uint32_t> m_entityTweenCounts;
+		uint32_t m_tweenCount = 0;
+	};
+}
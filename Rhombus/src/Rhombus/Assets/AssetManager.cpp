@@ -0,0 +1,369 @@
+#include "rbpch.h"
+#include "AssetManager.h"
+#include "TextureLoader.h"
+
+#include "Rhombus/Renderer/SharedTexture2D.h"
+
+namespace rhombus {
+
+	struct TextureAsset
+	{
+		Ref<Texture2D> Texture;
+		std::string Path;
+		size_t DecodedSize = 0;
+		uint64_t LastAccess = 0;
+	};
+
+	struct TexturePath
+	{
+		uint64_t Hash = 0;
+		// Handle given out for this path. The asset's texture for the path it was loaded from, otherwise a
+		// SharedTexture2D of it that keeps this path
+		Ref<Texture2D> Texture;
+		std::filesystem::file_time_type WriteTime;
+	};
+
+	struct AssetManagerData
+	{
+		// Textures are keyed by content hash, paths map onto them so the same file under different names loads once
+		std::unordered_map<uint64_t, TextureAsset> Textures;
+		std::unordered_map<std::string, TexturePath> TexturePaths;
+		// Paths as they were asked for, to their canonical path. Lets repeat requests skip the file system
+		std::unordered_map<std::string, std::string> RequestedPaths;
+		// Asynchronous loads by canonical path, the content hash is only known once the file is decoded
+		std::unordered_map<std::string, Ref<Texture2D>> PendingTextures;
+
+		size_t TextureBudget = 0;
+		uint64_t AccessCounter = 0;
+
+		AssetManagerStats Stats;
+	};
+
+	static AssetManagerData s_AssetData;
+
+	namespace utils
+	{
+		static std::string GetCanonicalPath(const std::filesystem::path& path)
+		{
+			std::error_code error;
+			std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+			if (error)
+				canonical = std::filesystem::absolute(path, error).lexically_normal();
+
+			return canonical.generic_string();
+		}
+
+		static std::filesystem::file_time_type GetWriteTime(const std::filesystem::path& path)
+		{
+			std::error_code error;
+			const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+			return error ? std::filesystem::file_time_type::min() : writeTime;
+		}
+	}
+
+	// Handles to an asset held outside the cache, to its own texture or to the shared textures of its other paths.
+	// Every path keeps one reference to the asset's texture, directly or through its shared texture
+	static long GetOutsideReferences(uint64_t hash, const TextureAsset& asset)
+	{
+		long references = asset.Texture.use_count() - 1;
+		for (const auto& [path, texturePath] : s_AssetData.TexturePaths)
+		{
+			if (texturePath.Hash != hash)
+				continue;
+
+			references--;
+			if (texturePath.Texture != asset.Texture)
+				references += texturePath.Texture.use_count() - 1;
+		}
+
+		return references;
+	}
+
+	static void EvictTexture(uint64_t hash)
+	{
+		auto it = s_AssetData.Textures.find(hash);
+		if (it == s_AssetData.Textures.end())
+			return;
+
+		s_AssetData.Stats.TextureMemory -= it->second.DecodedSize;
+		s_AssetData.Stats.TextureEvictions++;
+		s_AssetData.Textures.erase(it);
+		s_AssetData.Stats.TextureCount = (uint32_t)s_AssetData.Textures.size();
+
+		for (auto pathIt = s_AssetData.TexturePaths.begin(); pathIt != s_AssetData.TexturePaths.end();)
+		{
+			if (pathIt->second.Hash == hash)
+				pathIt = s_AssetData.TexturePaths.erase(pathIt);
+			else
+				++pathIt;
+		}
+	}
+
+	static void EnforceTextureBudget()
+	{
+		if (s_AssetData.TextureBudget == 0)
+			return;
+
+		while (s_AssetData.Stats.TextureMemory > s_AssetData.TextureBudget)
+		{
+			// Least recently used texture that nothing outside the cache is holding on to
+			uint64_t oldestHash = 0;
+			uint64_t oldestAccess = UINT64_MAX;
+			for (const auto& [hash, asset] : s_AssetData.Textures)
+			{
+				if (asset.LastAccess < oldestAccess && GetOutsideReferences(hash, asset) == 0)
+				{
+					oldestHash = hash;
+					oldestAccess = asset.LastAccess;
+				}
+			}
+
+			if (oldestAccess == UINT64_MAX)
+				break;
+
+			EvictTexture(oldestHash);
+		}
+	}
+
+	static Ref<Texture2D> FindCachedTexture(const std::string& canonicalPath)
+	{
+		auto pathIt = s_AssetData.TexturePaths.find(canonicalPath);
+		if (pathIt != s_AssetData.TexturePaths.end())
+		{
+			s_AssetData.Textures[pathIt->second.Hash].LastAccess = ++s_AssetData.AccessCounter;
+			s_AssetData.Stats.TextureCacheHits++;
+			return pathIt->second.Texture;
+		}
+
+		auto pendingIt = s_AssetData.PendingTextures.find(canonicalPath);
+		if (pendingIt != s_AssetData.PendingTextures.end())
+		{
+			s_AssetData.Stats.TextureCacheHits++;
+			return pendingIt->second;
+		}
+
+		return nullptr;
+	}
+
+	// Canonical path of a path as asked for. Only the first request for each spelling of a path touches the file system
+	static const std::string& ResolveRequestedPath(const std::filesystem::path& path)
+	{
+		auto [requestedIt, inserted] = s_AssetData.RequestedPaths.try_emplace(path.string());
+		if (inserted)
+			requestedIt->second = utils::GetCanonicalPath(path);
+
+		return requestedIt->second;
+	}
+
+	void AssetManager::Shutdown()
+	{
+		s_AssetData.Textures.clear();
+		s_AssetData.TexturePaths.clear();
+		s_AssetData.RequestedPaths.clear();
+		s_AssetData.PendingTextures.clear();
+		s_AssetData.Stats.TextureCount = 0;
+		s_AssetData.Stats.TextureMemory = 0;
+	}
+
+	Ref<Texture2D> AssetManager::GetTexture(const std::filesystem::path& path)
+	{
+		RB_PROFILE_FUNCTION();
+
+		const std::string canonicalPath = ResolveRequestedPath(path);
+		if (Ref<Texture2D> texture = FindCachedTexture(canonicalPath))
+			return texture;
+
+		// The file is read once, for its content hash and then for decoding
+		std::vector<uint8_t> encoded;
+		if (!TextureLoader::ReadFile(path.string(), encoded))
+		{
+			Log::Error("Could not read texture %s", path.string().c_str());
+			return Texture2D::Create(path.string());
+		}
+
+		const uint64_t hash = TextureLoader::HashContent(encoded);
+		const std::filesystem::file_time_type writeTime = utils::GetWriteTime(path);
+
+		// Different path, same content. The texture is shared but the handle keeps the path asked for, so whatever
+		// saves it points back at this file
+		auto textureIt = s_AssetData.Textures.find(hash);
+		if (textureIt != s_AssetData.Textures.end())
+		{
+			TexturePath& texturePath = s_AssetData.TexturePaths[canonicalPath];
+			texturePath = { hash, CreateRef<SharedTexture2D>(textureIt->second.Texture, path.string()), writeTime };
+			textureIt->second.LastAccess = ++s_AssetData.AccessCounter;
+			s_AssetData.Stats.TextureCacheHits++;
+			return texturePath.Texture;
+		}
+
+		TextureImage image;
+		if (!TextureLoader::DecodeImage(encoded, hash, image))
+		{
+			Log::Error("Failed to load texture %s", path.string().c_str());
+			return Texture2D::Create(path.string());
+		}
+
+		Ref<Texture2D> texture = Texture2D::Create(image, path.string());
+
+		TextureAsset& asset = s_AssetData.Textures[hash];
+		asset.Texture = texture;
+		asset.Path = canonicalPath;
+		asset.DecodedSize = image.Pixels.size();
+		asset.LastAccess = ++s_AssetData.AccessCounter;
+		s_AssetData.TexturePaths[canonicalPath] = { hash, texture, writeTime };
+
+		s_AssetData.Stats.TextureLoads++;
+		s_AssetData.Stats.TextureMemory += asset.DecodedSize;
+		s_AssetData.Stats.TextureCount = (uint32_t)s_AssetData.Textures.size();
+
+		EnforceTextureBudget();
+
+		return texture;
+	}
+
+	static void AddLoadedTexture(const std::string& canonicalPath, std::filesystem::file_time_type writeTime, const Ref<Texture2D>& texture, const TextureImage& image)
+	{
+		s_AssetData.PendingTextures.erase(canonicalPath);
+
+		if (texture->GetLoadState() != TextureLoadState::Ready)
+			return;
+
+		// Same content was loaded under another path in the meantime. Handles to this texture stay valid, later
+		// requests get the first one shared under this path
+		auto textureIt = s_AssetData.Textures.find(image.ContentHash);
+		if (textureIt != s_AssetData.Textures.end())
+		{
+			s_AssetData.TexturePaths[canonicalPath] = { image.ContentHash, CreateRef<SharedTexture2D>(textureIt->second.Texture, texture->GetPath()), writeTime };
+			return;
+		}
+
+		TextureAsset& asset = s_AssetData.Textures[image.ContentHash];
+		asset.Texture = texture;
+		asset.Path = canonicalPath;
+		asset.DecodedSize = image.Pixels.size();
+		asset.LastAccess = ++s_AssetData.AccessCounter;
+		s_AssetData.TexturePaths[canonicalPath] = { image.ContentHash, texture, writeTime };
+
+		s_AssetData.Stats.TextureLoads++;
+		s_AssetData.Stats.TextureMemory += asset.DecodedSize;
+		s_AssetData.Stats.TextureCount = (uint32_t)s_AssetData.Textures.size();
+
+		EnforceTextureBudget();
+	}
+
+	Ref<Texture2D> AssetManager::GetTextureAsync(const std::filesystem::path& path)
+	{
+		RB_PROFILE_FUNCTION();
+
+		const std::string canonicalPath = ResolveRequestedPath(path);
+		if (Ref<Texture2D> texture = FindCachedTexture(canonicalPath))
+			return texture;
+
+		const std::filesystem::file_time_type writeTime = utils::GetWriteTime(path);
+		Ref<Texture2D> texture = TextureLoader::LoadAsync(path.string(), [canonicalPath, writeTime](const Ref<Texture2D>& texture, const TextureImage& image)
+		{
+			AddLoadedTexture(canonicalPath, writeTime, texture, image);
+		});
+		s_AssetData.PendingTextures[canonicalPath] = texture;
+
+		return texture;
+	}
+
+	bool AssetManager::UnloadTexture(const std::filesystem::path& path)
+	{
+		auto pathIt = s_AssetData.TexturePaths.find(ResolveRequestedPath(path));
+		if (pathIt == s_AssetData.TexturePaths.end())
+			return false;
+
+		EvictTexture(pathIt->second.Hash);
+		return true;
+	}
+
+	uint32_t AssetManager::UnloadUnusedTextures()
+	{
+		std::vector<uint64_t> unused;
+		for (const auto& [hash, asset] : s_AssetData.Textures)
+		{
+			if (GetOutsideReferences(hash, asset) == 0)
+				unused.push_back(hash);
+		}
+
+		for (uint64_t hash : unused)
+			EvictTexture(hash);
+
+		return (uint32_t)unused.size();
+	}
+
+	uint32_t AssetManager::ReloadChangedTextures()
+	{
+		RB_PROFILE_FUNCTION();
+
+		uint32_t changed = 0;
+		for (auto pathIt = s_AssetData.TexturePaths.begin(); pathIt != s_AssetData.TexturePaths.end();)
+		{
+			if (utils::GetWriteTime(pathIt->first) != pathIt->second.WriteTime)
+			{
+				pathIt = s_AssetData.TexturePaths.erase(pathIt);
+				changed++;
+			}
+			else
+			{
+				++pathIt;
+			}
+		}
+
+		return changed;
+	}
+
+	void AssetManager::SetTextureBudget(size_t bytes)
+	{
+		s_AssetData.TextureBudget = bytes;
+		EnforceTextureBudget();
+	}
+
+	size_t AssetManager::GetTextureBudget()
+	{
+		return s_AssetData.TextureBudget;
+	}
+
+	const AssetManagerStats& AssetManager::GetStats()
+	{
+		return s_AssetData.Stats;
+	}
+
+	void AssetManager::ResetStats()
+	{
+		s_AssetData.Stats.TextureLoads = 0;
+		s_AssetData.Stats.TextureCacheHits = 0;
+		s_AssetData.Stats.TextureEvictions = 0;
+	}
+
+	void AssetManager::GetTextureInfos(std::vector<TextureAssetInfo>& infos)
+	{
+		infos.clear();
+		infos.reserve(s_AssetData.Textures.size());
+		for (const auto& [hash, asset] : s_AssetData.Textures)
+		{
+			TextureAssetInfo& info = infos.emplace_back();
+			info.Path = asset.Path;
+			info.ContentHash = hash;
+			info.Width = asset.Texture->GetWidth();
+			info.Height = asset.Texture->GetHeight();
+			info.DecodedSize = asset.DecodedSize;
+			info.RefCount = GetOutsideReferences(hash, asset);
+			info.LastAccess = asset.LastAccess;
+		}
+
+		for (const auto& [path, texturePath] : s_AssetData.TexturePaths)
+		{
+			for (TextureAssetInfo& info : infos)
+			{
+				if (info.ContentHash == texturePath.Hash)
+				{
+					info.AliasCount++;
+					break;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Rhombus/Renderer/Texture.h"
+
+#include <filesystem>
+
+namespace rhombus {
+
+	// Snapshot of a cached texture for tooling
+	struct TextureAssetInfo
+	{
+		std::string Path;						// Canonical path of the first file this texture was loaded from
+		uint32_t AliasCount = 0;				// Number of paths resolving to this texture (same file content)
+		uint64_t ContentHash = 0;
+		uint32_t Width = 0, Height = 0;
+		size_t DecodedSize = 0;					// In bytes, RGBA8
+		long RefCount = 0;						// Handles held outside the asset manager, under any of its paths
+		uint64_t LastAccess = 0;
+	};
+
+	struct AssetManagerStats
+	{
+		uint32_t TextureLoads = 0;				// Textures decoded from disk
+		uint32_t TextureCacheHits = 0;
+		uint32_t TextureEvictions = 0;
+		uint32_t TextureCount = 0;
+		size_t TextureMemory = 0;				// Decoded bytes held by the cache
+	};
+
+	// Caches textures loaded from disk so every request for the same file (by canonical path or by content)
+	// shares one texture. Handles are the usual Ref<Texture2D>, the cache keeps its own reference. A file with the
+	// same content as one already loaded gets a SharedTexture2D, so GetPath is still the path that was asked for.
+	// Repeat requests for a path are a map lookup, the file system is only checked by ReloadChangedTextures
+	class AssetManager
+	{
+	public:
+		static void Shutdown();
+
+		// Returns the cached texture or loads it. Files that fail to load are returned uncached like Texture2D::Create
+		static Ref<Texture2D> GetTexture(const std::filesystem::path& path);
+		// Same as GetTexture but a texture not yet cached is decoded on a worker, see TextureLoader::LoadAsync.
+		// It joins the cache once uploaded
+		static Ref<Texture2D> GetTextureAsync(const std::filesystem::path& path);
+
+		// Hot reload. Forgets cached paths whose file was modified since it was loaded so the next request loads it
+		// again, handles already given out keep the old texture. Stats every cached file, so call it occasionally.
+		// Returns the number of paths forgotten
+		static uint32_t ReloadChangedTextures();
+
+		// Removes a texture from the cache. Handles already given out stay valid
+		static bool UnloadTexture(const std::filesystem::path& path);
+		// Removes every texture no longer referenced outside the cache. Returns the number of textures evicted
+		static uint32_t UnloadUnusedTextures();
+
+		// When the decoded size of the cache goes over budget, the least recently used unreferenced textures are
+		// evicted. 0 means no budget
+		static void SetTextureBudget(size_t bytes);
+		static size_t GetTextureBudget();
+
+		static const AssetManagerStats& GetStats();
+		static void ResetStats();
+		static void GetTextureInfos(std::vector<TextureAssetInfo>& infos);
+	};
+}
@@ -0,0 +1,215 @@
+#include "rbpch.h"
+#include "TextureLoader.h"
+
+#include "Rhombus/Core/JobSystem.h"
+
+#include "stb_image.h"
+
+#include <atomic>
+#include <deque>
+#include <fstream>
+
+namespace rhombus {
+
+	struct TextureLoadRequest
+	{
+		Ref<Texture2D> Texture;
+		std::string Path;
+		TextureLoader::LoadedCallback OnLoaded;
+		TextureImage Image;
+		bool Decoded = false;
+
+		TextureLoadRequest* Next = nullptr;
+	};
+
+	struct TextureLoaderData
+	{
+		// Workers push finished decodes onto a lock free stack, the main thread takes the whole stack at once
+		std::atomic<TextureLoadRequest*> Completed = nullptr;
+		std::atomic<uint32_t> PendingCount = 0;
+
+		// Decodes taken off the stack but not uploaded yet because of the per frame budget (main thread only)
+		std::deque<TextureLoadRequest*> ReadyToUpload;
+	};
+
+	static TextureLoaderData s_LoaderData;
+
+	static void PushCompleted(TextureLoadRequest* request)
+	{
+		TextureLoadRequest* head = s_LoaderData.Completed.load(std::memory_order_relaxed);
+		do
+		{
+			request->Next = head;
+		} while (!s_LoaderData.Completed.compare_exchange_weak(head, request, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	// Moves everything off the completed stack into the upload queue, oldest first
+	static void CollectCompleted()
+	{
+		TextureLoadRequest* head = s_LoaderData.Completed.exchange(nullptr, std::memory_order_acquire);
+
+		TextureLoadRequest* reversed = nullptr;
+		while (head)
+		{
+			TextureLoadRequest* next = head->Next;
+			head->Next = reversed;
+			reversed = head;
+			head = next;
+		}
+
+		for (TextureLoadRequest* request = reversed; request; request = request->Next)
+			s_LoaderData.ReadyToUpload.push_back(request);
+	}
+
+	static void FinishRequest(TextureLoadRequest* request)
+	{
+		if (request->Decoded)
+		{
+			request->Texture->SetImage(request->Image);
+			request->Texture->SetLoadState(TextureLoadState::Ready);
+		}
+		else
+		{
+			Log::Error("Failed to load texture %s", request->Path.c_str());
+			request->Texture->SetLoadState(TextureLoadState::Failed);
+		}
+
+		if (request->OnLoaded)
+			request->OnLoaded(request->Texture, request->Image);
+
+		s_LoaderData.PendingCount--;
+		delete request;
+	}
+
+	void TextureLoader::Shutdown()
+	{
+		JobSystem::Wait();
+		ProcessUploads(SIZE_MAX);
+	}
+
+	bool TextureLoader::DecodeImage(const std::string& path, TextureImage& outImage)
+	{
+		RB_PROFILE_FUNCTION();
+
+		std::vector<uint8_t> encoded;
+		if (!ReadFile(path, encoded))
+			return false;
+
+		return DecodeImage(encoded, HashContent(encoded), outImage);
+	}
+
+	bool TextureLoader::DecodeImage(const std::vector<uint8_t>& encoded, uint64_t contentHash, TextureImage& outImage)
+	{
+		RB_PROFILE_FUNCTION();
+
+		// The flip flag is global in stb_image. Every texture loader sets it to 1 so set it once before the first decode
+		static std::once_flag s_FlipFlag;
+		std::call_once(s_FlipFlag, []() { stbi_set_flip_vertically_on_load(1); });
+
+		int width, height, channels;
+		stbi_uc* data = stbi_load_from_memory(encoded.data(), (int)encoded.size(), &width, &height, &channels, 4);
+		if (!data)
+			return false;
+
+		outImage.Width = width;
+		outImage.Height = height;
+		outImage.Pixels.assign(data, data + (size_t)width * height * 4);
+		outImage.ContentHash = contentHash;
+
+		stbi_image_free(data);
+		return true;
+	}
+
+	bool TextureLoader::ReadFile(const std::string& path, std::vector<uint8_t>& outEncoded)
+	{
+		std::ifstream stream(path, std::ios::in | std::ios::binary | std::ios::ate);
+		if (!stream)
+			return false;
+
+		const std::streamsize fileSize = stream.tellg();
+		if (fileSize <= 0)
+			return false;
+
+		outEncoded.resize((size_t)fileSize);
+		stream.seekg(0, std::ios::beg);
+		return (bool)stream.read((char*)outEncoded.data(), fileSize);
+	}
+
+	uint64_t TextureLoader::HashContent(const std::vector<uint8_t>& encoded)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (uint8_t byte : encoded)
+		{
+			hash ^= byte;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	Ref<Texture2D> TextureLoader::LoadAsync(const std::string& path, const LoadedCallback& onLoaded)
+	{
+		RB_PROFILE_FUNCTION();
+
+		Ref<Texture2D> texture = Texture2D::Create(GetPlaceholderImage(), path);
+		texture->SetLoadState(TextureLoadState::Loading);
+
+		TextureLoadRequest* request = new TextureLoadRequest();
+		request->Texture = texture;
+		request->Path = path;
+		request->OnLoaded = onLoaded;
+
+		s_LoaderData.PendingCount++;
+
+		// The texture is only touched again on the main thread, the worker owns the rest of the request until it is pushed
+		JobSystem::Execute([request]()
+		{
+			request->Decoded = DecodeImage(request->Path, request->Image);
+			PushCompleted(request);
+		});
+
+		return texture;
+	}
+
+	uint32_t TextureLoader::ProcessUploads(size_t maxBytes)
+	{
+		RB_PROFILE_FUNCTION();
+
+		CollectCompleted();
+
+		uint32_t completed = 0;
+		size_t uploadedBytes = 0;
+		while (!s_LoaderData.ReadyToUpload.empty())
+		{
+			TextureLoadRequest* request = s_LoaderData.ReadyToUpload.front();
+			const size_t size = request->Image.Pixels.size();
+			if (completed > 0 && uploadedBytes + size > maxBytes)
+				break;
+
+			s_LoaderData.ReadyToUpload.pop_front();
+			uploadedBytes += size;
+			FinishRequest(request);
+			completed++;
+		}
+
+		return completed;
+	}
+
+	uint32_t TextureLoader::GetPendingCount()
+	{
+		return s_LoaderData.PendingCount;
+	}
+
+	const TextureImage& TextureLoader::GetPlaceholderImage()
+	{
+		static TextureImage s_Placeholder = []()
+		{
+			TextureImage image;
+			image.Width = 1;
+			image.Height = 1;
+			image.Pixels = { 128, 128, 128, 255 };
+			return image;
+		}();
+
+		return s_Placeholder;
+	}
+}
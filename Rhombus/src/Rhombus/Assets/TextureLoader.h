@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Rhombus/Renderer/Texture.h"
+
+#include <functional>
+
+namespace rhombus {
+
+	// Decodes textures on the job system workers and uploads them from the main thread a few at a time.
+	// LoadAsync hands back a placeholder straight away that is filled in by ProcessUploads once decoded
+	class TextureLoader
+	{
+	public:
+		using LoadedCallback = std::function<void(const Ref<Texture2D>&, const TextureImage&)>;
+
+		// Waits for outstanding decodes and uploads everything still pending
+		static void Shutdown();
+
+		// Reads and decodes a file to RGBA8. Touches no renderer state so it can run on any thread
+		static bool DecodeImage(const std::string& path, TextureImage& outImage);
+		// Decodes a file already read into memory, contentHash is stored on the image
+		static bool DecodeImage(const std::vector<uint8_t>& encoded, uint64_t contentHash, TextureImage& outImage);
+
+		static bool ReadFile(const std::string& path, std::vector<uint8_t>& outEncoded);
+		// 64 bit FNV-1a over the encoded file, the content hash the asset manager shares textures by
+		static uint64_t HashContent(const std::vector<uint8_t>& encoded);
+
+		// Returns a 1x1 placeholder texture in the Loading state. onLoaded runs on the main thread after the upload
+		// (or after the decode failed, with an empty image)
+		static Ref<Texture2D> LoadAsync(const std::string& path, const LoadedCallback& onLoaded = nullptr);
+
+		// Main thread only. Uploads decoded images until maxBytes of pixels have been uploaded this call, at least
+		// one image is always uploaded so large textures still get through. Returns the number of textures completed
+		static uint32_t ProcessUploads(size_t maxBytes = 8 * 1024 * 1024);
+
+		// Textures queued with LoadAsync that have not been uploaded yet
+		static uint32_t GetPendingCount();
+
+		static const TextureImage& GetPlaceholderImage();
+	};
+}
@@ -3,6 +3,10 @@
 
 #include "Rhombus/Core/Log.h"
 #include "Rhombus/Core/KeyCodes.h"
+#include "Rhombus/Core/JobSystem.h"
+#include "Rhombus/Assets/AssetManager.h"
+#include "Rhombus/Assets/TextureLoader.h"
+#include "Rhombus/Animation/AnimationLibrary.h"
 
 #include "Rhombus/Renderer/Renderer.h"
 #include "Rhombus/Scripting/ScriptEngine.h"
@@ -35,11 +39,16 @@ namespace rhombus {
 		m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
 		SetViewport(0.0f, 0.0f, (float)m_Window->GetWidth(), (float)m_Window->GetHeight());
 
+		JobSystem::Init();
 		Renderer::Init();
 		ScriptEngine::Init();
+		ScriptEngine::SetMemoryBudget(m_Specification.luaMemoryBudget);
+		ScriptEngine::SetParallelStateCount(m_Specification.luaParallelStates);
 
 		m_ImGuiLayer = new ImGuiLayer();
 		PushOverlay(m_ImGuiLayer);
+
+		SetSimulationTickRate(m_Specification.simulationTickRate);
 	}
 
 	// Look into this
@@ -152,8 +161,45 @@ namespace rhombus {
 				}
 			}
 
+			// Upload textures decoded by the workers since last frame
+			TextureLoader::ProcessUploads();
+
+			// The simulation runs in fixed steps, frames only consume the time that has built up. A debug step
+			// advances exactly one tick
+			const float fixedDeltaTime = GetFixedDeltaTime();
+			if (m_Minimised)
+			{
+				m_SimulationAccumulator = 0.0f;
+			}
+			else if (!m_DebugPause)
+			{
+				m_SimulationAccumulator = m_DebugStep ? fixedDeltaTime : m_SimulationAccumulator + deltaTime;
+			}
+
 			if (!m_Minimised)
 			{
+				{
+					RB_PROFILE_SCOPE("LayerStack OnFixedUpdates");
+
+					uint32_t steps = 0;
+					while (m_SimulationAccumulator >= fixedDeltaTime && steps < m_Specification.maxSimulationStepsPerFrame)
+					{
+						for (Layer* layer : m_LayerStack)
+							layer->OnFixedUpdate(fixedDeltaTime);
+
+						m_SimulationAccumulator -= fixedDeltaTime;
+						steps++;
+					}
+
+					// Too far behind to catch up, drop the backlog rather than doing ever more steps each frame
+					if (m_SimulationAccumulator >= fixedDeltaTime)
+					{
+						m_SimulationAccumulator = fmod(m_SimulationAccumulator, fixedDeltaTime);
+					}
+
+					m_InterpolationAlpha = m_SimulationAccumulator / fixedDeltaTime;
+				}
+
 				{
 					RB_PROFILE_SCOPE("LayerStack OnUpdates");
 
@@ -172,8 +218,23 @@ namespace rhombus {
 				m_ImGuiLayer->End();
 			}
 
+			// The automatic collector is off, Lua garbage is only collected here so it never lands mid frame
+			ScriptEngine::CollectGarbage(m_Specification.luaGCBudgetMs);
+
 			m_Window->OnUpdate();
 		}
+
+		TextureLoader::Shutdown();
+		AssetManager::Shutdown();
+		AnimationLibrary::Shutdown();
+		JobSystem::Shutdown();
+	}
+
+	void Application::SetSimulationTickRate(uint32_t tickRate)
+	{
+		Log::Assert(tickRate > 0, "Simulation tick rate must be greater than zero");
+		m_Specification.simulationTickRate = tickRate > 0 ? tickRate : 60;
+		m_SimulationAccumulator = 0.0f;
 	}
 
 	bool Application::OnWindowClose(WindowCloseEvent& e)
@@ -37,6 +37,12 @@ namespace rhombus {
 		uint32_t width;
 		uint32_t height;
 		bool fullscreen = false;
+		uint32_t simulationTickRate = 60;			// Fixed updates per second
+		uint32_t maxSimulationStepsPerFrame = 5;	// Simulation time beyond this is dropped instead of caught up
+		bool physicsOnWorkerThread = false;			// Steps Box2D on its own thread one fixed update ahead of the game
+		float luaGCBudgetMs = 1.0f;					// Time given to the Lua garbage collector at the end of each frame
+		size_t luaMemoryBudget = 64 * 1024 * 1024;	// Lua memory beyond this is collected in full straight away
+		uint32_t luaParallelStates = 0;				// Lua states that scripts marked ThreadSafe are updated in across the workers
 	};
 
 	struct Viewport
@@ -75,6 +81,12 @@ namespace rhombus {
 		std::string GetPathRelativeToEditorDirectory(const std::string& path) const { return m_Specification.editorDirectory + "/" + path; }
 
 		bool GetIsDebugPaused() const { return m_DebugPause; }
+
+		void SetSimulationTickRate(uint32_t tickRate);
+		uint32_t GetSimulationTickRate() const { return m_Specification.simulationTickRate; }
+		float GetFixedDeltaTime() const { return 1.0f / (float)m_Specification.simulationTickRate; }
+		// How far the current frame is between the last two fixed updates, 0 to 1. Used to blend simulated transforms
+		float GetInterpolationAlpha() const { return m_InterpolationAlpha; }
 	private:
 		void Run();
 
@@ -102,6 +114,8 @@ namespace rhombus {
 		bool m_DebugStep = false;
 		LayerStack m_LayerStack;
 		float m_LastFrameTime = 0.0f;
+		float m_SimulationAccumulator = 0.0f;
+		float m_InterpolationAlpha = 0.0f;
 	private:
 		static Application* s_Instance;
 		friend int ::main(int argc, char** argv);
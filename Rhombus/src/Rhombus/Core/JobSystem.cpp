@@ -0,0 +1,176 @@
+#include "rbpch.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace rhombus
+{
+	struct JobSystemData
+	{
+		std::vector<std::thread> Workers;
+		std::deque<std::function<void()>> Queue;
+		std::mutex QueueMutex;
+		std::condition_variable QueueCondition;
+		std::condition_variable IdleCondition;
+		uint32_t PendingJobs = 0;
+		bool Running = false;
+	};
+
+	static JobSystemData s_JobData;
+
+	static void WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(s_JobData.QueueMutex);
+				s_JobData.QueueCondition.wait(lock, [] { return !s_JobData.Running || !s_JobData.Queue.empty(); });
+
+				if (!s_JobData.Running && s_JobData.Queue.empty())
+				{
+					return;
+				}
+
+				job = std::move(s_JobData.Queue.front());
+				s_JobData.Queue.pop_front();
+			}
+
+			job();
+
+			{
+				std::lock_guard<std::mutex> lock(s_JobData.QueueMutex);
+				s_JobData.PendingJobs--;
+			}
+			s_JobData.IdleCondition.notify_all();
+		}
+	}
+
+	void JobSystem::Init(uint32_t threadCount)
+	{
+		RB_PROFILE_FUNCTION();
+
+		if (s_JobData.Running)
+		{
+			return;
+		}
+
+		if (threadCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+		}
+
+		s_JobData.Running = true;
+		for (uint32_t i = 0; i < threadCount; i++)
+		{
+			s_JobData.Workers.emplace_back(WorkerLoop);
+		}
+	}
+
+	void JobSystem::Shutdown()
+	{
+		RB_PROFILE_FUNCTION();
+
+		{
+			std::lock_guard<std::mutex> lock(s_JobData.QueueMutex);
+			s_JobData.Running = false;
+		}
+		s_JobData.QueueCondition.notify_all();
+
+		for (std::thread& worker : s_JobData.Workers)
+		{
+			worker.join();
+		}
+		s_JobData.Workers.clear();
+	}
+
+	void JobSystem::Execute(const std::function<void()>& job)
+	{
+		if (s_JobData.Workers.empty())
+		{
+			job();
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(s_JobData.QueueMutex);
+			s_JobData.Queue.push_back(job);
+			s_JobData.PendingJobs++;
+		}
+		s_JobData.QueueCondition.notify_one();
+	}
+
+	void JobSystem::Dispatch(uint32_t jobCount, const std::function<void(uint32_t)>& job)
+	{
+		if (jobCount == 0)
+		{
+			return;
+		}
+
+		if (s_JobData.Workers.empty() || jobCount == 1)
+		{
+			for (uint32_t i = 0; i < jobCount; i++)
+			{
+				job(i);
+			}
+			return;
+		}
+
+		// Workers and the calling thread pull indices from a shared counter until they run out
+		struct DispatchState
+		{
+			std::atomic<uint32_t> NextIndex = 0;
+			std::atomic<uint32_t> Completed = 0;
+			std::mutex DoneMutex;
+			std::condition_variable DoneCondition;
+		};
+
+		auto state = std::make_shared<DispatchState>();
+		auto runJobs = [state, jobCount, &job]()
+		{
+			uint32_t index;
+			while ((index = state->NextIndex.fetch_add(1)) < jobCount)
+			{
+				job(index);
+				if (state->Completed.fetch_add(1) + 1 == jobCount)
+				{
+					std::lock_guard<std::mutex> lock(state->DoneMutex);
+					state->DoneCondition.notify_all();
+				}
+			}
+		};
+
+		uint32_t helperCount = std::min((uint32_t)s_JobData.Workers.size(), jobCount - 1);
+		for (uint32_t i = 0; i < helperCount; i++)
+		{
+			Execute(runJobs);
+		}
+
+		runJobs();
+
+		std::unique_lock<std::mutex> lock(state->DoneMutex);
+		state->DoneCondition.wait(lock, [&state, jobCount] { return state->Completed.load() == jobCount; });
+	}
+
+	void JobSystem::Wait()
+	{
+		std::unique_lock<std::mutex> lock(s_JobData.QueueMutex);
+		s_JobData.IdleCondition.wait(lock, [] { return s_JobData.PendingJobs == 0; });
+	}
+
+	bool JobSystem::IsBusy()
+	{
+		std::lock_guard<std::mutex> lock(s_JobData.QueueMutex);
+		return s_JobData.PendingJobs > 0;
+	}
+
+	uint32_t JobSystem::GetThreadCount()
+	{
+		return (uint32_t)s_JobData.Workers.size();
+	}
+}
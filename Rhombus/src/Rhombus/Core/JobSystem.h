@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Rhombus/Core/Core.h"
+
+namespace rhombus
+{
+	// Small fixed pool of worker threads shared by engine systems that want to spread work across cores
+	class JobSystem
+	{
+	public:
+		// threadCount of 0 uses one worker per hardware thread, minus the calling thread
+		static void Init(uint32_t threadCount = 0);
+		static void Shutdown();
+
+		// Queues a job to run on a worker. Runs inline when there are no workers
+		static void Execute(const std::function<void()>& job);
+
+		// Runs job(index) for every index in [0, jobCount) across the workers and the calling thread, returns once all are done
+		static void Dispatch(uint32_t jobCount, const std::function<void(uint32_t)>& job);
+
+		// Blocks until every job queued with Execute has finished
+		static void Wait();
+
+		static bool IsBusy();
+		static uint32_t GetThreadCount();
+	};
+}
@@ -15,6 +15,8 @@ namespace rhombus {
 		virtual void OnAttach() {}
 		virtual void OnDetach() {}
 		virtual void OnUpdate(DeltaTime dt) {}
+		// Called zero or more times before OnUpdate each frame, always with the fixed simulation time step
+		virtual void OnFixedUpdate(DeltaTime dt) {}
 		virtual void OnImGuiRender() {}
 		virtual void OnEvent(Event& event) {}
 
@@ -69,25 +69,41 @@ namespace rhombus
 			InternalEndSession();
 		}
 
+		bool IsSessionActive() const
+		{
+			return m_CurrentSession != nullptr;
+		}
+
 		void WriteProfile(const ProfileResult& result)
 		{
 			std::stringstream json;
+			WriteTraceEvent(json, result);
 
-			std::string name = result.Name;
-			std::replace(name.begin(), name.end(), '"', '\'');
+			//std::lock_guard lock(m_Mutex);
+			if (m_CurrentSession) {
+				m_OutputStream << json.str();
+				m_OutputStream.flush();
+			}
+		}
+
+		// Shows as a graph of value over time
+		void WriteCounter(const char* name, double value)
+		{
+			std::stringstream json;
+
+			std::string counterName = name;
+			std::replace(counterName.begin(), counterName.end(), '"', '\'');
 
 			json << std::setprecision(3) << std::fixed;
 			json << ",{";
-			json << "\"cat\":\"function\",";
-			json << "\"dur\":" << (result.ElapsedTime.count()) << ',';
-			json << "\"name\":\"" << name << "\",";
-			json << "\"ph\":\"X\",";
+			json << "\"args\":{\"value\":" << value << "},";
+			json << "\"cat\":\"counter\",";
+			json << "\"name\":\"" << counterName << "\",";
+			json << "\"ph\":\"C\",";
 			json << "\"pid\":0,";
-			json << "\"tid\":" << result.ThreadID << ",";
-			json << "\"ts\":" << result.Start.count();
+			json << "\"ts\":" << FloatingPointMicroseconds{ std::chrono::steady_clock::now().time_since_epoch() }.count();
 			json << "}";
 
-			//std::lock_guard lock(m_Mutex);
 			if (m_CurrentSession) {
 				m_OutputStream << json.str();
 				m_OutputStream.flush();
@@ -100,6 +116,34 @@ namespace rhombus
 			return instance;
 		}
 
+		// The trace format, for anything writing a file of its own
+		static void WriteTraceHeader(std::ostream& stream)
+		{
+			stream << "{\"otherData\": {},\"traceEvents\":[{}";
+		}
+
+		static void WriteTraceFooter(std::ostream& stream)
+		{
+			stream << "]}";
+		}
+
+		static void WriteTraceEvent(std::ostream& stream, const ProfileResult& result)
+		{
+			std::string name = result.Name;
+			std::replace(name.begin(), name.end(), '"', '\'');
+
+			stream << std::setprecision(3) << std::fixed;
+			stream << ",{";
+			stream << "\"cat\":\"function\",";
+			stream << "\"dur\":" << (result.ElapsedTime.count()) << ',';
+			stream << "\"name\":\"" << name << "\",";
+			stream << "\"ph\":\"X\",";
+			stream << "\"pid\":0,";
+			stream << "\"tid\":" << result.ThreadID << ",";
+			stream << "\"ts\":" << result.Start.count();
+			stream << "}";
+		}
+
 	private:
 
 		Instrumentor()
@@ -115,13 +159,13 @@ namespace rhombus
 
 		void WriteHeader()
 		{
-			m_OutputStream << "{\"otherData\": {},\"traceEvents\":[{}";
+			WriteTraceHeader(m_OutputStream);
 			m_OutputStream.flush();
 		}
 
 		void WriteFooter()
 		{
-			m_OutputStream << "]}";
+			WriteTraceFooter(m_OutputStream);
 			m_OutputStream.flush();
 		}
 
@@ -207,9 +251,11 @@ namespace rhombus
 #define RB_PROFILE_END_SESSION() ::rhombus::Instrumentor::Get().EndSession()
 #define RB_PROFILE_SCOPE(name) ::rhombus::InstrumentationTimer timer##__LINE__(name)
 #define RB_PROFILE_FUNCTION() RB_PROFILE_SCOPE(RB_FUNC_SIG)
+#define RB_PROFILE_COUNTER(name, value) ::rhombus::Instrumentor::Get().WriteCounter(name, (double)(value))
 #else
 #define RB_PROFILE_BEGIN_SESSION(name, filepath)
 #define RB_PROFILE_END_SESSION()
 #define RB_PROFILE_SCOPE(name)
 #define RB_PROFILE_FUNCTION()
+#define RB_PROFILE_COUNTER(name, value)
 #endif
@@ -16,6 +16,12 @@ namespace rhombus
 	public:
 		virtual ~ComponentArrayBase() = default;
 		virtual void OnEntityDestroyed(EntityID entity) = 0;
+
+		// For code that only knows the component type, like tweens writing to a field at an offset. The pointer is
+		// only valid until a component of this type is added or removed
+		virtual void* GetDataPointer(EntityID entity) = 0;
+		// Lets the component react to its fields being written directly
+		virtual void OnDataChanged(void* data) = 0;
 	};
 
 	template<typename T>
@@ -31,6 +37,7 @@ namespace rhombus
 			m_entityToIndexMap[entity] = newIndex;
 			m_indexToEntityMap[newIndex] = entity;
 			m_size++;
+			m_layoutVersion++;
 			return m_componentArray[newIndex];
 		}
 
@@ -44,6 +51,7 @@ namespace rhombus
 			m_indexToEntityMap[newIndex] = entity;
 			m_componentArray[newIndex] = component;
 			m_size++;
+			m_layoutVersion++;
 			return m_componentArray[newIndex];
 		}
 
@@ -53,6 +61,7 @@ namespace rhombus
 			Log::Assert(m_entityToIndexMap.find(entity) != m_entityToIndexMap.end(), "Replacing non-existent component.");
 
 			m_componentArray[m_entityToIndexMap[entity]] = component;
+			m_layoutVersion++;
 			return m_componentArray[m_entityToIndexMap[entity]];
 		}
 
@@ -74,6 +83,7 @@ namespace rhombus
 			m_indexToEntityMap.erase(indexOfLastEntity);
 
 			m_size--;
+			m_layoutVersion++;
 		}
 
 		T& GetData(EntityID entity)
@@ -84,6 +94,14 @@ namespace rhombus
 			return m_componentArray[m_entityToIndexMap[entity]];
 		}
 
+		// The packed components, valid up to GetSize(). For updating every component of a type in one loop
+		T* GetDataArray() { return m_componentArray.data(); }
+		size_t GetSize() const { return m_size; }
+		EntityID GetEntityAtIndex(size_t index) { return m_indexToEntityMap[index]; }
+		// Changes whenever a component is added, removed or replaced, after which pointers into the array and
+		// anything cached per index are stale
+		uint32_t GetLayoutVersion() const { return m_layoutVersion; }
+
 		bool HasData(EntityID entity)
 		{
 			// Return whether this entity has component T
@@ -105,6 +123,17 @@ namespace rhombus
 			return m_entityToIndexMap.begin()->first;
 		}
 
+		void* GetDataPointer(EntityID entity) override
+		{
+			auto it = m_entityToIndexMap.find(entity);
+			return it != m_entityToIndexMap.end() ? &m_componentArray[it->second] : nullptr;
+		}
+
+		void OnDataChanged(void* data) override
+		{
+			static_cast<T*>(data)->OnComponentChanged();
+		}
+
 		void OnEntityDestroyed(EntityID entity) override
 		{
 			if (m_entityToIndexMap.find(entity) != m_entityToIndexMap.end())
@@ -129,5 +158,7 @@ namespace rhombus
 
 		// Total size of valid entries in the array
 		size_t m_size;
+
+		uint32_t m_layoutVersion = 0;
 	};
 }
@@ -23,7 +23,9 @@ namespace rhombus
 			m_componentTypes.insert({ typeName, m_nextComponentType });
 
 			// Create a ComponentArray pointer and add it to the component arrays map
-			m_componentArrays.insert({ typeName, std::make_shared<ComponentArray<T>>() });
+			Ref<ComponentArray<T>> componentArray = std::make_shared<ComponentArray<T>>();
+			m_componentArrays.insert({ typeName, componentArray });
+			m_componentArraysByType[m_nextComponentType] = componentArray.get();
 
 			// Incremenmt the value so that the next component registered will be different
 			m_nextComponentType++;
@@ -40,6 +42,23 @@ namespace rhombus
 			return m_componentTypes[typeName];
 		}
 
+		ComponentArrayBase* GetComponentArray(ComponentType type) const
+		{
+			Log::Assert(type < m_nextComponentType, "Component type %u isn't registered.", (uint32_t)type);
+			return m_componentArraysByType[type];
+		}
+
+		// Convenience function to get the statically casted pointer to the CopmonentArray of type T
+		template<typename T>
+		ComponentArray<T>* GetComponentArray() const
+		{
+			const char* typeName = typeid(T).name();
+
+			Log::Assert(m_componentTypes.find(typeName) != m_componentTypes.end(), "Component not registered before use.");
+
+			return static_cast<ComponentArray<T>*>(m_componentArrays.at(typeName).get());
+		}
+
 		template<typename T>
 		T& AddComponent(EntityID entity)
 		{
@@ -112,19 +131,10 @@ namespace rhombus
 
 		// Map from type string point to component array
 		std::unordered_map<const char*, Ref<ComponentArrayBase>> m_componentArrays{};
+		// The same arrays by component type
+		std::array<ComponentArrayBase*, MAX_COMPONENTS> m_componentArraysByType{};
 
 		// The component type to be assigned to the next registered component - starting at 0
 		ComponentType m_nextComponentType{};
-
-		// Convenience function to get the statically casted pointer to the CopmonentArray of type T
-		template<typename T>
-		Ref<ComponentArray<T>> GetComponentArray()
-		{
-			const char* typeName = typeid(T).name();
-
-			Log::Assert(m_componentTypes.find(typeName) != m_componentTypes.end(), "Component not registered before use.");
-
-			return std::static_pointer_cast<ComponentArray<T>>(m_componentArrays[typeName]);
-		}
 	};
 }
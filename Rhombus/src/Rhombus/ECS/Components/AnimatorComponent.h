@@ -11,17 +11,22 @@ namespace rhombus
 		AnimatorComponent() = default;
 		AnimatorComponent(const AnimatorComponent& other) = default;
 
-		void AddAnimation(AnimationClip clip) { m_animations.push_back(clip); }
-		const AnimationClip& GetCurrentAnimation() const { return m_animations[m_currentAnimIndex]; }
+		// The clips are shared with every other animator using them, see AnimationLibrary
+		void SetAnimations(Ref<const AnimationClipSet> animations) { m_animations = animations; m_currentAnimIndex = 0; m_time = 0.0f; m_currentSample = INVALID_SAMPLE; }
+		bool HasAnimations() const { return m_animations && !m_animations->empty(); }
+		const AnimationClip& GetCurrentAnimation() const { return (*m_animations)[m_currentAnimIndex]; }
 
-		int GetAnimationCount() const { return m_animations.size(); }
-		AnimationClip GetAnimationClip(int index) const { return m_animations[index]; }
+		int GetAnimationCount() const { return m_animations ? (int)m_animations->size() : 0; }
+		const AnimationClip& GetAnimationClip(int index) const { return (*m_animations)[index]; }
+
+		static constexpr uint32_t INVALID_SAMPLE = 0xFFFFFFFF;
 
 		std::string m_filePath;
-		float m_normalizedTime = 0.0f;
+		float m_time = 0.0f;							// Into the current clip
+		uint32_t m_currentSample = INVALID_SAMPLE;		// Last sample given to the sprite
 
 	private:
-		std::vector<AnimationClip> m_animations;
+		Ref<const AnimationClipSet> m_animations;
 		uint32_t m_currentAnimIndex = 0;
 	};
 }
@@ -10,6 +10,8 @@ namespace rhombus
 	{
 	public:
 		virtual void OnComponentAdded() {}
+		// Called after fields were written directly rather than through setters, e.g. by a tween
+		virtual void OnComponentChanged() {}
 
 		void SetOwnerEntity(Entity entity) { m_ownerEntity = entity; }
 		void SetOwnerEntity(EntityID entityID, Scene* scene) { m_ownerEntity = { entityID, scene }; }
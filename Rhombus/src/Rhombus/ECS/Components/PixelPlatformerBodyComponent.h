@@ -15,9 +15,15 @@ namespace rhombus
 		PixelPlatformerBodyComponent(const PixelPlatformerBodyComponent& other) = default;
 
 		Vec2 m_velocity = Vec2(0.0f);
+
+		// Normal of the static bodies the last move was stopped by on each axis, zero on an axis that moved freely
+		Vec2 GetContactNormal() const { return m_contactNormal; }
+		bool IsGrounded() const { return m_contactNormal.y > 0.0f; }
+		bool IsTouchingWall() const { return m_contactNormal.x != 0.0f; }
 	private:
 		friend class PixelPlatformerPhysicsSystem;
 
 		Vec2 m_translationRemainder = Vec2(0.0f);
+		Vec2 m_contactNormal = Vec2(0.0f);
 	};
 }
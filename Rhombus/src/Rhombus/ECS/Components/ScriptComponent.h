@@ -11,6 +11,11 @@ namespace rhombus
 		ScriptComponent(const ScriptComponent&) = default;
 
 		std::string m_scriptName;
+
+		// Storage for runtime
+		void* m_runtimeClass = nullptr;		// Loaded script class, owned by the ScriptEngine
+		int m_runtimeInstance = -2;			// Registry reference to this entity's instance table, LUA_NOREF until initialised
+		uint32_t m_runtimeIndex = 0;		// Position in the instance list of its script class
 	};
 
 	// Forward declaration
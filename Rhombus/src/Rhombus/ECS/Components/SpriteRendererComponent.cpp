@@ -19,6 +19,9 @@ namespace rhombus
 	{
 		if (m_texture)
 		{
+			m_subtextureSourceWidth = m_texture->GetWidth();
+			m_subtextureSourceHeight = m_texture->GetHeight();
+
 			Vec2 spriteSize = Vec2(((float)m_texture->GetWidth() / (float)m_columns) - 2.0f * m_padding, ((float)m_texture->GetHeight() / (float)m_rows) - 2.0f * m_padding);
 			if (m_subtexture)
 			{
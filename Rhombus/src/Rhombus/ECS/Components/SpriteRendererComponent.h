@@ -30,6 +30,8 @@ namespace rhombus
 		bool UseSubTexture() const { return m_subtexture && (m_rows > 1 || m_columns > 1); }
 		Vec2 GetSpriteSize() const;
 		void UpdateSubTexture();
+		// True when the texture changed size since the sub texture was computed (e.g. an async load finished)
+		bool IsSubTextureOutdated() const { return m_subtexture && m_texture && (m_texture->GetWidth() != m_subtextureSourceWidth || m_texture->GetHeight() != m_subtextureSourceHeight); }
 
 		Ref<Texture2D> m_texture;
 		Ref<SubTexture2D> m_subtexture;
@@ -40,5 +42,7 @@ namespace rhombus
 		uint32_t m_columns = 1;
 		uint32_t m_padding = 0;
 		uint32_t m_frame = 0;
+		uint32_t m_subtextureSourceWidth = 0;
+		uint32_t m_subtextureSourceHeight = 0;
 	};
 }
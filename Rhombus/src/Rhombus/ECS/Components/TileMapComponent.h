@@ -16,6 +16,13 @@ namespace rhombus
 
 		Ref<TileMap> m_tilemap;
 
+		// Solid tiles collide as static geometry in both the pixel platformer and Box2D
+		bool m_generateCollision = false;
+
+		// Storage for runtime
+		void* m_runtimeBody = nullptr;
+		uint32_t m_runtimeCollisionVersion = 0;
+
 	private:
 		//Ref<TileMap> m_tilemap;
 	};
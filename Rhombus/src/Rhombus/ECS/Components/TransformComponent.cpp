@@ -21,6 +21,14 @@ namespace rhombus
 		return transform;
 	}
 
+	void TransformComponent::OnComponentChanged()
+	{
+		if (m_sceneGraphNode)
+		{
+			m_sceneGraphNode->SetIsDirty(true);
+		}
+	}
+
 	Vec3& TransformComponent::GetPositionRef()
 	{
 		m_sceneGraphNode->SetIsDirty(true); 
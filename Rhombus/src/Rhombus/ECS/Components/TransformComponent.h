@@ -22,6 +22,8 @@ namespace rhombus
 		TransformComponent() = default;
 		TransformComponent(const TransformComponent&) = default;
 
+		virtual void OnComponentChanged() override;
+
 		Vec3 GetPosition() const { return m_position; }
 		Vec3 GetRotation() const { return m_rotation; }
 		Vec3 GetScale() const { return m_scale; }
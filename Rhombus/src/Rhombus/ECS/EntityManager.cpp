@@ -32,6 +32,7 @@ namespace rhombus
 
 		// Invalidate the destroyed entity's signature
 		m_signatures[entity].reset();
+		m_generations[entity]++;
 
 		// Put the destroyed ID at the back of the queue
 		m_availableEntities.push(entity);
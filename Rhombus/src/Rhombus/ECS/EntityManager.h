@@ -19,6 +19,9 @@ namespace rhombus
 		void SetSignature(EntityID entity, Signature signature);
 
 		Signature GetSignature(EntityID entity);
+
+		// Bumped every time the ID is destroyed, so references made before then can tell the ID has been reused
+		uint32_t GetGeneration(EntityID entity) const { return m_generations[entity]; }
 	private:
 		// Queue of unused entity IDs
 		std::queue<EntityID> m_availableEntities{};
@@ -26,6 +29,8 @@ namespace rhombus
 		// Array of signatures where the index corresponds to the entity ID
 		std::array<Signature, MAX_ENTITIES> m_signatures{};
 
+		std::array<uint32_t, MAX_ENTITIES> m_generations{};
+
 		// Total active entities - used to keep limits on how many exist
 		uint32_t m_activeEntityCount{};
 	};
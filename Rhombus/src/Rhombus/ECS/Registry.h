@@ -32,6 +32,11 @@ namespace rhombus
 			m_componentManager->OnEntityDestroyed(entity);
 			m_systemManager->OnEntityDestroyed(entity);
 		}
+
+		uint32_t GetEntityGeneration(EntityID entity) const
+		{
+			return m_entityManager->GetGeneration(entity);
+		}
 		
 		// Component methods
 		template <typename T>
@@ -109,6 +114,17 @@ namespace rhombus
 			return m_componentManager->GetComponentType<T>();
 		}
 
+		template<typename T>
+		ComponentArray<T>* GetComponentArray() const
+		{
+			return m_componentManager->GetComponentArray<T>();
+		}
+
+		ComponentArrayBase* GetComponentArray(ComponentType type) const
+		{
+			return m_componentManager->GetComponentArray(type);
+		}
+
 		template<typename T>
 		std::vector<EntityID> GetEntityList() const
 		{
@@ -8,31 +8,58 @@ namespace rhombus
 {
 	void AnimationSystem::Update(DeltaTime dt)
 	{
-		for (Entity entity : GetEntities())
+		RB_PROFILE_FUNCTION();
+
+		// The system's signature is only the animator, so walking the packed animators visits the same entities
+		// without a lookup for each one
+		Registry& registry = m_scene->GetRegistry();
+		ComponentArray<AnimatorComponent>* animators = registry.GetComponentArray<AnimatorComponent>();
+		AnimatorComponent* animatorData = animators->GetDataArray();
+		const size_t animatorCount = animators->GetSize();
+		for (size_t i = 0; i < animatorCount; i++)
 		{
-			AnimatorComponent& animator = entity.GetComponent<AnimatorComponent>();
+			AnimatorComponent& animator = animatorData[i];
+			if (!animator.HasAnimations())
+			{
+				continue;
+			}
 
 			const AnimationClip& clip = animator.GetCurrentAnimation();
-			animator.m_normalizedTime += dt / clip.m_duration;
-			if (animator.m_normalizedTime > 1.0f)
+			if (clip.m_samples.empty() || clip.m_duration <= 0.0f)
+			{
+				continue;
+			}
+
+			animator.m_time += dt;
+			if (animator.m_time >= clip.m_duration)
+			{
+				animator.m_time = clip.m_looping ? std::fmod(animator.m_time, clip.m_duration) : clip.m_duration;
+			}
+
+			// Most updates stay inside the sample already showing
+			uint32_t sample = animator.m_currentSample;
+			if (sample >= clip.GetSampleCount() || animator.m_time < clip.GetSampleStartTime(sample) || animator.m_time >= clip.GetSampleEndTime(sample))
+			{
+				sample = clip.FindSample(animator.m_time);
+			}
+
+			if (sample == animator.m_currentSample)
 			{
-				animator.m_normalizedTime -= 1.0f;
+				continue;
 			}
+			animator.m_currentSample = sample;
 
-			float sampleNormTime = 0.0f;
-			for (int i = 0; i < clip.m_samples.size(); i++)
+			// Setting the frame recomputes the sprite's texture coordinates, so only when it changes
+			const EntityID entityID = animators->GetEntityAtIndex(i);
+			if (registry.HasComponent<SpriteRendererComponent>(entityID))
 			{
-				sampleNormTime += clip.m_samples[i].m_duration / clip.m_duration;
-				if (sampleNormTime > animator.m_normalizedTime)
+				SpriteRendererComponent& spriteRenderer = registry.GetComponent<SpriteRendererComponent>(entityID);
+				const uint32_t frame = (uint32_t)clip.m_samples[sample].m_spriteFrame;
+				if (spriteRenderer.GetFrame() != frame)
 				{
-					if (entity.HasComponent<SpriteRendererComponent>())
-					{
-						SpriteRendererComponent& spriteRenderer = entity.GetComponent<SpriteRendererComponent>();
-						spriteRenderer.SetFrame(clip.m_samples[i].m_spriteFrame);
-						break;
-					}
+					spriteRenderer.SetFrame(frame);
 				}
 			}
 		}
 	}
-}
\ No newline at end of file
+}
@@ -2,26 +2,52 @@
 #include "PixelPlatformerPhysicsSystem.h"
 #include "Rhombus/ECS/Components/Collider2DComponent.h"
 #include "Rhombus/ECS/Components/PixelPlatformerBodyComponent.h"
+#include "Rhombus/ECS/Components/TileMapComponent.h"
 #include "Rhombus/ECS/Components/TransformComponent.h"
 #include "Rhombus/Physics/AABB.h"
 #include "Rhombus/Physics/PrimitiveTests.h"
+#include "Rhombus/Scenes/SceneGraphNode.h"
 
 namespace rhombus
 {
-	void PixelPlatformerPhysicsSystem::Update(DeltaTime dt)
+	namespace utils
 	{
-		for (Entity entity : GetEntities())
+		static AABB GetStaticAABB(Entity entity)
+		{
+			BoxCollider2DComponent& colliderComponent = entity.GetComponent<BoxCollider2DComponent>();
+			TransformComponent& transformComponent = entity.GetComponent<TransformComponent>();
+
+			AABB aabb;
+			aabb.c = transformComponent.GetWorldPosition() + colliderComponent.m_offset;
+			aabb.r = Vec3(colliderComponent.m_size.x, colliderComponent.m_size.y, 10.0f);
+			return aabb;
+		}
+
+		static bool IsSameAABB(const AABB& a, const AABB& b)
 		{
-			auto& ppbComponent = entity.GetComponent<PixelPlatformerBodyComponent>();
+			return a.c.x == b.c.x && a.c.y == b.c.y && a.c.z == b.c.z && a.r.x == b.r.x && a.r.y == b.r.y && a.r.z == b.r.z;
+		}
+	}
 
-			switch (ppbComponent.m_type)
+	void PixelPlatformerPhysicsSystem::Update(DeltaTime dt)
+	{
+		UpdateStaticColliders();
+
+		// The system's signature is only the body, so walking the packed bodies visits the same entities without a
+		// lookup for each of the static ones
+		ComponentArray<PixelPlatformerBodyComponent>* bodies = m_scene->GetRegistry().GetComponentArray<PixelPlatformerBodyComponent>();
+		PixelPlatformerBodyComponent* bodyData = bodies->GetDataArray();
+		const size_t bodyCount = bodies->GetSize();
+		for (size_t i = 0; i < bodyCount; i++)
+		{
+			switch (bodyData[i].m_type)
 			{
 			case PixelPlatformerBodyComponent::BodyType::Static:
 				break;
 			case PixelPlatformerBodyComponent::BodyType::Kinematic:
 				break;
 			case PixelPlatformerBodyComponent::BodyType::Dynamic:
-				UpdateDynamicBody(entity, dt);
+				UpdateDynamicBody(bodyData[i].GetOwnerEntity(), dt);
 				break;
 			default:
 				break;
@@ -29,6 +55,120 @@ namespace rhombus
 		}
 	}
 
+	void PixelPlatformerPhysicsSystem::UpdateStaticColliders()
+	{
+		RB_PROFILE_FUNCTION();
+
+		// Static bodies are checked once a frame here instead of once per pixel stepped, and the grid is only
+		// rebuilt when the check finds something different from the last build
+		bool changed = false;
+		uint32_t staticCount = 0;
+		auto addStaticCollider = [&](EntityID entityID, const AABB& aabb)
+		{
+			if (staticCount < m_staticEntities.size() && m_staticEntities[staticCount] == entityID && utils::IsSameAABB(m_staticColliders[staticCount], aabb))
+			{
+				staticCount++;
+				return;
+			}
+
+			if (!changed)
+			{
+				changed = true;
+				m_staticEntities.resize(staticCount);
+				m_staticColliders.resize(staticCount);
+			}
+
+			m_staticEntities.push_back(entityID);
+			m_staticColliders.push_back(aabb);
+			staticCount++;
+		};
+
+		// The body components are walked in place. Adding or removing bodies or box colliders moves components
+		// around so every static body is looked up again, otherwise only the ones whose transform changed are
+		Registry& registry = m_scene->GetRegistry();
+		ComponentArray<PixelPlatformerBodyComponent>* bodies = registry.GetComponentArray<PixelPlatformerBodyComponent>();
+		ComponentArray<BoxCollider2DComponent>* colliders = registry.GetComponentArray<BoxCollider2DComponent>();
+		const bool layoutChanged = bodies->GetLayoutVersion() != m_bodyLayoutVersion || colliders->GetLayoutVersion() != m_colliderLayoutVersion;
+		m_bodyLayoutVersion = bodies->GetLayoutVersion();
+		m_colliderLayoutVersion = colliders->GetLayoutVersion();
+
+		const PixelPlatformerBodyComponent* bodyData = bodies->GetDataArray();
+		const size_t bodyCount = bodies->GetSize();
+		uint32_t staticBodyCount = 0;
+		for (size_t i = 0; i < bodyCount; i++)
+		{
+			if (bodyData[i].m_type != PixelPlatformerBodyComponent::BodyType::Static)
+			{
+				continue;
+			}
+
+			if (staticBodyCount == m_staticBodies.size())
+			{
+				m_staticBodies.emplace_back();
+			}
+			StaticBody& staticBody = m_staticBodies[staticBodyCount++];
+
+			const EntityID entityID = bodyData[i].GetOwnerEntity();
+			const bool lookUp = layoutChanged || staticBody.m_entity != entityID;
+			if (lookUp)
+			{
+				staticBody.m_entity = entityID;
+				staticBody.m_sceneGraphNode = registry.GetComponent<TransformComponent>(entityID).m_sceneGraphNode;
+				staticBody.m_hasCollider = registry.HasComponent<BoxCollider2DComponent>(entityID);
+			}
+
+			if (!staticBody.m_hasCollider)
+			{
+				continue;
+			}
+
+			const uint32_t transformVersion = staticBody.m_sceneGraphNode->GetTransformVersion();
+			if (lookUp || staticBody.m_transformVersion != transformVersion)
+			{
+				staticBody.m_transformVersion = transformVersion;
+				staticBody.m_aabb = utils::GetStaticAABB({ entityID, m_scene });
+			}
+
+			addStaticCollider(entityID, staticBody.m_aabb);
+		}
+		m_staticBodies.resize(staticBodyCount);
+
+		// Tile maps add their merged solid tiles as static boxes
+		for (EntityID entityID : m_scene->GetAllEntitiesWith<TileMapComponent>())
+		{
+			Entity entity = { entityID, m_scene };
+			TileMapComponent& tileMapComponent = entity.GetComponent<TileMapComponent>();
+			if (!tileMapComponent.m_generateCollision || !tileMapComponent.m_tilemap)
+			{
+				continue;
+			}
+
+			const Vec3 tileMapPosition = entity.GetComponent<TransformComponent>().GetWorldPosition();
+			for (const TileRect& rect : tileMapComponent.m_tilemap->GetCollisionRects())
+			{
+				Vec2 center, halfSize;
+				tileMapComponent.m_tilemap->GetCollisionRectBounds(rect, center, halfSize);
+
+				AABB aabb;
+				aabb.c = tileMapPosition + center;
+				aabb.r = Vec3(halfSize.x, halfSize.y, 10.0f);
+				addStaticCollider(entityID, aabb);
+			}
+		}
+
+		if (staticCount != m_staticEntities.size())
+		{
+			changed = true;
+			m_staticEntities.resize(staticCount);
+			m_staticColliders.resize(staticCount);
+		}
+
+		if (changed)
+		{
+			m_staticGrid.Build(m_staticColliders);
+		}
+	}
+
 	void PixelPlatformerPhysicsSystem::UpdateDynamicBody(Entity entity, DeltaTime dt)
 	{
 		PixelPlatformerBodyComponent& ppbComponent = entity.GetComponent<PixelPlatformerBodyComponent>();
@@ -39,41 +179,50 @@ namespace rhombus
 		Move(entity, translation);
 	}
 
-	void PixelPlatformerPhysicsSystem::Move(Entity entity, Vec2 translation)
+	Vec2 PixelPlatformerPhysicsSystem::Move(Entity entity, Vec2 translation)
 	{
 		TransformComponent& transformComponent = entity.GetComponent<TransformComponent>();
 		PixelPlatformerBodyComponent& ppbComponent = entity.GetComponent<PixelPlatformerBodyComponent>();
 		Vec3 position = transformComponent.GetWorldPosition();
 		Vec2& remainder = ppbComponent.m_translationRemainder;
 		Vec2 appliedTranslation = Vec2(0.0f);
+		Vec2 contactNormal = Vec2(0.0f);
+
+		BodyShape shape;
+		if (entity.HasComponent<BoxCollider2DComponent>())
+		{
+			BoxCollider2DComponent& colliderComponent = entity.GetComponent<BoxCollider2DComponent>();
+			shape.m_type = BodyShape::Type::Box;
+			shape.m_offset = Vec3(colliderComponent.m_offset.x, colliderComponent.m_offset.y, 0.0f);
+			shape.m_halfSize = colliderComponent.m_size;
+		}
+		else if (entity.HasComponent<CircleCollider2DComponent>())
+		{
+			CircleCollider2DComponent& colliderComponent = entity.GetComponent<CircleCollider2DComponent>();
+			shape.m_type = BodyShape::Type::Circle;
+			shape.m_offset = Vec3(colliderComponent.m_offset.x, colliderComponent.m_offset.y, 0.0f);
+			shape.m_radius = colliderComponent.m_radius;
+		}
 
 		remainder += translation;
 		int xTranslation = math::RoundInt(remainder.x);
 		int yTranslation = math::RoundInt(remainder.y);
 
-		// We are going to step forward per pixel. We can afford to do this
-		// since there are generally very few entities simulating on screen
-		// Note: We can optimize as it become required
+		// Bodies move in whole pixels, X first and then Y. Each axis is swept in one go
+		// so the cost doesn't depend on how fast the body is moving
 
 		// X direction
 		if (xTranslation != 0)
 		{
 			// Remove the whole translation from the remainer once we move (even if we collide)
 			remainder.x -= (float)xTranslation;
-			int step = math::Sign(xTranslation);
 
-			while (xTranslation != 0)
+			bool hit;
+			appliedTranslation.x += (float)(math::Sign(xTranslation) * Sweep(shape, position, appliedTranslation, 0, xTranslation, hit));
+			if (hit)
 			{
-				if (!Collide(entity, position + appliedTranslation + Vec2(step, 0.0f)))
-				{
-					appliedTranslation.x += step;
-					xTranslation -= step;
-				}
-				else
-				{
-					ppbComponent.m_velocity.x = 0.0f;
-					break;
-				}
+				ppbComponent.m_velocity.x = 0.0f;
+				contactNormal.x = (float)-math::Sign(xTranslation);
 			}
 		}
 
@@ -82,74 +231,162 @@ namespace rhombus
 		{
 			// Remove the whole translation from the remainer once we move (even if we collide)
 			remainder.y -= (float)yTranslation;
-			int step = math::Sign(yTranslation);
 
-			while (yTranslation != 0)
+			bool hit;
+			appliedTranslation.y += (float)(math::Sign(yTranslation) * Sweep(shape, position, appliedTranslation, 1, yTranslation, hit));
+			if (hit)
 			{
-				if (!Collide(entity, position + appliedTranslation + Vec2(0.0f, step)))
-				{
-					appliedTranslation.y += step;
-					yTranslation -= step;
-				}
-				else
-				{
-					ppbComponent.m_velocity.y = 0.0f;
-					break;
-				}
+				ppbComponent.m_velocity.y = 0.0f;
+				contactNormal.y = (float)-math::Sign(yTranslation);
 			}
 		}
 
 		transformComponent.SetWorldPosition(transformComponent.GetWorldPosition() + appliedTranslation);
+
+		ppbComponent.m_contactNormal = contactNormal;
+		return contactNormal;
 	}
 
-	bool PixelPlatformerPhysicsSystem::Collide(Entity entity, Vec2 position)
+	int PixelPlatformerPhysicsSystem::Sweep(const BodyShape& shape, const Vec3& position, const Vec2& appliedTranslation, int axis, int translation, bool& outHit) const
 	{
-		for (Entity other : GetEntities())
+		outHit = false;
+		const int step = math::Sign(translation);
+		const int stepCount = step * translation;
+		if (shape.m_type == BodyShape::Type::None || stepCount == 0)
 		{
-			if (entity == other)
-			{
-				continue;
-			}
+			return stepCount;
+		}
 
-			// We only want to collide with static objects (for now)
-			PixelPlatformerBodyComponent& otherPhysicsBody = other.GetComponent<PixelPlatformerBodyComponent>();
-			if (otherPhysicsBody.m_type != PixelPlatformerBodyComponent::BodyType::Static)
-			{
-				continue;
-			}
+		// Position after k steps, built with the same float operations as stepping a pixel at a time
+		// so touching contacts resolve exactly the same way
+		auto positionAfter = [&](int k)
+		{
+			Vec2 previous = appliedTranslation;
+			previous[axis] += (float)((k - 1) * step);
+			Vec2 stepTranslation = Vec2(0.0f);
+			stepTranslation[axis] = (float)step;
+			return Vec2(position + previous + stepTranslation);
+		};
 
-			BoxCollider2DComponent& otherColliderComponent = other.GetComponent<BoxCollider2DComponent>();
+		const Vec3 start = Vec3(Vec2(position + appliedTranslation), 0.0f) + shape.m_offset;
+		const Vec2 extent = shape.m_type == BodyShape::Type::Box ? shape.m_halfSize : Vec2(shape.m_radius, shape.m_radius);
 
-			TransformComponent& otherTransformComponent = other.GetComponent<TransformComponent>();
-			AABB otherAABB;
-			otherAABB.c = otherTransformComponent.GetWorldPosition() + otherColliderComponent.m_offset;
-			otherAABB.r = Vec3(otherColliderComponent.m_size.x, otherColliderComponent.m_size.y, 10.0f);
+		// One query over everything the body passes through
+		Vec2 min = Vec2(start.x - extent.x, start.y - extent.y);
+		Vec2 max = Vec2(start.x + extent.x, start.y + extent.y);
+		if (step > 0)
+		{
+			max[axis] += (float)stepCount;
+		}
+		else
+		{
+			min[axis] -= (float)stepCount;
+		}
 
-			// Check the type of collider that the dyanamic body has, and do the appropriate test
-			if (entity.HasComponent<BoxCollider2DComponent>())
-			{
-				BoxCollider2DComponent& myColliderComponent = entity.GetComponent<BoxCollider2DComponent>();
-				AABB myAABB;
-				myAABB.c = Vec3(position.x, position.y, 0.0f) + myColliderComponent.m_offset;
-				myAABB.r = Vec3(myColliderComponent.m_size.x, myColliderComponent.m_size.y, 10.0f);
+		const int other = 1 - axis;
+		int firstHit = stepCount + 1;
+		m_staticGrid.Query(min, max, [&](uint32_t index)
+		{
+			const AABB& box = m_staticColliders[index];
 
-				if (AABB::TestAABBAABB(myAABB, otherAABB))
+			// How far apart the centers can be along the axis while still overlapping. Stays the same along the whole sweep
+			// except for the axis itself
+			float reach;
+			if (shape.m_type == BodyShape::Type::Box)
+			{
+				if (math::Abs(start[other] - box.c[other]) >= extent[other] + box.r[other] || math::Abs(start.z - box.c.z) >= 10.0f + box.r.z)
 				{
-					return true;
+					return false;
 				}
+
+				reach = extent[axis] + box.r[axis];
 			}
-			else if (entity.HasComponent<CircleCollider2DComponent>())
+			else
 			{
-				CircleCollider2DComponent& myColliderComponent = entity.GetComponent<CircleCollider2DComponent>();
-				Sphere mySphere;
-				mySphere.c = Vec3(position.x, position.y, 0.0f) + myColliderComponent.m_offset;
-				mySphere.r = myColliderComponent.m_radius;
-
-				if (PrimitiveTests::TestSphereAABB(mySphere, otherAABB))
+				Vec3 alongAxis = start;
+				alongAxis[axis] = box.c[axis];
+				const float sqDistance = AABB::SqDistPointAABB(alongAxis, box);
+				const float sqRadius = shape.m_radius * shape.m_radius;
+				if (sqDistance >= sqRadius)
 				{
-					return true;
+					return false;
 				}
+
+				reach = box.r[axis] + math::Sqrt(sqRadius - sqDistance);
+			}
+
+			// Overlapping for step counts k with -reach < distance + step * k < reach
+			const float distance = (start[axis] - box.c[axis]) * (float)step;
+			const float lower = -reach - distance;
+			const float upper = reach - distance;
+			if (upper <= 1.0f - 1e-3f)
+			{
+				return false;
 			}
+
+			// Rounding can put the first overlapping step one out either way, settle it with the exact test
+			int k = std::max((int)math::Floor(lower) + 1, 1);
+			while (k > 1 && CollideStatic(shape, positionAfter(k - 1), index))
+			{
+				k--;
+			}
+
+			const int lastStep = std::min(firstHit - 1, (int)math::Ceil(upper) + 1);
+			while (k <= lastStep && !CollideStatic(shape, positionAfter(k), index))
+			{
+				k++;
+			}
+
+			if (k <= lastStep)
+			{
+				firstHit = k;
+			}
+
+			// Nothing can be hit before the first step
+			return firstHit == 1;
+		});
+
+		outHit = firstHit <= stepCount;
+		return outHit ? firstHit - 1 : stepCount;
+	}
+
+	bool PixelPlatformerPhysicsSystem::Collide(const BodyShape& shape, Vec2 position) const
+	{
+		// We only want to collide with static objects (for now), which are all in the grid
+		const Vec3 center = Vec3(position.x, position.y, 0.0f) + shape.m_offset;
+		const Vec2 extent = shape.m_type == BodyShape::Type::Box ? shape.m_halfSize : Vec2(shape.m_radius, shape.m_radius);
+		if (shape.m_type == BodyShape::Type::None)
+		{
+			return false;
+		}
+
+		const Vec2 min = Vec2(center.x - extent.x, center.y - extent.y);
+		const Vec2 max = Vec2(center.x + extent.x, center.y + extent.y);
+		return m_staticGrid.Query(min, max, [&](uint32_t index)
+		{
+			return CollideStatic(shape, position, index);
+		});
+	}
+
+	bool PixelPlatformerPhysicsSystem::CollideStatic(const BodyShape& shape, Vec2 position, uint32_t index) const
+	{
+		const Vec3 center = Vec3(position.x, position.y, 0.0f) + shape.m_offset;
+		const AABB& otherAABB = m_staticColliders[index];
+
+		// Check the type of collider that the dyanamic body has, and do the appropriate test
+		if (shape.m_type == BodyShape::Type::Box)
+		{
+			AABB myAABB;
+			myAABB.c = center;
+			myAABB.r = Vec3(shape.m_halfSize.x, shape.m_halfSize.y, 10.0f);
+			return AABB::TestAABBAABB(myAABB, otherAABB);
+		}
+		else if (shape.m_type == BodyShape::Type::Circle)
+		{
+			Sphere mySphere;
+			mySphere.c = center;
+			mySphere.r = shape.m_radius;
+			return PrimitiveTests::TestSphereAABB(mySphere, otherAABB);
 		}
 
 		return false;
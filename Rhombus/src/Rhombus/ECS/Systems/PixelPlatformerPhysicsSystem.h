@@ -2,9 +2,12 @@
 
 #include "Rhombus/ECS/System.h"
 #include "Rhombus/Core/DeltaTime.h"
+#include "Rhombus/Physics/UniformGrid.h"
 
 namespace rhombus
 {
+	class SceneGraphNode;
+
 	const float GRAVITY = -16.0f * 9.8f;			// 16 pixels -> 1 meter
 
 	class PixelPlatformerPhysicsSystem : public System
@@ -16,9 +19,52 @@ namespace rhombus
 
 		void Update(DeltaTime dt);
 
+		const UniformGrid& GetStaticGrid() const { return m_staticGrid; }
+
 	private:
+		// Checks Sweep against stepping a pixel at a time, see Rhombus-Tests
+		friend class PixelPlatformerSweepTest;
+
+		// Collider of the body being moved, fetched once per move rather than once per pixel
+		struct BodyShape
+		{
+			enum class Type { None = 0, Box, Circle };
+			Type m_type = Type::None;
+			Vec3 m_offset = Vec3(0.0f);
+			Vec2 m_halfSize = Vec2(0.0f);
+			float m_radius = 0.0f;
+		};
+
+		// Static body the grid was built from. Its collider is only read again when the body's transform changes or
+		// bodies or box colliders are added or removed, like the fixtures Box2D bodies are given at runtime start
+		struct StaticBody
+		{
+			EntityID m_entity = INVALID_ENTITY;
+			Ref<SceneGraphNode> m_sceneGraphNode;
+			uint32_t m_transformVersion = 0;
+			bool m_hasCollider = false;
+			AABB m_aabb;
+		};
+
+		// Rebuilds the static grid if a static body or tile map collision was added, removed, moved or resized since the last build
+		void UpdateStaticColliders();
+
 		void UpdateDynamicBody(Entity entity, DeltaTime dt);
-		void Move(Entity entity, Vec2 translation);
-		bool Collide(Entity entity, Vec2 position);
+		// Returns the contact normal of whatever stopped the move on each axis
+		Vec2 Move(Entity entity, Vec2 translation);
+		// Number of whole pixels the body can move along axis (0 = x, 1 = y) before it hits a static body, and
+		// whether it hit one. Gives the same result as stepping one pixel at a time with Collide
+		int Sweep(const BodyShape& shape, const Vec3& position, const Vec2& appliedTranslation, int axis, int translation, bool& outHit) const;
+		bool Collide(const BodyShape& shape, Vec2 position) const;
+		bool CollideStatic(const BodyShape& shape, Vec2 position, uint32_t index) const;
+
+	private:
+		std::vector<StaticBody> m_staticBodies;		// In body component order
+		uint32_t m_bodyLayoutVersion = 0;
+		uint32_t m_colliderLayoutVersion = 0;
+
+		std::vector<EntityID> m_staticEntities;
+		std::vector<AABB> m_staticColliders;		// Parallel to m_staticEntities
+		UniformGrid m_staticGrid;
 	};
 }
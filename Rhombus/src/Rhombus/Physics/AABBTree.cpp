@@ -0,0 +1,358 @@
+#include "rbpch.h"
+#include "AABBTree.h"
+
+namespace rhombus
+{
+	namespace utils
+	{
+		// Lets a proxy move this far before it has to be reinserted
+		static const float s_aabbTreeMargin = 0.1f;
+
+		static float Perimeter(const Vec2& min, const Vec2& max)
+		{
+			return 2.0f * ((max.x - min.x) + (max.y - min.y));
+		}
+
+		static Vec2 Min(const Vec2& a, const Vec2& b)
+		{
+			return Vec2(std::min(a.x, b.x), std::min(a.y, b.y));
+		}
+
+		static Vec2 Max(const Vec2& a, const Vec2& b)
+		{
+			return Vec2(std::max(a.x, b.x), std::max(a.y, b.y));
+		}
+	}
+
+	int32_t AABBTree::CreateProxy(const Vec2& min, const Vec2& max, uint32_t userData)
+	{
+		const int32_t proxyId = AllocateNode();
+		Node& node = m_nodes[proxyId];
+		node.m_min = min - Vec2(utils::s_aabbTreeMargin);
+		node.m_max = max + Vec2(utils::s_aabbTreeMargin);
+		node.m_userData = userData;
+		node.m_height = 0;
+
+		InsertLeaf(proxyId);
+		m_proxyCount++;
+		return proxyId;
+	}
+
+	void AABBTree::DestroyProxy(int32_t proxyId)
+	{
+		Log::Assert(m_nodes[proxyId].IsLeaf(), "AABBTree proxy %d is not a leaf", proxyId);
+
+		RemoveLeaf(proxyId);
+		FreeNode(proxyId);
+		m_proxyCount--;
+	}
+
+	bool AABBTree::MoveProxy(int32_t proxyId, const Vec2& min, const Vec2& max)
+	{
+		Node& node = m_nodes[proxyId];
+		if (node.m_min.x <= min.x && node.m_min.y <= min.y && max.x <= node.m_max.x && max.y <= node.m_max.y)
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxyId);
+
+		Node& movedNode = m_nodes[proxyId];
+		movedNode.m_min = min - Vec2(utils::s_aabbTreeMargin);
+		movedNode.m_max = max + Vec2(utils::s_aabbTreeMargin);
+
+		InsertLeaf(proxyId);
+		return true;
+	}
+
+	void AABBTree::Clear()
+	{
+		m_nodes.clear();
+		m_root = NULL_NODE;
+		m_freeList = NULL_NODE;
+		m_proxyCount = 0;
+	}
+
+	int32_t AABBTree::AllocateNode()
+	{
+		if (m_freeList == NULL_NODE)
+		{
+			m_nodes.emplace_back();
+			return (int32_t)m_nodes.size() - 1;
+		}
+
+		const int32_t nodeId = m_freeList;
+		m_freeList = m_nodes[nodeId].m_parent;
+		m_nodes[nodeId] = Node();
+		return nodeId;
+	}
+
+	void AABBTree::FreeNode(int32_t nodeId)
+	{
+		Node& node = m_nodes[nodeId];
+		node.m_parent = m_freeList;
+		node.m_child1 = NULL_NODE;
+		node.m_child2 = NULL_NODE;
+		node.m_height = -1;
+		m_freeList = nodeId;
+	}
+
+	void AABBTree::InsertLeaf(int32_t leaf)
+	{
+		if (m_root == NULL_NODE)
+		{
+			m_root = leaf;
+			m_nodes[leaf].m_parent = NULL_NODE;
+			return;
+		}
+
+		// Walk down to the sibling that grows the tree's total perimeter the least
+		const Vec2 leafMin = m_nodes[leaf].m_min;
+		const Vec2 leafMax = m_nodes[leaf].m_max;
+		int32_t index = m_root;
+		while (!m_nodes[index].IsLeaf())
+		{
+			const Node& node = m_nodes[index];
+			const float perimeter = utils::Perimeter(node.m_min, node.m_max);
+			const float combinedPerimeter = utils::Perimeter(utils::Min(node.m_min, leafMin), utils::Max(node.m_max, leafMax));
+
+			// Cost of pairing the leaf with this node, and the cost pushed down onto the children if we descend
+			const float cost = 2.0f * combinedPerimeter;
+			const float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+			auto descendCost = [&](int32_t childId)
+			{
+				const Node& child = m_nodes[childId];
+				const float newPerimeter = utils::Perimeter(utils::Min(child.m_min, leafMin), utils::Max(child.m_max, leafMax));
+				return child.IsLeaf() ? newPerimeter + inheritanceCost : (newPerimeter - utils::Perimeter(child.m_min, child.m_max)) + inheritanceCost;
+			};
+
+			const float cost1 = descendCost(node.m_child1);
+			const float cost2 = descendCost(node.m_child2);
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			index = cost1 < cost2 ? node.m_child1 : node.m_child2;
+		}
+
+		const int32_t sibling = index;
+		const int32_t oldParent = m_nodes[sibling].m_parent;
+		const int32_t newParent = AllocateNode();
+
+		Node& parentNode = m_nodes[newParent];
+		parentNode.m_parent = oldParent;
+		parentNode.m_min = utils::Min(m_nodes[sibling].m_min, leafMin);
+		parentNode.m_max = utils::Max(m_nodes[sibling].m_max, leafMax);
+		parentNode.m_height = m_nodes[sibling].m_height + 1;
+		parentNode.m_child1 = sibling;
+		parentNode.m_child2 = leaf;
+
+		if (oldParent != NULL_NODE)
+		{
+			if (m_nodes[oldParent].m_child1 == sibling)
+			{
+				m_nodes[oldParent].m_child1 = newParent;
+			}
+			else
+			{
+				m_nodes[oldParent].m_child2 = newParent;
+			}
+		}
+		else
+		{
+			m_root = newParent;
+		}
+
+		m_nodes[sibling].m_parent = newParent;
+		m_nodes[leaf].m_parent = newParent;
+
+		Refit(m_nodes[leaf].m_parent);
+	}
+
+	void AABBTree::RemoveLeaf(int32_t leaf)
+	{
+		if (leaf == m_root)
+		{
+			m_root = NULL_NODE;
+			return;
+		}
+
+		const int32_t parent = m_nodes[leaf].m_parent;
+		const int32_t grandParent = m_nodes[parent].m_parent;
+		const int32_t sibling = m_nodes[parent].m_child1 == leaf ? m_nodes[parent].m_child2 : m_nodes[parent].m_child1;
+
+		if (grandParent != NULL_NODE)
+		{
+			// The sibling takes the parent's place
+			if (m_nodes[grandParent].m_child1 == parent)
+			{
+				m_nodes[grandParent].m_child1 = sibling;
+			}
+			else
+			{
+				m_nodes[grandParent].m_child2 = sibling;
+			}
+
+			m_nodes[sibling].m_parent = grandParent;
+			FreeNode(parent);
+			Refit(grandParent);
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].m_parent = NULL_NODE;
+			FreeNode(parent);
+		}
+	}
+
+	void AABBTree::Refit(int32_t nodeId)
+	{
+		int32_t index = nodeId;
+		while (index != NULL_NODE)
+		{
+			index = Balance(index);
+
+			Node& node = m_nodes[index];
+			const Node& child1 = m_nodes[node.m_child1];
+			const Node& child2 = m_nodes[node.m_child2];
+			node.m_height = 1 + std::max(child1.m_height, child2.m_height);
+			node.m_min = utils::Min(child1.m_min, child2.m_min);
+			node.m_max = utils::Max(child1.m_max, child2.m_max);
+
+			index = node.m_parent;
+		}
+	}
+
+	int32_t AABBTree::Balance(int32_t iA)
+	{
+		Node& A = m_nodes[iA];
+		if (A.IsLeaf() || A.m_height < 2)
+		{
+			return iA;
+		}
+
+		const int32_t iB = A.m_child1;
+		const int32_t iC = A.m_child2;
+		Node& B = m_nodes[iB];
+		Node& C = m_nodes[iC];
+
+		const int32_t balance = C.m_height - B.m_height;
+
+		// Rotate C up
+		if (balance > 1)
+		{
+			const int32_t iF = C.m_child1;
+			const int32_t iG = C.m_child2;
+			Node& F = m_nodes[iF];
+			Node& G = m_nodes[iG];
+
+			C.m_child1 = iA;
+			C.m_parent = A.m_parent;
+			A.m_parent = iC;
+
+			if (C.m_parent != NULL_NODE)
+			{
+				if (m_nodes[C.m_parent].m_child1 == iA)
+				{
+					m_nodes[C.m_parent].m_child1 = iC;
+				}
+				else
+				{
+					m_nodes[C.m_parent].m_child2 = iC;
+				}
+			}
+			else
+			{
+				m_root = iC;
+			}
+
+			// The taller of C's children stays with C, the other moves under A
+			if (F.m_height > G.m_height)
+			{
+				C.m_child2 = iF;
+				A.m_child2 = iG;
+				G.m_parent = iA;
+				A.m_min = utils::Min(B.m_min, G.m_min);
+				A.m_max = utils::Max(B.m_max, G.m_max);
+				C.m_min = utils::Min(A.m_min, F.m_min);
+				C.m_max = utils::Max(A.m_max, F.m_max);
+				A.m_height = 1 + std::max(B.m_height, G.m_height);
+				C.m_height = 1 + std::max(A.m_height, F.m_height);
+			}
+			else
+			{
+				C.m_child2 = iG;
+				A.m_child2 = iF;
+				F.m_parent = iA;
+				A.m_min = utils::Min(B.m_min, F.m_min);
+				A.m_max = utils::Max(B.m_max, F.m_max);
+				C.m_min = utils::Min(A.m_min, G.m_min);
+				C.m_max = utils::Max(A.m_max, G.m_max);
+				A.m_height = 1 + std::max(B.m_height, F.m_height);
+				C.m_height = 1 + std::max(A.m_height, G.m_height);
+			}
+
+			return iC;
+		}
+
+		// Rotate B up
+		if (balance < -1)
+		{
+			const int32_t iD = B.m_child1;
+			const int32_t iE = B.m_child2;
+			Node& D = m_nodes[iD];
+			Node& E = m_nodes[iE];
+
+			B.m_child1 = iA;
+			B.m_parent = A.m_parent;
+			A.m_parent = iB;
+
+			if (B.m_parent != NULL_NODE)
+			{
+				if (m_nodes[B.m_parent].m_child1 == iA)
+				{
+					m_nodes[B.m_parent].m_child1 = iB;
+				}
+				else
+				{
+					m_nodes[B.m_parent].m_child2 = iB;
+				}
+			}
+			else
+			{
+				m_root = iB;
+			}
+
+			if (D.m_height > E.m_height)
+			{
+				B.m_child2 = iD;
+				A.m_child1 = iE;
+				E.m_parent = iA;
+				A.m_min = utils::Min(C.m_min, E.m_min);
+				A.m_max = utils::Max(C.m_max, E.m_max);
+				B.m_min = utils::Min(A.m_min, D.m_min);
+				B.m_max = utils::Max(A.m_max, D.m_max);
+				A.m_height = 1 + std::max(C.m_height, E.m_height);
+				B.m_height = 1 + std::max(A.m_height, D.m_height);
+			}
+			else
+			{
+				B.m_child2 = iE;
+				A.m_child1 = iD;
+				D.m_parent = iA;
+				A.m_min = utils::Min(C.m_min, D.m_min);
+				A.m_max = utils::Max(C.m_max, D.m_max);
+				B.m_min = utils::Min(A.m_min, E.m_min);
+				B.m_max = utils::Max(A.m_max, E.m_max);
+				A.m_height = 1 + std::max(C.m_height, D.m_height);
+				B.m_height = 1 + std::max(A.m_height, E.m_height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+}
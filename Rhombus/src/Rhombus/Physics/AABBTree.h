@@ -0,0 +1,231 @@
+#pragma once
+
+#include "Rhombus/Math/Vector.h"
+
+#include <cfloat>
+#include <vector>
+
+namespace rhombus
+{
+	// Dynamic bounding volume tree over 2D boxes. Leaves store a box grown by a margin so small movements don't need
+	// the tree to be touched, and the tree is kept balanced with rotations as leaves come and go
+	class AABBTree
+	{
+	public:
+		static constexpr int32_t NULL_NODE = -1;
+
+		int32_t CreateProxy(const Vec2& min, const Vec2& max, uint32_t userData);
+		void DestroyProxy(int32_t proxyId);
+		// Reinserts the proxy only if the box has left its grown box. Returns true if it was reinserted
+		bool MoveProxy(int32_t proxyId, const Vec2& min, const Vec2& max);
+		void Clear();
+
+		uint32_t GetUserData(int32_t proxyId) const { return m_nodes[proxyId].m_userData; }
+		const Vec2& GetFatMin(int32_t proxyId) const { return m_nodes[proxyId].m_min; }
+		const Vec2& GetFatMax(int32_t proxyId) const { return m_nodes[proxyId].m_max; }
+
+		uint32_t GetProxyCount() const { return m_proxyCount; }
+		int32_t GetHeight() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].m_height; }
+
+		// Calls func(proxyId) for every proxy whose grown box overlaps min to max, stopping as soon as func returns true.
+		// Returns true if func stopped the query
+		template<typename Func>
+		bool Query(const Vec2& min, const Vec2& max, Func func) const
+		{
+			int32_t stack[STACK_SIZE];
+			int32_t count = 0;
+			stack[count++] = m_root;
+			while (count > 0)
+			{
+				const int32_t nodeId = stack[--count];
+				if (nodeId == NULL_NODE)
+				{
+					continue;
+				}
+
+				const Node& node = m_nodes[nodeId];
+				if (node.m_max.x < min.x || node.m_min.x > max.x || node.m_max.y < min.y || node.m_min.y > max.y)
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					if (func(nodeId))
+					{
+						return true;
+					}
+				}
+				else
+				{
+					Log::Assert(count + 2 <= STACK_SIZE, "AABBTree is too deep to query");
+					stack[count++] = node.m_child1;
+					stack[count++] = node.m_child2;
+				}
+			}
+
+			return false;
+		}
+
+		// Casts the segment start to end. func(proxyId, maxFraction) is called for every proxy the remaining segment
+		// passes through the grown box of and returns the fraction to clip the segment to, maxFraction to carry on as
+		// is or 0 to stop
+		template<typename Func>
+		void Raycast(const Vec2& start, const Vec2& end, Func func) const
+		{
+			const Vec2 delta = end - start;
+			if (delta.GetMag2() <= 0.0f)
+			{
+				return;
+			}
+
+			// Separating axis along the segment normal, scaled by the segment length
+			const Vec2 normal = Vec2(-delta.y, delta.x);
+			const Vec2 absNormal = Vec2(std::abs(normal.x), std::abs(normal.y));
+
+			float maxFraction = 1.0f;
+			Vec2 segmentEnd = end;
+
+			int32_t stack[STACK_SIZE];
+			int32_t count = 0;
+			stack[count++] = m_root;
+			while (count > 0)
+			{
+				const int32_t nodeId = stack[--count];
+				if (nodeId == NULL_NODE)
+				{
+					continue;
+				}
+
+				const Node& node = m_nodes[nodeId];
+				if (node.m_max.x < std::min(start.x, segmentEnd.x) || node.m_min.x > std::max(start.x, segmentEnd.x) ||
+					node.m_max.y < std::min(start.y, segmentEnd.y) || node.m_min.y > std::max(start.y, segmentEnd.y))
+				{
+					continue;
+				}
+
+				const Vec2 center = (node.m_min + node.m_max) * 0.5f;
+				const Vec2 extents = (node.m_max - node.m_min) * 0.5f;
+				if (std::abs(normal.Dot(start - center)) - absNormal.Dot(extents) > 0.0f)
+				{
+					continue;
+				}
+
+				if (node.IsLeaf())
+				{
+					const float fraction = func(nodeId, maxFraction);
+					if (fraction == 0.0f)
+					{
+						return;
+					}
+
+					if (fraction < maxFraction)
+					{
+						maxFraction = fraction;
+						segmentEnd = start + delta * maxFraction;
+					}
+				}
+				else
+				{
+					Log::Assert(count + 2 <= STACK_SIZE, "AABBTree is too deep to raycast");
+					stack[count++] = node.m_child1;
+					stack[count++] = node.m_child2;
+				}
+			}
+		}
+
+		// Visits proxies nearest grown box first. func(proxyId) returns the squared distance from point beyond which
+		// proxies are of no more interest, anything whose grown box is further away than that is skipped
+		template<typename Func>
+		void QueryNearest(const Vec2& point, Func func) const
+		{
+			if (m_root == NULL_NODE)
+			{
+				return;
+			}
+
+			struct Entry
+			{
+				int32_t m_nodeId;
+				float m_distance2;
+			};
+
+			float maxDistance2 = FLT_MAX;
+
+			Entry stack[STACK_SIZE];
+			int32_t count = 0;
+			stack[count++] = { m_root, SqDistPointBox(point, m_nodes[m_root].m_min, m_nodes[m_root].m_max) };
+			while (count > 0)
+			{
+				const Entry entry = stack[--count];
+				if (entry.m_distance2 > maxDistance2)
+				{
+					continue;
+				}
+
+				const Node& node = m_nodes[entry.m_nodeId];
+				if (node.IsLeaf())
+				{
+					maxDistance2 = func(entry.m_nodeId);
+					continue;
+				}
+
+				const float distance1 = SqDistPointBox(point, m_nodes[node.m_child1].m_min, m_nodes[node.m_child1].m_max);
+				const float distance2 = SqDistPointBox(point, m_nodes[node.m_child2].m_min, m_nodes[node.m_child2].m_max);
+
+				// The nearer child goes on last so it is visited first and tightens the bound for the other
+				Log::Assert(count + 2 <= STACK_SIZE, "AABBTree is too deep to query");
+				if (distance1 < distance2)
+				{
+					stack[count++] = { node.m_child2, distance2 };
+					stack[count++] = { node.m_child1, distance1 };
+				}
+				else
+				{
+					stack[count++] = { node.m_child1, distance1 };
+					stack[count++] = { node.m_child2, distance2 };
+				}
+			}
+		}
+
+		static float SqDistPointBox(const Vec2& point, const Vec2& min, const Vec2& max)
+		{
+			const float dx = std::max(std::max(min.x - point.x, point.x - max.x), 0.0f);
+			const float dy = std::max(std::max(min.y - point.y, point.y - max.y), 0.0f);
+			return dx * dx + dy * dy;
+		}
+
+	private:
+		// A balanced tree of even a few million proxies stays well below this
+		static constexpr int32_t STACK_SIZE = 256;
+
+		struct Node
+		{
+			Vec2 m_min;
+			Vec2 m_max;
+			uint32_t m_userData = 0;
+			int32_t m_parent = NULL_NODE;		// Next free node while on the free list
+			int32_t m_child1 = NULL_NODE;
+			int32_t m_child2 = NULL_NODE;
+			int32_t m_height = -1;				// 0 for leaves, -1 while free
+
+			bool IsLeaf() const { return m_child1 == NULL_NODE; }
+		};
+
+		int32_t AllocateNode();
+		void FreeNode(int32_t nodeId);
+
+		void InsertLeaf(int32_t leaf);
+		void RemoveLeaf(int32_t leaf);
+		// Rotates the taller child of nodeId up if the children are unbalanced, returns the node now in its place
+		int32_t Balance(int32_t nodeId);
+		// Refits bounds and heights from nodeId up to the root, balancing on the way
+		void Refit(int32_t nodeId);
+
+	private:
+		std::vector<Node> m_nodes;
+		int32_t m_root = NULL_NODE;
+		int32_t m_freeList = NULL_NODE;
+		uint32_t m_proxyCount = 0;
+	};
+}
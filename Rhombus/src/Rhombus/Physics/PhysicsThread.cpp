@@ -0,0 +1,138 @@
+#include "rbpch.h"
+#include "PhysicsThread.h"
+
+// Box2d
+#include <box2d/b2_world.h>
+#include <box2d/b2_body.h>
+
+namespace rhombus
+{
+	PhysicsThread::PhysicsThread(b2World* world, int32_t velocityIterations, int32_t positionIterations)
+		: m_world(world), m_velocityIterations(velocityIterations), m_positionIterations(positionIterations)
+	{
+		m_thread = std::thread([this]() { Run(); });
+	}
+
+	PhysicsThread::~PhysicsThread()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_condition.notify_all();
+		m_thread.join();
+	}
+
+	void PhysicsThread::QueueLinearImpulse(b2Body* body, const Vec2& impulse)
+	{
+		m_queuedCommands.push_back({ Command::Type::ApplyLinearImpulse, body, impulse });
+	}
+
+	void PhysicsThread::DestroyBody(b2Body* body)
+	{
+		// Queued impulses would be applied to a dead body
+		m_queuedCommands.erase(std::remove_if(m_queuedCommands.begin(), m_queuedCommands.end(), [body](const Command& command)
+		{
+			return command.m_body == body;
+		}), m_queuedCommands.end());
+
+		if (m_stepping)
+		{
+			m_bodiesToDestroy.push_back(body);
+		}
+		else
+		{
+			m_world->DestroyBody(body);
+		}
+	}
+
+	void PhysicsThread::BeginStep(float dt)
+	{
+		Log::Assert(!m_stepping, "Physics step started while the previous one is still running");
+
+		// The worker is idle, so handing over the commands needs no lock
+		m_stepCommands.swap(m_queuedCommands);
+		m_queuedCommands.clear();
+		m_stepDeltaTime = dt;
+		m_stepping = true;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stepRequested = true;
+		}
+		m_condition.notify_all();
+	}
+
+	const std::vector<PhysicsBodyTransform>& PhysicsThread::EndStep()
+	{
+		if (m_stepping)
+		{
+			RB_PROFILE_FUNCTION();
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return !m_stepRequested; });
+			m_stepping = false;
+			m_writeIndex ^= 1;
+
+			for (b2Body* body : m_bodiesToDestroy)
+			{
+				m_world->DestroyBody(body);
+			}
+			m_bodiesToDestroy.clear();
+		}
+
+		return m_transforms[m_writeIndex ^ 1];
+	}
+
+	void PhysicsThread::GatherTransforms(b2World* world, std::vector<PhysicsBodyTransform>& outTransforms)
+	{
+		outTransforms.clear();
+		for (b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+		{
+			// Static and sleeping bodies can't have moved
+			if (body->GetType() == b2_staticBody || !body->IsAwake())
+			{
+				continue;
+			}
+
+			const b2Vec2& position = body->GetPosition();
+			const uintptr_t userData = body->GetUserData().pointer;
+			outTransforms.push_back({ GetBodyEntity(userData), GetBodyGeneration(userData), Vec2(position.x, position.y), body->GetAngle() });
+		}
+	}
+
+	void PhysicsThread::Run()
+	{
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]() { return m_stepRequested || m_quit; });
+				if (m_quit)
+				{
+					return;
+				}
+			}
+
+			for (const Command& command : m_stepCommands)
+			{
+				switch (command.m_type)
+				{
+				case Command::Type::ApplyLinearImpulse:
+					command.m_body->ApplyLinearImpulseToCenter(b2Vec2(command.m_value.x, command.m_value.y), true);
+					break;
+				}
+			}
+			m_stepCommands.clear();
+
+			m_world->Step(m_stepDeltaTime, m_velocityIterations, m_positionIterations);
+			GatherTransforms(m_world, m_transforms[m_writeIndex]);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stepRequested = false;
+			}
+			m_condition.notify_all();
+		}
+	}
+}
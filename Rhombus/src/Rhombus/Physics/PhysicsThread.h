@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Rhombus/ECS/ECSTypes.h"
+#include "Rhombus/Math/Vector.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class b2World;
+class b2Body;
+
+namespace rhombus
+{
+	// Bodies carry their entity and its generation when the body was made in the user data. A step can finish after
+	// the entity was destroyed and its ID reused, the generation tells the results apart
+	inline uintptr_t GetBodyUserData(EntityID entity, uint32_t generation) { return (uintptr_t)(((uint64_t)generation << 32) | entity); }
+	inline EntityID GetBodyEntity(uintptr_t userData) { return (EntityID)(userData & 0xFFFFFFFF); }
+	inline uint32_t GetBodyGeneration(uintptr_t userData) { return (uint32_t)((uint64_t)userData >> 32); }
+
+	// Where a moving body ended up after a step
+	struct PhysicsBodyTransform
+	{
+		EntityID m_entity;
+		uint32_t m_generation;
+		Vec2 m_position;
+		float m_angle;
+	};
+
+	// Steps a Box2D world on a dedicated thread. The main thread starts a step with BeginStep and picks up the result
+	// with EndStep on the next fixed update, so the step runs alongside everything else the game does in between.
+	// Results land in one of two transform buffers, the one EndStep hands out stays untouched while the next step writes
+	// the other. Nothing but this thread may touch the world between BeginStep and EndStep
+	class PhysicsThread
+	{
+	public:
+		PhysicsThread(b2World* world, int32_t velocityIterations, int32_t positionIterations);
+		~PhysicsThread();
+
+		// Applied on the worker right before the next step
+		void QueueLinearImpulse(b2Body* body, const Vec2& impulse);
+		// Destroys the body straight away when no step is running, otherwise once EndStep has waited for it
+		void DestroyBody(b2Body* body);
+
+		void BeginStep(float dt);
+		// Waits for the step in flight, if any, and returns the transforms of the bodies that were awake after it
+		const std::vector<PhysicsBodyTransform>& EndStep();
+
+		bool IsStepping() const { return m_stepping; }
+
+		// Transforms of the awake non-static bodies of the world
+		static void GatherTransforms(b2World* world, std::vector<PhysicsBodyTransform>& outTransforms);
+
+	private:
+		void Run();
+
+	private:
+		struct Command
+		{
+			enum class Type { ApplyLinearImpulse };
+
+			Type m_type;
+			b2Body* m_body;
+			Vec2 m_value;
+		};
+
+		b2World* m_world;
+		int32_t m_velocityIterations;
+		int32_t m_positionIterations;
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		bool m_stepRequested = false;			// Guarded by m_mutex
+		bool m_quit = false;					// Guarded by m_mutex
+		bool m_stepping = false;				// Main thread only, true between BeginStep and EndStep
+		float m_stepDeltaTime = 0.0f;
+
+		std::vector<Command> m_queuedCommands;	// Filled by the main thread
+		std::vector<Command> m_stepCommands;	// Handed to the worker by BeginStep
+		std::vector<b2Body*> m_bodiesToDestroy;	// Main thread only, destroyed by EndStep
+
+		std::vector<PhysicsBodyTransform> m_transforms[2];
+		uint32_t m_writeIndex = 0;				// Buffer the worker fills, EndStep hands out the other
+	};
+}
@@ -0,0 +1,118 @@
+#include "rbpch.h"
+#include "UniformGrid.h"
+
+namespace rhombus
+{
+	void UniformGrid::Build(const std::vector<AABB>& boxes, float cellSize)
+	{
+		RB_PROFILE_FUNCTION();
+
+		Clear();
+		if (boxes.empty())
+		{
+			return;
+		}
+
+		Vec2 min = Vec2(boxes[0].c.x - boxes[0].r.x, boxes[0].c.y - boxes[0].r.y);
+		Vec2 max = Vec2(boxes[0].c.x + boxes[0].r.x, boxes[0].c.y + boxes[0].r.y);
+		float totalSize = 0.0f;
+		for (const AABB& box : boxes)
+		{
+			min.x = std::min(min.x, box.c.x - box.r.x);
+			min.y = std::min(min.y, box.c.y - box.r.y);
+			max.x = std::max(max.x, box.c.x + box.r.x);
+			max.y = std::max(max.y, box.c.y + box.r.y);
+			totalSize += 2.0f * std::max(box.r.x, box.r.y);
+		}
+
+		// Roughly two boxes across a cell keeps the number of cells a box lands in low without crowding the cells
+		if (cellSize <= 0.0f)
+		{
+			cellSize = std::max(2.0f * totalSize / (float)boxes.size(), 1.0f);
+		}
+
+		// Sparse levels would otherwise allocate mostly empty cells, keep the grid within a few cells per box
+		const uint64_t maxCells = std::max<uint64_t>(1024, (uint64_t)boxes.size() * 4);
+		while (true)
+		{
+			m_columns = std::max((int)math::Floor((max.x - min.x) / cellSize) + 1, 1);
+			m_rows = std::max((int)math::Floor((max.y - min.y) / cellSize) + 1, 1);
+			if ((uint64_t)m_columns * (uint64_t)m_rows <= maxCells)
+			{
+				break;
+			}
+
+			cellSize *= 2.0f;
+		}
+
+		m_origin = min;
+		m_cellSize = cellSize;
+
+		// Counting sort of the boxes into their cells: count, prefix sum, then fill
+		const uint32_t cellCount = (uint32_t)(m_columns * m_rows);
+		m_cellStarts.assign(cellCount + 1, 0);
+		for (const AABB& box : boxes)
+		{
+			int minX, minY, maxX, maxY;
+			GetCellRange(Vec2(box.c.x - box.r.x, box.c.y - box.r.y), Vec2(box.c.x + box.r.x, box.c.y + box.r.y), minX, minY, maxX, maxY);
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					m_cellStarts[y * m_columns + x + 1]++;
+				}
+			}
+		}
+
+		for (uint32_t cell = 0; cell < cellCount; cell++)
+		{
+			m_cellStarts[cell + 1] += m_cellStarts[cell];
+		}
+
+		m_cellItems.resize(m_cellStarts[cellCount]);
+		std::vector<uint32_t> cursor(m_cellStarts.begin(), m_cellStarts.end() - 1);
+		for (uint32_t index = 0; index < (uint32_t)boxes.size(); index++)
+		{
+			const AABB& box = boxes[index];
+			int minX, minY, maxX, maxY;
+			GetCellRange(Vec2(box.c.x - box.r.x, box.c.y - box.r.y), Vec2(box.c.x + box.r.x, box.c.y + box.r.y), minX, minY, maxX, maxY);
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					m_cellItems[cursor[y * m_columns + x]++] = index;
+				}
+			}
+		}
+	}
+
+	void UniformGrid::Clear()
+	{
+		m_origin = Vec2(0.0f);
+		m_cellSize = 1.0f;
+		m_columns = 0;
+		m_rows = 0;
+		m_cellStarts.clear();
+		m_cellItems.clear();
+	}
+
+	bool UniformGrid::GetCellRange(const Vec2& min, const Vec2& max, int& outMinX, int& outMinY, int& outMaxX, int& outMaxY) const
+	{
+		const float inverseCellSize = 1.0f / m_cellSize;
+		const float minX = math::Floor((min.x - m_origin.x) * inverseCellSize);
+		const float minY = math::Floor((min.y - m_origin.y) * inverseCellSize);
+		const float maxX = math::Floor((max.x - m_origin.x) * inverseCellSize);
+		const float maxY = math::Floor((max.y - m_origin.y) * inverseCellSize);
+
+		if (maxX < 0.0f || maxY < 0.0f || minX >= (float)m_columns || minY >= (float)m_rows)
+		{
+			return false;
+		}
+
+		outMinX = std::max((int)minX, 0);
+		outMinY = std::max((int)minY, 0);
+		outMaxX = std::min((int)maxX, m_columns - 1);
+		outMaxY = std::min((int)maxY, m_rows - 1);
+		return true;
+	}
+}
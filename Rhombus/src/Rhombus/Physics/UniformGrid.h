@@ -0,0 +1,68 @@
+#pragma once
+
+#include "AABB.h"
+
+#include <vector>
+
+namespace rhombus
+{
+	// Static broadphase over the XY extents of a set of boxes. Built in one go and then only read from, each cell holds
+	// the indices of the boxes overlapping it in one flat array so a query touches a few contiguous runs of memory
+	class UniformGrid
+	{
+	public:
+		// A cellSize of 0 picks one from the average box size
+		void Build(const std::vector<AABB>& boxes, float cellSize = 0.0f);
+		void Clear();
+
+		// Calls func(index) for every box in the cells overlapping min to max, stopping as soon as func returns true.
+		// A box spanning several cells can be visited more than once. Returns true if func stopped the query
+		template<typename Func>
+		bool Query(const Vec2& min, const Vec2& max, Func func) const
+		{
+			if (m_cellStarts.empty())
+			{
+				return false;
+			}
+
+			int minX, minY, maxX, maxY;
+			if (!GetCellRange(min, max, minX, minY, maxX, maxY))
+			{
+				return false;
+			}
+
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					const uint32_t cell = (uint32_t)(y * m_columns + x);
+					for (uint32_t i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; i++)
+					{
+						if (func(m_cellItems[i]))
+						{
+							return true;
+						}
+					}
+				}
+			}
+
+			return false;
+		}
+
+		float GetCellSize() const { return m_cellSize; }
+		uint32_t GetCellCount() const { return (uint32_t)(m_columns * m_rows); }
+
+	private:
+		// Clamps the range to the grid. False if it misses the grid entirely
+		bool GetCellRange(const Vec2& min, const Vec2& max, int& outMinX, int& outMinY, int& outMaxX, int& outMaxY) const;
+
+	private:
+		Vec2 m_origin = Vec2(0.0f);
+		float m_cellSize = 1.0f;
+		int m_columns = 0;
+		int m_rows = 0;
+
+		std::vector<uint32_t> m_cellStarts;		// Cell i owns m_cellItems[m_cellStarts[i], m_cellStarts[i + 1])
+		std::vector<uint32_t> m_cellItems;
+	};
+}
@@ -3,6 +3,7 @@
 #include "Renderer.h"
 
 #include "Platform/OpenGL/OpenGLBuffer.h"
+#include "Platform/Null/NullBuffer.h"
 
 namespace rhombus {
 
@@ -10,7 +11,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI()) 
 		{
-			case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullVertexBuffer>(vertices, size);
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLVertexBuffer>(vertices, size);
 		}
@@ -23,7 +25,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullVertexBuffer>(size);
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLVertexBuffer>(size);
 		}
@@ -36,7 +39,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullIndexBuffer>(indices, count);
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLIndexBuffer>(indices, count);
 		}
@@ -3,6 +3,7 @@
 
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLFramebuffer.h"
+#include "Platform/Null/NullFramebuffer.h"
 
 namespace rhombus
 {
@@ -10,7 +11,8 @@ namespace rhombus
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None: Log::Assert(false, "RendererAPI::None is current not supported!"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None: return std::make_shared<NullFramebuffer>(spec);
 			case RendererAPI::API::OpenGL: return std::make_shared<OpenGLFramebuffer>(spec);
 		}
 
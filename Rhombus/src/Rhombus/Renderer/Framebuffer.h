@@ -59,6 +59,11 @@ namespace rhombus
 
 		virtual void Resize(uint32_t width, uint32_t height) = 0;
 		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) = 0;
+		// Queues a read of one integer texel without waiting for the GPU. The value can be collected with GetAsyncPixel
+		// once the GPU has caught up, usually the next frame. A new request is ignored while one is still in flight
+		virtual void ReadPixelAsync(uint32_t attachmentIndex, int x, int y) = 0;
+		// Returns false until the last ReadPixelAsync has finished
+		virtual bool GetAsyncPixel(int& outValue) = 0;
 
 		virtual void ClearAttachment(uint32_t attachmentIndex, int value) = 0;
 
@@ -0,0 +1,182 @@
+#include "rbpch.h"
+#include "PickingBuffer.h"
+
+namespace rhombus
+{
+	namespace utils
+	{
+		// Segment from origin to origin + direction against an axis aligned box
+		static bool SegmentIntersectsBounds(const Vec3& origin, const Vec3& direction, const Vec3& min, const Vec3& max)
+		{
+			float tMin = 0.0f;
+			float tMax = 1.0f;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				if (std::abs(direction[axis]) < 1e-8f)
+				{
+					if (origin[axis] < min[axis] || origin[axis] > max[axis])
+						return false;
+
+					continue;
+				}
+
+				const float inverse = 1.0f / direction[axis];
+				float t0 = (min[axis] - origin[axis]) * inverse;
+				float t1 = (max[axis] - origin[axis]) * inverse;
+				if (t0 > t1)
+					std::swap(t0, t1);
+
+				tMin = std::max(tMin, t0);
+				tMax = std::min(tMax, t1);
+				if (tMin > tMax)
+					return false;
+			}
+
+			return true;
+		}
+
+		// Same as the GLSL smoothstep
+		static float SmoothStep(float edge0, float edge1, float x)
+		{
+			const float t = std::clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+			return t * t * (3.0f - 2.0f * t);
+		}
+	}
+
+	void PickingBuffer::Clear()
+	{
+		m_Primitives.clear();
+		m_Bounds.clear();
+	}
+
+	PickingBuffer::Primitive& PickingBuffer::AddPrimitive(const Vec3 corners[4], int entityID, uint32_t batch, PrimitiveType type)
+	{
+		Bounds& bounds = m_Bounds.emplace_back();
+		bounds.Min = corners[0];
+		bounds.Max = corners[0];
+		for (int i = 1; i < 4; i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				bounds.Min[axis] = std::min(bounds.Min[axis], corners[i][axis]);
+				bounds.Max[axis] = std::max(bounds.Max[axis], corners[i][axis]);
+			}
+		}
+
+		Primitive& primitive = m_Primitives.emplace_back();
+		primitive.Origin = corners[0];
+		primitive.EdgeU = corners[1] - corners[0];
+		primitive.EdgeV = corners[3] - corners[0];
+		primitive.EntityID = entityID;
+		primitive.Batch = batch;
+		primitive.Type = type;
+		return primitive;
+	}
+
+	void PickingBuffer::AddQuad(const Vec3 corners[4], const Vec2& uvMin, const Vec2& uvMax, const Ref<Texture2D>& texture, float tilingFactor, int entityID, uint32_t batch)
+	{
+		Primitive& primitive = AddPrimitive(corners, entityID, batch, PrimitiveType::Quad);
+		primitive.UVMin = uvMin;
+		primitive.UVMax = uvMax;
+		primitive.Texture = texture;
+		primitive.TilingFactor = tilingFactor;
+	}
+
+	void PickingBuffer::AddCircle(const Vec3 corners[4], float thickness, float fade, int entityID, uint32_t batch)
+	{
+		Primitive& primitive = AddPrimitive(corners, entityID, batch, PrimitiveType::Circle);
+		primitive.Thickness = thickness;
+		primitive.Fade = fade;
+	}
+
+	bool PickingBuffer::HitTest(const Primitive& primitive, const Vec3& rayOrigin, const Vec3& rayDirection) const
+	{
+		const Vec3 normal = primitive.EdgeU.Cross(primitive.EdgeV);
+		const float denominator = rayDirection.Dot(normal);
+		if (std::abs(denominator) < 1e-12f)
+			return false;
+
+		const float t = (primitive.Origin - rayOrigin).Dot(normal) / denominator;
+		if (t < 0.0f || t > 1.0f)
+			return false;
+
+		// Position of the hit across the two edges, 0 to 1 inside the primitive
+		const Vec3 offset = rayOrigin + rayDirection * t - primitive.Origin;
+		const float normalLength2 = normal.Dot(normal);
+		const float s = offset.Cross(primitive.EdgeV).Dot(normal) / normalLength2;
+		const float r = primitive.EdgeU.Cross(offset).Dot(normal) / normalLength2;
+		if (s < 0.0f || s > 1.0f || r < 0.0f || r > 1.0f)
+			return false;
+
+		if (primitive.Type == PrimitiveType::Circle)
+		{
+			// Matches the discard in Renderer2D_Circle.glsl
+			const float x = s * 2.0f - 1.0f;
+			const float y = r * 2.0f - 1.0f;
+			const float distance = 1.0f - std::sqrt(x * x + y * y);
+
+			float circle;
+			if (primitive.Fade <= 0.0f)
+			{
+				circle = (distance >= 0.0f ? 1.0f : 0.0f) * (distance >= primitive.Thickness ? 0.0f : 1.0f);
+			}
+			else
+			{
+				circle = utils::SmoothStep(0.0f, primitive.Fade, distance) * utils::SmoothStep(primitive.Thickness + primitive.Fade, primitive.Thickness, distance);
+			}
+
+			return circle != 0.0f;
+		}
+
+		// Matches the alpha discard in Renderer2D_Quad.glsl, sampled the way a nearest filtered repeating texture is
+		const Texture2D* texture = primitive.Texture.get();
+		if (!texture || texture->GetWidth() == 0 || texture->GetHeight() == 0)
+			return true;
+
+		float u = (primitive.UVMin.x + (primitive.UVMax.x - primitive.UVMin.x) * s) * primitive.TilingFactor;
+		float v = (primitive.UVMin.y + (primitive.UVMax.y - primitive.UVMin.y) * r) * primitive.TilingFactor;
+		u -= std::floor(u);
+		v -= std::floor(v);
+
+		const uint32_t texelX = std::min((uint32_t)(u * texture->GetWidth()), texture->GetWidth() - 1);
+		const uint32_t texelY = std::min((uint32_t)(v * texture->GetHeight()), texture->GetHeight() - 1);
+		return texture->IsTexelVisible(texelX, texelY);
+	}
+
+	int PickingBuffer::Pick(const Vec2& ndc) const
+	{
+		RB_PROFILE_FUNCTION();
+
+		// Segment from the near plane to the far plane through the cursor
+		const Mat4 inverseViewProjection = m_ViewProjection.Inverse();
+		Vec4 nearPoint = inverseViewProjection * Vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+		Vec4 farPoint = inverseViewProjection * Vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+		if (nearPoint.w == 0.0f || farPoint.w == 0.0f)
+			return -1;
+
+		const Vec3 rayOrigin = Vec3(nearPoint / nearPoint.w);
+		const Vec3 rayDirection = Vec3(farPoint / farPoint.w) - rayOrigin;
+
+		// Later batches draw over earlier ones and within a batch circles draw over quads, otherwise submission order wins
+		int bestIndex = -1;
+		for (int i = (int)m_Primitives.size() - 1; i >= 0; i--)
+		{
+			const Primitive& primitive = m_Primitives[i];
+			if (bestIndex >= 0)
+			{
+				const Primitive& best = m_Primitives[bestIndex];
+				if (primitive.Batch < best.Batch || (primitive.Batch == best.Batch && primitive.Type <= best.Type))
+					continue;
+			}
+
+			const Bounds& bounds = m_Bounds[i];
+			if (!utils::SegmentIntersectsBounds(rayOrigin, rayDirection, bounds.Min, bounds.Max))
+				continue;
+
+			if (HitTest(primitive, rayOrigin, rayDirection))
+				bestIndex = i;
+		}
+
+		return bestIndex >= 0 ? m_Primitives[bestIndex].EntityID : -1;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Texture.h"
+
+#include "Rhombus/Math/Vector.h"
+#include "Rhombus/Math/Matrix.h"
+
+namespace rhombus
+{
+	// CPU copy of the quads and circles Renderer2D drew with an entity ID, so the entity under the cursor can be found
+	// without reading back the entity ID attachment. Hits follow the same draw order and discard rules as the shaders
+	class PickingBuffer
+	{
+	public:
+		void Clear();
+
+		void SetViewProjection(const Mat4& viewProjection) { m_ViewProjection = viewProjection; }
+
+		// Corners are in world space in the order of the Renderer2D quad vertices
+		void AddQuad(const Vec3 corners[4], const Vec2& uvMin, const Vec2& uvMax, const Ref<Texture2D>& texture, float tilingFactor, int entityID, uint32_t batch);
+		void AddCircle(const Vec3 corners[4], float thickness, float fade, int entityID, uint32_t batch);
+
+		// ndc is the position in normalised device coordinates. Returns -1 if nothing is hit
+		int Pick(const Vec2& ndc) const;
+
+		uint32_t GetPrimitiveCount() const { return (uint32_t)m_Primitives.size(); }
+
+	private:
+		// Within a batch every quad is drawn before any circle
+		enum class PrimitiveType : uint8_t { Quad = 0, Circle = 1 };
+
+		struct Primitive
+		{
+			Vec3 Origin;
+			Vec3 EdgeU;
+			Vec3 EdgeV;
+			Vec2 UVMin;
+			Vec2 UVMax;
+			Ref<Texture2D> Texture;
+			float TilingFactor = 1.0f;
+			float Thickness = 1.0f;
+			float Fade = 0.0f;
+			int EntityID = -1;
+			uint32_t Batch = 0;
+			PrimitiveType Type = PrimitiveType::Quad;
+		};
+
+		struct Bounds
+		{
+			Vec3 Min;
+			Vec3 Max;
+		};
+
+		Primitive& AddPrimitive(const Vec3 corners[4], int entityID, uint32_t batch, PrimitiveType type);
+		bool HitTest(const Primitive& primitive, const Vec3& rayOrigin, const Vec3& rayDirection) const;
+
+	private:
+		std::vector<Primitive> m_Primitives;
+		std::vector<Bounds> m_Bounds;			// Kept apart from the primitives so the broad phase scan stays in cache
+		Mat4 m_ViewProjection = Mat4::Identity();
+	};
+}
@@ -10,6 +10,8 @@ namespace rhombus {
 	public:
 		static void Init()
 		{
+			// Recreate in case the API was changed after static initialisation
+			s_RendererAPI = RendererAPI::Create();
 			s_RendererAPI->Init();
 		}
 
@@ -49,7 +51,7 @@ namespace rhombus {
 		}
 
 	private:
-		static RendererAPI* s_RendererAPI;
+		static Scope<RendererAPI> s_RendererAPI;
 	};
 
 }
@@ -3,6 +3,8 @@
 
 #include "VertexArray.h"
 #include "Shader.h"
+#include "UniformBuffer.h"
+#include "PickingBuffer.h"
 #include "RenderCommand.h"
 #include "Rhombus/Core/Application.h"
 #include "Rhombus/Math/Math.h"
@@ -97,6 +99,12 @@ namespace rhombus
 		Vec4 QuadVertexPosition[4];
 		Mat4 ViewProjectionMatrix;
 
+		// Camera block shared by the quad, circle and line shaders
+		Ref<UniformBuffer> CameraUniformBuffer;
+
+		PickingBuffer* Picking = nullptr;
+		uint32_t BatchIndex = 0;
+
 		Renderer2D::Statistics Stats;
 	};
 
@@ -201,6 +209,8 @@ namespace rhombus
 		s_Data.CircleShader = Shader::Create(Application::Get().GetPathRelativeToEngineDirectory("resources/shaders/Renderer2D_Circle.glsl"));
 		s_Data.LineShader = Shader::Create(Application::Get().GetPathRelativeToEngineDirectory("resources/shaders/Renderer2D_Line.glsl"));
 
+		s_Data.CameraUniformBuffer = UniformBuffer::Create(sizeof(Mat4), UniformBuffer::CameraBinding);
+
 		s_Data.TextureSlots[0] = s_Data.BlankTexture;
 
 		s_Data.QuadVertexPosition[0] = { -0.5, -0.5, 0.0, 1.0f };
@@ -216,16 +226,26 @@ namespace rhombus
 		delete[] s_Data.QuadVertexBufferBase;	
 	}
 
-	// TODO: Manage multiple shaders better
-	void SetShaderViewProjection(Mat4 viewProjection)
+	void SetShaderViewProjection(const Mat4& viewProjection)
 	{
 		s_Data.ViewProjectionMatrix = viewProjection;
-		s_Data.QuadShader->Bind();
-		s_Data.QuadShader->SetMat4("u_ViewProjection", viewProjection);
-		s_Data.CircleShader->Bind();
-		s_Data.CircleShader->SetMat4("u_ViewProjection", viewProjection);
-		s_Data.LineShader->Bind();
-		s_Data.LineShader->SetMat4("u_ViewProjection", viewProjection);
+		s_Data.CameraUniformBuffer->SetData(viewProjection.ToPtr(), sizeof(Mat4));
+
+		if (s_Data.Picking)
+			s_Data.Picking->SetViewProjection(viewProjection);
+	}
+
+	static void RecordPickingQuad(const Mat4& transform, const Vec2& uvMin, const Vec2& uvMax, const Ref<Texture2D>& texture, const Color& color, float tilingFactor, int entityID)
+	{
+		// Fully transparent quads are discarded by the shader so they never reach the entity ID attachment either
+		if (entityID < 0 || color.a == 0.0f)
+			return;
+
+		Vec3 corners[4];
+		for (int i = 0; i < 4; i++)
+			corners[i] = transform * s_Data.QuadVertexPosition[i];
+
+		s_Data.Picking->AddQuad(corners, uvMin, uvMax, texture, tilingFactor, entityID, s_Data.BatchIndex);
 	}
 
 	void Renderer2D::BeginScene()
@@ -332,6 +352,8 @@ namespace rhombus
 		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
 
 		s_Data.TextureSlotIndex = 1;
+
+		s_Data.BatchIndex++;
 	}
 
 	void Renderer2D::NextBatch()
@@ -443,6 +465,9 @@ namespace rhombus
 		s_Data.QuadIndexCount += 6;
 
 		s_Data.Stats.QuadCount++;
+
+		if (s_Data.Picking)
+			RecordPickingQuad(transform, textureCoords[0], textureCoords[2], nullptr, color, tilingFactor, entityID);
 	}
 
 	void Renderer2D::DrawQuad(const Mat4& transform, const Ref<Texture2D>& texture, const Color& color, float tilingFactor, int entityID, bool pixelPerfect)
@@ -499,6 +524,9 @@ namespace rhombus
 		s_Data.QuadIndexCount += 6;
 
 		s_Data.Stats.QuadCount++;
+
+		if (s_Data.Picking)
+			RecordPickingQuad(scaledTransform, textureCoords[0], textureCoords[2], texture, color, tilingFactor, entityID);
 	}
 
 	void Renderer2D::DrawQuad(const Mat4& transform, const Ref<SubTexture2D>& subTexture, const Color& color, float tilingFactor, int entityID, bool pixelPerfect)
@@ -558,6 +586,9 @@ namespace rhombus
 		s_Data.QuadIndexCount += 6;
 
 		s_Data.Stats.QuadCount++;
+
+		if (s_Data.Picking)
+			RecordPickingQuad(scaledTransform, textureCoords[0], textureCoords[2], texture, color, tilingFactor, entityID);
 	}
 
 	void Renderer2D::DrawQuadOverlay(const Vec2& position, const float& angle, const Vec2& scale, const Ref<Texture2D>& texture, const Color& color, float tilingFactor)
@@ -688,6 +719,15 @@ namespace rhombus
 		s_Data.CircleIndexCount += 6;
 
 		s_Data.Stats.QuadCount++;
+
+		if (s_Data.Picking && entityID >= 0 && color.a != 0.0f)
+		{
+			Vec3 corners[4];
+			for (int i = 0; i < 4; i++)
+				corners[i] = transform * s_Data.QuadVertexPosition[i];
+
+			s_Data.Picking->AddCircle(corners, thickness, fade, entityID, s_Data.BatchIndex);
+		}
 	}
 
 	void Renderer2D::DrawSprite(const Mat4& transform, const SpriteRendererComponent& src, int entityID)
@@ -714,6 +754,14 @@ namespace rhombus
 		RenderCommand::DrawQuad();
 	}
 
+	void Renderer2D::SetPickingBuffer(PickingBuffer* pickingBuffer)
+	{
+		s_Data.Picking = pickingBuffer;
+
+		if (s_Data.Picking)
+			s_Data.Picking->SetViewProjection(s_Data.ViewProjectionMatrix);
+	}
+
 	float Renderer2D::GetLineWidth()
 	{
 		return s_Data.LineWidth;
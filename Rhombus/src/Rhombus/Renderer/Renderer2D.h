@@ -11,6 +11,8 @@
 
 namespace rhombus
 {
+	class PickingBuffer;
+
 	class Renderer2D
 	{
 	public:
@@ -52,6 +54,9 @@ namespace rhombus
 
 		static void DrawFrambuffer(Ref<Framebuffer> frameBuffer);
 
+		// While set, quads and circles drawn with an entity ID are also recorded for CPU picking
+		static void SetPickingBuffer(PickingBuffer* pickingBuffer);
+
 		static float GetLineWidth();
 		static void SetLineWidth(float width);
 
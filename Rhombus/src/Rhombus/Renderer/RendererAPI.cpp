@@ -1,7 +1,26 @@
 #include "rbpch.h"
 #include "RendererAPI.h"
 
+#include "Platform/OpenGL/OpenGLRendererAPI.h"
+#include "Platform/Null/NullRendererAPI.h"
+#include "Platform/Software/SoftwareRendererAPI.h"
+
 namespace rhombus {
 	
 	RendererAPI::API RendererAPI::s_API = RendererAPI::API::OpenGL;
-}
\ No newline at end of file
+
+	Scope<RendererAPI> RendererAPI::Create()
+	{
+		switch (s_API)
+		{
+			case RendererAPI::API::None:		return CreateScope<NullRendererAPI>();
+
+			case RendererAPI::API::OpenGL:	return CreateScope<OpenGLRendererAPI>();
+
+			case RendererAPI::API::Software:	return CreateScope<SoftwareRendererAPI>();
+		}
+
+		Log::Assert(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+}
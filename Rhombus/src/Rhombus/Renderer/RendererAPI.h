@@ -10,7 +10,7 @@ namespace rhombus {
 	class RendererAPI {
 	public:
 		enum class API {
-			None = 0, OpenGL = 1
+			None = 0, OpenGL = 1, Software = 2
 		};
 	public:
 		virtual ~RendererAPI() = default;
@@ -28,6 +28,11 @@ namespace rhombus {
 		virtual void SetLineWidth(float width) = 0;
 
 		inline static API GetAPI() { return s_API; }
+
+		// Must be called before the renderer is initialised. None and Software run headless with no graphics context
+		inline static void SetAPI(API api) { s_API = api; }
+
+		static Scope<RendererAPI> Create();
 	private:
 		static API s_API;
 	};
@@ -3,6 +3,7 @@
 
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLShader.h"
+#include "Platform/Null/NullShader.h"
 
 namespace rhombus {
 
@@ -10,7 +11,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullShader>(filepath);
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLShader>(filepath);
 		}
@@ -23,7 +25,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullShader>(name, vertexSrc, pixelSrc);
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLShader>(name, vertexSrc, pixelSrc);
 		}
@@ -8,6 +8,14 @@
 
 namespace rhombus {
 
+	// Precomputed uniform location, look it up once with Shader::GetUniformHandle and reuse it every frame
+	struct UniformHandle
+	{
+		int32_t Location = -1;
+
+		bool IsValid() const { return Location >= 0; }
+	};
+
 	class Shader {
 	public:
 		virtual ~Shader() = default;
@@ -23,6 +31,17 @@ namespace rhombus {
 		virtual void SetFloat4(const std::string& name, const Vec4& value) = 0;
 		virtual void SetMat4(const std::string& name, const Mat4& value) = 0;
 
+		// Invalid if the shader has no active uniform with that name. Setting an invalid handle does nothing
+		virtual UniformHandle GetUniformHandle(const std::string& name) const = 0;
+
+		virtual void SetInt(UniformHandle handle, int value) = 0;
+		virtual void SetIntArray(UniformHandle handle, int* values, uint32_t count) = 0;
+		virtual void SetFloat(UniformHandle handle, const float value) = 0;
+		virtual void SetFloat2(UniformHandle handle, const Vec2& value) = 0;
+		virtual void SetFloat3(UniformHandle handle, const Vec3& value) = 0;
+		virtual void SetFloat4(UniformHandle handle, const Vec4& value) = 0;
+		virtual void SetMat4(UniformHandle handle, const Mat4& value) = 0;
+
 		virtual const std::string& GetName() const = 0;
 
 		static Ref<Shader> Create(const std::string& filepath);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Texture.h"
+
+namespace rhombus {
+
+	// Handle to another texture under a path of its own, for files with the same contents sharing one texture.
+	// Everything but the path is the shared texture's, and changing the data changes it for every handle
+	class SharedTexture2D : public Texture2D
+	{
+	public:
+		SharedTexture2D(const Ref<Texture2D>& texture, const std::string& path)
+			: m_Texture(texture), m_Path(path)
+		{
+			m_LoadState = texture->GetLoadState();
+		}
+
+		virtual uint32_t GetWidth() const override { return m_Texture->GetWidth(); }
+		virtual uint32_t GetHeight() const override { return m_Texture->GetHeight(); }
+		virtual uint32_t GetRendererID() const override { return m_Texture->GetRendererID(); }
+		virtual std::string GetPath() const override { return m_Path; }
+
+		virtual void SetData(void* data, uint32_t size) override { m_Texture->SetData(data, size); }
+		virtual void SetImage(const TextureImage& image) override { m_Texture->SetImage(image); }
+
+		virtual void Bind(uint32_t slot = 0) const override { m_Texture->Bind(slot); }
+
+		virtual bool IsLoaded() const override { return m_Texture->IsLoaded(); }
+		virtual bool IsTexelVisible(uint32_t x, uint32_t y) const override { return m_Texture->IsTexelVisible(x, y); }
+
+		virtual bool operator==(const Texture& other) const override
+		{
+			return GetRendererID() == other.GetRendererID();
+		}
+
+		const Ref<Texture2D>& GetSharedTexture() const { return m_Texture; }
+
+	private:
+		Ref<Texture2D> m_Texture;
+		std::string m_Path;
+	};
+}
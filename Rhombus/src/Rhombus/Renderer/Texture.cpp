@@ -3,6 +3,7 @@
 
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLTexture.h"
+#include "Platform/Null/NullTexture.h"
 
 namespace rhombus {
 
@@ -10,7 +11,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI())
 		{
-		case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+		case RendererAPI::API::Software:
+		case RendererAPI::API::None:		return std::make_shared<NullTexture2D>(width, height);
 
 		case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture2D>(width, height);
 		}
@@ -23,7 +25,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullTexture2D>(path);
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture2D>(path);
 		}
@@ -31,4 +34,51 @@ namespace rhombus {
 		Log::Assert(false, "Unknown RendererAPI");
 		return nullptr;
 	}
+
+	Ref<Texture2D> Texture2D::Create(const TextureImage& image, const std::string& path)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullTexture2D>(image, path);
+
+			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLTexture2D>(image, path);
+		}
+
+		Log::Assert(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+
+	bool Texture2D::IsTexelVisible(uint32_t x, uint32_t y) const
+	{
+		if (m_VisibilityMask.empty())
+			return true;
+
+		const size_t index = (size_t)y * m_VisibilityMaskWidth + x;
+		return index / 64 < m_VisibilityMask.size() && (m_VisibilityMask[index / 64] >> (index % 64)) & 1;
+	}
+
+	void Texture2D::UpdateVisibilityMask(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels)
+	{
+		m_VisibilityMask.clear();
+		m_VisibilityMaskWidth = width;
+
+		if (channels != 4 || !pixels)
+			return;
+
+		const size_t texelCount = (size_t)width * height;
+		bool transparent = false;
+		for (size_t i = 0; i < texelCount && !transparent; i++)
+			transparent = pixels[i * 4 + 3] == 0;
+
+		if (!transparent)
+			return;
+
+		m_VisibilityMask.assign((texelCount + 63) / 64, 0);
+		for (size_t i = 0; i < texelCount; i++)
+		{
+			if (pixels[i * 4 + 3] != 0)
+				m_VisibilityMask[i / 64] |= 1ull << (i % 64);
+		}
+	}
 }
\ No newline at end of file
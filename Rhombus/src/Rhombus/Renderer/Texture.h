@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "Rhombus/Core/Core.h"
 
@@ -26,11 +27,45 @@ namespace rhombus {
 		virtual bool operator==(const Texture& other) const = 0;
 	};
 
+	// Decoded image in memory, tightly packed RGBA8 with the bottom row first (OpenGL order)
+	struct TextureImage
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		std::vector<uint8_t> Pixels;
+		uint64_t ContentHash = 0;			// Hash of the encoded file, 0 if not loaded from a file
+	};
+
+	enum class TextureLoadState
+	{
+		Ready = 0, Loading, Failed
+	};
+
 	// 2D texture (still abstract, it needs to be implemented by specific renderer API's)
 	class Texture2D : public Texture
 	{
 	public:
+		// Replaces the size and contents of the texture
+		virtual void SetImage(const TextureImage& image) = 0;
+
+		// Textures loaded asynchronously show a placeholder while Loading
+		TextureLoadState GetLoadState() const { return m_LoadState; }
+		void SetLoadState(TextureLoadState state) { m_LoadState = state; }
+
+		// CPU copy of which texels have a non zero alpha, used by picking. Textures without transparency keep no mask
+		virtual bool IsTexelVisible(uint32_t x, uint32_t y) const;
+
 		static Ref<Texture2D> Create(uint32_t width, uint32_t height);
 		static Ref<Texture2D> Create(const std::string& path);
+		static Ref<Texture2D> Create(const TextureImage& image, const std::string& path = "");
+
+	protected:
+		// Backends call this with every upload, pixels are 8 bits per channel with alpha last
+		void UpdateVisibilityMask(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t channels);
+
+	protected:
+		TextureLoadState m_LoadState = TextureLoadState::Ready;
+		std::vector<uint64_t> m_VisibilityMask;		// One bit per texel, row by row
+		uint32_t m_VisibilityMaskWidth = 0;
 	};
 }
@@ -0,0 +1,23 @@
+#include "rbpch.h"
+#include "UniformBuffer.h"
+#include "Renderer.h"
+
+#include "Platform/OpenGL/OpenGLUniformBuffer.h"
+#include "Platform/Null/NullUniformBuffer.h"
+
+namespace rhombus {
+
+	Ref<UniformBuffer> UniformBuffer::Create(uint32_t size, uint32_t binding)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullUniformBuffer>(size, binding);
+
+			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLUniformBuffer>(size, binding);
+		}
+
+		Log::Assert(false, "Unknown RendererAPI");
+		return nullptr;
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Rhombus/Core/Core.h"
+
+namespace rhombus {
+
+	// Block of uniform data shared by every shader that declares a uniform block at the same binding
+	class UniformBuffer
+	{
+	public:
+		// Binding of the Camera block declared by the Renderer2D shaders
+		static constexpr uint32_t CameraBinding = 0;
+
+		virtual ~UniformBuffer() = default;
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+
+		// Use this instead of constructor
+		static Ref<UniformBuffer> Create(uint32_t size, uint32_t binding);
+	};
+}
@@ -3,6 +3,7 @@
 
 #include "Renderer.h"
 #include "Platform/OpenGL/OpenGLVertexArray.h"
+#include "Platform/Null/NullVertexArray.h"
 
 namespace rhombus {
 
@@ -10,7 +11,8 @@ namespace rhombus {
 	{
 		switch (Renderer::GetAPI()) 
 		{
-			case RendererAPI::API::None:		Log::Assert(false, "RendererAPI::None is currently not supported"); return nullptr;
+			case RendererAPI::API::Software:
+			case RendererAPI::API::None:		return std::make_shared<NullVertexArray>();
 
 			case RendererAPI::API::OpenGL:	return std::make_shared<OpenGLVertexArray>();
 		}
@@ -8,7 +8,9 @@
 #include "Rhombus/Renderer/Renderer2D.h"
 #include "Rhombus/Scripting/ScriptEngine.h"
 #include "Rhombus/Core/Application.h"
+#include "Rhombus/Assets/AssetManager.h"
 #include "Rhombus/Tiles/TileMap.h"
+#include "Rhombus/Animation/TweenEngine.h"
 
 // To Remove
 #include "Rhombus/ECS/Components/AnimatorComponent.h"
@@ -22,7 +24,6 @@
 #include "Rhombus/ECS/Components/ScriptComponent.h"
 #include "Rhombus/ECS/Components/SpriteRendererComponent.h"
 #include "Rhombus/ECS/Components/TransformComponent.h"
-#include "Rhombus/ECS/Components/TweenComponent.h"
 #include "Rhombus/ECS/Components/TileMapComponent.h"
 
 // Box2d
@@ -40,7 +41,7 @@ namespace rhombus
 		ComponentGroup<TransformComponent, SpriteRendererComponent,
 		CircleRendererComponent, CameraComponent, ScriptComponent, NativeScriptComponent,
 		Rigidbody2DComponent, PixelPlatformerBodyComponent, BoxCollider2DComponent, CircleCollider2DComponent, BoxArea2DComponent,
-		TweenComponent, TileMapComponent, PlatformerPlayerControllerComponent, AnimatorComponent>;
+		TileMapComponent, PlatformerPlayerControllerComponent, AnimatorComponent>;
 	// -----------------------------------------------------
 
 	static b2BodyType Rigidbody2DTypetoBox2DType(Rigidbody2DComponent::BodyType bodyType)
@@ -56,6 +57,37 @@ namespace rhombus
 		return b2_staticBody;
 	}
 
+	// One box fixture per merged rectangle of solid tiles, rebuilt only when the tile map's collision has changed
+	static void SyncTileMapFixtures(b2Body* body, TileMapComponent& tileMapComponent)
+	{
+		TileMap& tilemap = *tileMapComponent.m_tilemap;
+		const std::vector<TileRect>& rects = tilemap.GetCollisionRects();
+		if (tileMapComponent.m_runtimeCollisionVersion == tilemap.GetCollisionVersion())
+		{
+			return;
+		}
+
+		while (b2Fixture* fixture = body->GetFixtureList())
+		{
+			body->DestroyFixture(fixture);
+		}
+
+		for (const TileRect& rect : rects)
+		{
+			Vec2 center, halfSize;
+			tilemap.GetCollisionRectBounds(rect, center, halfSize);
+
+			b2PolygonShape boxShape;
+			boxShape.SetAsBox(halfSize.x, halfSize.y, b2Vec2(center.x, center.y), 0.0f);
+
+			b2FixtureDef fixtureDef;
+			fixtureDef.shape = &boxShape;
+			body->CreateFixture(&fixtureDef);
+		}
+
+		tileMapComponent.m_runtimeCollisionVersion = tilemap.GetCollisionVersion();
+	}
+
 	Scene::Scene()
 	{
 		InitScene();
@@ -63,6 +95,7 @@ namespace rhombus
 
 	Scene::~Scene()
 	{
+		m_PhysicsThread.reset();
 		delete m_PhysicsWorld;		// just incase
 	}
 
@@ -80,12 +113,7 @@ namespace rhombus
 
 		RegisterComponents(RhombusComponents{});
 
-		tweeningSystem = m_Registry.RegisterSystem<TweeningSystem>(this);
-		{
-			Signature signature;
-			signature.set(m_Registry.GetComponentType<TweenComponent>());
-			m_Registry.SetSystemSignature<TweeningSystem>(signature);
-		}
+		m_tweenEngine = CreateScope<TweenEngine>(this);
 
 		pixelPlatformerPhysicsSystem = m_Registry.RegisterSystem<PixelPlatformerPhysicsSystem>(this);
 		{
@@ -206,10 +234,25 @@ namespace rhombus
 		}
 		sceneGraphNode->SetParent(false);		// Remove this entity's parent
 
+		if (entity.HasComponent<ScriptComponent>() && ScriptEngine::GetSceneContext() == this)
+		{
+			ScriptEngine::OnDestroyEntity(entity);
+		}
+
+		// Nothing left for them to write to
+		m_tweenEngine->StopEntity(entity);
+		DestroyPhysicsBody(entity);
+		m_interpolatedTransforms.erase(std::remove_if(m_interpolatedTransforms.begin(), m_interpolatedTransforms.end(), [&](const InterpolatedTransform& interpolated)
+		{
+			return interpolated.m_entity == (EntityID)entity;
+		}), m_interpolatedTransforms.end());
+
 		// Destroy Entity
 		UUID entityUUID = entity.GetUUID();
 		m_Registry.DestroyEntity(entity);
 		m_EntityMap.erase(entityUUID);
+
+		InvalidateQuery();
 	}
 
 	void Scene::OnRuntimeStart()
@@ -232,25 +275,86 @@ namespace rhombus
 
 	void Scene::OnRuntimeStop()
 	{
+		// Joins the worker, which may be in the middle of a step
+		m_PhysicsThread.reset();
+		m_PhysicsTransforms.clear();
 		delete m_PhysicsWorld;
 		m_PhysicsWorld = nullptr;
 
+		m_interpolatedTransforms.clear();
+		m_query.Clear();
+		InvalidateQuery();
+
+		m_hoveredAreas.clear();
+		m_cursorMoved = false;
+
 		ScriptEngine::OnRuntimeStop();
 	}
 
+	void Scene::OnFixedUpdateRuntime(DeltaTime dt)
+	{
+		if (Application::Get().GetIsDebugPaused())
+		{
+			return;
+		}
+
+		InvalidateQuery();
+
+		// Physics
+		if (m_PhysicsThread)
+		{
+			// The step started last fixed update has to finish before the world can be touched here. Tile map fixtures
+			// are synced in that gap and the next step is started straight away, so it runs while the game uses the
+			// results of this one
+			const std::vector<PhysicsBodyTransform>& physicsTransforms = m_PhysicsThread->EndStep();
+			SyncTileMapBodies();
+			m_PhysicsThread->BeginStep(dt);
+
+			RecordSimulatedTransforms(true, &physicsTransforms);
+			ApplyPhysicsTransforms(physicsTransforms);
+		}
+		else
+		{
+			RecordSimulatedTransforms(true);
+			SyncTileMapBodies();
+
+			const int32_t velocityIterations = 6;
+			const int32_t positionIterations = 2;
+			m_PhysicsWorld->Step(dt, velocityIterations, positionIterations);
+
+			PhysicsThread::GatherTransforms(m_PhysicsWorld, m_PhysicsTransforms);
+			ApplyPhysicsTransforms(m_PhysicsTransforms);
+		}
+
+		platformerPlayerControllerSystem->Update(dt);
+		pixelPlatformerPhysicsSystem->Update(dt);
+
+		RecordSimulatedTransforms(false);
+	}
+
 	void Scene::OnUpdateRuntime(DeltaTime dt)
 	{
+		InvalidateQuery();
+		UpdateMouseAreas();
+
 		if (!Application::Get().GetIsDebugPaused())
 		{
 			// Update Scripts
 			{
 				// Lua
+#ifndef RB_DIST
+				// Scripts only change under a running game while it is being developed
+				ScriptEngine::ReloadChangedScripts(dt);
+#endif
 				std::vector<EntityID> view = m_Registry.GetEntityList<ScriptComponent>();
 				for (auto e : view)
 				{
 					Entity entity = { e, this };
 					ScriptEngine::OnUpdateEntity(entity, dt);
 				}
+				ScriptEngine::OnUpdateBatched(dt);
+				ScriptEngine::OnUpdateParallel(dt);
+				ScriptEngine::OnUpdateCoroutines(dt);
 
 				// Native
 				std::vector<EntityID> nativeView = m_Registry.GetEntityList<NativeScriptComponent>();
@@ -270,30 +374,7 @@ namespace rhombus
 				}
 			}
 
-			// Physics
-			{
-				const int32_t velocityIterations = 6;
-				const int32_t positionIterations = 2;
-				m_PhysicsWorld->Step(dt, velocityIterations, positionIterations);
-
-				// Retrieve transform post physics step
-				std::vector<EntityID> view = m_Registry.GetEntityList<Rigidbody2DComponent>();
-				for (auto e : view)
-				{
-					Entity entity = { e, this };
-					auto& transform = entity.GetComponent<TransformComponent>();
-					auto& rb = entity.GetComponent<Rigidbody2DComponent>();
-
-					b2Body* body = (b2Body*)rb.m_runtimeBody;
-					const auto& position = body->GetPosition();
-					transform.SetPosition(Vec2(position.x, position.y));
-					transform.SetRotation(body->GetAngle());
-				}
-			}
-
-			platformerPlayerControllerSystem->Update(dt);
-			pixelPlatformerPhysicsSystem->Update(dt);
-			tweeningSystem->UpdateTweens(dt);
+			m_tweenEngine->Update(dt);
 			animationSystem->Update(dt);
 		}
 
@@ -320,7 +401,9 @@ namespace rhombus
 		{
 			Renderer2D::BeginScene(*mainCamera, cameraTransform);
 
+			ApplyInterpolatedTransforms(Application::Get().GetInterpolationAlpha());
 			DrawScene();
+			RestoreInterpolatedTransforms();
 
 			Renderer2D::EndScene();
 
@@ -329,7 +412,7 @@ namespace rhombus
 			if (Application::Get().GetIsDebugPaused())
 			{
 				Vec2 position = Vec2(0.9f, 0.9f);
-				Ref<Texture2D> texture = Texture2D::Create(Application::Get().GetPathRelativeToEngineDirectory("resources/icons/Pause.png"));
+				Ref<Texture2D> texture = AssetManager::GetTexture(Application::Get().GetPathRelativeToEngineDirectory("resources/icons/Pause.png"));
 				Renderer2D::DrawQuadOverlay(position, 0.0f, 1.0f, texture);
 			}
 
@@ -337,8 +420,179 @@ namespace rhombus
 		}
 	}
 
+	void Scene::RecordSimulatedTransforms(bool beforeStep, const std::vector<PhysicsBodyTransform>* physicsTransforms)
+	{
+		if (beforeStep)
+		{
+			m_interpolatedTransforms.clear();
+
+			if (physicsTransforms)
+			{
+				for (const PhysicsBodyTransform& physicsTransform : *physicsTransforms)
+				{
+					if (IsPhysicsBodyEntity(physicsTransform))
+					{
+						m_interpolatedTransforms.push_back({ physicsTransform.m_entity });
+					}
+				}
+			}
+			else
+			{
+				// Only bodies that are awake going into the step can move during it
+				for (b2Body* body = m_PhysicsWorld->GetBodyList(); body; body = body->GetNext())
+				{
+					if (body->GetType() != b2_staticBody && body->IsAwake())
+					{
+						m_interpolatedTransforms.push_back({ GetBodyEntity(body->GetUserData().pointer) });
+					}
+				}
+			}
+
+			for (EntityID e : m_Registry.GetEntityList<PixelPlatformerBodyComponent>())
+			{
+				if (m_Registry.GetComponent<PixelPlatformerBodyComponent>(e).m_type == PixelPlatformerBodyComponent::BodyType::Dynamic)
+				{
+					m_interpolatedTransforms.push_back({ e });
+				}
+			}
+		}
+
+		for (InterpolatedTransform& interpolated : m_interpolatedTransforms)
+		{
+			const TransformComponent& transform = m_Registry.GetComponent<TransformComponent>(interpolated.m_entity);
+			if (beforeStep)
+			{
+				interpolated.m_previousPosition = transform.GetPosition();
+				interpolated.m_previousRotation = transform.GetRotation();
+			}
+			else
+			{
+				interpolated.m_currentPosition = transform.GetPosition();
+				interpolated.m_currentRotation = transform.GetRotation();
+			}
+		}
+	}
+
+	void Scene::SyncTileMapBodies()
+	{
+		std::vector<EntityID> tileMapView = m_Registry.GetEntityList<TileMapComponent>();
+		for (auto e : tileMapView)
+		{
+			TileMapComponent& tileMapComponent = m_Registry.GetComponent<TileMapComponent>(e);
+			if (tileMapComponent.m_runtimeBody)
+			{
+				SyncTileMapFixtures((b2Body*)tileMapComponent.m_runtimeBody, tileMapComponent);
+			}
+		}
+	}
+
+	void Scene::ApplyPhysicsTransforms(const std::vector<PhysicsBodyTransform>& physicsTransforms)
+	{
+		// Writing an unchanged value would still dirty the scene graph below the entity
+		for (const PhysicsBodyTransform& physicsTransform : physicsTransforms)
+		{
+			if (!IsPhysicsBodyEntity(physicsTransform))
+			{
+				continue;
+			}
+
+			TransformComponent& transform = m_Registry.GetComponent<TransformComponent>(physicsTransform.m_entity);
+			const Vec3 currentPosition = transform.GetPosition();
+			if (currentPosition.x != physicsTransform.m_position.x || currentPosition.y != physicsTransform.m_position.y)
+			{
+				transform.SetPosition(physicsTransform.m_position);
+			}
+
+			if (transform.GetRotation().z != physicsTransform.m_angle)
+			{
+				transform.SetRotation(physicsTransform.m_angle);
+			}
+		}
+	}
+
+	bool Scene::IsPhysicsBodyEntity(const PhysicsBodyTransform& physicsTransform) const
+	{
+		return m_Registry.GetEntityGeneration(physicsTransform.m_entity) == physicsTransform.m_generation && m_Registry.HasComponent<Rigidbody2DComponent>(physicsTransform.m_entity);
+	}
+
+	void Scene::DestroyPhysicsBody(Entity entity)
+	{
+		if (!m_PhysicsWorld)
+		{
+			return;
+		}
+
+		b2Body* body = nullptr;
+		if (entity.HasComponent<Rigidbody2DComponent>())
+		{
+			Rigidbody2DComponent& rb = entity.GetComponent<Rigidbody2DComponent>();
+			body = (b2Body*)rb.m_runtimeBody;
+			rb.m_runtimeBody = nullptr;
+		}
+		else if (entity.HasComponent<TileMapComponent>())
+		{
+			TileMapComponent& tileMapComponent = entity.GetComponent<TileMapComponent>();
+			body = (b2Body*)tileMapComponent.m_runtimeBody;
+			tileMapComponent.m_runtimeBody = nullptr;
+		}
+
+		if (!body)
+		{
+			return;
+		}
+
+		// The world belongs to the worker while it steps
+		if (m_PhysicsThread)
+		{
+			m_PhysicsThread->DestroyBody(body);
+		}
+		else
+		{
+			m_PhysicsWorld->DestroyBody(body);
+		}
+	}
+
+	void Scene::ApplyInterpolatedTransforms(float alpha)
+	{
+		for (InterpolatedTransform& interpolated : m_interpolatedTransforms)
+		{
+			// Destroyed since the last step
+			if (!m_Registry.HasComponent<TransformComponent>(interpolated.m_entity))
+			{
+				interpolated.m_applied = false;
+				continue;
+			}
+
+			TransformComponent& transform = m_Registry.GetComponent<TransformComponent>(interpolated.m_entity);
+
+			// Moved by something other than the simulation since the last step, so there is nothing to blend from
+			interpolated.m_applied = transform.GetPosition() == interpolated.m_currentPosition && transform.GetRotation() == interpolated.m_currentRotation;
+			if (interpolated.m_applied)
+			{
+				transform.SetPosition(math::Lerp(interpolated.m_previousPosition, interpolated.m_currentPosition, Vec3(alpha)));
+				transform.SetRotation(math::Lerp(interpolated.m_previousRotation, interpolated.m_currentRotation, Vec3(alpha)));
+			}
+		}
+	}
+
+	void Scene::RestoreInterpolatedTransforms()
+	{
+		for (InterpolatedTransform& interpolated : m_interpolatedTransforms)
+		{
+			if (interpolated.m_applied)
+			{
+				TransformComponent& transform = m_Registry.GetComponent<TransformComponent>(interpolated.m_entity);
+				transform.SetPosition(interpolated.m_currentPosition);
+				transform.SetRotation(interpolated.m_currentRotation);
+				interpolated.m_applied = false;
+			}
+		}
+	}
+
 	void Scene::OnUpdateEditor(DeltaTime dt, EditorCamera& camera)
 	{
+		InvalidateQuery();
+
 		Renderer2D::BeginScene(camera);
 
 		DrawScene();
@@ -371,6 +625,12 @@ namespace rhombus
 			return m_Registry.GetComponent<TransformComponent>(lhs.m_entityID).GetWorldTransform().d().z < m_Registry.GetComponent<TransformComponent>(rhs.m_entityID).GetWorldTransform().d().z;
 		});
 
+		if (m_pickingEnabled)
+		{
+			m_pickingBuffer.Clear();
+			Renderer2D::SetPickingBuffer(&m_pickingBuffer);
+		}
+
 		for (DrawEntity drawEntity : drawOrder)
 		{
 			EntityID entity = drawEntity.m_entityID;
@@ -405,12 +665,34 @@ namespace rhombus
 			}
 		}
 
+		Renderer2D::SetPickingBuffer(nullptr);
+
 		OnDraw();
 	}
 
+	EntityID Scene::PickEntity(const Vec2& ndc) const
+	{
+		int entity = m_pickingBuffer.Pick(ndc);
+		return entity < 0 ? INVALID_ENTITY : (EntityID)entity;
+	}
+
+	SceneQuery& Scene::Query()
+	{
+		if (!m_querySynced)
+		{
+			m_query.Sync();
+			m_querySynced = true;
+		}
+
+		return m_query;
+	}
+
 	void Scene::DrawSprite(EntityID entity, Mat4 transform)
 	{
-		auto spriteRendererComponent = m_Registry.GetComponent<SpriteRendererComponent>(entity);
+		SpriteRendererComponent& spriteRendererComponent = m_Registry.GetComponent<SpriteRendererComponent>(entity);
+		if (spriteRendererComponent.IsSubTextureOutdated())
+			spriteRendererComponent.UpdateSubTexture();
+
 		Renderer2D::DrawSprite(transform, spriteRendererComponent, (int)entity);
 	}
 
@@ -456,56 +738,104 @@ namespace rhombus
 
 	void Scene::OnMouseMoved(int x, int y)
 	{
-		Vec3 cursorCoords = Renderer2D::ConvertScreenToWorldSpace(x, y);
-		// Area 2D
+		m_cursorX = x;
+		m_cursorY = y;
+		m_cursorMoved = true;
+	}
+
+	void Scene::UpdateMouseAreas()
+	{
+		if (!m_cursorMoved)
 		{
-			std::vector<EntityID> view = m_Registry.GetEntityList<BoxArea2DComponent>();
-			for (auto e : view)
-			{
-				Entity entity = { e, this };
-				auto& transform = entity.GetComponent<TransformComponent>();
-				auto& ba2D = entity.GetComponent<BoxArea2DComponent>();
+			return;
+		}
 
-				Vec2 offsetPosition = Vec2(transform.GetWorldPosition()) + ba2D.m_offset;
-				bool withinXLimit = (cursorCoords.x < offsetPosition.x + ba2D.m_size.x) && (cursorCoords.x > offsetPosition.x - ba2D.m_size.x);
-				bool withinYLimit = (cursorCoords.y < offsetPosition.y + ba2D.m_size.y) && (cursorCoords.y > offsetPosition.y - ba2D.m_size.y);
-				if (withinXLimit && withinYLimit)
-				{
-					if (!ba2D.m_isMouseInArea)
-					{
-						ba2D.m_isMouseInArea = true;
-						ScriptEngine::OnMouseEnterArea(entity);
-					}
-				}
-				else if (ba2D.m_isMouseInArea)
+		RB_PROFILE_FUNCTION();
+
+		m_cursorMoved = false;
+
+		// Things may have moved since the query was last brought up to date
+		InvalidateQuery();
+
+		Vec3 cursorCoords = Renderer2D::ConvertScreenToWorldSpace(m_cursorX, m_cursorY);
+		if (m_areaHits.empty())
+		{
+			m_areaHits.resize(64);
+		}
+
+		uint32_t hitCount;
+		while ((hitCount = Query().OverlapPoint(Vec2(cursorCoords.x, cursorCoords.y), m_areaHits.data(), (uint32_t)m_areaHits.size(), QUERY_BOX_AREA)) == (uint32_t)m_areaHits.size())
+		{
+			m_areaHits.resize(m_areaHits.size() * 2);
+		}
+
+		m_areasUnderCursor.clear();
+		for (uint32_t i = 0; i < hitCount; i++)
+		{
+			m_areasUnderCursor.push_back(m_areaHits[i].m_entity);
+		}
+		std::sort(m_areasUnderCursor.begin(), m_areasUnderCursor.end());
+
+		// Walk both sorted lists, anything only in the old one was left and anything only in the new one was entered
+		std::swap(m_hoveredAreas, m_areasUnderCursor);
+		const std::vector<EntityID>& previousAreas = m_areasUnderCursor;
+		size_t previousIndex = 0;
+		size_t currentIndex = 0;
+		while (previousIndex < previousAreas.size() || currentIndex < m_hoveredAreas.size())
+		{
+			const EntityID previous = previousIndex < previousAreas.size() ? previousAreas[previousIndex] : INVALID_ENTITY;
+			const EntityID current = currentIndex < m_hoveredAreas.size() ? m_hoveredAreas[currentIndex] : INVALID_ENTITY;
+			if (previous == current)
+			{
+				previousIndex++;
+				currentIndex++;
+			}
+			else if (previous < current)
+			{
+				// Destroyed areas just drop out
+				if (m_Registry.HasComponent<BoxArea2DComponent>(previous))
 				{
-					ba2D.m_isMouseInArea = false;
-					ScriptEngine::OnMouseExitArea(entity);
+					m_Registry.GetComponent<BoxArea2DComponent>(previous).m_isMouseInArea = false;
+					ScriptEngine::OnMouseExitArea({ previous, this });
 				}
+				previousIndex++;
+			}
+			else
+			{
+				m_Registry.GetComponent<BoxArea2DComponent>(current).m_isMouseInArea = true;
+				ScriptEngine::OnMouseEnterArea({ current, this });
+				currentIndex++;
 			}
 		}
+
+		OnCursorMoved(m_cursorX, m_cursorY);
 	}
 
 	void Scene::OnMouseButtonPressed(int button)
 	{
+		UpdateMouseAreas();
+
+		// Copied as scripts may change what is hovered
+		m_areasUnderCursor = m_hoveredAreas;
+		for (EntityID e : m_areasUnderCursor)
 		{
-			std::vector<EntityID> view = m_Registry.GetEntityList<BoxArea2DComponent>();
-			for (auto e : view)
+			if (m_Registry.HasComponent<BoxArea2DComponent>(e))
 			{
-				Entity entity = { e, this };
-				ScriptEngine::OnMouseButtonPressed(entity, button);
+				ScriptEngine::OnMouseButtonPressed({ e, this }, button);
 			}
 		}
 	}
 
 	void Scene::OnMouseButtonReleased(int button)
 	{
+		UpdateMouseAreas();
+
+		m_areasUnderCursor = m_hoveredAreas;
+		for (EntityID e : m_areasUnderCursor)
 		{
-			std::vector<EntityID> view = m_Registry.GetEntityList<BoxArea2DComponent>();
-			for (auto e : view)
+			if (m_Registry.HasComponent<BoxArea2DComponent>(e))
 			{
-				Entity entity = { e, this };
-				ScriptEngine::OnMouseButtonReleased(entity, button);
+				ScriptEngine::OnMouseButtonReleased({ e, this }, button);
 			}
 		}
 	}
@@ -546,25 +876,49 @@ namespace rhombus
 	{
 		m_PhysicsWorld = new b2World({ 0.0f, -9.8f });
 
+		// Gather the components in one pass so the creation loop below does no lookups. Nothing is added or removed
+		// while bodies are created so the pointers stay valid
+		struct BodyToCreate
+		{
+			EntityID m_entity;
+			TransformComponent* m_transform;
+			Rigidbody2DComponent* m_rigidbody;
+			BoxCollider2DComponent* m_boxCollider;
+			CircleCollider2DComponent* m_circleCollider;
+		};
+
 		std::vector<EntityID> view = m_Registry.GetEntityList<Rigidbody2DComponent>();
+		std::vector<BodyToCreate> bodiesToCreate;
+		bodiesToCreate.reserve(view.size());
 		for (auto e : view)
 		{
-			Entity entity = { e, this };
-			auto& transform = entity.GetComponent<TransformComponent>();
-			auto& rb = entity.GetComponent<Rigidbody2DComponent>();
+			BodyToCreate& bodyToCreate = bodiesToCreate.emplace_back();
+			bodyToCreate.m_entity = e;
+			bodyToCreate.m_transform = &m_Registry.GetComponent<TransformComponent>(e);
+			bodyToCreate.m_rigidbody = &m_Registry.GetComponent<Rigidbody2DComponent>(e);
+			bodyToCreate.m_boxCollider = m_Registry.HasComponent<BoxCollider2DComponent>(e) ? &m_Registry.GetComponent<BoxCollider2DComponent>(e) : nullptr;
+			bodyToCreate.m_circleCollider = m_Registry.HasComponent<CircleCollider2DComponent>(e) ? &m_Registry.GetComponent<CircleCollider2DComponent>(e) : nullptr;
+		}
 
+		for (const BodyToCreate& bodyToCreate : bodiesToCreate)
+		{
+			const TransformComponent& transform = *bodyToCreate.m_transform;
+			Rigidbody2DComponent& rb = *bodyToCreate.m_rigidbody;
+
+			// Fixed rotation goes in the definition, setting it on the body afterwards recomputes the mass
 			b2BodyDef bodyDef;
 			bodyDef.type = Rigidbody2DTypetoBox2DType(rb.m_type);
 			bodyDef.position.Set(transform.GetPosition().x, transform.GetPosition().y);
 			bodyDef.angle = transform.GetRotation().z;
+			bodyDef.fixedRotation = rb.m_fixedRotation;
+			bodyDef.userData.pointer = GetBodyUserData(bodyToCreate.m_entity, m_Registry.GetEntityGeneration(bodyToCreate.m_entity));
 
 			b2Body* body = m_PhysicsWorld->CreateBody(&bodyDef);
-			body->SetFixedRotation(rb.m_fixedRotation);
 			rb.m_runtimeBody = body;
 
-			if (entity.HasComponent<BoxCollider2DComponent>())
+			if (bodyToCreate.m_boxCollider)
 			{
-				auto& collider = entity.GetComponent<BoxCollider2DComponent>();
+				const BoxCollider2DComponent& collider = *bodyToCreate.m_boxCollider;
 
 				b2PolygonShape boxShape;
 				boxShape.SetAsBox(collider.m_size.x * transform.GetScale().x, collider.m_size.y * transform.GetScale().y);
@@ -578,9 +932,9 @@ namespace rhombus
 				body->CreateFixture(&fixtureDef);
 			}
 
-			if (entity.HasComponent<CircleCollider2DComponent>())
+			if (bodyToCreate.m_circleCollider)
 			{
-				auto& collider = entity.GetComponent<CircleCollider2DComponent>();
+				const CircleCollider2DComponent& collider = *bodyToCreate.m_circleCollider;
 
 				b2CircleShape circleShape;
 				circleShape.m_p.Set(collider.m_offset.x, collider.m_offset.y);
@@ -595,55 +949,91 @@ namespace rhombus
 				body->CreateFixture(&fixtureDef);
 			}
 		}
+
+		// Tile maps get a single static body carrying all of their merged collision rectangles
+		std::vector<EntityID> tileMapView = m_Registry.GetEntityList<TileMapComponent>();
+		for (auto e : tileMapView)
+		{
+			Entity entity = { e, this };
+			auto& tileMapComponent = entity.GetComponent<TileMapComponent>();
+			tileMapComponent.m_runtimeBody = nullptr;
+			tileMapComponent.m_runtimeCollisionVersion = 0;
+			if (!tileMapComponent.m_generateCollision || !tileMapComponent.m_tilemap)
+			{
+				continue;
+			}
+
+			auto& transform = entity.GetComponent<TransformComponent>();
+
+			b2BodyDef bodyDef;
+			bodyDef.type = b2_staticBody;
+			bodyDef.position.Set(transform.GetPosition().x, transform.GetPosition().y);
+			bodyDef.userData.pointer = GetBodyUserData(e, m_Registry.GetEntityGeneration(e));
+
+			b2Body* body = m_PhysicsWorld->CreateBody(&bodyDef);
+			tileMapComponent.m_runtimeBody = body;
+			SyncTileMapFixtures(body, tileMapComponent);
+		}
+
+		if (Application::Get().GetSpecification().physicsOnWorkerThread)
+		{
+			const int32_t velocityIterations = 6;
+			const int32_t positionIterations = 2;
+			m_PhysicsThread = CreateScope<PhysicsThread>(m_PhysicsWorld, velocityIterations, positionIterations);
+		}
+	}
+
+	void Scene::ApplyLinearImpulse(Entity entity, const Vec2& impulse)
+	{
+		b2Body* body = (b2Body*)entity.GetComponent<Rigidbody2DComponent>().m_runtimeBody;
+		if (!body)
+		{
+			return;
+		}
+
+		if (m_PhysicsThread)
+		{
+			m_PhysicsThread->QueueLinearImpulse(body, impulse);
+		}
+		else
+		{
+			body->ApplyLinearImpulseToCenter(b2Vec2(impulse.x, impulse.y), true);
+		}
 	}
 
-	Ref<Tween> Scene::CreateTween(Entity entity, const TweenParameterStep& tweenStep)
+	Tween Scene::CreateTween(Entity entity, const TweenParameterStep& tweenStep)
 	{
-		TweenComponent& tweenComponent = entity.GetOrAddComponent<TweenComponent>();
-		Ref<Tween> tween = tweenComponent.CreateTween(tweenStep);
-		return tween;
+		return m_tweenEngine->CreateTween(entity, tweenStep);
 	}
 
-	Ref<Tween> Scene::CreateTween(Entity entity, const TweenCallbackStep& tweenStep)
+	Tween Scene::CreateTween(Entity entity, const TweenCallbackStep& tweenStep)
 	{
-		TweenComponent& tweenComponent = entity.GetOrAddComponent<TweenComponent>();
-		Ref<Tween> tween = tweenComponent.CreateTween(tweenStep);
-		return tween;
+		return m_tweenEngine->CreateTween(entity, tweenStep);
 	}
 
-	Ref<Tween> Scene::CreateTween(Entity entity, const TweenWaitStep& tweenStep)
+	Tween Scene::CreateTween(Entity entity, const TweenWaitStep& tweenStep)
 	{
-		TweenComponent& tweenComponent = entity.GetOrAddComponent<TweenComponent>();
-		Ref<Tween> tween = tweenComponent.CreateTween(tweenStep);
-		return tween;
+		return m_tweenEngine->CreateTween(entity, tweenStep);
 	}
 
-	Ref<Tween> Scene::CreateTween(Entity entity, float* param, float begin, float finish, float duration, EasingType easingType)
+	Tween Scene::CreateTween(Entity entity, const TweenTarget& target, float begin, float finish, float duration, EasingType easingType)
 	{
-		TweenComponent& tweenComponent = entity.GetOrAddComponent<TweenComponent>();
-		Ref<Tween> tween = tweenComponent.CreateTween(param, begin, finish, duration, easingType);
-		return tween;
+		return m_tweenEngine->CreateTween(entity, TweenParameterStep(target, begin, finish, duration, easingType));
 	}
 
-	Ref<Tween> Scene::CreateTween(Entity entity, Vec2* param, Vec2 begin, Vec2 finish, float duration, EasingType easingType)
+	Tween Scene::CreateTween(Entity entity, const TweenTarget& target, Vec2 begin, Vec2 finish, float duration, EasingType easingType)
 	{
-		TweenComponent& tweenComponent = entity.GetOrAddComponent<TweenComponent>();
-		Ref<Tween> tween = tweenComponent.CreateTween(param, begin, finish, duration, easingType);
-		return tween;
+		return m_tweenEngine->CreateTween(entity, TweenParameterStep(target, begin, finish, duration, easingType));
 	}
 
-	Ref<Tween> Scene::CreateTween(Entity entity, Vec3* param, Vec3 begin, Vec3 finish, float duration, EasingType easingType)
+	Tween Scene::CreateTween(Entity entity, const TweenTarget& target, Vec3 begin, Vec3 finish, float duration, EasingType easingType)
 	{
-		TweenComponent& tweenComponent = entity.GetOrAddComponent<TweenComponent>();
-		Ref<Tween> tween = tweenComponent.CreateTween(param, begin, finish, duration, easingType);
-		return tween;
+		return m_tweenEngine->CreateTween(entity, TweenParameterStep(target, begin, finish, duration, easingType));
 	}
 
-	Ref<Tween> Scene::CreateTween(Entity entity, Vec4* param, Vec4 begin, Vec4 finish, float duration, EasingType easingType)
+	Tween Scene::CreateTween(Entity entity, const TweenTarget& target, Vec4 begin, Vec4 finish, float duration, EasingType easingType)
 	{
-		TweenComponent& tweenComponent = entity.GetOrAddComponent<TweenComponent>();
-		Ref<Tween> tween = tweenComponent.CreateTween(param, begin, finish, duration, easingType);
-		return tween;
+		return m_tweenEngine->CreateTween(entity, TweenParameterStep(target, begin, finish, duration, easingType));
 	}
 
 	void Scene::DuplicateEntity(Entity entity)
@@ -6,9 +6,11 @@
 #include "Rhombus/Core/DeltaTime.h"
 #include "Rhombus/Core/UUID.h"
 #include "Rhombus/Renderer/EditorCamera.h"
+#include "Rhombus/Renderer/PickingBuffer.h"
+#include "Rhombus/Physics/PhysicsThread.h"
+#include "SceneQuery.h"
 #include "Rhombus/ECS/Systems/PixelPlatformerPhysicsSystem.h"
 #include "Rhombus/ECS/Systems/PlatformerPlayerControllerSystem.h"
-#include "Rhombus/ECS/Systems/TweeningSystem.h"
 #include "Rhombus/ECS/Systems/AnimationSystem.h"
 #include "Rhombus/Animation/EasingFunctions.h"
 
@@ -21,6 +23,8 @@ namespace rhombus
 	class TweenParameterStep;
 	class TweenCallbackStep;
 	class TweenWaitStep;
+	class TweenEngine;
+	struct TweenTarget;
 	class SceneGraphNode;
 
 	template <typename... Component>
@@ -48,10 +52,15 @@ namespace rhombus
 		virtual void OnRuntimeStart();
 		virtual void OnRuntimeStop();
 
+		// Physics and movement at the fixed simulation rate
+		virtual void OnFixedUpdateRuntime(DeltaTime dt);
+		// Scripts, tweens and animation once per frame, then draws with simulated bodies blended between their last two steps
 		virtual void OnUpdateRuntime(DeltaTime dt);
 		void OnUpdateEditor(DeltaTime dt, EditorCamera& camera);
 		virtual void OnDraw();
+		// Only records the cursor, areas are hit tested once per update however many motion events arrive
 		virtual void OnMouseMoved(int x, int y);
+		// Sent to the areas under the cursor
 		virtual void OnMouseButtonPressed(int button);
 		virtual void OnMouseButtonReleased(int button);
 		virtual void OnKeyPressed(int keycode, bool isRepeat);
@@ -62,13 +71,16 @@ namespace rhombus
 
 		void InitPhyics2D();
 
-		Ref<Tween> CreateTween(Entity entity, const TweenParameterStep& tweenStep);
-		Ref<Tween> CreateTween(Entity entity, const TweenCallbackStep& tweenStep);
-		Ref<Tween> CreateTween(Entity entity, const TweenWaitStep& tweenStep);
-		Ref<Tween> CreateTween(Entity entity, float* param, float begin, float finish, float duration, EasingType easingType = EasingType::LINEAR);
-		Ref<Tween> CreateTween(Entity entity, Vec2* param, Vec2 begin, Vec2 finish, float duration, EasingType easingType = EasingType::LINEAR);
-		Ref<Tween> CreateTween(Entity entity, Vec3* param, Vec3 begin, Vec3 finish, float duration, EasingType easingType = EasingType::LINEAR);
-		Ref<Tween> CreateTween(Entity entity, Vec4* param, Vec4 begin, Vec4 finish, float duration, EasingType easingType = EasingType::LINEAR);
+		// Applied straight away, or queued for the next step when physics runs on its own thread
+		void ApplyLinearImpulse(Entity entity, const Vec2& impulse);
+
+		Tween CreateTween(Entity entity, const TweenParameterStep& tweenStep);
+		Tween CreateTween(Entity entity, const TweenCallbackStep& tweenStep);
+		Tween CreateTween(Entity entity, const TweenWaitStep& tweenStep);
+		Tween CreateTween(Entity entity, const TweenTarget& target, float begin, float finish, float duration, EasingType easingType = EasingType::LINEAR);
+		Tween CreateTween(Entity entity, const TweenTarget& target, Vec2 begin, Vec2 finish, float duration, EasingType easingType = EasingType::LINEAR);
+		Tween CreateTween(Entity entity, const TweenTarget& target, Vec3 begin, Vec3 finish, float duration, EasingType easingType = EasingType::LINEAR);
+		Tween CreateTween(Entity entity, const TweenTarget& target, Vec4 begin, Vec4 finish, float duration, EasingType easingType = EasingType::LINEAR);
 
 		void DuplicateEntity(Entity entity);
 
@@ -98,13 +110,45 @@ namespace rhombus
 
 		bool IsEntityDisabled(EntityID entity) const;
 
+		// When enabled every draw records what it rendered so PickEntity can find the entity at a position on screen
+		void SetPickingEnabled(bool enabled) { m_pickingEnabled = enabled; }
+		bool IsPickingEnabled() const { return m_pickingEnabled; }
+		// ndc is the position in normalised device coordinates of the last draw. INVALID_ENTITY if nothing is there
+		EntityID PickEntity(const Vec2& ndc) const;
+
+		// Spatial queries over colliders and areas. Shapes are brought up to date the first time this is called in each
+		// update, call InvalidateQuery after moving things for later queries in the same update to see it
+		SceneQuery& Query();
+		void InvalidateQuery() { m_querySynced = false; }
+
+		// Hit tests box areas against the cursor if it has moved, sending enter and exit to the areas it came into or
+		// left, then calls OnCursorMoved. Runs at the start of every runtime update and before mouse buttons are sent
+		void UpdateMouseAreas();
+
 	private:
 		void DrawScene();
 		void DrawSprite(EntityID entity, Mat4 transform);
 		void DrawCircle(EntityID entity, Mat4 transform);
 		void DrawTilemap(EntityID entity, Mat4 transform);
 
+		// Rigid bodies and dynamic pixel platformer bodies, the entities whose transforms are driven by the fixed step
+		// Rigid bodies are taken from physicsTransforms when given, otherwise from the awake bodies of the world
+		void RecordSimulatedTransforms(bool beforeStep, const std::vector<PhysicsBodyTransform>* physicsTransforms = nullptr);
+		void ApplyPhysicsTransforms(const std::vector<PhysicsBodyTransform>& physicsTransforms);
+		// False for results of a step that finished after the entity was destroyed, maybe with its ID reused since
+		bool IsPhysicsBodyEntity(const PhysicsBodyTransform& physicsTransform) const;
+		// Rigid body or tile map body, left to the physics thread to destroy if it is stepping
+		void DestroyPhysicsBody(Entity entity);
+		// Rebuilds the fixtures of tile maps whose collision changed. The world must not be stepping
+		void SyncTileMapBodies();
+		// Moves simulated bodies to their blended transforms for drawing, restore puts back the simulated result
+		void ApplyInterpolatedTransforms(float alpha);
+		void RestoreInterpolatedTransforms();
+
 	protected:
+		// Called at most once per update with the latest cursor position, after the areas under it are known
+		virtual void OnCursorMoved(int x, int y) {}
+
 		// Component Registration
 		template<typename... Component>
 		inline void RegisterComponents()
@@ -189,7 +233,8 @@ namespace rhombus
 		Ref<SceneGraphNode> m_rootSceneNode;
 
 		b2World* m_PhysicsWorld = nullptr;
-		Ref<TweeningSystem> tweeningSystem;
+		Scope<PhysicsThread> m_PhysicsThread;						// Only while physics runs on its own thread
+		std::vector<PhysicsBodyTransform> m_PhysicsTransforms;		// Step results when it doesn't
 		Ref<PixelPlatformerPhysicsSystem> pixelPlatformerPhysicsSystem;
 		Ref<PlatformerPlayerControllerSystem> platformerPlayerControllerSystem;
 		Ref<AnimationSystem> animationSystem;
@@ -197,6 +242,32 @@ namespace rhombus
 		std::unordered_map<UUID, EntityID> m_EntityMap;
 		std::unordered_map<EntityID, bool> m_entityEnabledMap;
 
+		struct InterpolatedTransform
+		{
+			EntityID m_entity;
+			Vec3 m_previousPosition;
+			Vec3 m_previousRotation;
+			Vec3 m_currentPosition;
+			Vec3 m_currentRotation;
+			bool m_applied = false;
+		};
+		std::vector<InterpolatedTransform> m_interpolatedTransforms;
+
+		bool m_pickingEnabled = false;
+		PickingBuffer m_pickingBuffer;
+
+		Scope<TweenEngine> m_tweenEngine;
+
+		SceneQuery m_query{ this };
+		bool m_querySynced = false;
+
+		int m_cursorX = 0;
+		int m_cursorY = 0;
+		bool m_cursorMoved = false;
+		std::vector<EntityID> m_hoveredAreas;			// Sorted
+		std::vector<EntityID> m_areasUnderCursor;
+		std::vector<QueryHit> m_areaHits;
+
 		friend class Entity;
 		friend class SceneSerializer;
 		friend class SceneHierarchyPanel;
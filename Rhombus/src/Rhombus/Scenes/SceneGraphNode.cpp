@@ -91,6 +91,7 @@ namespace rhombus
 		m_isDirty = dirty; 
 		if (m_isDirty)
 		{
+			m_transformVersion++;
 			for (auto& child : m_children)
 			{
 				child->SetIsDirty(true);
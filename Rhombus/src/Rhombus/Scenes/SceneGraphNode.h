@@ -18,7 +18,7 @@ namespace rhombus
 		const Mat4& GetLocalTransform() const { return m_localTransform; }
 		Mat4 GetWorldTransform();
 
-		void SetParent(SceneGraphNode* parentNode) { m_parent = parentNode; }
+		void SetParent(SceneGraphNode* parentNode) { m_parent = parentNode; m_transformVersion++; }
 
 		Ref<SceneGraphNode> AddChild(Entity entity);
 		void AddChild(Ref<SceneGraphNode> sceneGraphNode);
@@ -39,6 +39,8 @@ namespace rhombus
 
 		void SetIsDirty(bool dirty);
 		bool GetIsDirty() const { return m_isDirty; }
+		// Changes whenever the world transform may have changed, so a system can keep data derived from it until it does
+		uint32_t GetTransformVersion() const { return m_transformVersion; }
 
 		void UpdateDirtyTransforms();
 
@@ -47,6 +49,7 @@ namespace rhombus
 		Entity m_entity;
 		Scene* m_rootScene;
 		bool m_isDirty;
+		uint32_t m_transformVersion = 0;
 		Mat4 m_localTransform;
 		Mat4 m_worldTransform;
 		std::vector<Ref<SceneGraphNode>> m_children;
@@ -0,0 +1,540 @@
+#include "rbpch.h"
+#include "SceneQuery.h"
+
+#include "Scene.h"
+#include "Rhombus/ECS/Components/Area2DComponent.h"
+#include "Rhombus/ECS/Components/Collider2DComponent.h"
+#include "Rhombus/ECS/Components/TransformComponent.h"
+#include "SceneGraphNode.h"
+
+namespace rhombus
+{
+	namespace utils
+	{
+		static float SqDistPointSegment(const Vec2& point, const Vec2& a, const Vec2& b)
+		{
+			const Vec2 ab = b - a;
+			const float length2 = ab.GetMag2();
+			const float t = length2 > 0.0f ? std::clamp((point - a).Dot(ab) / length2, 0.0f, 1.0f) : 0.0f;
+			return (a + ab * t - point).GetMag2();
+		}
+
+		static Vec2 Perpendicular(const Vec2& v)
+		{
+			return Vec2(-v.y, v.x);
+		}
+	}
+
+	void SceneQuery::Shape::GetBounds(Vec2& outMin, Vec2& outMax) const
+	{
+		const Vec2 extents = m_isCircle ? Vec2(m_radius) : Vec2(std::abs(m_axisX.x) + std::abs(m_axisY.x), std::abs(m_axisX.y) + std::abs(m_axisY.y));
+		outMin = m_center - extents;
+		outMax = m_center + extents;
+	}
+
+	bool SceneQuery::Shape::Contains(const Vec2& point) const
+	{
+		const Vec2 offset = point - m_center;
+		if (m_isCircle)
+		{
+			return offset.GetMag2() < m_radius * m_radius;
+		}
+
+		// Position of the point in terms of the two axes, inside when both are within -1 to 1
+		const float determinant = m_axisX.x * m_axisY.y - m_axisX.y * m_axisY.x;
+		if (determinant == 0.0f)
+		{
+			return false;
+		}
+
+		const float u = (offset.x * m_axisY.y - offset.y * m_axisY.x) / determinant;
+		const float v = (m_axisX.x * offset.y - m_axisX.y * offset.x) / determinant;
+		return std::abs(u) < 1.0f && std::abs(v) < 1.0f;
+	}
+
+	bool SceneQuery::Shape::Overlaps(const Vec2& min, const Vec2& max) const
+	{
+		if (m_isCircle)
+		{
+			return AABBTree::SqDistPointBox(m_center, min, max) < m_radius * m_radius;
+		}
+
+		// Separating axis test on the box axes and both edge normals of the shape
+		const Vec2 halfSize = (max - min) * 0.5f;
+		const Vec2 offset = m_center - (min + max) * 0.5f;
+		if (std::abs(offset.x) >= halfSize.x + std::abs(m_axisX.x) + std::abs(m_axisY.x) ||
+			std::abs(offset.y) >= halfSize.y + std::abs(m_axisX.y) + std::abs(m_axisY.y))
+		{
+			return false;
+		}
+
+		const Vec2 normals[2] = { utils::Perpendicular(m_axisX), utils::Perpendicular(m_axisY) };
+		const Vec2 otherAxes[2] = { m_axisY, m_axisX };
+		for (int i = 0; i < 2; i++)
+		{
+			const Vec2& normal = normals[i];
+			const float shapeRadius = std::abs(otherAxes[i].Dot(normal));
+			const float boxRadius = halfSize.x * std::abs(normal.x) + halfSize.y * std::abs(normal.y);
+			if (std::abs(offset.Dot(normal)) >= shapeRadius + boxRadius)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	float SceneQuery::Shape::SqDistance(const Vec2& point) const
+	{
+		if (m_isCircle)
+		{
+			const float distance = std::max((point - m_center).GetMagnitude() - m_radius, 0.0f);
+			return distance * distance;
+		}
+
+		if (Contains(point))
+		{
+			return 0.0f;
+		}
+
+		const Vec2 corners[4] =
+		{
+			m_center - m_axisX - m_axisY,
+			m_center + m_axisX - m_axisY,
+			m_center + m_axisX + m_axisY,
+			m_center - m_axisX + m_axisY
+		};
+
+		float distance2 = FLT_MAX;
+		for (int i = 0; i < 4; i++)
+		{
+			distance2 = std::min(distance2, utils::SqDistPointSegment(point, corners[i], corners[(i + 1) % 4]));
+		}
+
+		return distance2;
+	}
+
+	bool SceneQuery::Shape::Raycast(const Vec2& start, const Vec2& end, float maxFraction, float& outFraction, Vec2& outNormal) const
+	{
+		const Vec2 delta = end - start;
+		if (m_isCircle)
+		{
+			const Vec2 offset = start - m_center;
+			const float a = delta.GetMag2();
+			const float b = offset.Dot(delta);
+			const float c = offset.GetMag2() - m_radius * m_radius;
+			const float discriminant = b * b - a * c;
+			if (c < 0.0f || a <= 0.0f || discriminant < 0.0f)
+			{
+				return false;
+			}
+
+			const float fraction = (-b - std::sqrt(discriminant)) / a;
+			if (fraction < 0.0f || fraction > maxFraction)
+			{
+				return false;
+			}
+
+			outFraction = fraction;
+			outNormal = start + delta * fraction - m_center;
+			outNormal.Normalize();
+			return true;
+		}
+
+		const float determinant = m_axisX.x * m_axisY.y - m_axisX.y * m_axisY.x;
+		if (determinant == 0.0f)
+		{
+			return false;
+		}
+
+		// Slab test against -1 to 1 on both axes in the shape's own space, fractions carry over unchanged
+		const Vec2 inverseRowX = Vec2(m_axisY.y, -m_axisY.x) / determinant;
+		const Vec2 inverseRowY = Vec2(-m_axisX.y, m_axisX.x) / determinant;
+		const Vec2 offset = start - m_center;
+		const float localStart[2] = { inverseRowX.Dot(offset), inverseRowY.Dot(offset) };
+		const float localDelta[2] = { inverseRowX.Dot(delta), inverseRowY.Dot(delta) };
+		if (std::abs(localStart[0]) < 1.0f && std::abs(localStart[1]) < 1.0f)
+		{
+			return false;
+		}
+
+		float fractionIn = 0.0f;
+		float fractionOut = maxFraction;
+		int hitAxis = -1;
+		float hitSide = 0.0f;
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (localDelta[axis] == 0.0f)
+			{
+				if (std::abs(localStart[axis]) >= 1.0f)
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			const float inverse = 1.0f / localDelta[axis];
+			float fraction1 = (-1.0f - localStart[axis]) * inverse;
+			float fraction2 = (1.0f - localStart[axis]) * inverse;
+			float side = -1.0f;
+			if (fraction1 > fraction2)
+			{
+				std::swap(fraction1, fraction2);
+				side = 1.0f;
+			}
+
+			if (fraction1 > fractionIn)
+			{
+				fractionIn = fraction1;
+				hitAxis = axis;
+				hitSide = side;
+			}
+
+			fractionOut = std::min(fractionOut, fraction2);
+			if (fractionIn > fractionOut)
+			{
+				return false;
+			}
+		}
+
+		if (hitAxis < 0)
+		{
+			return false;
+		}
+
+		// The face normal goes back to world space through the inverse transpose
+		outFraction = fractionIn;
+		outNormal = (hitAxis == 0 ? inverseRowX : inverseRowY) * hitSide;
+		outNormal.Normalize();
+		return true;
+	}
+
+	void SceneQuery::Sync()
+	{
+		RB_PROFILE_FUNCTION();
+
+		// The components are walked in place. Proxies that come back as up to date are skipped, so a sync where
+		// little moved costs a read of each component and its transform version
+		m_syncStamp++;
+		Registry& registry = m_scene->GetRegistry();
+		ComponentArray<BoxCollider2DComponent>* boxColliders = registry.GetComponentArray<BoxCollider2DComponent>();
+		ComponentArray<CircleCollider2DComponent>* circleColliders = registry.GetComponentArray<CircleCollider2DComponent>();
+		ComponentArray<BoxArea2DComponent>* boxAreas = registry.GetComponentArray<BoxArea2DComponent>();
+
+		const BoxCollider2DComponent* boxColliderData = boxColliders->GetDataArray();
+		for (size_t i = 0; i < boxColliders->GetSize(); i++)
+		{
+			const BoxCollider2DComponent& collider = boxColliderData[i];
+			const int32_t proxyIndex = SyncProxy(QueryShapeType::BoxCollider, collider.GetOwnerEntity(), collider.m_offset, collider.m_size);
+			if (proxyIndex < 0)
+			{
+				continue;
+			}
+
+			const Mat4 worldTransform = m_proxies[proxyIndex].m_sceneGraphNode->GetWorldTransform();
+			const Vec4 center = worldTransform * Vec4(collider.m_offset.x, collider.m_offset.y, 0.0f, 1.0f);
+
+			Shape shape;
+			shape.m_center = Vec2(center.x, center.y);
+			shape.m_axisX = Vec2(worldTransform[0].x, worldTransform[0].y) * collider.m_size.x;
+			shape.m_axisY = Vec2(worldTransform[1].x, worldTransform[1].y) * collider.m_size.y;
+			SetProxyShape(proxyIndex, shape);
+		}
+
+		const CircleCollider2DComponent* circleColliderData = circleColliders->GetDataArray();
+		for (size_t i = 0; i < circleColliders->GetSize(); i++)
+		{
+			const CircleCollider2DComponent& collider = circleColliderData[i];
+			const int32_t proxyIndex = SyncProxy(QueryShapeType::CircleCollider, collider.GetOwnerEntity(), collider.m_offset, Vec2(collider.m_radius, 0.0f));
+			if (proxyIndex < 0)
+			{
+				continue;
+			}
+
+			const Mat4 worldTransform = m_proxies[proxyIndex].m_sceneGraphNode->GetWorldTransform();
+			const Vec4 center = worldTransform * Vec4(collider.m_offset.x, collider.m_offset.y, 0.0f, 1.0f);
+
+			// Scaled by x like the Box2D fixture
+			Shape shape;
+			shape.m_isCircle = true;
+			shape.m_center = Vec2(center.x, center.y);
+			shape.m_radius = collider.m_radius * Vec2(worldTransform[0].x, worldTransform[0].y).GetMagnitude();
+			SetProxyShape(proxyIndex, shape);
+		}
+
+		const BoxArea2DComponent* boxAreaData = boxAreas->GetDataArray();
+		for (size_t i = 0; i < boxAreas->GetSize(); i++)
+		{
+			const BoxArea2DComponent& area = boxAreaData[i];
+			const int32_t proxyIndex = SyncProxy(QueryShapeType::BoxArea, area.GetOwnerEntity(), area.m_offset, area.m_size);
+			if (proxyIndex < 0)
+			{
+				continue;
+			}
+
+			const Mat4 worldTransform = m_proxies[proxyIndex].m_sceneGraphNode->GetWorldTransform();
+
+			// Areas ignore rotation and scale, they are the size given around the world position
+			Shape shape;
+			shape.m_center = Vec2(worldTransform[3].x, worldTransform[3].y) + area.m_offset;
+			shape.m_axisX = Vec2(area.m_size.x, 0.0f);
+			shape.m_axisY = Vec2(0.0f, area.m_size.y);
+			SetProxyShape(proxyIndex, shape);
+		}
+
+		// Anything not seen above lost its component or its entity, which changes the layout of its component array
+		const uint32_t layoutVersions[(uint32_t)QueryShapeType::Count] = { boxColliders->GetLayoutVersion(), circleColliders->GetLayoutVersion(), boxAreas->GetLayoutVersion() };
+		if (std::equal(std::begin(layoutVersions), std::end(layoutVersions), std::begin(m_layoutVersions)))
+		{
+			return;
+		}
+		std::copy(std::begin(layoutVersions), std::end(layoutVersions), std::begin(m_layoutVersions));
+
+		for (uint32_t i = 0; i < (uint32_t)m_proxies.size(); i++)
+		{
+			if (m_proxies[i].m_entity != INVALID_ENTITY && m_proxies[i].m_syncStamp != m_syncStamp)
+			{
+				DestroyProxy(i);
+			}
+		}
+	}
+
+	void SceneQuery::Clear()
+	{
+		m_tree.Clear();
+		m_proxies.clear();
+		m_freeProxies.clear();
+		for (std::vector<int32_t>& entityProxies : m_entityProxies)
+		{
+			entityProxies.clear();
+		}
+		std::fill(std::begin(m_layoutVersions), std::end(m_layoutVersions), 0);
+	}
+
+	int32_t SceneQuery::SyncProxy(QueryShapeType type, EntityID entity, const Vec2& offset, const Vec2& size)
+	{
+		Registry& registry = m_scene->GetRegistry();
+		std::vector<int32_t>& entityProxies = m_entityProxies[(uint32_t)type];
+		if (entity >= (EntityID)entityProxies.size())
+		{
+			entityProxies.resize(std::max<size_t>(entity + 1, MAX_ENTITIES), -1);
+		}
+
+		// An entity destroyed since the last sync can have had its ID handed to a new one
+		const uint32_t generation = registry.GetEntityGeneration(entity);
+		int32_t proxyIndex = entityProxies[entity];
+		if (proxyIndex >= 0 && m_proxies[proxyIndex].m_generation != generation)
+		{
+			DestroyProxy((uint32_t)proxyIndex);
+			proxyIndex = -1;
+		}
+
+		if (proxyIndex < 0)
+		{
+			if (m_freeProxies.empty())
+			{
+				proxyIndex = (int32_t)m_proxies.size();
+				m_proxies.emplace_back();
+			}
+			else
+			{
+				proxyIndex = (int32_t)m_freeProxies.back();
+				m_freeProxies.pop_back();
+			}
+
+			entityProxies[entity] = proxyIndex;
+
+			Proxy& proxy = m_proxies[proxyIndex];
+			proxy.m_entity = entity;
+			proxy.m_type = type;
+			proxy.m_generation = generation;
+			proxy.m_sceneGraphNode = registry.GetComponent<TransformComponent>(entity).m_sceneGraphNode;
+		}
+
+		Proxy& proxy = m_proxies[proxyIndex];
+		proxy.m_syncStamp = m_syncStamp;
+
+		const uint32_t transformVersion = proxy.m_sceneGraphNode->GetTransformVersion();
+		if (proxy.m_treeProxy != AABBTree::NULL_NODE && proxy.m_transformVersion == transformVersion && proxy.m_offset == offset && proxy.m_size == size)
+		{
+			return -1;
+		}
+
+		proxy.m_transformVersion = transformVersion;
+		proxy.m_offset = offset;
+		proxy.m_size = size;
+		return proxyIndex;
+	}
+
+	void SceneQuery::SetProxyShape(int32_t proxyIndex, const Shape& shape)
+	{
+		Vec2 min, max;
+		shape.GetBounds(min, max);
+
+		Proxy& proxy = m_proxies[proxyIndex];
+		if (proxy.m_treeProxy == AABBTree::NULL_NODE)
+		{
+			proxy.m_treeProxy = m_tree.CreateProxy(min, max, (uint32_t)proxyIndex);
+		}
+		else
+		{
+			m_tree.MoveProxy(proxy.m_treeProxy, min, max);
+		}
+
+		proxy.m_shape = shape;
+	}
+
+	void SceneQuery::DestroyProxy(uint32_t proxyIndex)
+	{
+		Proxy& proxy = m_proxies[proxyIndex];
+		m_tree.DestroyProxy(proxy.m_treeProxy);
+		m_entityProxies[(uint32_t)proxy.m_type][proxy.m_entity] = -1;
+
+		proxy.m_entity = INVALID_ENTITY;
+		proxy.m_treeProxy = AABBTree::NULL_NODE;
+		m_freeProxies.push_back(proxyIndex);
+	}
+
+	uint32_t SceneQuery::OverlapPoint(const Vec2& point, QueryHit* hits, uint32_t maxHits, uint32_t shapeFlags) const
+	{
+		uint32_t count = 0;
+		if (maxHits == 0)
+		{
+			return count;
+		}
+
+		m_tree.Query(point, point, [&](int32_t treeProxy)
+		{
+			const Proxy& proxy = m_proxies[m_tree.GetUserData(treeProxy)];
+			if ((shapeFlags & (1 << (uint32_t)proxy.m_type)) && proxy.m_shape.Contains(point))
+			{
+				hits[count++] = { proxy.m_entity, proxy.m_type, 0.0f };
+			}
+
+			return count == maxHits;
+		});
+
+		return count;
+	}
+
+	uint32_t SceneQuery::OverlapBox(const Vec2& min, const Vec2& max, QueryHit* hits, uint32_t maxHits, uint32_t shapeFlags) const
+	{
+		uint32_t count = 0;
+		if (maxHits == 0)
+		{
+			return count;
+		}
+
+		m_tree.Query(min, max, [&](int32_t treeProxy)
+		{
+			const Proxy& proxy = m_proxies[m_tree.GetUserData(treeProxy)];
+			if ((shapeFlags & (1 << (uint32_t)proxy.m_type)) && proxy.m_shape.Overlaps(min, max))
+			{
+				hits[count++] = { proxy.m_entity, proxy.m_type, 0.0f };
+			}
+
+			return count == maxHits;
+		});
+
+		return count;
+	}
+
+	uint32_t SceneQuery::Nearest(const Vec2& point, QueryHit* hits, uint32_t maxHits, float maxDistance, uint32_t shapeFlags) const
+	{
+		uint32_t count = 0;
+		if (maxHits == 0)
+		{
+			return count;
+		}
+
+		const float maxDistance2 = maxDistance < std::sqrt(FLT_MAX) ? maxDistance * maxDistance : FLT_MAX;
+		m_tree.QueryNearest(point, [&](int32_t treeProxy)
+		{
+			const Proxy& proxy = m_proxies[m_tree.GetUserData(treeProxy)];
+			if (shapeFlags & (1 << (uint32_t)proxy.m_type))
+			{
+				const float distance2 = proxy.m_shape.SqDistance(point);
+				const float worstDistance = count == maxHits ? hits[count - 1].m_distance : FLT_MAX;
+				if (distance2 <= maxDistance2 && distance2 < worstDistance * worstDistance)
+				{
+					// Insertion into the sorted hits, dropping the furthest once full
+					const float distance = std::sqrt(distance2);
+					uint32_t index = count < maxHits ? count++ : maxHits - 1;
+					while (index > 0 && hits[index - 1].m_distance > distance)
+					{
+						hits[index] = hits[index - 1];
+						index--;
+					}
+
+					hits[index] = { proxy.m_entity, proxy.m_type, distance };
+				}
+			}
+
+			return count == maxHits ? hits[count - 1].m_distance * hits[count - 1].m_distance : maxDistance2;
+		});
+
+		return count;
+	}
+
+	bool SceneQuery::Raycast(const Vec2& start, const Vec2& end, RaycastHit& outHit, uint32_t shapeFlags) const
+	{
+		bool hit = false;
+		m_tree.Raycast(start, end, [&](int32_t treeProxy, float maxFraction)
+		{
+			const Proxy& proxy = m_proxies[m_tree.GetUserData(treeProxy)];
+			float fraction;
+			Vec2 normal;
+			if (!(shapeFlags & (1 << (uint32_t)proxy.m_type)) || !proxy.m_shape.Raycast(start, end, maxFraction, fraction, normal))
+			{
+				return maxFraction;
+			}
+
+			outHit = { proxy.m_entity, proxy.m_type, start + (end - start) * fraction, normal, fraction };
+			hit = true;
+			return fraction;
+		});
+
+		return hit;
+	}
+
+	uint32_t SceneQuery::RaycastAll(const Vec2& start, const Vec2& end, RaycastHit* hits, uint32_t maxHits, uint32_t shapeFlags) const
+	{
+		uint32_t count = 0;
+		if (maxHits == 0)
+		{
+			return count;
+		}
+
+		m_tree.Raycast(start, end, [&](int32_t treeProxy, float maxFraction)
+		{
+			const Proxy& proxy = m_proxies[m_tree.GetUserData(treeProxy)];
+			float fraction;
+			Vec2 normal;
+			if (!(shapeFlags & (1 << (uint32_t)proxy.m_type)) || !proxy.m_shape.Raycast(start, end, maxFraction, fraction, normal))
+			{
+				return maxFraction;
+			}
+
+			if (count == maxHits && fraction >= hits[count - 1].m_fraction)
+			{
+				return maxFraction;
+			}
+
+			// Insertion into the sorted hits, dropping the furthest once full
+			uint32_t index = count < maxHits ? count++ : maxHits - 1;
+			while (index > 0 && hits[index - 1].m_fraction > fraction)
+			{
+				hits[index] = hits[index - 1];
+				index--;
+			}
+
+			hits[index] = { proxy.m_entity, proxy.m_type, start + (end - start) * fraction, normal, fraction };
+
+			// Once full nothing beyond the furthest kept hit can make it in
+			return count == maxHits ? hits[count - 1].m_fraction : maxFraction;
+		});
+
+		return count;
+	}
+}
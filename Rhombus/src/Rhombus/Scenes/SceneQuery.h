@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Rhombus/ECS/ECSTypes.h"
+#include "Rhombus/Math/Vector.h"
+#include "Rhombus/Physics/AABBTree.h"
+
+#include <vector>
+
+namespace rhombus
+{
+	class Scene;
+	class SceneGraphNode;
+
+	enum class QueryShapeType : uint8_t { BoxCollider = 0, CircleCollider, BoxArea, Count };
+
+	enum QUERY_SHAPE_FLAGS : uint32_t
+	{
+		QUERY_BOX_COLLIDER = 1 << (uint32_t)QueryShapeType::BoxCollider,
+		QUERY_CIRCLE_COLLIDER = 1 << (uint32_t)QueryShapeType::CircleCollider,
+		QUERY_BOX_AREA = 1 << (uint32_t)QueryShapeType::BoxArea,
+		QUERY_COLLIDERS = QUERY_BOX_COLLIDER | QUERY_CIRCLE_COLLIDER,
+		QUERY_ALL = QUERY_COLLIDERS | QUERY_BOX_AREA
+	};
+
+	struct QueryHit
+	{
+		EntityID m_entity;
+		QueryShapeType m_shape;
+		float m_distance;			// Only set by nearest queries
+	};
+
+	struct RaycastHit
+	{
+		EntityID m_entity;
+		QueryShapeType m_shape;
+		Vec2 m_point;
+		Vec2 m_normal;
+		float m_fraction;			// Along the ray from start to end
+	};
+
+	// Spatial queries over the box colliders, circle colliders and box areas of a scene. Every shape is a separate
+	// result, so an entity with both a collider and an area can come back twice. Results are written into buffers
+	// supplied by the caller, the functions return how many were written and never allocate
+	class SceneQuery
+	{
+	public:
+		SceneQuery(Scene* scene) : m_scene(scene) {}
+
+		// Brings the shapes up to date with the components and world transforms. Only shapes whose component or
+		// transform changed since the last sync are recomputed and moved in the tree
+		void Sync();
+		void Clear();
+
+		// Shapes containing point
+		uint32_t OverlapPoint(const Vec2& point, QueryHit* hits, uint32_t maxHits, uint32_t shapeFlags = QUERY_ALL) const;
+		// Shapes overlapping the axis aligned box min to max
+		uint32_t OverlapBox(const Vec2& min, const Vec2& max, QueryHit* hits, uint32_t maxHits, uint32_t shapeFlags = QUERY_ALL) const;
+		// Up to maxHits shapes nearest point, nearest first. Shapes containing point are at distance 0
+		uint32_t Nearest(const Vec2& point, QueryHit* hits, uint32_t maxHits, float maxDistance = FLT_MAX, uint32_t shapeFlags = QUERY_ALL) const;
+
+		// First shape along the segment start to end. Shapes containing start are ignored
+		bool Raycast(const Vec2& start, const Vec2& end, RaycastHit& outHit, uint32_t shapeFlags = QUERY_ALL) const;
+		// The first maxHits shapes along the segment, nearest first
+		uint32_t RaycastAll(const Vec2& start, const Vec2& end, RaycastHit* hits, uint32_t maxHits, uint32_t shapeFlags = QUERY_ALL) const;
+
+		uint32_t GetShapeCount() const { return m_tree.GetProxyCount(); }
+		const AABBTree& GetTree() const { return m_tree; }
+
+	private:
+		// Boxes are the parallelogram center +- axisX +- axisY so rotation and scale from the scene graph carry over
+		struct Shape
+		{
+			Vec2 m_center;
+			Vec2 m_axisX;
+			Vec2 m_axisY;
+			float m_radius = 0.0f;
+			bool m_isCircle = false;
+
+			void GetBounds(Vec2& outMin, Vec2& outMax) const;
+			bool Contains(const Vec2& point) const;
+			bool Overlaps(const Vec2& min, const Vec2& max) const;
+			float SqDistance(const Vec2& point) const;
+			bool Raycast(const Vec2& start, const Vec2& end, float maxFraction, float& outFraction, Vec2& outNormal) const;
+		};
+
+		struct Proxy
+		{
+			Shape m_shape;
+			EntityID m_entity = INVALID_ENTITY;
+			QueryShapeType m_type = QueryShapeType::BoxCollider;
+			int32_t m_treeProxy = AABBTree::NULL_NODE;
+			uint32_t m_syncStamp = 0;
+
+			// What the shape was made from, it is only made again when one of these changes
+			Ref<SceneGraphNode> m_sceneGraphNode;
+			uint32_t m_generation = 0;
+			uint32_t m_transformVersion = 0;
+			Vec2 m_offset;
+			Vec2 m_size;
+		};
+
+		// Finds or creates the entity's proxy of this type and marks it as seen. Returns the proxy if its shape has to
+		// be made again, -1 if it is up to date
+		int32_t SyncProxy(QueryShapeType type, EntityID entity, const Vec2& offset, const Vec2& size);
+		void SetProxyShape(int32_t proxyIndex, const Shape& shape);
+		void DestroyProxy(uint32_t proxyIndex);
+
+	private:
+		Scene* m_scene;
+		AABBTree m_tree;
+
+		std::vector<Proxy> m_proxies;
+		std::vector<uint32_t> m_freeProxies;
+		std::vector<int32_t> m_entityProxies[(uint32_t)QueryShapeType::Count];		// Proxy index per entity, -1 if none
+		uint32_t m_layoutVersions[(uint32_t)QueryShapeType::Count] = {};			// Of the component arrays at the last sync
+		uint32_t m_syncStamp = 0;
+	};
+}
@@ -5,6 +5,7 @@
 #include "SceneGraphNode.h"
 
 #include "Rhombus/Project/Project.h"
+#include "Rhombus/Assets/AssetManager.h"
 #include "Rhombus/Tiles/TileSerializer.h"
 #include "Rhombus/Animation/AnimationSerializer.h"
 
@@ -259,6 +260,7 @@ namespace rhombus
 			out << YAML::Key << "TileMapComponent";
 			out << YAML::BeginMap; // TileMapComponent
 			out << YAML::Key << "TileMap" << YAML::Value << path;
+			out << YAML::Key << "GenerateCollision" << YAML::Value << tilemapComponent.m_generateCollision;
 			out << YAML::EndMap; // TileMapComponent
 		}
 
@@ -432,7 +434,7 @@ namespace rhombus
 					{
 						std::string texturePath = spriteRendererComponent["Texture"].as<std::string>();
 						auto path = Project::GetAssetFileSystemPath(texturePath);
-						src.m_texture = Texture2D::Create(path.string());
+						src.m_texture = AssetManager::GetTextureAsync(path);
 
 						src.SetRows(spriteRendererComponent["Rows"].as<int>());
 						src.SetColumns(spriteRendererComponent["Columns"].as<int>());
@@ -507,6 +509,11 @@ namespace rhombus
 					{
 						tilemap.m_tilemap = TileSerializer::DeserializeTileMap(tileMapComponent["TileMap"].as<std::string>());
 					}
+
+					if (tileMapComponent["GenerateCollision"])
+					{
+						tilemap.m_generateCollision = tileMapComponent["GenerateCollision"].as<bool>();
+					}
 				}
 
 				auto platformerPlayerControllerComponent = entity["PlatformerPlayerControllerComponent"];
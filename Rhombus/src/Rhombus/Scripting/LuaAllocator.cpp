@@ -0,0 +1,352 @@
+#include "rbpch.h"
+#include "LuaAllocator.h"
+
+#ifdef RB_PLATFORM_WINDOWS
+	#include <malloc.h>
+#endif
+
+namespace rhombus
+{
+	namespace utils
+	{
+		static void* AllocatePage(size_t size)
+		{
+#ifdef RB_PLATFORM_WINDOWS
+			return _aligned_malloc(size, size);
+#else
+			return std::aligned_alloc(size, size);
+#endif
+		}
+
+		static void FreePage(void* page)
+		{
+#ifdef RB_PLATFORM_WINDOWS
+			_aligned_free(page);
+#else
+			std::free(page);
+#endif
+		}
+	}
+
+	LuaAllocator::LuaAllocator()
+	{
+		static_assert(sizeof(Page) % 16 == 0, "Lua allocator pages must keep blocks 16 byte aligned");
+
+		m_ownerStats[ENGINE_OWNER].Name = "Engine";
+
+		// The reserve page, kept so a block can always be shrunk into a smaller size class
+		if (Page* page = TakePage(false))
+		{
+			page->m_poolNext = nullptr;
+			m_freePages = page;
+			m_freePageCount = 1;
+		}
+	}
+
+	LuaAllocator::~LuaAllocator()
+	{
+		Page* page = m_pages;
+		while (page)
+		{
+			Page* next = page->m_next;
+			utils::FreePage(page);
+			page = next;
+		}
+	}
+
+	void* LuaAllocator::Allocate(void* userData, void* block, size_t oldSize, size_t newSize)
+	{
+		LuaAllocator* allocator = (LuaAllocator*)userData;
+
+		// Lua passes the type of object being made as oldSize when block is null
+		const size_t currentSize = block ? oldSize : 0;
+
+		if (newSize == 0)
+		{
+			if (block)
+			{
+				allocator->ReleaseBlock(block, currentSize);
+			}
+			return nullptr;
+		}
+
+		// Blocks that stay in the same size class don't need to move
+		if (block && currentSize <= s_sizeClasses[SIZE_CLASS_COUNT - 1] && newSize <= s_sizeClasses[SIZE_CLASS_COUNT - 1] &&
+			GetSizeClass(currentSize) == GetSizeClass(newSize))
+		{
+			const uint32_t owner = GetBlockOwner(block, currentSize);
+			if (newSize > currentSize)
+			{
+				allocator->CountAllocation(owner, newSize - currentSize);
+			}
+			else
+			{
+				allocator->CountFree(owner, currentSize - newSize);
+			}
+			return block;
+		}
+
+		if (!block)
+		{
+			return allocator->AllocateBlock(newSize);
+		}
+
+		// A block that moves stays with its owner, the collector resizes tables and strings while anything is running
+		const bool shrinking = newSize < currentSize;
+		const uint32_t currentOwner = allocator->m_owner;
+		const uint32_t owner = GetBlockOwner(block, currentSize);
+		allocator->m_owner = owner;
+		void* newBlock = allocator->AllocateBlock(newSize, shrinking);
+		allocator->m_owner = currentOwner;
+
+		if (newBlock)
+		{
+			memcpy(newBlock, block, std::min(currentSize, newSize));
+			allocator->ReleaseBlock(block, currentSize);
+			return newBlock;
+		}
+
+		// Out of memory. A block that shrinks without leaving the pages, or without going into them, can stay where
+		// it is, it is released by its page's size class or as a large block either way
+		const size_t largestSmallBlock = s_sizeClasses[SIZE_CLASS_COUNT - 1];
+		if (shrinking && (currentSize <= largestSmallBlock || newSize > largestSmallBlock))
+		{
+			allocator->CountFree(owner, currentSize - newSize);
+			return block;
+		}
+
+		return nullptr;
+	}
+
+	uint32_t LuaAllocator::RegisterOwner(const std::string& name)
+	{
+		for (uint32_t i = 1; i < m_ownerCount; i++)
+		{
+			if (m_ownerStats[i].Name == name)
+			{
+				return i;
+			}
+		}
+
+		if (m_ownerCount == MAX_OWNERS)
+		{
+			Log::Warn("Lua allocator is out of owners, memory for %s is counted against the engine", name.c_str());
+			return ENGINE_OWNER;
+		}
+
+		m_ownerStats[m_ownerCount].Name = name;
+		return m_ownerCount++;
+	}
+
+	void LuaAllocator::GetOwnerStats(std::vector<ScriptMemoryStats>& stats) const
+	{
+		stats.assign(m_ownerStats, m_ownerStats + m_ownerCount);
+	}
+
+	void LuaAllocator::EndFrame()
+	{
+		m_total.FrameAllocations = 0;
+		m_total.FrameAllocatedBytes = 0;
+		for (uint32_t i = 0; i < m_ownerCount; i++)
+		{
+			m_ownerStats[i].FrameAllocations = m_frameAllocations[i];
+			m_ownerStats[i].FrameAllocatedBytes = m_frameAllocatedBytes[i];
+			m_total.FrameAllocations += m_frameAllocations[i];
+			m_total.FrameAllocatedBytes += m_frameAllocatedBytes[i];
+
+			m_frameAllocations[i] = 0;
+			m_frameAllocatedBytes[i] = 0;
+		}
+	}
+
+	uint32_t LuaAllocator::GetBlockOwner(const void* block, size_t size)
+	{
+		if (size <= s_sizeClasses[SIZE_CLASS_COUNT - 1])
+		{
+			return GetPage(block)->m_owner;
+		}
+
+		return *(const uint32_t*)((const char*)block - LARGE_BLOCK_HEADER_SIZE);
+	}
+
+	uint32_t LuaAllocator::GetSizeClass(size_t size)
+	{
+		uint32_t sizeClass = 0;
+		while (s_sizeClasses[sizeClass] < size)
+		{
+			sizeClass++;
+		}
+		return sizeClass;
+	}
+
+	void* LuaAllocator::AllocateBlock(size_t size, bool useReserve)
+	{
+		if (size <= s_sizeClasses[SIZE_CLASS_COUNT - 1])
+		{
+			void* block = AllocateFromPool(GetSizeClass(size), useReserve);
+			if (block)
+			{
+				CountAllocation(m_owner, size);
+			}
+			return block;
+		}
+
+		// Large blocks go to the system allocator with their owner in front of them
+		char* memory = (char*)malloc(size + LARGE_BLOCK_HEADER_SIZE);
+		if (!memory)
+		{
+			return nullptr;
+		}
+
+		*(uint32_t*)memory = m_owner;
+		CountAllocation(m_owner, size);
+		return memory + LARGE_BLOCK_HEADER_SIZE;
+	}
+
+	void LuaAllocator::ReleaseBlock(void* block, size_t size)
+	{
+		if (size <= s_sizeClasses[SIZE_CLASS_COUNT - 1])
+		{
+			Page* page = GetPage(block);
+			Pool& pool = m_pools[page->m_owner][page->m_sizeClass];
+			const bool wasFull = IsFull(page);
+
+			FreeBlock* freeBlock = (FreeBlock*)block;
+			freeBlock->m_next = page->m_freeList;
+			page->m_freeList = freeBlock;
+			page->m_usedBlocks--;
+
+			CountFree(page->m_owner, size);
+
+			if (page->m_usedBlocks == 0)
+			{
+				if (!wasFull)
+				{
+					RemoveFromPool(pool, page);
+				}
+
+				page->m_poolNext = m_freePages;
+				m_freePages = page;
+				m_freePageCount++;
+			}
+			else if (wasFull)
+			{
+				AddToPool(pool, page);
+			}
+			return;
+		}
+
+		char* memory = (char*)block - LARGE_BLOCK_HEADER_SIZE;
+		CountFree(*(uint32_t*)memory, size);
+		free(memory);
+	}
+
+	void* LuaAllocator::AllocateFromPool(uint32_t sizeClass, bool useReserve)
+	{
+		Pool& pool = m_pools[m_owner][sizeClass];
+		Page* page = pool.m_pages;
+		if (!page)
+		{
+			page = TakePage(useReserve);
+			if (!page)
+			{
+				return nullptr;
+			}
+
+			page->m_owner = m_owner;
+			page->m_sizeClass = sizeClass;
+			page->m_freeList = nullptr;
+			page->m_bump = (char*)page + sizeof(Page);
+			page->m_usedBlocks = 0;
+			AddToPool(pool, page);
+		}
+
+		void* block;
+		if (page->m_freeList)
+		{
+			block = page->m_freeList;
+			page->m_freeList = page->m_freeList->m_next;
+		}
+		else
+		{
+			block = page->m_bump;
+			page->m_bump += s_sizeClasses[sizeClass];
+		}
+
+		page->m_usedBlocks++;
+		if (IsFull(page))
+		{
+			RemoveFromPool(pool, page);
+		}
+
+		return block;
+	}
+
+	LuaAllocator::Page* LuaAllocator::TakePage(bool useReserve)
+	{
+		if (m_freePages && (m_freePages->m_poolNext || useReserve))
+		{
+			Page* page = m_freePages;
+			m_freePages = page->m_poolNext;
+			m_freePageCount--;
+			return page;
+		}
+
+		Page* page = (Page*)utils::AllocatePage(PAGE_SIZE);
+		if (!page)
+		{
+			return nullptr;
+		}
+
+		page->m_next = m_pages;
+		m_pages = page;
+		m_pageCount++;
+		return page;
+	}
+
+	void LuaAllocator::AddToPool(Pool& pool, Page* page)
+	{
+		page->m_poolPrevious = nullptr;
+		page->m_poolNext = pool.m_pages;
+		if (pool.m_pages)
+		{
+			pool.m_pages->m_poolPrevious = page;
+		}
+		pool.m_pages = page;
+	}
+
+	void LuaAllocator::RemoveFromPool(Pool& pool, Page* page)
+	{
+		if (page->m_poolPrevious)
+		{
+			page->m_poolPrevious->m_poolNext = page->m_poolNext;
+		}
+		else
+		{
+			pool.m_pages = page->m_poolNext;
+		}
+
+		if (page->m_poolNext)
+		{
+			page->m_poolNext->m_poolPrevious = page->m_poolPrevious;
+		}
+	}
+
+	void LuaAllocator::CountAllocation(uint32_t owner, size_t size)
+	{
+		ScriptMemoryStats& stats = m_ownerStats[owner];
+		stats.LiveBytes += size;
+		stats.PeakBytes = std::max(stats.PeakBytes, stats.LiveBytes);
+		m_frameAllocations[owner]++;
+		m_frameAllocatedBytes[owner] += size;
+
+		m_total.LiveBytes += size;
+		m_total.PeakBytes = std::max(m_total.PeakBytes, m_total.LiveBytes);
+	}
+
+	void LuaAllocator::CountFree(uint32_t owner, size_t size)
+	{
+		m_ownerStats[owner].LiveBytes -= size;
+		m_total.LiveBytes -= size;
+	}
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace rhombus
+{
+	struct ScriptMemoryStats
+	{
+		std::string Name;
+		size_t LiveBytes = 0;
+		size_t PeakBytes = 0;
+		uint32_t FrameAllocations = 0;			// During the last frame
+		size_t FrameAllocatedBytes = 0;			// During the last frame
+	};
+
+	// Allocator for a Lua state. Small blocks come from pages split into a few size classes, so the many small
+	// strings, tables and closures Lua makes don't each go to the system allocator. Every page belongs to a single
+	// owner, a script or the engine for anything else, so the memory in use can be counted per script without a
+	// header on each block. A page whose blocks have all been freed goes back to a pool shared by every owner and
+	// size class of the state
+	class LuaAllocator
+	{
+	public:
+		static constexpr uint32_t ENGINE_OWNER = 0;
+		static constexpr uint32_t MAX_OWNERS = 64;
+
+		LuaAllocator();
+		~LuaAllocator();
+
+		LuaAllocator(const LuaAllocator&) = delete;
+		LuaAllocator& operator=(const LuaAllocator&) = delete;
+
+		// The lua_Alloc function, userData is the allocator
+		static void* Allocate(void* userData, void* block, size_t oldSize, size_t newSize);
+
+		// Owners are looked up by name so a reloaded script keeps counting against the same one. Once every owner is
+		// taken the engine owner is returned
+		uint32_t RegisterOwner(const std::string& name);
+		// New blocks are counted against this owner
+		void SetOwner(uint32_t owner) { m_owner = owner; }
+		uint32_t GetOwner() const { return m_owner; }
+
+		size_t GetLiveBytes() const { return m_total.LiveBytes; }
+		// Pages taken from the system so far, and how many of them are empty and waiting to be reused
+		uint32_t GetPageCount() const { return m_pageCount; }
+		uint32_t GetFreePageCount() const { return m_freePageCount; }
+		const ScriptMemoryStats& GetStats() const { return m_total; }
+		void GetOwnerStats(std::vector<ScriptMemoryStats>& stats) const;
+
+		// Moves this frame's allocation counts into the last frame ones
+		void EndFrame();
+
+	private:
+		static constexpr size_t PAGE_SIZE = 16 * 1024;
+		static constexpr size_t LARGE_BLOCK_HEADER_SIZE = 16;		// Keeps large blocks 16 byte aligned
+		static constexpr uint32_t SIZE_CLASS_COUNT = 8;
+		static constexpr size_t s_sizeClasses[SIZE_CLASS_COUNT] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+		struct FreeBlock
+		{
+			FreeBlock* m_next;
+		};
+
+		// At the start of every page, pages are aligned to PAGE_SIZE so a block finds its page by masking
+		struct alignas(16) Page
+		{
+			Page* m_next;						// Every page, so they can be given back to the system
+			Page* m_poolNext;					// In its pool while it has room, or in the free pages while empty
+			Page* m_poolPrevious;
+			FreeBlock* m_freeList;
+			char* m_bump;						// Space not yet handed out
+			uint32_t m_owner;
+			uint32_t m_sizeClass;
+			uint32_t m_usedBlocks;
+		};
+
+		// Blocks of one size class for one owner
+		struct Pool
+		{
+			Page* m_pages = nullptr;			// The pages with room, blocks come from the first
+		};
+
+		static uint32_t GetSizeClass(size_t size);
+		static uint32_t GetBlockOwner(const void* block, size_t size);
+		static Page* GetPage(const void* block) { return (Page*)((uintptr_t)block & ~(uintptr_t)(PAGE_SIZE - 1)); }
+		static bool IsFull(const Page* page) { return !page->m_freeList && page->m_bump + s_sizeClasses[page->m_sizeClass] > (const char*)page + PAGE_SIZE; }
+
+		// A shrinking block can use the reserve page, Lua expects shrinking never to fail
+		void* AllocateBlock(size_t size, bool useReserve = false);
+		void ReleaseBlock(void* block, size_t size);
+		void* AllocateFromPool(uint32_t sizeClass, bool useReserve);
+		Page* TakePage(bool useReserve);
+		void AddToPool(Pool& pool, Page* page);
+		void RemoveFromPool(Pool& pool, Page* page);
+
+		void CountAllocation(uint32_t owner, size_t size);
+		void CountFree(uint32_t owner, size_t size);
+
+	private:
+		Pool m_pools[MAX_OWNERS][SIZE_CLASS_COUNT];
+		Page* m_pages = nullptr;
+		Page* m_freePages = nullptr;			// The last one is only used for shrinking blocks
+		uint32_t m_pageCount = 0;
+		uint32_t m_freePageCount = 0;
+
+		uint32_t m_owner = ENGINE_OWNER;
+		uint32_t m_ownerCount = 1;
+		ScriptMemoryStats m_ownerStats[MAX_OWNERS];
+		ScriptMemoryStats m_total;
+
+		// This frame's counts, per owner and overall
+		uint32_t m_frameAllocations[MAX_OWNERS] = {};
+		size_t m_frameAllocatedBytes[MAX_OWNERS] = {};
+	};
+}
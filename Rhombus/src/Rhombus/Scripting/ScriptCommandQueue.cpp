@@ -0,0 +1,111 @@
+#include "rbpch.h"
+#include "ScriptCommandQueue.h"
+#include "ScriptEngine.h"
+
+#include "Rhombus/ECS/Components/TransformComponent.h"
+
+namespace rhombus
+{
+	static thread_local ScriptCommandQueue* t_currentQueue = nullptr;
+
+	ScriptCommandQueue* ScriptCommandQueue::GetCurrent()
+	{
+		return t_currentQueue;
+	}
+
+	void ScriptCommandQueue::SetCurrent(ScriptCommandQueue* queue)
+	{
+		t_currentQueue = queue;
+	}
+
+	void ScriptCommandQueue::SetPosition(Entity entity, const Vec3& position)
+	{
+		AddEntityCommand(CommandType::SetPosition, entity, position);
+	}
+
+	void ScriptCommandQueue::Translate(Entity entity, const Vec2& translation)
+	{
+		AddEntityCommand(CommandType::Translate, entity, Vec3(translation.x, translation.y, 0.0f));
+	}
+
+	void ScriptCommandQueue::ApplyLinearImpulse(Entity entity, const Vec2& impulse)
+	{
+		AddEntityCommand(CommandType::ApplyLinearImpulse, entity, Vec3(impulse.x, impulse.y, 0.0f));
+	}
+
+	void ScriptCommandQueue::LogDebug(const std::string& message)
+	{
+		AddMessage(CommandType::LogDebug, message);
+	}
+
+	void ScriptCommandQueue::LogWarning(const std::string& message)
+	{
+		AddMessage(CommandType::LogWarning, message);
+	}
+
+	void ScriptCommandQueue::LogError(const std::string& message)
+	{
+		AddMessage(CommandType::LogError, message);
+	}
+
+	void ScriptCommandQueue::Execute(Scene* scene)
+	{
+		uint32_t messageIndex = 0;
+		for (const Command& command : m_commands)
+		{
+			switch (command.m_type)
+			{
+			case CommandType::LogDebug:
+				Log::Debug("%s", m_messages[messageIndex++].c_str());
+				continue;
+			case CommandType::LogWarning:
+				Log::Warn("%s", m_messages[messageIndex++].c_str());
+				continue;
+			case CommandType::LogError:
+				Log::Error("%s", m_messages[messageIndex++].c_str());
+				continue;
+			default:
+				break;
+			}
+
+			if (!scene || scene->GetRegistry().GetEntityGeneration(command.m_entity) != command.m_generation)
+			{
+				continue;
+			}
+
+			Entity entity(command.m_entity, scene);
+			switch (command.m_type)
+			{
+			case CommandType::SetPosition:
+				entity.GetComponent<TransformComponent>().SetPosition(command.m_value);
+				break;
+			case CommandType::Translate:
+			{
+				TransformComponent& transformComponent = entity.GetComponent<TransformComponent>();
+				transformComponent.SetPosition(transformComponent.GetPosition() + command.m_value);
+				break;
+			}
+			case CommandType::ApplyLinearImpulse:
+				scene->ApplyLinearImpulse(entity, Vec2(command.m_value.x, command.m_value.y));
+				break;
+			default:
+				break;
+			}
+		}
+
+		m_commands.clear();
+		m_messages.clear();
+	}
+
+	void ScriptCommandQueue::AddEntityCommand(CommandType type, Entity entity, const Vec3& value)
+	{
+		Scene* scene = ScriptEngine::GetSceneContext();
+		m_commands.push_back({ type, entity, scene->GetRegistry().GetEntityGeneration(entity), value });
+	}
+
+	void ScriptCommandQueue::AddMessage(CommandType type, const std::string& message)
+	{
+		m_commands.push_back({ type, INVALID_ENTITY, 0, Vec3() });
+		m_messages.push_back(message);
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Rhombus/Scenes/Entity.h"
+
+namespace rhombus
+{
+	// Changes to engine state made by scripts running on a worker, applied in the order they were made once the
+	// workers are done. Messages are logged from the main thread at the same point
+	class ScriptCommandQueue
+	{
+	public:
+		// The queue of the scripts running on this thread, null where changes are made straight away
+		static ScriptCommandQueue* GetCurrent();
+		static void SetCurrent(ScriptCommandQueue* queue);
+
+		void SetPosition(Entity entity, const Vec3& position);
+		void Translate(Entity entity, const Vec2& translation);
+		void ApplyLinearImpulse(Entity entity, const Vec2& impulse);
+
+		void LogDebug(const std::string& message);
+		void LogWarning(const std::string& message);
+		void LogError(const std::string& message);
+
+		// Entities destroyed since their commands were queued are skipped
+		void Execute(Scene* scene);
+
+		bool IsEmpty() const { return m_commands.empty(); }
+
+	private:
+		enum class CommandType
+		{
+			SetPosition,
+			Translate,
+			ApplyLinearImpulse,
+			LogDebug,
+			LogWarning,
+			LogError
+		};
+
+		struct Command
+		{
+			CommandType m_type;
+			EntityID m_entity;
+			uint32_t m_generation;
+			Vec3 m_value;
+		};
+
+		void AddEntityCommand(CommandType type, Entity entity, const Vec3& value);
+		void AddMessage(CommandType type, const std::string& message);
+
+	private:
+		std::vector<Command> m_commands;
+		std::vector<std::string> m_messages;		// Messages of the log commands, in order
+	};
+}
@@ -1,8 +1,12 @@
 #include "rbpch.h"
 #include "ScriptEngine.h"
 #include "ScriptGlue.h"
+#include "ScriptProfiler.h"
+#include "ScriptCommandQueue.h"
+#include "ScriptScheduler.h"
 
 #include "Rhombus/Core/Log.h"
+#include "Rhombus/Core/JobSystem.h"
 #include "Rhombus/Project/Project.h"
 #include "Rhombus/ECS/Components/ScriptComponent.h"
 
@@ -15,20 +19,509 @@ extern "C"
 
 namespace rhombus
 {
-	static lua_State* L = nullptr;
+	// A Lua state with its allocator and garbage collection progress
+	struct ScriptState
+	{
+		lua_State* m_state = nullptr;
+		Scope<LuaAllocator> m_allocator;
+		ScriptGarbageCollectionStats m_gcStats;
+		bool m_gcCycleInProgress = false;
+		size_t m_liveBytesAfterCycle = 0;
+		bool m_warnedOverMemoryBudget = false;
+
+		// Only used by the parallel states
+		ScriptCommandQueue m_commands;
+		struct CallTime
+		{
+			uint32_t m_profileIndex;
+			uint32_t m_calls;
+			double m_totalMs;
+			double m_maxMs;
+		};
+		std::vector<CallTime> m_callTimes;			// For the profiler, from the last parallel update
+	};
+
+	// Every script runs in the main state. Scripts marked ThreadSafe have their entities spread over the parallel
+	// states instead, which are updated at the same time across the job system's workers
+	static ScriptState s_mainState;
+	static std::vector<Scope<ScriptState>> s_parallelStates;
+
+	static lua_State* L = nullptr;							// The main state's
 	static Scene* sceneContext = nullptr;
 
+	static size_t s_memoryBudget = 64 * 1024 * 1024;		// For each state
+	// Over every state, the main state's own when there are no parallel states
+	static ScriptGarbageCollectionStats s_gcStats;
+	static ScriptMemoryStats s_memoryStats;
+
+	// Like Lua's own collector, a new cycle isn't started until memory has grown by this much since the last one
+	static constexpr size_t GC_PAUSE_PERCENT = 200;
+	static constexpr int GC_STEP_SIZE_LOG2 = 10;
+
+	// Every check reads the write time of every script file, so they are spaced out rather than done each frame
+	static constexpr float SCRIPT_RELOAD_CHECK_SECONDS = 0.5f;
+	static float s_reloadCheckTimer = 0.0f;
+
+	enum ScriptCallback
+	{
+		SCRIPT_CALLBACK_INIT = 0,
+		SCRIPT_CALLBACK_UPDATE,
+		SCRIPT_CALLBACK_MOUSE_ENTER_AREA,
+		SCRIPT_CALLBACK_MOUSE_EXIT_AREA,
+		SCRIPT_CALLBACK_MOUSE_BUTTON_PRESSED,
+		SCRIPT_CALLBACK_MOUSE_BUTTON_RELEASED,
+		SCRIPT_CALLBACK_UPDATE_ALL,
+		SCRIPT_CALLBACK_RUN,
+		SCRIPT_CALLBACK_COUNT
+	};
+
+	static const char* s_scriptCallbackNames[SCRIPT_CALLBACK_COUNT] =
+	{
+		"Init", "Update", "OnMouseEnterArea", "OnMouseExitArea", "OnMouseButtonPressed", "OnMouseButtonReleased", "UpdateAll", "Run"
+	};
+
+	// A script file that has been run in one state, with registry references to its callbacks so calling into it
+	// needs no lookups by name
+	struct ScriptClass
+	{
+		std::string m_name;
+		std::filesystem::path m_path;
+		std::filesystem::file_time_type m_lastWriteTime;
+		ScriptState* m_scriptState = nullptr;
+		int m_classRef = LUA_NOREF;
+		int m_metatableRef = LUA_NOREF;							// Shared by the instances, __index is the class table
+		int m_callbackRefs[SCRIPT_CALLBACK_COUNT];				// LUA_NOREF if the script doesn't define it
+		uint32_t m_allocatorOwner = LuaAllocator::ENGINE_OWNER;	// What the script allocates is counted against this
+		uint32_t m_profileIndex = 0;							// Of the profile for the first callback
+
+		// Array of the instance tables, in the same order as m_entities. Given to UpdateAll
+		int m_instancesRef = LUA_NOREF;
+		std::vector<EntityID> m_entities;
+
+		// Only in the main state. When the script is marked ThreadSafe, the class as loaded into each parallel state
+		// and the compiled chunk they are loaded from
+		bool m_threadSafe = false;
+		std::vector<ScriptClass> m_parallelClasses;
+		std::string m_bytecode;
+	};
+
+	// Loaded once per run of the scene, by script name
+	static std::unordered_map<std::string, ScriptClass> s_scriptClasses;
+
+	// Counts what Lua allocates while it is in scope against the owner
+	struct ScriptMemoryOwnerScope
+	{
+		LuaAllocator& m_allocator;
+		uint32_t m_previousOwner;
+
+		ScriptMemoryOwnerScope(LuaAllocator& allocator, uint32_t owner)
+			: m_allocator(allocator), m_previousOwner(allocator.GetOwner())
+		{
+			m_allocator.SetOwner(owner);
+		}
+
+		~ScriptMemoryOwnerScope()
+		{
+			m_allocator.SetOwner(m_previousOwner);
+		}
+	};
+
+	static int OnLuaPanic(lua_State* state)
+	{
+		const char* message = lua_tostring(state, -1);
+		Log::Error("[Lua Panic] %s", message ? message : "unknown error");
+		return 0;
+	}
+
 	bool CheckLua(lua_State* state, int r)
 	{
 		if (r != LUA_OK)
 		{
 			std::string errormsg = lua_tostring(state, -1);
-			Log::Error("[Lua Error] %s", errormsg);
+			lua_pop(state, 1);
+
+			// Logging isn't safe from the workers, their errors are logged at the sync point
+			if (ScriptCommandQueue* commands = ScriptCommandQueue::GetCurrent())
+			{
+				commands->LogError("[Lua Error] " + errormsg);
+			}
+			else
+			{
+				Log::Error("[Lua Error] %s", errormsg.c_str());
+			}
+			return false;
+		}
+		return true;
+	}
+
+	static int WriteBytecode(lua_State*, const void* data, size_t size, void* userData)
+	{
+		((std::string*)userData)->append((const char*)data, size);
+		return 0;
+	}
+
+	static void InitScriptState(ScriptState& scriptState)
+	{
+		scriptState.m_allocator = CreateScope<LuaAllocator>();
+		scriptState.m_state = lua_newstate(LuaAllocator::Allocate, scriptState.m_allocator.get());
+		lua_atpanic(scriptState.m_state, OnLuaPanic);
+
+		// Garbage is only collected in CollectGarbage, within the time given to it each frame. Steps are made smaller
+		// than Lua's default so the budget can be kept to more closely
+		lua_gc(scriptState.m_state, LUA_GCSTOP);
+		lua_gc(scriptState.m_state, LUA_GCINC, 0, 0, GC_STEP_SIZE_LOG2);
+		scriptState.m_gcStats = {};
+		scriptState.m_gcCycleInProgress = false;
+		scriptState.m_liveBytesAfterCycle = 0;
+
+		luaL_openlibs(scriptState.m_state);
+		ScriptGlue::RegisterFunctions(scriptState.m_state);
+	}
+
+	static void ShutdownScriptState(ScriptState& scriptState)
+	{
+		lua_close(scriptState.m_state);
+		scriptState.m_state = nullptr;
+		scriptState.m_allocator.reset();
+	}
+
+	// Runs the script and takes the callbacks from the class table it defines. The previous callbacks are kept if it
+	// fails. Classes in the main state load the file and keep the compiled chunk, the parallel states load the chunk
+	static bool RunScriptClass(ScriptClass& scriptClass, const std::string* bytecode = nullptr)
+	{
+		lua_State* state = scriptClass.m_scriptState->m_state;
+		ScriptMemoryOwnerScope ownerScope(*scriptClass.m_scriptState->m_allocator, scriptClass.m_allocatorOwner);
+
+		if (bytecode)
+		{
+			const std::string chunkName = "@" + scriptClass.m_path.string();
+			if (!CheckLua(state, luaL_loadbufferx(state, bytecode->data(), bytecode->size(), chunkName.c_str(), "b")))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			std::error_code error;
+			scriptClass.m_lastWriteTime = std::filesystem::last_write_time(scriptClass.m_path, error);
+
+			if (!CheckLua(state, luaL_loadfile(state, scriptClass.m_path.string().c_str())))
+			{
+				return false;
+			}
+
+			if (!s_parallelStates.empty())
+			{
+				scriptClass.m_bytecode.clear();
+				lua_dump(state, WriteBytecode, &scriptClass.m_bytecode, 0);
+			}
+		}
+
+		if (!CheckLua(state, lua_pcall(state, 0, 0, 0)))
+		{
 			return false;
 		}
+
+		if (lua_getglobal(state, scriptClass.m_name.c_str()) != LUA_TTABLE)
+		{
+			Log::Error("[Lua Error] %s doesn't define the table %s", scriptClass.m_path.string().c_str(), scriptClass.m_name.c_str());
+			lua_pop(state, 1);
+			return false;
+		}
+
+		for (int i = 0; i < SCRIPT_CALLBACK_COUNT; i++)
+		{
+			luaL_unref(state, LUA_REGISTRYINDEX, scriptClass.m_callbackRefs[i]);
+			scriptClass.m_callbackRefs[i] = LUA_NOREF;
+
+			if (lua_getfield(state, -1, s_scriptCallbackNames[i]) == LUA_TFUNCTION)
+			{
+				scriptClass.m_callbackRefs[i] = luaL_ref(state, LUA_REGISTRYINDEX);
+			}
+			else
+			{
+				lua_pop(state, 1);
+			}
+		}
+
+		luaL_unref(state, LUA_REGISTRYINDEX, scriptClass.m_classRef);
+		lua_pushvalue(state, -1);
+		scriptClass.m_classRef = luaL_ref(state, LUA_REGISTRYINDEX);
+
+		// Pointing the shared metatable at the new class table carries a reload over to the instances that already exist
+		lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass.m_metatableRef);
+		lua_insert(state, -2);
+		lua_setfield(state, -2, "__index");
+		lua_pop(state, 1);
 		return true;
 	}
 
+	static void InitScriptClass(ScriptClass& scriptClass, const std::string& scriptName, ScriptState& scriptState)
+	{
+		lua_State* state = scriptState.m_state;
+
+		scriptClass.m_name = scriptName;
+		scriptClass.m_path = Project::GetScriptDirectory() / (scriptName + ".lua");
+		scriptClass.m_scriptState = &scriptState;
+		std::fill(std::begin(scriptClass.m_callbackRefs), std::end(scriptClass.m_callbackRefs), LUA_NOREF);
+		scriptClass.m_allocatorOwner = scriptState.m_allocator->RegisterOwner(scriptName);
+		scriptClass.m_profileIndex = ScriptProfiler::RegisterScript(scriptName, s_scriptCallbackNames, SCRIPT_CALLBACK_COUNT);
+
+		lua_createtable(state, 0, 1);
+		scriptClass.m_metatableRef = luaL_ref(state, LUA_REGISTRYINDEX);
+		lua_createtable(state, 0, 0);
+		scriptClass.m_instancesRef = luaL_ref(state, LUA_REGISTRYINDEX);
+	}
+
+	static bool IsMarkedThreadSafe(const ScriptClass& scriptClass)
+	{
+		if (scriptClass.m_classRef == LUA_NOREF)
+		{
+			return false;
+		}
+
+		lua_rawgeti(L, LUA_REGISTRYINDEX, scriptClass.m_classRef);
+		lua_getfield(L, -1, "ThreadSafe");
+		const bool threadSafe = lua_toboolean(L, -1);
+		lua_pop(L, 2);
+		return threadSafe;
+	}
+
+	static ScriptClass* GetScriptClass(const std::string& scriptName)
+	{
+		auto it = s_scriptClasses.find(scriptName);
+		if (it != s_scriptClasses.end())
+		{
+			return &it->second;
+		}
+
+		// A script that fails to run is still kept, without callbacks, so it isn't retried until the file changes
+		ScriptClass& scriptClass = s_scriptClasses[scriptName];
+		InitScriptClass(scriptClass, scriptName, s_mainState);
+		RunScriptClass(scriptClass);
+
+		// Whether a script runs in parallel is decided when it is first loaded, changing it needs the scene restarted
+		if (!s_parallelStates.empty() && IsMarkedThreadSafe(scriptClass))
+		{
+			scriptClass.m_threadSafe = true;
+			scriptClass.m_parallelClasses.resize(s_parallelStates.size());
+			for (size_t i = 0; i < s_parallelStates.size(); i++)
+			{
+				InitScriptClass(scriptClass.m_parallelClasses[i], scriptName, *s_parallelStates[i]);
+				scriptClass.m_parallelClasses[i].m_lastWriteTime = scriptClass.m_lastWriteTime;
+				RunScriptClass(scriptClass.m_parallelClasses[i], &scriptClass.m_bytecode);
+			}
+		}
+
+		return &scriptClass;
+	}
+
+	static void ReleaseScriptClass(ScriptClass& scriptClass)
+	{
+		lua_State* state = scriptClass.m_scriptState->m_state;
+		for (int callbackRef : scriptClass.m_callbackRefs)
+		{
+			luaL_unref(state, LUA_REGISTRYINDEX, callbackRef);
+		}
+		luaL_unref(state, LUA_REGISTRYINDEX, scriptClass.m_classRef);
+		luaL_unref(state, LUA_REGISTRYINDEX, scriptClass.m_metatableRef);
+		luaL_unref(state, LUA_REGISTRYINDEX, scriptClass.m_instancesRef);
+
+		for (ScriptClass& parallelClass : scriptClass.m_parallelClasses)
+		{
+			ReleaseScriptClass(parallelClass);
+		}
+	}
+
+	static void ReleaseScriptClasses()
+	{
+		for (auto& [name, scriptClass] : s_scriptClasses)
+		{
+			ReleaseScriptClass(scriptClass);
+		}
+		s_scriptClasses.clear();
+	}
+
+	// The class whose state a new entity of the script lives in. Entities of thread safe scripts go to the parallel
+	// state with the fewest of them
+	static ScriptClass* ChooseScriptClassForEntity(ScriptClass& scriptClass)
+	{
+		if (!scriptClass.m_threadSafe)
+		{
+			return &scriptClass;
+		}
+
+		ScriptClass* chosenClass = &scriptClass.m_parallelClasses[0];
+		for (ScriptClass& parallelClass : scriptClass.m_parallelClasses)
+		{
+			if (parallelClass.m_entities.size() < chosenClass->m_entities.size())
+			{
+				chosenClass = &parallelClass;
+			}
+		}
+		return chosenClass;
+	}
+
+	// Pushes the callback and the entity's instance table as self. Returns the entity's script class, or null with
+	// nothing pushed if the entity isn't initialised or its script doesn't define the callback
+	static const ScriptClass* PushCallback(const ScriptComponent& scriptComponent, ScriptCallback callback)
+	{
+		const ScriptClass* scriptClass = (const ScriptClass*)scriptComponent.m_runtimeClass;
+		if (!scriptClass || scriptClass->m_callbackRefs[callback] == LUA_NOREF)
+		{
+			return nullptr;
+		}
+
+		lua_State* state = scriptClass->m_scriptState->m_state;
+		lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass->m_callbackRefs[callback]);
+		lua_rawgeti(state, LUA_REGISTRYINDEX, scriptComponent.m_runtimeInstance);
+		return scriptClass;
+	}
+
+	// Calls the pushed callback with argCount arguments, counting what it allocates against the script class and
+	// timing it for the profiler. Main thread only
+	static void CallScript(const ScriptClass& scriptClass, ScriptCallback callback, int argCount)
+	{
+		ScriptMemoryOwnerScope ownerScope(*scriptClass.m_scriptState->m_allocator, scriptClass.m_allocatorOwner);
+		ScriptProfiler::CallScope profileScope(scriptClass.m_profileIndex + callback);
+		CheckLua(scriptClass.m_scriptState->m_state, lua_pcall(scriptClass.m_scriptState->m_state, argCount, 0, 0));
+	}
+
+	// Runs on a worker. Calls Update on every instance of the thread safe scripts in the state, or UpdateAll once for
+	// the scripts that define it
+	static void UpdateParallelState(ScriptState& scriptState, uint32_t stateIndex, DeltaTime dt)
+	{
+		lua_State* state = scriptState.m_state;
+		ScriptCommandQueue::SetCurrent(&scriptState.m_commands);
+		scriptState.m_callTimes.clear();
+
+		// Timing every call costs two clock reads per entity, only worth it when someone is looking
+		const bool timeCalls = ScriptProfiler::IsEnabled();
+
+		for (auto& [name, rootClass] : s_scriptClasses)
+		{
+			if (!rootClass.m_threadSafe)
+			{
+				continue;
+			}
+
+			const ScriptClass& scriptClass = rootClass.m_parallelClasses[stateIndex];
+			const uint32_t entityCount = (uint32_t)scriptClass.m_entities.size();
+			if (entityCount == 0)
+			{
+				continue;
+			}
+
+			ScriptMemoryOwnerScope ownerScope(*scriptState.m_allocator, scriptClass.m_allocatorOwner);
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			ScriptCallback callback;
+			uint32_t calls = 0;
+			double maxMs = 0.0;
+			if (scriptClass.m_callbackRefs[SCRIPT_CALLBACK_UPDATE_ALL] != LUA_NOREF)
+			{
+				callback = SCRIPT_CALLBACK_UPDATE_ALL;
+				calls = 1;
+				lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass.m_callbackRefs[SCRIPT_CALLBACK_UPDATE_ALL]);
+				lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass.m_classRef);
+				lua_pushnumber(state, (float)dt);
+				lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass.m_instancesRef);
+				CheckLua(state, lua_pcall(state, 3, 0, 0));
+			}
+			else if (scriptClass.m_callbackRefs[SCRIPT_CALLBACK_UPDATE] != LUA_NOREF)
+			{
+				callback = SCRIPT_CALLBACK_UPDATE;
+				calls = entityCount;
+				lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass.m_instancesRef);
+				for (uint32_t i = 1; i <= entityCount; i++)
+				{
+					const std::chrono::steady_clock::time_point callStart = timeCalls ? std::chrono::steady_clock::now() : start;
+
+					lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass.m_callbackRefs[SCRIPT_CALLBACK_UPDATE]);
+					lua_rawgeti(state, -2, (lua_Integer)i);
+					lua_pushnumber(state, (float)dt);
+					CheckLua(state, lua_pcall(state, 2, 0, 0));
+
+					if (timeCalls)
+					{
+						maxMs = std::max(maxMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - callStart).count());
+					}
+				}
+				lua_pop(state, 1);
+			}
+			else
+			{
+				continue;
+			}
+
+			const double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (calls == 1)
+			{
+				maxMs = totalMs;
+			}
+			scriptState.m_callTimes.push_back({ scriptClass.m_profileIndex + callback, calls, totalMs, maxMs });
+		}
+
+		ScriptCommandQueue::SetCurrent(nullptr);
+	}
+
+	static void CollectStateGarbage(ScriptState& scriptState, float budgetMilliseconds)
+	{
+		lua_State* state = scriptState.m_state;
+		LuaAllocator& allocator = *scriptState.m_allocator;
+		ScriptGarbageCollectionStats& gcStats = scriptState.m_gcStats;
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const std::chrono::steady_clock::time_point end = start + std::chrono::microseconds((int64_t)(budgetMilliseconds * 1000.0f));
+
+		gcStats.Steps = 0;
+
+		const size_t liveBytes = allocator.GetLiveBytes();
+		if (liveBytes > s_memoryBudget && liveBytes > scriptState.m_liveBytesAfterCycle)
+		{
+			lua_gc(state, LUA_GCCOLLECT);
+			gcStats.Cycles++;
+			gcStats.FullCollections++;
+			scriptState.m_gcCycleInProgress = false;
+			scriptState.m_liveBytesAfterCycle = allocator.GetLiveBytes();
+
+			// Only worth a warning if there is more in use than the budget allows, not just garbage
+			if (scriptState.m_liveBytesAfterCycle > s_memoryBudget && !scriptState.m_warnedOverMemoryBudget)
+			{
+				char message[128];
+				snprintf(message, sizeof(message), "Lua is using %u KB after a full collection, over its budget of %u KB",
+					(uint32_t)(scriptState.m_liveBytesAfterCycle / 1024), (uint32_t)(s_memoryBudget / 1024));
+				if (ScriptCommandQueue* commands = ScriptCommandQueue::GetCurrent())
+				{
+					commands->LogWarning(message);
+				}
+				else
+				{
+					Log::Warn("%s", message);
+				}
+				scriptState.m_warnedOverMemoryBudget = true;
+			}
+		}
+		else if (scriptState.m_gcCycleInProgress || liveBytes >= scriptState.m_liveBytesAfterCycle * GC_PAUSE_PERCENT / 100)
+		{
+			scriptState.m_gcCycleInProgress = true;
+			do
+			{
+				gcStats.Steps++;
+				if (lua_gc(state, LUA_GCSTEP, 0))
+				{
+					gcStats.Cycles++;
+					scriptState.m_gcCycleInProgress = false;
+					scriptState.m_liveBytesAfterCycle = allocator.GetLiveBytes();
+					break;
+				}
+			} while (std::chrono::steady_clock::now() < end);
+		}
+
+		gcStats.TimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		allocator.EndFrame();
+	}
+
 	void ScriptEngine::Init()
 	{
 		InitLua();
@@ -36,16 +529,15 @@ namespace rhombus
 
 	void ScriptEngine::Shutdown()
 	{
+		SetParallelStateCount(0);
 		ShutdownLua();
-		delete L;
 	}
 
 	void ScriptEngine::InitLua()
 	{
-		L = luaL_newstate();
-		luaL_openlibs(L);
-
-		ScriptGlue::RegisterFunctions(L);
+		InitScriptState(s_mainState);
+		L = s_mainState.m_state;
+		ScriptProfiler::Init(L);
 
 #if 0
 		int r = luaL_dofile(L, "Resources/Scripts/Main.lua");
@@ -123,10 +615,34 @@ namespace rhombus
 
 	void ScriptEngine::ShutdownLua()
 	{
-		lua_close(L);
+		ScriptProfiler::Shutdown();
+		ShutdownScriptState(s_mainState);
 		L = nullptr;
 	}
 
+	void ScriptEngine::SetParallelStateCount(uint32_t count)
+	{
+		Log::Assert(!sceneContext, "The number of parallel Lua states can't change while a scene is running");
+
+		while (s_parallelStates.size() > count)
+		{
+			ShutdownScriptState(*s_parallelStates.back());
+			s_parallelStates.pop_back();
+		}
+
+		while (s_parallelStates.size() < count)
+		{
+			Scope<ScriptState> scriptState = CreateScope<ScriptState>();
+			InitScriptState(*scriptState);
+			s_parallelStates.push_back(std::move(scriptState));
+		}
+	}
+
+	uint32_t ScriptEngine::GetParallelStateCount()
+	{
+		return (uint32_t)s_parallelStates.size();
+	}
+
 	void ScriptEngine::OnRuntimeStart(Scene* scene)
 	{
 		sceneContext = scene;
@@ -134,23 +650,56 @@ namespace rhombus
 
 	void ScriptEngine::OnRuntimeStop()
 	{
+		if (sceneContext)
+		{
+			std::vector<EntityID> view = sceneContext->GetAllEntitiesWith<ScriptComponent>();
+			for (auto e : view)
+			{
+				OnDestroyEntity({ e, sceneContext });
+			}
+		}
+
+		ScriptScheduler::Clear();
+		ReleaseScriptClasses();
+		ScriptGlue::ResetEntityHandles(L);
+		for (Scope<ScriptState>& scriptState : s_parallelStates)
+		{
+			ScriptGlue::ResetEntityHandles(scriptState->m_state);
+		}
 		sceneContext = nullptr;
 	}
 
-	void ScriptEngine::SetupEntity(Entity entity)
+	void ScriptEngine::ReloadChangedScripts(DeltaTime dt)
 	{
-		const auto& scriptComponent = entity.GetComponent<ScriptComponent>();
-
-		lua_getglobal(L, scriptComponent.m_scriptName.c_str());
-		UUID entityID = entity.GetUUID();
-		uint32_t entityID32a = (uint32_t)((entityID & 0xFFFFFFFF00000000LL) >> 32);
-		uint32_t entityID32b = (uint32_t)(entityID & 0xFFFFFFFFLL);
+		s_reloadCheckTimer += dt;
+		if (s_reloadCheckTimer < SCRIPT_RELOAD_CHECK_SECONDS)
+		{
+			return;
+		}
+		s_reloadCheckTimer = 0.0f;
 
-		lua_pushnumber(L, (int)entityID32a);
-		lua_setfield(L, -2, "entityIDa");
+		for (auto& [name, scriptClass] : s_scriptClasses)
+		{
+			std::error_code error;
+			const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(scriptClass.m_path, error);
+			if (!error && lastWriteTime != scriptClass.m_lastWriteTime)
+			{
+				Log::Info("Reloading script %s", scriptClass.m_path.string().c_str());
+				if (RunScriptClass(scriptClass))
+				{
+					for (ScriptClass& parallelClass : scriptClass.m_parallelClasses)
+					{
+						RunScriptClass(parallelClass, &scriptClass.m_bytecode);
+					}
+				}
+			}
+		}
+	}
 
-		lua_pushnumber(L, (int)entityID32b);
-		lua_setfield(L, -2, "entityIDb");
+	void ScriptEngine::SetupEntity(Entity entity)
+	{
+		ScriptGlue::PushEntity(L, entity);
+		lua_setfield(L, -2, "entity");
 	}
 
 	bool ScriptEngine::DoScript(std::string sciptPath)
@@ -244,23 +793,37 @@ namespace rhombus
 
 	void ScriptEngine::OnInitEntity(Entity entity)
 	{
-		const auto& scriptComponent = entity.GetComponent<ScriptComponent>();
-		
-		// Todo set path in component
-		std::string sciptPath = Project::GetScriptDirectory().string() + "\\" + scriptComponent.m_scriptName + ".lua";
-		int r = luaL_dofile(L, sciptPath.c_str());
+		auto& scriptComponent = entity.GetComponent<ScriptComponent>();
+		ScriptClass* scriptClass = ChooseScriptClassForEntity(*GetScriptClass(scriptComponent.m_scriptName));
+		lua_State* state = scriptClass->m_scriptState->m_state;
+		ScriptMemoryOwnerScope ownerScope(*scriptClass->m_scriptState->m_allocator, scriptClass->m_allocatorOwner);
 
-		if (CheckLua(L, r))
+		// Each entity gets its own table as self, which falls back on the class table for functions and defaults
+		lua_createtable(state, 0, 1);
+		ScriptGlue::PushEntity(state, entity);
+		lua_setfield(state, -2, "entity");
+		lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass->m_metatableRef);
+		lua_setmetatable(state, -2);
+
+		lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass->m_instancesRef);
+		lua_pushvalue(state, -2);
+		lua_rawseti(state, -2, (lua_Integer)scriptClass->m_entities.size() + 1);
+		lua_pop(state, 1);
+
+		scriptComponent.m_runtimeInstance = luaL_ref(state, LUA_REGISTRYINDEX);
+		scriptComponent.m_runtimeClass = scriptClass;
+		scriptComponent.m_runtimeIndex = (uint32_t)scriptClass->m_entities.size();
+		scriptClass->m_entities.push_back(entity);
+
+		// Init and Run start on the main thread for every script, thread safe or not
+		if (PushCallback(scriptComponent, SCRIPT_CALLBACK_INIT))
 		{
-			SetupEntity(entity);
+			CallScript(*scriptClass, SCRIPT_CALLBACK_INIT, 1);
+		}
 
-			lua_getglobal(L, scriptComponent.m_scriptName.c_str());
-			lua_getfield(L, -1, "Init");
-			if (lua_isfunction(L, -1))
-			{
-				lua_pushvalue(L, -2);
-				CheckLua(L, lua_pcall(L, 1, 0, 0));
-			}
+		if (PushCallback(scriptComponent, SCRIPT_CALLBACK_RUN))
+		{
+			ScriptScheduler::Start(state, entity, 1);
 		}
 	}
 
@@ -268,129 +831,241 @@ namespace rhombus
 	{
 		const auto& scriptComponent = entity.GetComponent<ScriptComponent>();
 
-		// Todo set path in component
-		std::string sciptPath = Project::GetScriptDirectory().string() + "\\" + scriptComponent.m_scriptName + ".lua";
-		int r = luaL_dofile(L, sciptPath.c_str());
+		// Added since the runtime started
+		if (!scriptComponent.m_runtimeClass)
+		{
+			OnInitEntity(entity);
+		}
 
-		if (CheckLua(L, r))
+		// Updated with the rest of its class in OnUpdateBatched or OnUpdateParallel instead
+		const ScriptClass* scriptClass = (const ScriptClass*)scriptComponent.m_runtimeClass;
+		if (scriptClass->m_scriptState != &s_mainState || scriptClass->m_callbackRefs[SCRIPT_CALLBACK_UPDATE_ALL] != LUA_NOREF)
 		{
-			SetupEntity(entity);
+			return;
+		}
 
-			lua_getglobal(L, scriptComponent.m_scriptName.c_str());
-			lua_getfield(L, -1, "Update");
-			if (lua_isfunction(L, -1))
+		if (PushCallback(scriptComponent, SCRIPT_CALLBACK_UPDATE))
+		{
+			lua_pushnumber(L, (float)dt);
+			CallScript(*scriptClass, SCRIPT_CALLBACK_UPDATE, 2);
+		}
+	}
+
+	void ScriptEngine::OnDestroyEntity(Entity entity)
+	{
+		ScriptScheduler::StopEntity(entity);
+
+		auto& scriptComponent = entity.GetComponent<ScriptComponent>();
+		if (scriptComponent.m_runtimeClass)
+		{
+			// The last instance takes the place of this one in the class's instance list
+			ScriptClass* scriptClass = (ScriptClass*)scriptComponent.m_runtimeClass;
+			lua_State* state = scriptClass->m_scriptState->m_state;
+			const uint32_t index = scriptComponent.m_runtimeIndex;
+			const uint32_t lastIndex = (uint32_t)scriptClass->m_entities.size() - 1;
+
+			lua_rawgeti(state, LUA_REGISTRYINDEX, scriptClass->m_instancesRef);
+			if (index != lastIndex)
 			{
-				lua_pushvalue(L, -2);
-				lua_pushnumber(L, (float)dt);
-				CheckLua(L, lua_pcall(L, 2, 0, 0));
+				const EntityID lastEntity = scriptClass->m_entities[lastIndex];
+				scriptClass->m_entities[index] = lastEntity;
+				sceneContext->GetRegistry().GetComponent<ScriptComponent>(lastEntity).m_runtimeIndex = index;
+
+				lua_rawgeti(state, -1, (lua_Integer)lastIndex + 1);
+				lua_rawseti(state, -2, (lua_Integer)index + 1);
 			}
+			lua_pushnil(state);
+			lua_rawseti(state, -2, (lua_Integer)lastIndex + 1);
+			lua_pop(state, 1);
+			scriptClass->m_entities.pop_back();
+
+			luaL_unref(state, LUA_REGISTRYINDEX, scriptComponent.m_runtimeInstance);
+			scriptComponent.m_runtimeInstance = LUA_NOREF;
+			scriptComponent.m_runtimeClass = nullptr;
 		}
 	}
 
-	Scene* ScriptEngine::GetSceneContext()
+	void ScriptEngine::OnUpdateBatched(DeltaTime dt)
 	{
-		return sceneContext;
+		for (auto& [name, scriptClass] : s_scriptClasses)
+		{
+			const int updateAllRef = scriptClass.m_callbackRefs[SCRIPT_CALLBACK_UPDATE_ALL];
+			if (updateAllRef == LUA_NOREF || scriptClass.m_entities.empty())
+			{
+				continue;
+			}
+
+			lua_rawgeti(L, LUA_REGISTRYINDEX, updateAllRef);
+			lua_rawgeti(L, LUA_REGISTRYINDEX, scriptClass.m_classRef);
+			lua_pushnumber(L, (float)dt);
+			lua_rawgeti(L, LUA_REGISTRYINDEX, scriptClass.m_instancesRef);
+			CallScript(scriptClass, SCRIPT_CALLBACK_UPDATE_ALL, 3);
+		}
 	}
 
-	void ScriptEngine::OnMouseEnterArea(Entity entity)
+	void ScriptEngine::OnUpdateParallel(DeltaTime dt)
 	{
-		if (entity.HasComponent<ScriptComponent>())
+		const bool hasThreadSafeScripts = std::any_of(s_scriptClasses.begin(), s_scriptClasses.end(),
+			[](const auto& scriptClass) { return scriptClass.second.m_threadSafe; });
+		if (!sceneContext || !hasThreadSafeScripts)
 		{
-			const auto& scriptComponent = entity.GetComponent<ScriptComponent>();
+			return;
+		}
 
-			// Todo set path in component
-			std::string sciptPath = Project::GetScriptDirectory().string() + "\\" + scriptComponent.m_scriptName + ".lua";
-			int r = luaL_dofile(L, sciptPath.c_str());
+		RB_PROFILE_FUNCTION();
 
-			if (CheckLua(L, r))
+		// Brought up to date here as the workers can only read it
+		sceneContext->Query();
+
+		JobSystem::Dispatch((uint32_t)s_parallelStates.size(), [dt](uint32_t stateIndex)
 			{
-				SetupEntity(entity);
+				UpdateParallelState(*s_parallelStates[stateIndex], stateIndex, dt);
+			});
 
-				lua_getglobal(L, scriptComponent.m_scriptName.c_str());
-				lua_getfield(L, -1, "OnMouseEnterArea");
-				if (lua_isfunction(L, -1))
-				{
-					lua_pushvalue(L, -2);
-					CheckLua(L, lua_pcall(L, 1, 0, 0));
-				}
+		// Applied in the same order every frame, however the work was split between the threads
+		for (Scope<ScriptState>& scriptState : s_parallelStates)
+		{
+			scriptState->m_commands.Execute(sceneContext);
+			for (const ScriptState::CallTime& callTime : scriptState->m_callTimes)
+			{
+				ScriptProfiler::AddCalls(callTime.m_profileIndex, callTime.m_calls, callTime.m_totalMs, callTime.m_maxMs);
 			}
 		}
 	}
 
-	void ScriptEngine::OnMouseExitArea(Entity entity)
+	void ScriptEngine::OnUpdateCoroutines(DeltaTime dt)
 	{
-		if (entity.HasComponent<ScriptComponent>())
-		{
-			const auto& scriptComponent = entity.GetComponent<ScriptComponent>();
+		ScriptScheduler::Update(dt);
+	}
+
+	Scene* ScriptEngine::GetSceneContext()
+	{
+		return sceneContext;
+	}
 
-			// Todo set path in component
-			std::string sciptPath = Project::GetScriptDirectory().string() + "\\" + scriptComponent.m_scriptName + ".lua";
-			int r = luaL_dofile(L, sciptPath.c_str());
+	void ScriptEngine::CollectGarbage(float budgetMilliseconds)
+	{
+		RB_PROFILE_FUNCTION();
 
-			if (CheckLua(L, r))
-			{
-				SetupEntity(entity);
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-				lua_getglobal(L, scriptComponent.m_scriptName.c_str());
-				lua_getfield(L, -1, "OnMouseExitArea");
-				if (lua_isfunction(L, -1))
+		if (s_parallelStates.empty())
+		{
+			CollectStateGarbage(s_mainState, budgetMilliseconds);
+			s_gcStats = s_mainState.m_gcStats;
+		}
+		else
+		{
+			// Each state collects on its own thread, the main state is index 0
+			JobSystem::Dispatch((uint32_t)s_parallelStates.size() + 1, [budgetMilliseconds](uint32_t stateIndex)
 				{
-					lua_pushvalue(L, -2);
-					CheckLua(L, lua_pcall(L, 1, 0, 0));
-				}
+					ScriptState& scriptState = stateIndex == 0 ? s_mainState : *s_parallelStates[stateIndex - 1];
+					ScriptCommandQueue::SetCurrent(&scriptState.m_commands);
+					CollectStateGarbage(scriptState, budgetMilliseconds);
+					ScriptCommandQueue::SetCurrent(nullptr);
+				});
+
+			s_gcStats = s_mainState.m_gcStats;
+			s_memoryStats = s_mainState.m_allocator->GetStats();
+			s_mainState.m_commands.Execute(sceneContext);
+			for (Scope<ScriptState>& scriptState : s_parallelStates)
+			{
+				scriptState->m_commands.Execute(sceneContext);
+
+				s_gcStats.Steps += scriptState->m_gcStats.Steps;
+				s_gcStats.Cycles += scriptState->m_gcStats.Cycles;
+				s_gcStats.FullCollections += scriptState->m_gcStats.FullCollections;
+
+				const ScriptMemoryStats& stats = scriptState->m_allocator->GetStats();
+				s_memoryStats.LiveBytes += stats.LiveBytes;
+				s_memoryStats.PeakBytes += stats.PeakBytes;
+				s_memoryStats.FrameAllocations += stats.FrameAllocations;
+				s_memoryStats.FrameAllocatedBytes += stats.FrameAllocatedBytes;
 			}
+			s_gcStats.TimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
 		}
+
+		RB_PROFILE_COUNTER("Lua Memory (KB)", GetMemoryStats().LiveBytes / 1024.0);
+		RB_PROFILE_COUNTER("Lua Allocations", GetMemoryStats().FrameAllocations);
+		RB_PROFILE_COUNTER("Lua GC (ms)", s_gcStats.TimeMs);
 	}
 
-	void ScriptEngine::OnMouseButtonPressed(Entity entity, int button)
+	void ScriptEngine::SetMemoryBudget(size_t bytes)
 	{
-		if (entity.HasComponent<ScriptComponent>())
+		s_memoryBudget = bytes;
+		s_mainState.m_warnedOverMemoryBudget = false;
+		for (Scope<ScriptState>& scriptState : s_parallelStates)
 		{
-			const auto& scriptComponent = entity.GetComponent<ScriptComponent>();
+			scriptState->m_warnedOverMemoryBudget = false;
+		}
+	}
 
-			// Todo set path in component
-			std::string sciptPath = Project::GetScriptDirectory().string() + "\\" + scriptComponent.m_scriptName + ".lua";
-			int r = luaL_dofile(L, sciptPath.c_str());
+	size_t ScriptEngine::GetMemoryBudget()
+	{
+		return s_memoryBudget;
+	}
 
-			if (CheckLua(L, r))
-			{
-				SetupEntity(entity);
+	const ScriptMemoryStats& ScriptEngine::GetMemoryStats()
+	{
+		return s_parallelStates.empty() ? s_mainState.m_allocator->GetStats() : s_memoryStats;
+	}
 
-				lua_getglobal(L, scriptComponent.m_scriptName.c_str());
-				lua_getfield(L, -1, "OnMouseButtonPressed");
-				if (lua_isfunction(L, -1))
-				{
-					lua_pushvalue(L, -2);
-					lua_pushnumber(L, button);
-					CheckLua(L, lua_pcall(L, 2, 0, 0));
-				}
+	void ScriptEngine::GetScriptMemoryStats(std::vector<ScriptMemoryStats>& stats)
+	{
+		s_mainState.m_allocator->GetOwnerStats(stats);
+
+		std::vector<ScriptMemoryStats> parallelStats;
+		for (size_t i = 0; i < s_parallelStates.size(); i++)
+		{
+			s_parallelStates[i]->m_allocator->GetOwnerStats(parallelStats);
+			for (ScriptMemoryStats& ownerStats : parallelStats)
+			{
+				ownerStats.Name += " [" + std::to_string(i) + "]";
+				stats.push_back(std::move(ownerStats));
 			}
 		}
 	}
 
-	void ScriptEngine::OnMouseButtonReleased(Entity entity, int button)
+	const ScriptGarbageCollectionStats& ScriptEngine::GetGarbageCollectionStats()
+	{
+		return s_gcStats;
+	}
+
+	void ScriptEngine::OnMouseEnterArea(Entity entity)
 	{
-		if (entity.HasComponent<ScriptComponent>())
+		const ScriptClass* scriptClass = entity.HasComponent<ScriptComponent>() ? PushCallback(entity.GetComponent<ScriptComponent>(), SCRIPT_CALLBACK_MOUSE_ENTER_AREA) : nullptr;
+		if (scriptClass)
 		{
-			const auto& scriptComponent = entity.GetComponent<ScriptComponent>();
+			CallScript(*scriptClass, SCRIPT_CALLBACK_MOUSE_ENTER_AREA, 1);
+		}
+	}
 
-			// Todo set path in component
-			std::string sciptPath = Project::GetScriptDirectory().string() + "\\" + scriptComponent.m_scriptName + ".lua";
-			int r = luaL_dofile(L, sciptPath.c_str());
+	void ScriptEngine::OnMouseExitArea(Entity entity)
+	{
+		const ScriptClass* scriptClass = entity.HasComponent<ScriptComponent>() ? PushCallback(entity.GetComponent<ScriptComponent>(), SCRIPT_CALLBACK_MOUSE_EXIT_AREA) : nullptr;
+		if (scriptClass)
+		{
+			CallScript(*scriptClass, SCRIPT_CALLBACK_MOUSE_EXIT_AREA, 1);
+		}
+	}
 
-			if (CheckLua(L, r))
-			{
-				SetupEntity(entity);
+	void ScriptEngine::OnMouseButtonPressed(Entity entity, int button)
+	{
+		const ScriptClass* scriptClass = entity.HasComponent<ScriptComponent>() ? PushCallback(entity.GetComponent<ScriptComponent>(), SCRIPT_CALLBACK_MOUSE_BUTTON_PRESSED) : nullptr;
+		if (scriptClass)
+		{
+			lua_pushnumber(scriptClass->m_scriptState->m_state, button);
+			CallScript(*scriptClass, SCRIPT_CALLBACK_MOUSE_BUTTON_PRESSED, 2);
+		}
+	}
 
-				lua_getglobal(L, scriptComponent.m_scriptName.c_str());
-				lua_getfield(L, -1, "OnMouseButtonReleased");
-				if (lua_isfunction(L, -1))
-				{
-					lua_pushvalue(L, -2);
-					lua_pushnumber(L, button);
-					CheckLua(L, lua_pcall(L, 2, 0, 0));
-				}
-			}
+	void ScriptEngine::OnMouseButtonReleased(Entity entity, int button)
+	{
+		const ScriptClass* scriptClass = entity.HasComponent<ScriptComponent>() ? PushCallback(entity.GetComponent<ScriptComponent>(), SCRIPT_CALLBACK_MOUSE_BUTTON_RELEASED) : nullptr;
+		if (scriptClass)
+		{
+			lua_pushnumber(scriptClass->m_scriptState->m_state, button);
+			CallScript(*scriptClass, SCRIPT_CALLBACK_MOUSE_BUTTON_RELEASED, 2);
 		}
 	}
 }
\ No newline at end of file
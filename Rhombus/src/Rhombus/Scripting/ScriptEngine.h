@@ -2,20 +2,40 @@
 
 #include "Rhombus/Scenes/Scene.h"
 #include "Rhombus/Scenes/Entity.h"
+#include "LuaAllocator.h"
 
 #include <list>
 
 namespace rhombus {
 
+	struct ScriptGarbageCollectionStats
+	{
+		float TimeMs = 0.0f;				// During the last frame
+		uint32_t Steps = 0;					// During the last frame
+		uint32_t Cycles = 0;				// Finished since Init
+		uint32_t FullCollections = 0;		// Done in one go because memory went over budget
+	};
+
 	class ScriptEngine
 	{
 	public:
 		static void Init();
 		static void Shutdown();
 
+		// Lua states besides the main one that scripts marked thread safe are updated in, on the job system's workers.
+		// A thread safe script sets ThreadSafe = true in its class table and has its entities spread over these states,
+		// so it can't share Lua globals between them. Can't be changed while a scene is running
+		static void SetParallelStateCount(uint32_t count);
+		static uint32_t GetParallelStateCount();
+
 		static void OnRuntimeStart(Scene* scene);
 		static void OnRuntimeStop();
 
+		// Reruns the scripts whose files have changed since they were loaded. Called every frame, the files are only
+		// looked at every half second
+		static void ReloadChangedScripts(DeltaTime dt);
+
+		// Sets the entity field of the table on top of the stack to the entity's handle
 		static void SetupEntity(Entity entity);
 
 		static bool DoScript(std::string sciptPath);
@@ -36,8 +56,20 @@ namespace rhombus {
 		static int NextKey();
 		static const char* GetKey();
 
+		// Loads the entity's script the first time it is used and gives the entity its own instance table
 		static void OnInitEntity(Entity entity);
+		// Skips entities whose script defines UpdateAll, see OnUpdateBatched, or is thread safe, see OnUpdateParallel
 		static void OnUpdateEntity(Entity entity, DeltaTime dt);
+		// Calls UpdateAll(dt, entities) once on each script class that defines it, where entities is the array of the
+		// instance tables of that class. The array belongs to the engine and must not be changed by the script
+		static void OnUpdateBatched(DeltaTime dt);
+		// Runs Update, or UpdateAll, of the thread safe scripts in every parallel state at once. Scripts there see the
+		// scene as it was before the call, what they change is applied once every state has finished
+		static void OnUpdateParallel(DeltaTime dt);
+		// Resumes the coroutines that are due, see ScriptScheduler. A script's Run(self) is started as a coroutine of
+		// the entity once Init has been called
+		static void OnUpdateCoroutines(DeltaTime dt);
+		static void OnDestroyEntity(Entity entity);
 
 		static void OnMouseEnterArea(Entity entity);
 		static void OnMouseExitArea(Entity entity);
@@ -46,6 +78,17 @@ namespace rhombus {
 		static void OnMouseButtonReleased(Entity entity, int button);
 
 		static Scene* GetSceneContext();
+
+		// Steps the incremental collector until budgetMilliseconds have passed or a cycle finishes, or collects in
+		// full if memory is over budget. Lua never collects on its own, so this must be called once per frame
+		static void CollectGarbage(float budgetMilliseconds);
+		static void SetMemoryBudget(size_t bytes);
+		static size_t GetMemoryBudget();
+
+		static const ScriptMemoryStats& GetMemoryStats();
+		// The engine first, then each script that has been loaded, then the same for every parallel state
+		static void GetScriptMemoryStats(std::vector<ScriptMemoryStats>& stats);
+		static const ScriptGarbageCollectionStats& GetGarbageCollectionStats();
 	private:
 		static void InitLua();
 		static void ShutdownLua();
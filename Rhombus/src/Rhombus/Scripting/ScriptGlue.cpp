@@ -6,12 +6,14 @@
 #include "Rhombus/Core/KeyCodes.h"
 #include "Rhombus/Scenes/Scene.h"
 #include "Rhombus/Scripting/ScriptEngine.h"
+#include "Rhombus/Scripting/ScriptCommandQueue.h"
+#include "Rhombus/Scripting/ScriptScheduler.h"
 #include "Rhombus/Renderer/Renderer2D.h"
 #include "Rhombus/ECS/Components/Rigidbody2DComponent.h"
 #include "Rhombus/ECS/Components/TransformComponent.h"
 #include "Rhombus/ECS/Components/Area2DComponent.h"
-
-#include "box2d/b2_body.h"
+#include "Rhombus/ECS/Components/ScriptComponent.h"
+#include "Rhombus/Animation/Tween.h"
 
 extern "C"
 {
@@ -24,18 +26,79 @@ namespace rhombus
 {
 #define ADD_INTERNAL_CALL(L, Name) lua_register(L, #Name, Name)
 
-	UUID GetEntityUUIDFromLua(lua_State * state)
+	// Entities are given to Lua as userdata holding the ID and the generation it had, which tells a handle to a
+	// destroyed entity apart from a new one that has reused the ID
+	struct EntityHandle
 	{
-		lua_getfield(state, 1, "entityIDa");		// indexed as if this is a fresh stack
-		uint32_t entityID32a = (uint32_t)lua_tonumber(state, -1);		// indexed as if this is a fresh stack
+		EntityID m_entity;
+		uint32_t m_generation;
+	};
 
-		lua_getfield(state, 1, "entityIDb");		// indexed as if this is a fresh stack
-		uint32_t entityID32b = (uint32_t)lua_tonumber(state, -1);		// indexed as if this is a fresh stack
+	// Every Lua state keeps its own entity metatable and handles in its registry, under the addresses of these keys
+	static const char s_entityMetatableKey = 0;
+	static const char s_entityHandlesKey = 0;		// Handles given out, indexed by EntityID + 1
+
+	static EntityHandle* ToEntityHandle(lua_State* state, int index)
+	{
+		EntityHandle* handle = (EntityHandle*)lua_touserdata(state, index);
+		if (!handle || !lua_getmetatable(state, index))
+		{
+			return nullptr;
+		}
+
+		lua_rawgetp(state, LUA_REGISTRYINDEX, &s_entityMetatableKey);
+		const bool isEntity = lua_rawequal(state, -1, -2);
+		lua_pop(state, 2);
+		return isEntity ? handle : nullptr;
+	}
 
+	// Takes a handle, or a table holding one in its entity field the way the self of a script does. The functions
+	// registered here have the field name as their first upvalue so it isn't interned again on every call
+	static Entity CheckEntity(lua_State* state, int index)
+	{
+		Scene* scene = ScriptEngine::GetSceneContext();
+		Log::Assert(scene, "Invalid Scene for an entity handle");
+
+		EntityHandle* handle = nullptr;
+		if (lua_type(state, index) == LUA_TTABLE)
+		{
+			lua_pushvalue(state, lua_upvalueindex(1));
+			lua_rawget(state, index);
+			handle = ToEntityHandle(state, -1);		// Still held by the table once popped
+			lua_pop(state, 1);
+		}
+		else
+		{
+			handle = ToEntityHandle(state, index);
+		}
+
+		if (!handle)
+		{
+			luaL_argerror(state, index, "entity expected");
+		}
+
+		if (scene->GetRegistry().GetEntityGeneration(handle->m_entity) != handle->m_generation)
+		{
+			luaL_argerror(state, index, "entity has been destroyed");
+		}
+
+		return Entity(handle->m_entity, scene);
+	}
 
-		uint64_t entityID64 = ((uint64_t)entityID32a) << 32 | entityID32b;
+	// Shared by the query functions on each thread, results beyond this are dropped
+	static const uint32_t s_maxQueryHits = 256;
+	static thread_local QueryHit s_queryHits[s_maxQueryHits];
 
-		return (UUID)entityID64;
+	static int PushQueryHits(lua_State* state, int resultsIndex, uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			ScriptGlue::PushEntity(state, s_queryHits[i].m_entity);
+			lua_rawseti(state, resultsIndex, (lua_Integer)i + 1);
+		}
+
+		lua_pushinteger(state, (lua_Integer)count);
+		return 1;
 	}
 
 	int HostFunction(lua_State* state)
@@ -53,15 +116,19 @@ namespace rhombus
 	{
 		Log::Assert(lua_gettop(state) == 1, "Invalid number of arguments passed to function");
 		std::string logString = lua_tostring(state, 1);
+		if (ScriptCommandQueue* commands = ScriptCommandQueue::GetCurrent())
+		{
+			commands->LogDebug(logString);
+			return 0;
+		}
+
 		Log::Debug(logString.c_str());
 		return 0;
 	}
 
 	int GetName(lua_State* state)
 	{
-		UUID entityID = GetEntityUUIDFromLua(state);
-		Scene* scene = ScriptEngine::GetSceneContext();
-		Entity entity = scene->GetEntityByUUID(entityID);
+		Entity entity = CheckEntity(state, 1);
 
 		lua_pushstring(state, entity.GetName().c_str());		// Push result onto lua stack
 		return 1;						// Number of return values that lua is expecting
@@ -81,19 +148,17 @@ namespace rhombus
 	{
 		Log::Assert(lua_gettop(state) == 3, "Invalid number of arguments passed to function");
 
-		UUID entityID = GetEntityUUIDFromLua(state);
+		Entity entity = CheckEntity(state, 1);
 		float impulseX = (float)lua_tonumber(state, 2);		// indexed as if this is a fresh stack
 		float impulseY = (float)lua_tonumber(state, 3);		// indexed as if this is a fresh stack
-		Scene* scene = ScriptEngine::GetSceneContext();
-		Log::Assert(scene, "Invalid Scene in ApplyLinearImpulse");
-		Entity entity = scene->GetEntityByUUID(entityID);
-		std::string name = entity.GetComponent<TagComponent>().m_tag;
-		//RB_CORE_ASSERT(entity, "Invalid Entity in ApplyLinearImpulse");
-
-		auto& rb2d = entity.GetComponent<Rigidbody2DComponent>();
-		// move to function
-		b2Body* body = (b2Body*)rb2d.m_runtimeBody;
-		body->ApplyLinearImpulseToCenter(b2Vec2(impulseX, impulseY), true);
+
+		if (ScriptCommandQueue* commands = ScriptCommandQueue::GetCurrent())
+		{
+			commands->ApplyLinearImpulse(entity, Vec2(impulseX, impulseY));
+			return 0;
+		}
+
+		ScriptEngine::GetSceneContext()->ApplyLinearImpulse(entity, Vec2(impulseX, impulseY));
 		return 0;						// Number of return values that lua is expecting
 	}
 
@@ -101,13 +166,15 @@ namespace rhombus
 	{
 		Log::Assert(lua_gettop(state) == 3, "Invalid number of arguments passed to function");
 
-		UUID entityID = GetEntityUUIDFromLua(state);
+		Entity entity = CheckEntity(state, 1);
 		float translateX = (float)lua_tonumber(state, 2);		// indexed as if this is a fresh stack
 		float translateY = (float)lua_tonumber(state, 3);		// indexed as if this is a fresh stack
-		Scene* scene = ScriptEngine::GetSceneContext();
-		Log::Assert(scene, "Invalid Scene in Translate");
-		Entity entity = scene->GetEntityByUUID(entityID);
-		std::string name = entity.GetComponent<TagComponent>().m_tag;
+
+		if (ScriptCommandQueue* commands = ScriptCommandQueue::GetCurrent())
+		{
+			commands->Translate(entity, Vec2(translateX, translateY));
+			return 0;
+		}
 
 		auto& transformComponent = entity.GetComponent<TransformComponent>();
 		transformComponent.SetPosition(transformComponent.GetPosition() + Vec3(translateX, translateY, 0.0f));
@@ -119,14 +186,16 @@ namespace rhombus
 	{
 		Log::Assert(lua_gettop(state) == 4, "Invalid number of arguments passed to function");
 
-		UUID entityID = GetEntityUUIDFromLua(state);
+		Entity entity = CheckEntity(state, 1);
 		float positionX = (float)lua_tonumber(state, 2);		// indexed as if this is a fresh stack
 		float positionY = (float)lua_tonumber(state, 3);		// indexed as if this is a fresh stack
 		float positionZ = (float)lua_tonumber(state, 4);		// indexed as if this is a fresh stack
-		Scene* scene = ScriptEngine::GetSceneContext();
-		Log::Assert(scene, "Invalid Scene in Translate");
-		Entity entity = scene->GetEntityByUUID(entityID);
-		std::string name = entity.GetComponent<TagComponent>().m_tag;
+
+		if (ScriptCommandQueue* commands = ScriptCommandQueue::GetCurrent())
+		{
+			commands->SetPosition(entity, Vec3(positionX, positionY, positionZ));
+			return 0;
+		}
 
 		auto& transformComponent = entity.GetComponent<TransformComponent>();
 		transformComponent.SetPosition(Vec3(positionX, positionY, positionZ));
@@ -138,20 +207,75 @@ namespace rhombus
 	{
 		Log::Assert(lua_gettop(state) == 1, "Invalid number of arguments passed to function");
 
-		UUID entityID = GetEntityUUIDFromLua(state);
-		Scene* scene = ScriptEngine::GetSceneContext();
-		Log::Assert(scene, "Invalid Scene in Translate");
-		Entity entity = scene->GetEntityByUUID(entityID);
-		std::string name = entity.GetComponent<TagComponent>().m_tag;
+		Entity entity = CheckEntity(state, 1);
 
-		auto& transformComponent = entity.GetComponent<TransformComponent>();
-		lua_pushnumber(state, transformComponent.GetPosition().x);
-		lua_pushnumber(state, transformComponent.GetPosition().y);
-		lua_pushnumber(state, transformComponent.GetPosition().z);
+		const Vec3 position = entity.GetComponentRead<TransformComponent>().GetPosition();
+		lua_pushnumber(state, position.x);
+		lua_pushnumber(state, position.y);
+		lua_pushnumber(state, position.z);
 
 		return 3;
 	}
 
+	// GetPositions(entities, positions) writes the x and y of entities[i] to positions[2i - 1] and positions[2i] and
+	// returns the number of entities. The entities can be handles or instance tables, like the array given to UpdateAll.
+	// Keeping the positions table between calls means it is only grown the first time
+	int GetPositions(lua_State* state)
+	{
+		Log::Assert(lua_gettop(state) == 2, "Invalid number of arguments passed to function");
+		luaL_checktype(state, 1, LUA_TTABLE);
+		luaL_checktype(state, 2, LUA_TTABLE);
+
+		const lua_Integer count = (lua_Integer)lua_rawlen(state, 1);
+		for (lua_Integer i = 1; i <= count; i++)
+		{
+			lua_rawgeti(state, 1, i);
+			Entity entity = CheckEntity(state, 3);
+			lua_pop(state, 1);
+
+			const Vec3 position = entity.GetComponentRead<TransformComponent>().GetPosition();
+			lua_pushnumber(state, position.x);
+			lua_rawseti(state, 2, 2 * i - 1);
+			lua_pushnumber(state, position.y);
+			lua_rawseti(state, 2, 2 * i);
+		}
+
+		lua_pushinteger(state, count);
+		return 1;
+	}
+
+	// SetPositions(entities, positions) moves entities[i] to x = positions[2i - 1], y = positions[2i], keeping its z
+	int SetPositions(lua_State* state)
+	{
+		Log::Assert(lua_gettop(state) == 2, "Invalid number of arguments passed to function");
+		luaL_checktype(state, 1, LUA_TTABLE);
+		luaL_checktype(state, 2, LUA_TTABLE);
+
+		ScriptCommandQueue* commands = ScriptCommandQueue::GetCurrent();
+		const lua_Integer count = (lua_Integer)lua_rawlen(state, 1);
+		for (lua_Integer i = 1; i <= count; i++)
+		{
+			lua_rawgeti(state, 1, i);
+			Entity entity = CheckEntity(state, 3);
+			lua_rawgeti(state, 2, 2 * i - 1);
+			lua_rawgeti(state, 2, 2 * i);
+			const float positionX = (float)lua_tonumber(state, -2);
+			const float positionY = (float)lua_tonumber(state, -1);
+			lua_pop(state, 3);
+
+			const Vec3 position = Vec3(positionX, positionY, entity.GetComponentRead<TransformComponent>().GetPosition().z);
+			if (commands)
+			{
+				commands->SetPosition(entity, position);
+				continue;
+			}
+
+			entity.GetComponent<TransformComponent>().SetPosition(position);
+		}
+
+		return 0;
+	}
+
 	int GetMousePosition(lua_State* state)
 	{
 		Log::Assert(lua_gettop(state) == 0, "Invalid number of arguments passed to function");
@@ -167,17 +291,200 @@ namespace rhombus
 	{
 		Log::Assert(lua_gettop(state) == 1, "Invalid number of arguments passed to function");
 
-		UUID entityID = GetEntityUUIDFromLua(state);
-		Scene* scene = ScriptEngine::GetSceneContext();
-		Entity entity = scene->GetEntityByUUID(entityID);
+		Entity entity = CheckEntity(state, 1);
 
-		auto& ba2d = entity.GetComponent<BoxArea2DComponent>();
-		
+		// Read only, it is called from thread safe scripts on the workers too
+		const auto& ba2d = entity.GetComponentRead<BoxArea2DComponent>();
 		lua_pushboolean(state, ba2d.m_isMouseInArea);
 
 		return 1;
 	}
 
+	// IsValid(entity) is false once the entity has been destroyed, where the other functions would raise an error
+	int IsValid(lua_State* state)
+	{
+		Log::Assert(lua_gettop(state) == 1, "Invalid number of arguments passed to function");
+
+		Scene* scene = ScriptEngine::GetSceneContext();
+		EntityHandle* handle = ToEntityHandle(state, 1);
+		lua_pushboolean(state, scene && handle && scene->GetRegistry().GetEntityGeneration(handle->m_entity) == handle->m_generation);
+		return 1;
+	}
+
+	int EntityToString(lua_State* state)
+	{
+		EntityHandle* handle = ToEntityHandle(state, 1);
+		lua_pushfstring(state, "Entity(%d:%d)", (int)handle->m_entity, (int)handle->m_generation);
+		return 1;
+	}
+
+	// QueryPoint(x, y, results [, shapeFlags]) fills results[1..n] with the entities whose shapes contain the point and returns n
+	int QueryPoint(lua_State* state)
+	{
+		const int argumentCount = lua_gettop(state);
+		Log::Assert(argumentCount == 3 || argumentCount == 4, "Invalid number of arguments passed to function");
+		luaL_checktype(state, 3, LUA_TTABLE);
+
+		Scene* scene = ScriptEngine::GetSceneContext();
+		Log::Assert(scene, "Invalid Scene in QueryPoint");
+
+		const Vec2 point = Vec2((float)lua_tonumber(state, 1), (float)lua_tonumber(state, 2));
+		const uint32_t shapeFlags = argumentCount == 4 ? (uint32_t)lua_tointeger(state, 4) : QUERY_ALL;
+		const uint32_t count = scene->Query().OverlapPoint(point, s_queryHits, s_maxQueryHits, shapeFlags);
+		return PushQueryHits(state, 3, count);
+	}
+
+	// QueryBox(minX, minY, maxX, maxY, results [, shapeFlags]) fills results[1..n] with the entities overlapping the box and returns n
+	int QueryBox(lua_State* state)
+	{
+		const int argumentCount = lua_gettop(state);
+		Log::Assert(argumentCount == 5 || argumentCount == 6, "Invalid number of arguments passed to function");
+		luaL_checktype(state, 5, LUA_TTABLE);
+
+		Scene* scene = ScriptEngine::GetSceneContext();
+		Log::Assert(scene, "Invalid Scene in QueryBox");
+
+		const Vec2 min = Vec2((float)lua_tonumber(state, 1), (float)lua_tonumber(state, 2));
+		const Vec2 max = Vec2((float)lua_tonumber(state, 3), (float)lua_tonumber(state, 4));
+		const uint32_t shapeFlags = argumentCount == 6 ? (uint32_t)lua_tointeger(state, 6) : QUERY_ALL;
+		const uint32_t count = scene->Query().OverlapBox(min, max, s_queryHits, s_maxQueryHits, shapeFlags);
+		return PushQueryHits(state, 5, count);
+	}
+
+	// QueryNearest(x, y, k, results [, maxDistance [, shapeFlags]]) fills results[1..n] with up to k entities nearest
+	// the point, nearest first, and returns n
+	int QueryNearest(lua_State* state)
+	{
+		const int argumentCount = lua_gettop(state);
+		Log::Assert(argumentCount >= 4 && argumentCount <= 6, "Invalid number of arguments passed to function");
+		luaL_checktype(state, 4, LUA_TTABLE);
+
+		Scene* scene = ScriptEngine::GetSceneContext();
+		Log::Assert(scene, "Invalid Scene in QueryNearest");
+
+		const Vec2 point = Vec2((float)lua_tonumber(state, 1), (float)lua_tonumber(state, 2));
+		const uint32_t maxHits = std::min((uint32_t)std::max(lua_tointeger(state, 3), (lua_Integer)0), s_maxQueryHits);
+		const float maxDistance = argumentCount >= 5 ? (float)lua_tonumber(state, 5) : FLT_MAX;
+		const uint32_t shapeFlags = argumentCount == 6 ? (uint32_t)lua_tointeger(state, 6) : QUERY_ALL;
+		const uint32_t count = scene->Query().Nearest(point, s_queryHits, maxHits, maxDistance, shapeFlags);
+		return PushQueryHits(state, 4, count);
+	}
+
+	// Raycast(startX, startY, endX, endY, hit [, shapeFlags]) returns true and fills hit.entity, hit.x, hit.y,
+	// hit.normalX, hit.normalY and hit.fraction with the first shape along the segment
+	int Raycast(lua_State* state)
+	{
+		const int argumentCount = lua_gettop(state);
+		Log::Assert(argumentCount == 5 || argumentCount == 6, "Invalid number of arguments passed to function");
+		luaL_checktype(state, 5, LUA_TTABLE);
+
+		Scene* scene = ScriptEngine::GetSceneContext();
+		Log::Assert(scene, "Invalid Scene in Raycast");
+
+		const Vec2 start = Vec2((float)lua_tonumber(state, 1), (float)lua_tonumber(state, 2));
+		const Vec2 end = Vec2((float)lua_tonumber(state, 3), (float)lua_tonumber(state, 4));
+		const uint32_t shapeFlags = argumentCount == 6 ? (uint32_t)lua_tointeger(state, 6) : QUERY_ALL;
+
+		RaycastHit hit;
+		if (!scene->Query().Raycast(start, end, hit, shapeFlags))
+		{
+			lua_pushboolean(state, false);
+			return 1;
+		}
+
+		ScriptGlue::PushEntity(state, hit.m_entity);
+		lua_setfield(state, 5, "entity");
+
+		lua_pushnumber(state, hit.m_point.x);
+		lua_setfield(state, 5, "x");
+		lua_pushnumber(state, hit.m_point.y);
+		lua_setfield(state, 5, "y");
+		lua_pushnumber(state, hit.m_normal.x);
+		lua_setfield(state, 5, "normalX");
+		lua_pushnumber(state, hit.m_normal.y);
+		lua_setfield(state, 5, "normalY");
+		lua_pushnumber(state, hit.m_fraction);
+		lua_setfield(state, 5, "fraction");
+
+		lua_pushboolean(state, true);
+		return 1;
+	}
+
+	// StartCoroutine(entity, function, ...) runs function(...) as a coroutine that stops when the entity, which must have
+	// a script, is destroyed
+	int StartCoroutine(lua_State* state)
+	{
+		Entity entity = CheckEntity(state, 1);
+		luaL_argcheck(state, entity.HasComponent<ScriptComponent>(), 1, "entity has no script");
+		luaL_checktype(state, 2, LUA_TFUNCTION);
+		if (ScriptCommandQueue::GetCurrent())
+		{
+			return luaL_error(state, "StartCoroutine can't be called from a thread safe script's update");
+		}
+
+		ScriptScheduler::Start(state, entity, lua_gettop(state) - 2);
+		return 0;
+	}
+
+	// Wait(seconds), WaitFrames(n) and WaitForTween(tween) can only be called from a coroutine
+	int Wait(lua_State* state)
+	{
+		return ScriptScheduler::Wait(state, (float)luaL_checknumber(state, 1));
+	}
+
+	int WaitFrames(lua_State* state)
+	{
+		return ScriptScheduler::WaitFrames(state, (uint32_t)luaL_optinteger(state, 1, 1));
+	}
+
+	int WaitForTween(lua_State* state)
+	{
+		return ScriptScheduler::WaitForTween(state, (uint32_t)luaL_checkinteger(state, 1));
+	}
+
+	// TweenPosition(entity, x, y, z, duration [, easing]) moves the entity from where it is and returns the tween, easing
+	// is one of rhombus.Easing
+	int TweenPosition(lua_State* state)
+	{
+		const int argumentCount = lua_gettop(state);
+		Log::Assert(argumentCount == 5 || argumentCount == 6, "Invalid number of arguments passed to function");
+
+		Entity entity = CheckEntity(state, 1);
+		const Vec3 finish = Vec3((float)lua_tonumber(state, 2), (float)lua_tonumber(state, 3), (float)lua_tonumber(state, 4));
+		const float duration = (float)lua_tonumber(state, 5);
+		const EasingType easingType = (EasingType)luaL_optinteger(state, 6, (lua_Integer)EasingType::LINEAR);
+		if (ScriptCommandQueue::GetCurrent())
+		{
+			return luaL_error(state, "TweenPosition can't be called from a thread safe script's update");
+		}
+
+		auto& transformComponent = entity.GetComponent<TransformComponent>();
+		Tween tween = ScriptEngine::GetSceneContext()->CreateTween(entity, TweenTarget::Create(entity, transformComponent, &transformComponent.GetPositionRef()), transformComponent.GetPosition(), finish, duration, easingType);
+
+		const uint32_t tweenID = ScriptScheduler::RegisterTween();
+		tween.SetOnFinished([tweenID]() { ScriptScheduler::OnTweenFinished(tweenID); });
+		tween.Start();
+
+		lua_pushinteger(state, (lua_Integer)tweenID);
+		return 1;
+	}
+
+	// In the order of EasingType
+	static const char* s_easingTypeNames[] =
+	{
+		"LINEAR",
+		"SINE_IN", "SINE_OUT", "SINE_IN_OUT",
+		"QUAD_IN", "QUAD_OUT", "QUAD_IN_OUT",
+		"CUBIC_IN", "CUBIC_OUT", "CUBIC_IN_OUT",
+		"QUART_IN", "QUART_OUT", "QUART_IN_OUT",
+		"QUINT_IN", "QUINT_OUT", "QUINT_IN_OUT",
+		"EXPO_IN", "EXPO_OUT", "EXPO_IN_OUT",
+		"CIRC_IN", "CIRC_OUT", "CIRC_IN_OUT",
+		"BACK_IN", "BACK_OUT", "BACK_IN_OUT",
+		"ELASTIC_IN", "ELASTIC_OUT", "ELASTIC_IN_OUT",
+		"BOUNCE_IN", "BOUNCE_OUT", "BOUNCE_IN_OUT"
+	};
+
 	static const luaL_Reg rhombus_funcs[] =
 	{
 		{ "HostFunction", HostFunction},
@@ -188,16 +495,107 @@ namespace rhombus
 		{ "Translate", Translate},
 		{ "SetPosition", SetPosition},
 		{ "GetPosition", GetPosition},
+		{ "GetPositions", GetPositions},
+		{ "SetPositions", SetPositions},
 		{ "GetMousePosition", GetMousePosition},
 		{ "IsMouseInArea", IsMouseInArea},
+		{ "QueryPoint", QueryPoint},
+		{ "QueryBox", QueryBox},
+		{ "QueryNearest", QueryNearest},
+		{ "Raycast", Raycast},
+		{ "IsValid", IsValid},
+		{ "StartCoroutine", StartCoroutine},
+		{ "Wait", Wait},
+		{ "WaitFrames", WaitFrames},
+		{ "WaitForTween", WaitForTween},
+		{ "TweenPosition", TweenPosition},
+		{ NULL, NULL }
+	};
+
+	// Methods of the entity handles, so entity:GetPosition() works the same as rhombus.GetPosition(entity)
+	static const luaL_Reg entity_methods[] =
+	{
+		{ "GetName", GetName},
+		{ "ApplyLinearImpulse", ApplyLinearImpulse},
+		{ "Translate", Translate},
+		{ "SetPosition", SetPosition},
+		{ "GetPosition", GetPosition},
+		{ "IsMouseInArea", IsMouseInArea},
+		{ "IsValid", IsValid},
+		{ "StartCoroutine", StartCoroutine},
+		{ "TweenPosition", TweenPosition},
 		{ NULL, NULL }
 	};
 
+	void ScriptGlue::PushEntity(lua_State* L, EntityID entity)
+	{
+		Scene* scene = ScriptEngine::GetSceneContext();
+		Log::Assert(scene, "Invalid Scene in PushEntity");
+		const uint32_t generation = scene->GetRegistry().GetEntityGeneration(entity);
+
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &s_entityHandlesKey);
+		if (lua_rawgeti(L, -1, (lua_Integer)entity + 1) == LUA_TUSERDATA && ((EntityHandle*)lua_touserdata(L, -1))->m_generation == generation)
+		{
+			lua_remove(L, -2);
+			return;
+		}
+		lua_pop(L, 1);
+
+		EntityHandle* handle = (EntityHandle*)lua_newuserdatauv(L, sizeof(EntityHandle), 0);
+		handle->m_entity = entity;
+		handle->m_generation = generation;
+		lua_rawgetp(L, LUA_REGISTRYINDEX, &s_entityMetatableKey);
+		lua_setmetatable(L, -2);
+
+		lua_pushvalue(L, -1);
+		lua_rawseti(L, -3, (lua_Integer)entity + 1);
+		lua_remove(L, -2);
+	}
+
+	void ScriptGlue::ResetEntityHandles(lua_State* L)
+	{
+		lua_createtable(L, MAX_ENTITIES, 0);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &s_entityHandlesKey);
+	}
+
 	void ScriptGlue::RegisterFunctions(lua_State* L)
 	{
+		// Entity handles
+		luaL_newmetatable(L, "rhombus.Entity");
+		lua_createtable(L, 0, 10);
+		lua_pushliteral(L, "entity");
+		luaL_setfuncs(L, entity_methods, 1);
+		lua_setfield(L, -2, "__index");
+		lua_pushcfunction(L, EntityToString);
+		lua_setfield(L, -2, "__tostring");
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &s_entityMetatableKey);
+
+		lua_createtable(L, MAX_ENTITIES, 0);
+		lua_rawsetp(L, LUA_REGISTRYINDEX, &s_entityHandlesKey);
+
 		lua_createtable(L, 0, 1);
-		luaL_setfuncs(L, rhombus_funcs, 0);
-		lua_pushvalue(L, -1);
+		lua_pushliteral(L, "entity");
+		luaL_setfuncs(L, rhombus_funcs, 1);
+
+		// Shape flags for the query functions
+		lua_pushinteger(L, QUERY_BOX_COLLIDER);
+		lua_setfield(L, -2, "QUERY_BOX_COLLIDER");
+		lua_pushinteger(L, QUERY_CIRCLE_COLLIDER);
+		lua_setfield(L, -2, "QUERY_CIRCLE_COLLIDER");
+		lua_pushinteger(L, QUERY_BOX_AREA);
+		lua_setfield(L, -2, "QUERY_BOX_AREA");
+		lua_pushinteger(L, QUERY_COLLIDERS);
+		lua_setfield(L, -2, "QUERY_COLLIDERS");
+		lua_pushinteger(L, QUERY_ALL);
+		lua_setfield(L, -2, "QUERY_ALL");
+
+		lua_createtable(L, 0, (int)std::size(s_easingTypeNames));
+		for (int i = 0; i < (int)std::size(s_easingTypeNames); i++)
+		{
+			lua_pushinteger(L, i);
+			lua_setfield(L, -2, s_easingTypeNames[i]);
+		}
+		lua_setfield(L, -2, "Easing");
 		lua_setglobal(L, "rhombus");
 		//ADD_INTERNAL_CALL(L, HostFunction);
 		//ADD_INTERNAL_CALL(L, Log);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Rhombus/ECS/ECSTypes.h"
+
 extern "C"
 {
 	class lua_State;
@@ -11,5 +13,11 @@ namespace rhombus
 	{
 	public:
 		static void RegisterFunctions(lua_State* L);
+
+		// Pushes the handle for an entity of the scene context. The same userdata is pushed every time until the
+		// entity is destroyed
+		static void PushEntity(lua_State* L, EntityID entity);
+		// Drops the handles given out so far, for when the scene context changes
+		static void ResetEntityHandles(lua_State* L);
 	};
 }
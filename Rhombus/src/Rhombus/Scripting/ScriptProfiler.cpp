@@ -0,0 +1,326 @@
+#include "rbpch.h"
+#include "ScriptProfiler.h"
+
+#include "Rhombus/Core/Log.h"
+
+extern "C"
+{
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+namespace rhombus
+{
+	struct ScriptTraceEvent
+	{
+		uint32_t m_profileIndex;
+		std::chrono::steady_clock::time_point m_start;
+		std::chrono::steady_clock::duration m_duration;
+	};
+
+	// Enough for several minutes of a busy scene, recording stops after that until the next reset
+	static constexpr uint32_t MAX_TRACE_EVENTS = 1 << 20;
+
+	static lua_State* s_state = nullptr;
+	static ScriptProfilerMode s_mode = ScriptProfilerMode::Off;
+	static int s_sampleInterval = 1000;
+
+	static std::vector<ScriptCallbackProfile> s_callbackProfiles;
+	static std::unordered_map<std::string, uint32_t> s_scriptProfileIndices;
+	static std::vector<ScriptTraceEvent> s_traceEvents;
+
+	static std::vector<ScriptFunctionProfile> s_functionProfiles;
+	static std::unordered_map<std::string, uint32_t> s_functionProfileIndices;
+	static std::vector<ScriptLineProfile> s_lineProfiles;
+	static std::unordered_map<std::string, uint32_t> s_lineProfileIndices;
+
+	static uint32_t s_callDepth = 0;
+	static uint32_t s_sampleCount = 0;
+	static std::chrono::steady_clock::time_point s_lastSampleTime;
+	// Lua time since the last sample from calls that have returned. Most calls are shorter than the sample interval, so
+	// their time goes to the next sample instead of being lost
+	static std::chrono::steady_clock::duration s_pendingSampleTime{};
+
+	namespace utils
+	{
+		static double ToMilliseconds(std::chrono::steady_clock::duration duration)
+		{
+			return std::chrono::duration<double, std::milli>(duration).count();
+		}
+
+		static std::string GetSourceKey(const lua_Debug& debug, int line)
+		{
+			std::string key = debug.source ? debug.source : "?";
+			key += ':';
+			key += std::to_string(line);
+			return key;
+		}
+	}
+
+	static ScriptFunctionProfile& GetFunctionProfile(const lua_Debug& debug)
+	{
+		const std::string key = utils::GetSourceKey(debug, debug.linedefined);
+		auto it = s_functionProfileIndices.find(key);
+		if (it == s_functionProfileIndices.end())
+		{
+			it = s_functionProfileIndices.emplace(key, (uint32_t)s_functionProfiles.size()).first;
+
+			ScriptFunctionProfile& profile = s_functionProfiles.emplace_back();
+			profile.Source = debug.short_src;
+			profile.Line = debug.linedefined;
+		}
+
+		// Functions called from the engine have no name, the name is taken from whichever sample finds one
+		ScriptFunctionProfile& profile = s_functionProfiles[it->second];
+		if (profile.Name.empty() && debug.name)
+		{
+			profile.Name = debug.name;
+		}
+		return profile;
+	}
+
+	static ScriptLineProfile& GetLineProfile(const lua_Debug& debug)
+	{
+		const std::string key = utils::GetSourceKey(debug, debug.currentline);
+		auto it = s_lineProfileIndices.find(key);
+		if (it == s_lineProfileIndices.end())
+		{
+			it = s_lineProfileIndices.emplace(key, (uint32_t)s_lineProfiles.size()).first;
+
+			ScriptLineProfile& profile = s_lineProfiles.emplace_back();
+			profile.Source = debug.short_src;
+			profile.Line = debug.currentline;
+		}
+		return s_lineProfiles[it->second];
+	}
+
+	// Called every s_sampleInterval instructions. The time since the last sample goes to the running line and
+	// function as self time, and to every function on the stack as total time
+	static void OnSampleHook(lua_State* state, lua_Debug*)
+	{
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		const double elapsedMs = utils::ToMilliseconds(s_pendingSampleTime + (now - s_lastSampleTime));
+		s_pendingSampleTime = {};
+		s_lastSampleTime = now;
+
+		s_sampleCount++;
+
+		lua_Debug debug;
+		for (int level = 0; lua_getstack(state, level, &debug); level++)
+		{
+			lua_getinfo(state, "Sln", &debug);
+			if (debug.what[0] == 'C')
+			{
+				continue;
+			}
+
+			ScriptFunctionProfile& function = GetFunctionProfile(debug);
+			if (level == 0)
+			{
+				function.Samples++;
+				function.SelfMs += elapsedMs;
+
+				ScriptLineProfile& line = GetLineProfile(debug);
+				line.Samples++;
+				line.SelfMs += elapsedMs;
+			}
+
+			if (function.LastSample != s_sampleCount)
+			{
+				function.LastSample = s_sampleCount;
+				function.TotalMs += elapsedMs;
+			}
+		}
+	}
+
+	void ScriptProfiler::Init(lua_State* state)
+	{
+		s_state = state;
+		SetMode(s_mode);
+	}
+
+	void ScriptProfiler::Shutdown()
+	{
+		if (s_state)
+		{
+			lua_sethook(s_state, nullptr, 0, 0);
+		}
+		s_state = nullptr;
+	}
+
+	void ScriptProfiler::SetMode(ScriptProfilerMode mode)
+	{
+		s_mode = mode;
+		if (s_state)
+		{
+			if (mode == ScriptProfilerMode::Sampling)
+			{
+				lua_sethook(s_state, OnSampleHook, LUA_MASKCOUNT, s_sampleInterval);
+			}
+			else
+			{
+				lua_sethook(s_state, nullptr, 0, 0);
+			}
+		}
+	}
+
+	ScriptProfilerMode ScriptProfiler::GetMode()
+	{
+		return s_mode;
+	}
+
+	bool ScriptProfiler::IsEnabled()
+	{
+		return s_mode != ScriptProfilerMode::Off;
+	}
+
+	void ScriptProfiler::SetSampleInterval(int instructionCount)
+	{
+		s_sampleInterval = std::max(instructionCount, 1);
+		SetMode(s_mode);
+	}
+
+	int ScriptProfiler::GetSampleInterval()
+	{
+		return s_sampleInterval;
+	}
+
+	uint32_t ScriptProfiler::RegisterScript(const std::string& scriptName, const char** callbackNames, uint32_t callbackCount)
+	{
+		auto it = s_scriptProfileIndices.find(scriptName);
+		if (it != s_scriptProfileIndices.end())
+		{
+			return it->second;
+		}
+
+		const uint32_t firstIndex = (uint32_t)s_callbackProfiles.size();
+		for (uint32_t i = 0; i < callbackCount; i++)
+		{
+			ScriptCallbackProfile& profile = s_callbackProfiles.emplace_back();
+			profile.ScriptName = scriptName;
+			profile.CallbackName = callbackNames[i];
+		}
+
+		s_scriptProfileIndices[scriptName] = firstIndex;
+		return firstIndex;
+	}
+
+	void ScriptProfiler::AddCalls(uint32_t profileIndex, uint32_t calls, double totalMs, double maxMs)
+	{
+		if (s_mode == ScriptProfilerMode::Off || calls == 0)
+		{
+			return;
+		}
+
+		ScriptCallbackProfile& profile = s_callbackProfiles[profileIndex];
+		profile.Calls += calls;
+		profile.TotalMs += totalMs;
+		profile.MaxMs = std::max(profile.MaxMs, maxMs);
+	}
+
+	void ScriptProfiler::Reset()
+	{
+		for (ScriptCallbackProfile& profile : s_callbackProfiles)
+		{
+			profile.Calls = 0;
+			profile.TotalMs = 0.0;
+			profile.MaxMs = 0.0;
+		}
+		s_traceEvents.clear();
+
+		s_functionProfiles.clear();
+		s_functionProfileIndices.clear();
+		s_lineProfiles.clear();
+		s_lineProfileIndices.clear();
+		s_sampleCount = 0;
+		s_pendingSampleTime = {};
+	}
+
+	const std::vector<ScriptCallbackProfile>& ScriptProfiler::GetCallbackProfiles()
+	{
+		return s_callbackProfiles;
+	}
+
+	const std::vector<ScriptFunctionProfile>& ScriptProfiler::GetFunctionProfiles()
+	{
+		return s_functionProfiles;
+	}
+
+	const std::vector<ScriptLineProfile>& ScriptProfiler::GetLineProfiles()
+	{
+		return s_lineProfiles;
+	}
+
+	uint32_t ScriptProfiler::GetTraceEventCount()
+	{
+		return (uint32_t)s_traceEvents.size();
+	}
+
+	bool ScriptProfiler::ExportChromeTrace(const std::string& filepath)
+	{
+		// A file of its own, so it works while an Instrumentor session is running
+		std::ofstream stream(filepath);
+		if (!stream.is_open())
+		{
+			Log::Error("Could not open %s to export the script profile", filepath.c_str());
+			return false;
+		}
+
+		Instrumentor::WriteTraceHeader(stream);
+
+		const std::thread::id threadID = std::this_thread::get_id();
+		for (const ScriptTraceEvent& event : s_traceEvents)
+		{
+			const ScriptCallbackProfile& profile = s_callbackProfiles[event.m_profileIndex];
+			const std::string name = profile.ScriptName + ":" + profile.CallbackName;
+			Instrumentor::WriteTraceEvent(stream, { name, FloatingPointMicroseconds{ event.m_start.time_since_epoch() },
+				std::chrono::duration_cast<std::chrono::microseconds>(event.m_duration), threadID });
+		}
+
+		Instrumentor::WriteTraceFooter(stream);
+		Log::Info("Exported %u script calls to %s", (uint32_t)s_traceEvents.size(), filepath.c_str());
+		return true;
+	}
+
+	ScriptProfiler::CallScope::CallScope(uint32_t profileIndex)
+		: m_profileIndex(profileIndex), m_enabled(s_mode != ScriptProfilerMode::Off)
+	{
+		if (m_enabled)
+		{
+			m_start = std::chrono::steady_clock::now();
+
+			// Time between calls isn't spent in Lua
+			if (s_callDepth++ == 0)
+			{
+				s_lastSampleTime = m_start;
+			}
+		}
+	}
+
+	ScriptProfiler::CallScope::~CallScope()
+	{
+		if (!m_enabled)
+		{
+			return;
+		}
+
+		const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		if (--s_callDepth == 0)
+		{
+			s_pendingSampleTime += end - s_lastSampleTime;
+		}
+
+		const std::chrono::steady_clock::duration duration = end - m_start;
+		const double durationMs = utils::ToMilliseconds(duration);
+
+		ScriptCallbackProfile& profile = s_callbackProfiles[m_profileIndex];
+		profile.Calls++;
+		profile.TotalMs += durationMs;
+		profile.MaxMs = std::max(profile.MaxMs, durationMs);
+
+		if (s_traceEvents.size() < MAX_TRACE_EVENTS)
+		{
+			s_traceEvents.push_back({ m_profileIndex, m_start, duration });
+		}
+	}
+}
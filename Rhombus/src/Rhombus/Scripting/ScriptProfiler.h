@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+namespace rhombus
+{
+	enum class ScriptProfilerMode
+	{
+		Off = 0,
+		Instrumentation,		// Times every callback the engine makes into a script
+		Sampling				// Instrumentation, and a count hook that attributes time to Lua functions and lines
+	};
+
+	// Time spent in one callback of one script class, counted from the moment the engine calls into Lua
+	struct ScriptCallbackProfile
+	{
+		std::string ScriptName;
+		std::string CallbackName;
+		uint32_t Calls = 0;
+		double TotalMs = 0.0;
+		double MaxMs = 0.0;
+	};
+
+	// Self is time sampled while the function was running, total also counts the functions it called
+	struct ScriptFunctionProfile
+	{
+		std::string Name;
+		std::string Source;
+		int Line = 0;					// Where the function is defined
+		uint32_t Samples = 0;
+		double SelfMs = 0.0;
+		double TotalMs = 0.0;
+		uint32_t LastSample = 0;		// Stops recursive functions being counted more than once per sample
+	};
+
+	struct ScriptLineProfile
+	{
+		std::string Source;
+		int Line = 0;
+		uint32_t Samples = 0;
+		double SelfMs = 0.0;
+	};
+
+	class ScriptProfiler
+	{
+	public:
+		static void Init(lua_State* state);
+		static void Shutdown();
+
+		static void SetMode(ScriptProfilerMode mode);
+		static ScriptProfilerMode GetMode();
+		static bool IsEnabled();
+
+		// Instructions run between samples in sampling mode
+		static void SetSampleInterval(int instructionCount);
+		static int GetSampleInterval();
+
+		// Reserves a profile for each callback of a script class and returns the index of the first
+		static uint32_t RegisterScript(const std::string& scriptName, const char** callbackNames, uint32_t callbackCount);
+
+		// Adds calls timed off the main thread, maxMs being the longest of them. They aren't traced
+		static void AddCalls(uint32_t profileIndex, uint32_t calls, double totalMs, double maxMs);
+
+		static void Reset();
+
+		static const std::vector<ScriptCallbackProfile>& GetCallbackProfiles();
+		static const std::vector<ScriptFunctionProfile>& GetFunctionProfiles();
+		static const std::vector<ScriptLineProfile>& GetLineProfiles();
+		static uint32_t GetTraceEventCount();
+
+		// Writes every callback timed since the last reset as a trace that can be viewed in chrome://tracing/, in a file
+		// of its own whether or not an Instrumentor session is running
+		static bool ExportChromeTrace(const std::string& filepath);
+
+		// Times a call into Lua, when the profiler is enabled
+		class CallScope
+		{
+		public:
+			CallScope(uint32_t profileIndex);
+			~CallScope();
+
+		private:
+			uint32_t m_profileIndex;
+			bool m_enabled;
+			std::chrono::steady_clock::time_point m_start;
+		};
+	};
+}
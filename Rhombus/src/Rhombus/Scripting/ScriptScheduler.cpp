@@ -0,0 +1,515 @@
+#include "rbpch.h"
+#include "ScriptScheduler.h"
+#include "ScriptProfiler.h"
+#include "LuaAllocator.h"
+
+#include "Rhombus/Core/Log.h"
+
+extern "C"
+{
+#include <lua.h>
+#include <lauxlib.h>
+}
+
+namespace rhombus
+{
+	static constexpr uint32_t INVALID_COROUTINE = UINT32_MAX;
+	static constexpr uint32_t MIN_STALE_ENTRIES = 64;		// Before a wait queue is swept of stopped coroutines
+
+	enum class WaitType
+	{
+		None = 0,
+		Frames,
+		Time,
+		Tween
+	};
+
+	struct ScriptCoroutine
+	{
+		lua_State* m_thread = nullptr;
+		lua_State* m_state = nullptr;					// Main thread of the state that holds the reference to it
+		int m_threadRef = LUA_NOREF;
+		LuaAllocator* m_allocator = nullptr;
+		uint32_t m_allocatorOwner = LuaAllocator::ENGINE_OWNER;		// Of the script that started it
+		EntityID m_entity = INVALID_ENTITY;
+		uint32_t m_generation = 0;						// Tells a parked entry apart from a later coroutine in the same slot
+		uint32_t m_previous = INVALID_COROUTINE;		// In the list of its entity's coroutines
+		uint32_t m_next = INVALID_COROUTINE;
+		WaitType m_waiting = WaitType::None;
+		uint32_t m_tweenID = 0;							// While waiting for a tween
+		bool m_running = false;
+		bool m_stopped = false;							// While running, it is released once it yields instead of parked
+	};
+
+	// An entry of a wait queue. Entries of coroutines stopped while parked are skipped when they come up, or swept out
+	// once they are half the queue
+	struct ParkedCoroutine
+	{
+		double m_due;			// Frame or time
+		uint64_t m_order;		// Coroutines due at the same point resume in the order they were parked
+		uint32_t m_index;
+		uint32_t m_generation;
+
+		bool operator>(const ParkedCoroutine& other) const
+		{
+			return m_due != other.m_due ? m_due > other.m_due : m_order > other.m_order;
+		}
+	};
+
+	// A heap with the first due on top, kept as a vector so stale entries can be swept out
+	struct WaitQueue
+	{
+		std::vector<ParkedCoroutine> m_entries;
+		uint32_t m_staleEntries = 0;
+
+		bool IsDue(double due) const { return !m_entries.empty() && m_entries.front().m_due <= due; }
+
+		void Push(const ParkedCoroutine& parked)
+		{
+			m_entries.push_back(parked);
+			std::push_heap(m_entries.begin(), m_entries.end(), std::greater<ParkedCoroutine>());
+		}
+
+		ParkedCoroutine Pop()
+		{
+			std::pop_heap(m_entries.begin(), m_entries.end(), std::greater<ParkedCoroutine>());
+			const ParkedCoroutine parked = m_entries.back();
+			m_entries.pop_back();
+			return parked;
+		}
+
+		void Clear()
+		{
+			m_entries.clear();
+			m_staleEntries = 0;
+		}
+	};
+
+	// What the wait function called by a coroutine asked for, read as soon as it yields
+	struct WaitRequest
+	{
+		lua_State* m_thread = nullptr;
+		WaitType m_type = WaitType::None;
+		double m_value = 0.0;
+	};
+
+	static std::vector<ScriptCoroutine> s_coroutines;
+	static std::vector<uint32_t> s_freeCoroutines;
+	static std::unordered_map<EntityID, uint32_t> s_entityCoroutines;		// First in the list of each entity's coroutines
+
+	static WaitQueue s_frameQueue;
+	static WaitQueue s_timeQueue;
+	static std::unordered_map<uint32_t, std::vector<ParkedCoroutine>> s_tweenWaiters;		// Only coroutines still waiting
+	static std::unordered_set<uint32_t> s_runningTweens;
+	static std::vector<uint32_t> s_finishedTweens;			// Since the last update
+	static uint32_t s_nextTweenID = 1;
+
+	static double s_time = 0.0;
+	static uint64_t s_frame = 0;
+	static uint64_t s_parkCount = 0;
+	static WaitRequest s_waitRequest;
+	static std::vector<ParkedCoroutine> s_dueCoroutines;
+
+	static ScriptSchedulerStats s_stats;
+	static uint32_t s_profileIndex = UINT32_MAX;
+
+	static bool IsStale(const ParkedCoroutine& parked)
+	{
+		return s_coroutines[parked.m_index].m_generation != parked.m_generation;
+	}
+
+	static void SweepStaleEntries(WaitQueue& queue)
+	{
+		if (queue.m_staleEntries < MIN_STALE_ENTRIES || queue.m_staleEntries * 2 < queue.m_entries.size())
+		{
+			return;
+		}
+
+		queue.m_entries.erase(std::remove_if(queue.m_entries.begin(), queue.m_entries.end(), IsStale), queue.m_entries.end());
+		std::make_heap(queue.m_entries.begin(), queue.m_entries.end(), std::greater<ParkedCoroutine>());
+		queue.m_staleEntries = 0;
+	}
+
+	// Takes the entry of a parked coroutine out of its wait, before the coroutine is released
+	static void Unpark(uint32_t index)
+	{
+		ScriptCoroutine& coroutine = s_coroutines[index];
+		switch (coroutine.m_waiting)
+		{
+		case WaitType::Time:
+			s_timeQueue.m_staleEntries++;
+			break;
+		case WaitType::Frames:
+			s_frameQueue.m_staleEntries++;
+			break;
+		case WaitType::Tween:
+		{
+			auto it = s_tweenWaiters.find(coroutine.m_tweenID);
+			if (it != s_tweenWaiters.end())
+			{
+				std::vector<ParkedCoroutine>& waiters = it->second;
+				waiters.erase(std::find_if(waiters.begin(), waiters.end(), [index](const ParkedCoroutine& parked) { return parked.m_index == index; }));
+				if (waiters.empty())
+				{
+					s_tweenWaiters.erase(it);
+				}
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	static uint32_t& GetWaitCount(WaitType type)
+	{
+		switch (type)
+		{
+		case WaitType::Time:
+			return s_stats.WaitingForTime;
+		case WaitType::Tween:
+			return s_stats.WaitingForTweens;
+		default:
+			return s_stats.WaitingForFrames;
+		}
+	}
+
+	static void SetWaiting(ScriptCoroutine& coroutine, WaitType type)
+	{
+		if (coroutine.m_waiting != WaitType::None)
+		{
+			GetWaitCount(coroutine.m_waiting)--;
+		}
+		if (type != WaitType::None)
+		{
+			GetWaitCount(type)++;
+		}
+		coroutine.m_waiting = type;
+	}
+
+	static void ReleaseCoroutine(uint32_t index)
+	{
+		ScriptCoroutine& coroutine = s_coroutines[index];
+
+		if (coroutine.m_previous != INVALID_COROUTINE)
+		{
+			s_coroutines[coroutine.m_previous].m_next = coroutine.m_next;
+		}
+		else if (coroutine.m_next != INVALID_COROUTINE)
+		{
+			s_entityCoroutines[coroutine.m_entity] = coroutine.m_next;
+		}
+		else
+		{
+			s_entityCoroutines.erase(coroutine.m_entity);
+		}
+
+		if (coroutine.m_next != INVALID_COROUTINE)
+		{
+			s_coroutines[coroutine.m_next].m_previous = coroutine.m_previous;
+		}
+
+		Unpark(index);
+		SetWaiting(coroutine, WaitType::None);
+		luaL_unref(coroutine.m_state, LUA_REGISTRYINDEX, coroutine.m_threadRef);
+
+		coroutine.m_thread = nullptr;
+		coroutine.m_state = nullptr;
+		coroutine.m_threadRef = LUA_NOREF;
+		coroutine.m_entity = INVALID_ENTITY;
+		coroutine.m_generation++;
+		coroutine.m_previous = INVALID_COROUTINE;
+		coroutine.m_next = INVALID_COROUTINE;
+		coroutine.m_stopped = false;
+
+		s_freeCoroutines.push_back(index);
+		s_stats.Coroutines--;
+	}
+
+	static void Park(uint32_t index, const WaitRequest& request)
+	{
+		ScriptCoroutine& coroutine = s_coroutines[index];
+		const uint64_t order = s_parkCount++;
+
+		switch (request.m_type)
+		{
+		case WaitType::Time:
+			s_timeQueue.Push({ s_time + request.m_value, order, index, coroutine.m_generation });
+			break;
+		case WaitType::Tween:
+			coroutine.m_tweenID = (uint32_t)request.m_value;
+			s_tweenWaiters[coroutine.m_tweenID].push_back({ 0.0, order, index, coroutine.m_generation });
+			break;
+		default:
+			s_frameQueue.Push({ (double)s_frame + std::max(request.m_value, 1.0), order, index, coroutine.m_generation });
+			break;
+		}
+
+		SetWaiting(coroutine, request.m_type == WaitType::None ? WaitType::Frames : request.m_type);
+	}
+
+	// Runs the coroutine until it waits, returns or fails. from is the thread resuming it
+	static void Resume(uint32_t index, lua_State* from, int argCount)
+	{
+		// Starting coroutines from inside this one can grow s_coroutines, so nothing is held across the resume
+		lua_State* thread = s_coroutines[index].m_thread;
+		LuaAllocator* allocator = s_coroutines[index].m_allocator;
+		const uint32_t previousOwner = allocator->GetOwner();
+
+		s_coroutines[index].m_running = true;
+		allocator->SetOwner(s_coroutines[index].m_allocatorOwner);
+
+		int resultCount = 0;
+		int status;
+		{
+			ScriptProfiler::CallScope profileScope(s_profileIndex);
+			status = lua_resume(thread, from, argCount, &resultCount);
+		}
+
+		allocator->SetOwner(previousOwner);
+		s_stats.Resumed++;
+
+		// A plain coroutine.yield waits a frame
+		const WaitRequest request = s_waitRequest.m_thread == thread ? s_waitRequest : WaitRequest();
+		s_waitRequest = {};
+
+		ScriptCoroutine& coroutine = s_coroutines[index];
+		coroutine.m_running = false;
+
+		if (status == LUA_YIELD)
+		{
+			lua_pop(thread, resultCount);
+			if (!coroutine.m_stopped)
+			{
+				Park(index, request);
+				return;
+			}
+		}
+		else if (status != LUA_OK)
+		{
+			luaL_traceback(from, thread, lua_tostring(thread, -1), 0);
+			Log::Error("[Lua Error] %s", lua_tostring(from, -1));
+			lua_pop(from, 1);
+		}
+
+		ReleaseCoroutine(index);
+	}
+
+	static int YieldFor(lua_State* state, WaitType type, double value, const char* functionName)
+	{
+		if (!lua_isyieldable(state))
+		{
+			return luaL_error(state, "%s can only be called from a coroutine started with StartCoroutine", functionName);
+		}
+
+		s_waitRequest = { state, type, value };
+		return lua_yield(state, 0);
+	}
+
+	void ScriptScheduler::Start(lua_State* state, Entity entity, int argCount)
+	{
+		if (s_profileIndex == UINT32_MAX)
+		{
+			const char* callbackName = "Resume";
+			s_profileIndex = ScriptProfiler::RegisterScript("Coroutines", &callbackName, 1);
+		}
+
+		uint32_t index;
+		if (!s_freeCoroutines.empty())
+		{
+			index = s_freeCoroutines.back();
+			s_freeCoroutines.pop_back();
+		}
+		else
+		{
+			index = (uint32_t)s_coroutines.size();
+			s_coroutines.emplace_back();
+		}
+
+		ScriptCoroutine& coroutine = s_coroutines[index];
+
+		void* allocator = nullptr;
+		lua_getallocf(state, &allocator);
+		coroutine.m_allocator = (LuaAllocator*)allocator;
+		coroutine.m_allocatorOwner = coroutine.m_allocator->GetOwner();
+
+		// The reference is released through the main thread, the thread starting this one may be gone by then
+		lua_rawgeti(state, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+		coroutine.m_state = lua_tothread(state, -1);
+		lua_pop(state, 1);
+
+		coroutine.m_thread = lua_newthread(state);
+		coroutine.m_threadRef = luaL_ref(state, LUA_REGISTRYINDEX);
+		lua_xmove(state, coroutine.m_thread, argCount + 1);
+
+		coroutine.m_entity = entity;
+		auto it = s_entityCoroutines.find(entity);
+		if (it != s_entityCoroutines.end())
+		{
+			coroutine.m_next = it->second;
+			s_coroutines[it->second].m_previous = index;
+			it->second = index;
+		}
+		else
+		{
+			s_entityCoroutines[entity] = index;
+		}
+
+		s_stats.Coroutines++;
+		Resume(index, state, argCount);
+	}
+
+	void ScriptScheduler::Update(DeltaTime dt)
+	{
+		RB_PROFILE_FUNCTION();
+
+		s_time += dt;
+		s_frame++;
+		s_stats.Resumed = 0;
+
+		// Tweens first, then frames, then time. Taken out of their waits here, so any stopped before they are resumed
+		// are released without leaving a stale entry behind
+		s_dueCoroutines.clear();
+		for (uint32_t tweenID : s_finishedTweens)
+		{
+			auto it = s_tweenWaiters.find(tweenID);
+			if (it != s_tweenWaiters.end())
+			{
+				s_dueCoroutines.insert(s_dueCoroutines.end(), it->second.begin(), it->second.end());
+				s_tweenWaiters.erase(it);
+			}
+		}
+		s_finishedTweens.clear();
+
+		auto takeDue = [](WaitQueue& queue, double due)
+		{
+			while (queue.IsDue(due))
+			{
+				const ParkedCoroutine parked = queue.Pop();
+				if (IsStale(parked))
+				{
+					queue.m_staleEntries--;
+				}
+				else
+				{
+					s_dueCoroutines.push_back(parked);
+				}
+			}
+		};
+		takeDue(s_frameQueue, (double)s_frame);
+		takeDue(s_timeQueue, s_time);
+
+		for (const ParkedCoroutine& parked : s_dueCoroutines)
+		{
+			SetWaiting(s_coroutines[parked.m_index], WaitType::None);
+		}
+
+		for (const ParkedCoroutine& parked : s_dueCoroutines)
+		{
+			if (IsStale(parked))
+			{
+				continue;
+			}
+
+			Resume(parked.m_index, s_coroutines[parked.m_index].m_state, 0);
+		}
+	}
+
+	void ScriptScheduler::StopEntity(EntityID entity)
+	{
+		auto it = s_entityCoroutines.find(entity);
+		if (it == s_entityCoroutines.end())
+		{
+			return;
+		}
+
+		uint32_t index = it->second;
+		while (index != INVALID_COROUTINE)
+		{
+			ScriptCoroutine& coroutine = s_coroutines[index];
+			const uint32_t next = coroutine.m_next;
+
+			// An entity destroying itself from one of its coroutines
+			if (coroutine.m_running)
+			{
+				coroutine.m_stopped = true;
+			}
+			else
+			{
+				ReleaseCoroutine(index);
+			}
+
+			index = next;
+		}
+
+		SweepStaleEntries(s_frameQueue);
+		SweepStaleEntries(s_timeQueue);
+	}
+
+	void ScriptScheduler::Clear()
+	{
+		for (ScriptCoroutine& coroutine : s_coroutines)
+		{
+			if (coroutine.m_thread)
+			{
+				luaL_unref(coroutine.m_state, LUA_REGISTRYINDEX, coroutine.m_threadRef);
+			}
+		}
+
+		s_coroutines.clear();
+		s_freeCoroutines.clear();
+		s_entityCoroutines.clear();
+
+		s_frameQueue.Clear();
+		s_timeQueue.Clear();
+		s_tweenWaiters.clear();
+		s_runningTweens.clear();
+		s_finishedTweens.clear();
+
+		s_time = 0.0;
+		s_frame = 0;
+		s_waitRequest = {};
+		s_stats = {};
+	}
+
+	int ScriptScheduler::Wait(lua_State* state, float seconds)
+	{
+		return YieldFor(state, WaitType::Time, seconds, "Wait");
+	}
+
+	int ScriptScheduler::WaitFrames(lua_State* state, uint32_t frameCount)
+	{
+		return YieldFor(state, WaitType::Frames, frameCount, "WaitFrames");
+	}
+
+	int ScriptScheduler::WaitForTween(lua_State* state, uint32_t tweenID)
+	{
+		// Finished, or never made
+		if (s_runningTweens.find(tweenID) == s_runningTweens.end())
+		{
+			return 0;
+		}
+
+		return YieldFor(state, WaitType::Tween, tweenID, "WaitForTween");
+	}
+
+	uint32_t ScriptScheduler::RegisterTween()
+	{
+		const uint32_t tweenID = s_nextTweenID++;
+		s_runningTweens.insert(tweenID);
+		return tweenID;
+	}
+
+	void ScriptScheduler::OnTweenFinished(uint32_t tweenID)
+	{
+		if (s_runningTweens.erase(tweenID))
+		{
+			s_finishedTweens.push_back(tweenID);
+		}
+	}
+
+	const ScriptSchedulerStats& ScriptScheduler::GetStats()
+	{
+		return s_stats;
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Rhombus/Core/DeltaTime.h"
+#include "Rhombus/Scenes/Entity.h"
+
+struct lua_State;
+
+namespace rhombus
+{
+	struct ScriptSchedulerStats
+	{
+		uint32_t Coroutines = 0;			// Alive, running or parked
+		uint32_t WaitingForTime = 0;
+		uint32_t WaitingForFrames = 0;
+		uint32_t WaitingForTweens = 0;
+		uint32_t Resumed = 0;				// During the last update
+	};
+
+	// Runs Lua functions as coroutines that belong to an entity. A coroutine that waits is parked until it is due,
+	// in a queue ordered by the time or frame it is waiting for, or in the list of a tween, so parked coroutines
+	// cost nothing while they wait however many there are. The coroutines of an entity stop when it is destroyed
+	class ScriptScheduler
+	{
+	public:
+		// Takes the function with its argCount arguments above it off the stack of state and runs it as a coroutine of
+		// the entity until it first waits or returns
+		static void Start(lua_State* state, Entity entity, int argCount);
+
+		// Advances time and resumes every coroutine that is due. Waits on tweens that finished come first, then frame
+		// waits, then time waits, each in the order they are due. Once per update
+		static void Update(DeltaTime dt);
+
+		// Stops the coroutines of the entity, they are never resumed again
+		static void StopEntity(EntityID entity);
+		// Stops every coroutine and starts time again from zero
+		static void Clear();
+
+		// Yield the running coroutine with what it is waiting for. Raise a Lua error outside a coroutine
+		static int Wait(lua_State* state, float seconds);
+		static int WaitFrames(lua_State* state, uint32_t frameCount);
+		static int WaitForTween(lua_State* state, uint32_t tweenID);
+
+		// Tweens that coroutines can wait for are given an ID when created and report when they finish or are stopped
+		static uint32_t RegisterTween();
+		static void OnTweenFinished(uint32_t tweenID);
+
+		static const ScriptSchedulerStats& GetStats();
+	};
+}
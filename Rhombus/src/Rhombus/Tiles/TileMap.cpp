@@ -29,6 +29,129 @@ namespace rhombus
 		return m_tilesets.back();
 	}
 
+	const std::vector<TileRect>& TileMap::GetCollisionRects()
+	{
+		if (!m_collisionDirty)
+		{
+			return m_collisionRects;
+		}
+
+		RB_PROFILE_FUNCTION();
+
+		const uint32_t chunkRowCount = (m_gridHeight + TILE_COLLISION_CHUNK_SIZE - 1) / TILE_COLLISION_CHUNK_SIZE;
+		const uint32_t chunkColumnCount = (m_gridWidth + TILE_COLLISION_CHUNK_SIZE - 1) / TILE_COLLISION_CHUNK_SIZE;
+		if (chunkColumnCount != m_chunkColumnCount || m_chunkCollisionRects.size() != chunkRowCount * chunkColumnCount)
+		{
+			m_chunkColumnCount = chunkColumnCount;
+			m_chunkCollisionRects.assign(chunkRowCount * chunkColumnCount, {});
+			m_dirtyCollisionChunks.assign(chunkRowCount * chunkColumnCount, true);
+		}
+
+		for (uint32_t chunk = 0; chunk < (uint32_t)m_chunkCollisionRects.size(); chunk++)
+		{
+			if (m_dirtyCollisionChunks[chunk])
+			{
+				m_chunkCollisionRects[chunk].clear();
+				GenerateChunkCollision(chunk / chunkColumnCount, chunk % chunkColumnCount, m_chunkCollisionRects[chunk]);
+				m_dirtyCollisionChunks[chunk] = false;
+			}
+		}
+
+		m_collisionRects.clear();
+		for (const std::vector<TileRect>& chunkRects : m_chunkCollisionRects)
+		{
+			m_collisionRects.insert(m_collisionRects.end(), chunkRects.begin(), chunkRects.end());
+		}
+
+		m_collisionDirty = false;
+		m_collisionVersion++;
+		return m_collisionRects;
+	}
+
+	void TileMap::GetCollisionRectBounds(const TileRect& rect, Vec2& outCenter, Vec2& outHalfSize) const
+	{
+		const float tileMapHalfWidth = (m_gridWidth * m_tileSize.x) / 2.0f;
+		const float tileMapHalfHeight = (m_gridHeight * m_tileSize.y) / 2.0f;
+
+		outHalfSize = Vec2(rect.m_columnCount * m_tileSize.x, rect.m_rowCount * m_tileSize.y) * 0.5f;
+		outCenter = Vec2(-tileMapHalfWidth + rect.m_column * m_tileSize.x + outHalfSize.x, tileMapHalfHeight - rect.m_row * m_tileSize.y - outHalfSize.y);
+	}
+
+	void TileMap::InvalidateCollision()
+	{
+		std::fill(m_dirtyCollisionChunks.begin(), m_dirtyCollisionChunks.end(), true);
+		m_collisionDirty = true;
+	}
+
+	void TileMap::InvalidateCollision(uint32_t i, uint32_t j)
+	{
+		const uint32_t chunk = (i / TILE_COLLISION_CHUNK_SIZE) * m_chunkColumnCount + j / TILE_COLLISION_CHUNK_SIZE;
+		if (chunk < m_dirtyCollisionChunks.size())
+		{
+			m_dirtyCollisionChunks[chunk] = true;
+		}
+
+		m_collisionDirty = true;
+	}
+
+	void TileMap::GenerateChunkCollision(uint32_t chunkRow, uint32_t chunkColumn, std::vector<TileRect>& outRects) const
+	{
+		const uint32_t firstRow = chunkRow * TILE_COLLISION_CHUNK_SIZE;
+		const uint32_t firstColumn = chunkColumn * TILE_COLLISION_CHUNK_SIZE;
+		const uint32_t rowCount = std::min(TILE_COLLISION_CHUNK_SIZE, m_gridHeight - firstRow);
+		const uint32_t columnCount = std::min(TILE_COLLISION_CHUNK_SIZE, m_gridWidth - firstColumn);
+
+		// Take the first free solid tile, grow it as wide as possible and then as far down as the whole width allows
+		bool merged[TILE_COLLISION_CHUNK_SIZE][TILE_COLLISION_CHUNK_SIZE] = {};
+		for (uint32_t row = 0; row < rowCount; row++)
+		{
+			for (uint32_t column = 0; column < columnCount; column++)
+			{
+				if (merged[row][column] || !IsTileSolid(firstRow + row, firstColumn + column))
+				{
+					continue;
+				}
+
+				uint32_t width = 1;
+				while (column + width < columnCount && !merged[row][column + width] && IsTileSolid(firstRow + row, firstColumn + column + width))
+				{
+					width++;
+				}
+
+				uint32_t height = 1;
+				while (row + height < rowCount)
+				{
+					bool rowSolid = true;
+					for (uint32_t x = column; x < column + width && rowSolid; x++)
+					{
+						rowSolid = !merged[row + height][x] && IsTileSolid(firstRow + row + height, firstColumn + x);
+					}
+
+					if (!rowSolid)
+					{
+						break;
+					}
+
+					height++;
+				}
+
+				for (uint32_t y = row; y < row + height; y++)
+				{
+					for (uint32_t x = column; x < column + width; x++)
+					{
+						merged[y][x] = true;
+					}
+				}
+
+				TileRect& rect = outRects.emplace_back();
+				rect.m_row = firstRow + row;
+				rect.m_column = firstColumn + column;
+				rect.m_rowCount = height;
+				rect.m_columnCount = width;
+			}
+		}
+	}
+
 	Ref<TileMap> TileMap::Create()
 	{
 		Ref<TileMap> tilemap = CreateRef<TileMap>();
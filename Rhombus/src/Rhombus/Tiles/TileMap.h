@@ -10,6 +10,16 @@ namespace rhombus
 
 	const uint32_t DEFAULT_GRID_DIMENSIONS = 32;
 	const uint32_t DEFAULT_TILE_SIZE = 16;
+	const uint32_t TILE_COLLISION_CHUNK_SIZE = 16;		// Collision is regenerated per chunk of this many tiles square
+
+	// Rectangle of solid tiles in grid coordinates. Rows count down from the top of the map like m_tileGrid
+	struct TileRect
+	{
+		uint32_t m_row = 0;
+		uint32_t m_column = 0;
+		uint32_t m_rowCount = 0;
+		uint32_t m_columnCount = 0;
+	};
 
 	class TileMap
 	{
@@ -17,8 +27,8 @@ namespace rhombus
 		TileMap();
 
 		Ref<SubTexture2D> GetTile(uint32_t i, uint32_t j) const { return m_tileGrid[i][j] < 0 ? nullptr : m_tilesets[0]->GetTile(m_tileGrid[i][j]); }
-		void SetTile(std::string tilesetID, int tileIndex, uint32_t i, uint32_t j) { m_tileGrid[i][j] = tileIndex; }
-		void ClearTile(uint32_t i, uint32_t j) { m_tileGrid[i][j] = -1; }
+		void SetTile(std::string tilesetID, int tileIndex, uint32_t i, uint32_t j) { m_tileGrid[i][j] = tileIndex; InvalidateCollision(i, j); }
+		void ClearTile(uint32_t i, uint32_t j) { m_tileGrid[i][j] = -1; InvalidateCollision(i, j); }
 
 		bool ContainsTileset(std::string id) const;
 		const Ref<Tileset> GetTileset(std::string id) const;
@@ -30,8 +40,24 @@ namespace rhombus
 		uint32_t GetGridWidth() const { return m_gridWidth; }
 		uint32_t GetGridHeight() const { return m_gridHeight; }
 
+		// Every tile that is set counts as solid. Solid tiles are greedily merged into rectangles per chunk and only the
+		// chunks touched since the last call are merged again
+		const std::vector<TileRect>& GetCollisionRects();
+		// Changes whenever GetCollisionRects returns something different, so users can tell when to rebuild
+		uint32_t GetCollisionVersion() const { return m_collisionVersion; }
+		// Center and half size of a rectangle relative to the centre of the map, matching how the tiles are drawn
+		void GetCollisionRectBounds(const TileRect& rect, Vec2& outCenter, Vec2& outHalfSize) const;
+
+		// Needed after writing to m_tileGrid directly
+		void InvalidateCollision();
+		void InvalidateCollision(uint32_t i, uint32_t j);
+
 		static Ref<TileMap> Create();
 
+	private:
+		bool IsTileSolid(uint32_t i, uint32_t j) const { return i < m_tileGrid.size() && j < m_tileGrid[i].size() && m_tileGrid[i][j] >= 0; }
+		void GenerateChunkCollision(uint32_t chunkRow, uint32_t chunkColumn, std::vector<TileRect>& outRects) const;
+
 	public:
 		TileGrid m_tileGrid;
 
@@ -42,6 +68,13 @@ namespace rhombus
 		uint32_t m_gridWidth;
 		uint32_t m_gridHeight;
 		Vec2 m_tileSize;
+
+		uint32_t m_chunkColumnCount = 0;
+		std::vector<std::vector<TileRect>> m_chunkCollisionRects;
+		std::vector<bool> m_dirtyCollisionChunks;
+		std::vector<TileRect> m_collisionRects;
+		bool m_collisionDirty = true;
+		uint32_t m_collisionVersion = 0;
 	};
 }
 
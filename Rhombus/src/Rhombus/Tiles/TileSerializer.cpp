@@ -125,6 +125,7 @@ namespace rhombus
 
 		std::vector<std::vector<int>> tilegrid = tileGridNode.as<std::vector<std::vector<int>>>();
 		tilemap->m_tileGrid = tilegrid;
+		tilemap->InvalidateCollision();
 
 		return tilemap;
 	}
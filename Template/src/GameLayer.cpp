@@ -36,6 +36,13 @@ void GameLayer::OnDetach()
 	RB_PROFILE_FUNCTION();
 }
 
+void GameLayer::OnFixedUpdate(rhombus::DeltaTime dt)
+{
+	RB_PROFILE_FUNCTION();
+
+	m_ActiveScene->OnFixedUpdateRuntime(dt);
+}
+
 void GameLayer::OnUpdate(rhombus::DeltaTime dt)
 {
 	RB_PROFILE_FUNCTION();
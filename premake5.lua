@@ -47,4 +47,5 @@ include "Rhombus"
 include "Rhombus-Editor"
 include "Volley"
 include "Patience"
-include "Rhombus-ScriptRegistry"
\ No newline at end of file
+include "Rhombus-ScriptRegistry"
+include "Rhombus-Tests"
\ No newline at end of file